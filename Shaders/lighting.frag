@@ -7,9 +7,17 @@ uniform sampler2D uSceneTex;
 uniform sampler2D uNormalTex;
 uniform sampler2D uCookieTex[8];
 uniform vec3 uAmbient;
-uniform int uLightCount;
 uniform mat4 uInverseViewProjection;
 
+// Lights are binned per screen tile on the CPU (see LightBinning.hpp).
+// uLightData holds four texels per light; the tile buffers are CSR lists.
+uniform samplerBuffer uLightData;
+uniform usamplerBuffer uTileOffsets;
+uniform usamplerBuffer uTileIndices;
+uniform int uTileSize;
+uniform int uTilesX;
+uniform int uTilesY;
+
 struct Light {
     int type;          // 0=point,1=directional,2=spot
     vec2 pos;
@@ -24,7 +32,28 @@ struct Light {
     int cookieSlot;
     float cookieStrength;
 };
-uniform Light uLights[8];
+
+Light fetchLight(int index) {
+    int base = index * 4;
+    vec4 t0 = texelFetch(uLightData, base);
+    vec4 t1 = texelFetch(uLightData, base + 1);
+    vec4 t2 = texelFetch(uLightData, base + 2);
+    vec4 t3 = texelFetch(uLightData, base + 3);
+    Light l;
+    l.pos = t0.xy;
+    l.dir = t0.zw;
+    l.color = t1.rgb;
+    l.intensity = t1.a;
+    l.radius = t2.x;
+    l.falloff = t2.y;
+    l.innerCutoff = t2.z;
+    l.outerCutoff = t2.w;
+    l.type = int(t3.x);
+    l.emissiveBoost = t3.y;
+    l.cookieSlot = int(t3.z);
+    l.cookieStrength = t3.w;
+    return l;
+}
 
 float sampleCookie(int slot, vec2 uv) {
     if (slot == 0) return texture(uCookieTex[0], uv).r;
@@ -55,8 +84,14 @@ void main() {
 
     vec3 lit = albedo * uAmbient;
 
-    for (int i = 0; i < uLightCount; ++i) {
-        Light l = uLights[i];
+    ivec2 tile = clamp(ivec2(gl_FragCoord.xy) / uTileSize, ivec2(0),
+                       ivec2(uTilesX - 1, uTilesY - 1));
+    int tileIndex = tile.y * uTilesX + tile.x;
+    int first = int(texelFetch(uTileOffsets, tileIndex).r);
+    int last = int(texelFetch(uTileOffsets, tileIndex + 1).r);
+
+    for (int i = first; i < last; ++i) {
+        Light l = fetchLight(int(texelFetch(uTileIndices, i).r));
         float att = 1.0;
 
         if (l.type == 0) { // Point
@@ -1,17 +1,43 @@
 #version 330 core
 
-layout (location = 0) in vec2 aPos;
-layout (location = 1) in vec4 aColor;
-layout (location = 2) in vec2 aTexCoord;
+// One instance per particle, uploaded column by column straight from the
+// simulation's structure-of-arrays storage. The quad is expanded here.
+layout (location = 0) in float aPositionX;
+layout (location = 1) in float aPositionY;
+layout (location = 2) in float aSizeX;
+layout (location = 3) in float aSizeY;
+layout (location = 4) in float aRotation;
+layout (location = 5) in float aRed;
+layout (location = 6) in float aGreen;
+layout (location = 7) in float aBlue;
+layout (location = 8) in float aAlpha;
 
 out vec4 vColor;
 out vec2 vTexCoord;
 
-uniform mat4 transform;
 uniform mat4 projection;
+uniform vec4 uTint;
+// With a border each instance draws 12 vertices: an enlarged quad in the
+// border color, then the particle itself.
+uniform bool uUseBorder;
+uniform vec4 uBorderColor;
+uniform float uBorderScale;
+
+const vec2 kCorners[6] = vec2[](
+    vec2(-0.5, -0.5), vec2(0.5, -0.5), vec2(0.5, 0.5),
+    vec2(0.5, 0.5), vec2(-0.5, 0.5), vec2(-0.5, -0.5));
 
 void main() {
-    vColor = aColor;
-    vTexCoord = aTexCoord;
-    gl_Position = projection * transform * vec4(aPos, 0.0, 1.0);
+    bool borderQuad = uUseBorder && gl_VertexID < 6;
+    vec2 corner = kCorners[gl_VertexID % 6];
+    vec2 size = vec2(aSizeX, aSizeY) * (borderQuad ? uBorderScale : 1.0);
+    float c = cos(aRotation);
+    float s = sin(aRotation);
+    vec2 local = corner * size;
+    vec2 world = vec2(aPositionX, aPositionY) +
+                 vec2(local.x * c - local.y * s, local.x * s + local.y * c);
+
+    vColor = borderQuad ? uBorderColor : vec4(aRed, aGreen, aBlue, aAlpha) * uTint;
+    vTexCoord = vec2(corner.x + 0.5, 0.5 - corner.y);
+    gl_Position = projection * vec4(world, 0.0, 1.0);
 }
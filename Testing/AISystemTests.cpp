@@ -1,12 +1,16 @@
 #include <boost/test/unit_test.hpp>
 
 #include <limits>
+#include <map>
 #include <memory>
+#include <random>
 #include <stdexcept>
 #include <vector>
 
 #include "AISystem/AICombatBrain.hpp"
 #include "AISystem/Perception.hpp"
+#include "AISystem/PerceptionService.hpp"
+#include "AISystem/UpdateScheduler.hpp"
 #include "GameObjects/Components/ColliderComponent.hpp"
 #include "GameObjects/Components/CombatComponent.hpp"
 #include "GameObjects/Components/TransformComponent.hpp"
@@ -15,10 +19,11 @@
 
 namespace {
 std::unique_ptr<Entity> makeBoxEntity(const glm::vec2& position,
-                                      std::uint32_t layer = 0) {
+                                      std::uint32_t layer = 0,
+                                      const glm::vec2& halfSize = glm::vec2{0.5f}) {
     auto entity = std::make_unique<Entity>();
     entity->addComponent<TransformComponent>().setPosition(position);
-    auto collider = std::make_unique<AABBCollider>(glm::vec2{-0.5f}, glm::vec2{0.5f});
+    auto collider = std::make_unique<AABBCollider>(-halfSize, halfSize);
     auto& component = entity->addComponent<ColliderComponent>(std::move(collider));
     component.setLayer(layer);
     component.ensureCollider(*entity);
@@ -112,4 +117,289 @@ BOOST_AUTO_TEST_CASE(hearing_clears_output_and_respects_radius_and_layers) {
                       std::invalid_argument);
 }
 
+BOOST_AUTO_TEST_CASE(perception_service_answers_batched_queries_on_the_next_tick) {
+    std::vector<std::unique_ptr<Entity>> entities;
+    entities.push_back(makeBoxEntity(glm::vec2{5.0f, 0.0f}));
+    entities.push_back(makeBoxEntity(glm::vec2{10.0f, 0.0f}, 3));
+    entities.push_back(makeBoxEntity(glm::vec2{10.0f, 6.0f}, 3));
+    Entity* wall = entities[0].get();
+    Entity* target = entities[1].get();
+
+    AI::PerceptionService perception;
+    const auto blocked = perception.requestLineOfSight(glm::vec2{0.0f}, glm::vec2{10.0f, 0.0f},
+                                                       0xFFFFFFFFu, nullptr, target);
+    const auto duplicate = perception.requestLineOfSight(glm::vec2{0.0f}, glm::vec2{10.0f, 0.0f},
+                                                         0xFFFFFFFFu, nullptr, target);
+    const auto ignoringWall = perception.requestLineOfSight(glm::vec2{0.0f}, glm::vec2{10.0f, 0.0f},
+                                                            0xFFFFFFFFu, wall, target);
+    const auto above = perception.requestLineOfSight(glm::vec2{0.0f, 6.0f}, glm::vec2{10.0f, 6.0f},
+                                                     0xFFFFFFFFu, nullptr, entities[2].get());
+    const auto hearing = perception.requestHearing(glm::vec2{10.0f, 3.0f}, 3.0f, 1u << 3u);
+    const auto deaf = perception.requestHearing(glm::vec2{10.0f, 3.0f}, 0.0f);
+    BOOST_TEST(perception.pending() == 5u);
+    BOOST_TEST(perception.stats().deduplicated == 1u);
+    BOOST_TEST(!perception.lineOfSight(blocked).has_value());
+    BOOST_CHECK_THROW(static_cast<void>(perception.requestHearing(glm::vec2{0.0f}, -1.0f)),
+                      std::invalid_argument);
+
+    perception.update(entities);
+    BOOST_TEST(perception.pending() == 0u);
+    BOOST_TEST((perception.lineOfSight(blocked) == std::optional<bool>{false}));
+    BOOST_TEST((perception.lineOfSight(duplicate) == std::optional<bool>{false}));
+    BOOST_TEST((perception.lineOfSight(ignoringWall) == std::optional<bool>{true}));
+    BOOST_TEST((perception.lineOfSight(above) == std::optional<bool>{true}));
+    BOOST_TEST(!perception.lineOfSight(hearing).has_value());
+    BOOST_TEST((perception.heard(hearing) == std::optional<bool>{true}));
+    const auto heard = perception.heardEntities(hearing);
+    BOOST_REQUIRE(heard.size() == 2u);
+    BOOST_TEST(heard[0] == target);
+    BOOST_TEST(heard[1] == entities[2].get());
+    BOOST_TEST((perception.heard(deaf) == std::optional<bool>{false}));
+    BOOST_TEST(perception.heardEntities(deaf).empty());
+    BOOST_TEST(perception.stats().lineOfSightResolved == 3u);
+    BOOST_TEST(perception.stats().collidersLastUpdate == 3u);
+
+    // With one retained batch, answers last until the next update.
+    perception.setSettings(AI::PerceptionService::Settings{1});
+    BOOST_TEST((perception.lineOfSight(blocked) == std::optional<bool>{false}));
+    const auto next = perception.requestLineOfSight(glm::vec2{0.0f}, glm::vec2{1.0f, 0.0f});
+    BOOST_TEST((perception.lineOfSight(blocked) == std::optional<bool>{false}));
+    perception.update(entities);
+    BOOST_TEST(!perception.lineOfSight(blocked).has_value());
+    BOOST_TEST(perception.heardEntities(hearing).empty());
+    BOOST_TEST((perception.lineOfSight(next) == std::optional<bool>{true}));
+    BOOST_TEST(!perception.lineOfSight(AI::PerceptionTicket{}).has_value());
+    BOOST_CHECK_THROW(perception.setSettings(AI::PerceptionService::Settings{0}), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(perception_answers_outlive_slow_scheduler_rates) {
+    std::vector<std::unique_ptr<Entity>> entities;
+    entities.push_back(makeBoxEntity(glm::vec2{5.0f, 0.0f}));
+    entities.push_back(makeBoxEntity(glm::vec2{10.0f, 0.0f}, 3));
+    Entity* target = entities[1].get();
+
+    // A far agent asks on its own update and reads the answer on its next
+    // one, 16 ticks later, while the service resolves a batch every tick.
+    AI::PerceptionService perception;
+    AI::UpdateScheduler scheduler;
+    const AI::AgentHandle agent = scheduler.add(1, glm::vec2{500.0f, 0.0f});
+    const std::vector<glm::vec2> focus{glm::vec2{0.0f}};
+    AI::PerceptionTicket sight;
+    AI::PerceptionTicket hearing;
+    int updates = 0;
+    int answered = 0;
+    for (int tick = 0; tick < 64; ++tick) {
+        scheduler.tick(1.0f / 60.0f, focus, [&](const AI::UpdateScheduler::Update&) {
+            ++updates;
+            if (sight.valid()) {
+                BOOST_TEST((perception.lineOfSight(sight) == std::optional<bool>{false}));
+                BOOST_TEST((perception.heard(hearing) == std::optional<bool>{true}));
+                BOOST_TEST(perception.heardEntities(hearing).size() == 2u);
+                ++answered;
+            }
+            sight = perception.requestLineOfSight(glm::vec2{0.0f}, glm::vec2{10.0f, 0.0f},
+                                                  0xFFFFFFFFu, nullptr, target);
+            hearing = perception.requestHearing(glm::vec2{7.0f, 0.0f}, 4.0f);
+        });
+        // Unrelated queries from other agents fill the batches in between.
+        static_cast<void>(perception.requestHearing(glm::vec2{static_cast<float>(tick), 50.0f}, 1.0f));
+        perception.update(entities);
+    }
+    BOOST_TEST((scheduler.rate(agent) == AI::UpdateRate::Every16th));
+    BOOST_TEST(updates == 4);
+    BOOST_TEST(answered == 3);
+
+    // Once retainedBatches newer batches are resolved, the answers are gone.
+    for (std::size_t i = 0; i < perception.settings().retainedBatches; ++i) {
+        perception.update(entities);
+    }
+    BOOST_TEST(!perception.lineOfSight(sight).has_value());
+    BOOST_TEST(perception.heardEntities(hearing).empty());
+}
+
+BOOST_AUTO_TEST_CASE(perception_occlusion_grid_agrees_with_exact_line_of_sight) {
+    std::vector<std::unique_ptr<Entity>> entities;
+    // Static walls on layer 1, actors on layer 2.
+    entities.push_back(makeBoxEntity(glm::vec2{0.0f, 0.0f}, 1, glm::vec2{1.0f, 8.0f}));
+    entities.push_back(makeBoxEntity(glm::vec2{6.0f, 5.0f}, 1, glm::vec2{4.0f, 0.75f}));
+    entities.push_back(makeBoxEntity(glm::vec2{-6.0f, -4.0f}, 1, glm::vec2{2.5f, 2.5f}));
+    // Straddles the first wall, so it can be seen past it.
+    entities.push_back(makeBoxEntity(glm::vec2{0.0f, 6.0f}, 2, glm::vec2{2.0f, 0.5f}));
+    for (int i = 0; i < 6; ++i) {
+        entities.push_back(makeBoxEntity(glm::vec2{-9.0f + 3.5f * i, -9.0f + 3.0f * i}, 2));
+    }
+
+    AI::PerceptionService perception;
+    perception.bakeOcclusion(entities, 1u << 1u, 0.5f);
+    BOOST_TEST(perception.occludedCells() == 4u * 32u + 16u * 2u + 100u);
+    BOOST_CHECK_THROW(perception.bakeOcclusion(entities, 1u << 1u, 0.0f), std::invalid_argument);
+
+    std::mt19937 rng(7u);
+    std::uniform_real_distribution<float> coordinate(-12.0f, 12.0f);
+    std::uniform_int_distribution<std::size_t> pick(3, entities.size() - 1);
+    struct Line {
+        glm::vec2 from;
+        glm::vec2 to;
+        std::uint32_t mask;
+        const Entity* ignore;
+        const Entity* target;
+        AI::PerceptionTicket ticket;
+    };
+    std::vector<Line> lines;
+    for (int i = 0; i < 400; ++i) {
+        Line line{{coordinate(rng), coordinate(rng)}, {coordinate(rng), coordinate(rng)},
+                  i % 5 == 0 ? (1u << 2u) : 0xFFFFFFFFu, nullptr, nullptr, {}};
+        if (i % 2 == 0) {
+            const Entity* target = entities[pick(rng)].get();
+            line.target = target;
+            line.to = target->getComponent<ColliderComponent>()->collider()->getAABB().center();
+        }
+        if (i % 7 == 0) {
+            line.ignore = entities[static_cast<std::size_t>(i % 3)].get();
+        }
+        line.ticket = perception.requestLineOfSight(line.from, line.to, line.mask,
+                                                    line.ignore, line.target);
+        lines.push_back(line);
+    }
+    // From just left of the wall to the straddling target's tip, through the wall.
+    const auto pastWall = perception.requestLineOfSight(glm::vec2{-3.0f, 6.0f}, glm::vec2{1.5f, 6.0f},
+                                                        0xFFFFFFFFu, nullptr, entities[3].get());
+    const auto throughWall = perception.requestLineOfSight(glm::vec2{-3.0f, 0.0f}, glm::vec2{3.0f, 0.0f});
+    perception.update(entities);
+
+    for (const Line& line : lines) {
+        const bool exact = AI::hasLineOfSight(line.from, line.to, entities, line.mask,
+                                              line.ignore, line.target);
+        BOOST_TEST((perception.lineOfSight(line.ticket) == std::optional<bool>{exact}));
+    }
+    BOOST_TEST((perception.lineOfSight(pastWall) == std::optional<bool>{true}));
+    BOOST_TEST((perception.lineOfSight(throughWall) == std::optional<bool>{false}));
+    BOOST_TEST(perception.stats().occlusionRejects > 50u);
+
+    perception.clearOcclusion();
+    BOOST_TEST(perception.occludedCells() == 0u);
+}
+
+BOOST_AUTO_TEST_CASE(update_scheduler_staggers_buckets_by_distance_and_importance) {
+    AI::UpdateScheduler scheduler(AI::UpdateScheduler::Settings{10.0f, 50.0f, 0.1f});
+    std::vector<AI::AgentHandle> handles;
+    for (std::uint64_t i = 0; i < 8; ++i) {
+        handles.push_back(scheduler.add(i, glm::vec2{5.0f, 0.0f}));
+    }
+    for (std::uint64_t i = 8; i < 40; ++i) {
+        handles.push_back(scheduler.add(i, glm::vec2{0.0f, 30.0f}));
+    }
+    for (std::uint64_t i = 40; i < 104; ++i) {
+        handles.push_back(scheduler.add(i, glm::vec2{-100.0f, 0.0f}));
+    }
+    // Far away, but important enough to count as near.
+    const AI::AgentHandle boss = scheduler.add(104, glm::vec2{-100.0f, 0.0f}, 20.0f);
+    const std::vector<glm::vec2> focus{glm::vec2{0.0f}, glm::vec2{1000.0f}};
+
+    std::map<std::uint64_t, int> updates;
+    std::map<std::uint64_t, float> elapsed;
+    const auto record = [&](const AI::UpdateScheduler::Update& update) {
+        ++updates[update.user];
+        elapsed[update.user] += update.dt;
+    };
+    constexpr float dt = 0.25f;
+    scheduler.tick(dt, focus, record);
+    BOOST_TEST(updates.size() == 105u);
+    BOOST_TEST((scheduler.rate(handles.front()) == AI::UpdateRate::EveryTick));
+    BOOST_TEST((scheduler.rate(handles[8]) == AI::UpdateRate::Every4th));
+    BOOST_TEST((scheduler.rate(handles.back()) == AI::UpdateRate::Every16th));
+    BOOST_TEST((scheduler.rate(boss) == AI::UpdateRate::EveryTick));
+    BOOST_TEST(scheduler.stats().buckets[0].agents == 9u);
+    BOOST_TEST(scheduler.stats().buckets[1].agents == 32u);
+    BOOST_TEST(scheduler.stats().buckets[2].agents == 64u);
+
+    // After the first tick each bucket runs 1/period of its agents per tick.
+    for (int tick = 1; tick <= 16; ++tick) {
+        scheduler.tick(dt, focus, record);
+        BOOST_TEST(scheduler.stats().buckets[0].updatedLastTick == 9u);
+        BOOST_TEST(scheduler.stats().buckets[1].updatedLastTick == 8u);
+        BOOST_TEST(scheduler.stats().buckets[2].updatedLastTick == 4u);
+    }
+    BOOST_TEST(updates[0] == 17);
+    BOOST_TEST(updates[8] == 5);
+    BOOST_TEST(updates[40] == 2);
+    BOOST_TEST(scheduler.stats().ticks == 17u);
+    BOOST_TEST(scheduler.stats().buckets[2].updates == 64u + 64u);
+    // Each update carries the time since the agent's previous one.
+    for (const auto& [user, seconds] : elapsed) {
+        BOOST_TEST(seconds <= 17 * dt);
+        BOOST_TEST(seconds > 17 * dt - 16 * dt);
+    }
+    BOOST_TEST(elapsed[0] == 17 * dt);
+    BOOST_TEST(elapsed[8] == 17 * dt);
+}
+
+BOOST_AUTO_TEST_CASE(update_scheduler_accumulates_time_for_combat_cooldowns) {
+    AI::UpdateScheduler scheduler;
+    const AI::AgentHandle far = scheduler.add(7, glm::vec2{500.0f, 0.0f});
+    AICombatBrain brain;
+    brain.setAttackRange(1000.0f);
+    brain.setCooldown(1.0f);
+
+    constexpr float dt = 1.0f / 60.0f;
+    int attacks = 0;
+    float brainTime = 0.0f;
+    const std::vector<glm::vec2> focus{glm::vec2{0.0f}};
+    for (int tick = 0; tick < 160; ++tick) {
+        scheduler.tick(dt, focus, [&](const AI::UpdateScheduler::Update& update) {
+            BOOST_TEST(update.user == 7u);
+            brain.update(update.dt);
+            brainTime += update.dt;
+            if (brain.tryAttack(glm::vec2{500.0f, 0.0f}, glm::vec2{0.0f})) ++attacks;
+        });
+    }
+    BOOST_TEST((scheduler.rate(far) == AI::UpdateRate::Every16th));
+    // Updates on ticks 0, 16, ..., 144: ten in all, with 144 ticks between
+    // the first and last, so a one-second cooldown allows attacks at 0, 64
+    // and 128 ticks.
+    BOOST_TEST(brainTime == 145.0f * dt, boost::test_tools::tolerance(1e-4f));
+    BOOST_TEST(attacks == 3);
+    BOOST_TEST(brain.remainingCooldown() == 1.0f - 16.0f * dt, boost::test_tools::tolerance(1e-4f));
+}
+
+BOOST_AUTO_TEST_CASE(update_scheduler_demotes_with_hysteresis_and_validates_handles) {
+    AI::UpdateScheduler scheduler(AI::UpdateScheduler::Settings{10.0f, 50.0f, 0.2f});
+    const AI::AgentHandle agent = scheduler.add(1, glm::vec2{5.0f, 0.0f});
+    const std::vector<glm::vec2> focus{glm::vec2{0.0f}};
+    const auto ignore = [](const AI::UpdateScheduler::Update&) {};
+    scheduler.tick(0.1f, focus, ignore);
+    BOOST_TEST((scheduler.rate(agent) == AI::UpdateRate::EveryTick));
+
+    scheduler.setPosition(agent, glm::vec2{11.0f, 0.0f});
+    scheduler.tick(0.1f, focus, ignore);
+    BOOST_TEST((scheduler.rate(agent) == AI::UpdateRate::EveryTick));
+    scheduler.setPosition(agent, glm::vec2{59.0f, 0.0f});
+    scheduler.tick(0.1f, focus, ignore);
+    BOOST_TEST((scheduler.rate(agent) == AI::UpdateRate::Every4th));
+    scheduler.setPosition(agent, glm::vec2{61.0f, 0.0f});
+    scheduler.tick(0.1f, focus, ignore);
+    BOOST_TEST((scheduler.rate(agent) == AI::UpdateRate::Every16th));
+    // Promotion is immediate.
+    scheduler.setPosition(agent, glm::vec2{9.0f, 0.0f});
+    scheduler.tick(0.1f, focus, ignore);
+    BOOST_TEST((scheduler.rate(agent) == AI::UpdateRate::EveryTick));
+    scheduler.setImportance(agent, 0.5f);
+    scheduler.tick(0.1f, focus, ignore);
+    BOOST_TEST((scheduler.rate(agent) == AI::UpdateRate::Every4th));
+
+    scheduler.remove(agent);
+    BOOST_TEST(!scheduler.contains(agent));
+    BOOST_TEST(scheduler.size() == 0u);
+    BOOST_CHECK_THROW(scheduler.setPosition(agent, glm::vec2{0.0f}), std::out_of_range);
+    BOOST_CHECK_THROW(static_cast<void>(scheduler.rate(agent)), std::out_of_range);
+    const AI::AgentHandle reused = scheduler.add(2, glm::vec2{0.0f});
+    BOOST_TEST(reused.index == agent.index);
+    BOOST_TEST(!(reused == agent));
+
+    BOOST_CHECK_THROW(static_cast<void>(scheduler.add(3, glm::vec2{0.0f}, 0.0f)), std::invalid_argument);
+    BOOST_CHECK_THROW(scheduler.tick(-1.0f, focus, ignore), std::invalid_argument);
+    BOOST_CHECK_THROW(scheduler.setSettings(AI::UpdateScheduler::Settings{10.0f, 5.0f, 0.1f}),
+                      std::invalid_argument);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
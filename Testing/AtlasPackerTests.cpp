@@ -0,0 +1,94 @@
+#include <boost/test/unit_test.hpp>
+
+#include "RenderingSystem/AtlasPacker.hpp"
+
+#include <stdexcept>
+#include <vector>
+
+namespace {
+bool intersects(const Rendering::AtlasPacker::Placement& a,
+                const Rendering::AtlasPacker::Placement& b, int padding) {
+    return a.page == b.page &&
+           a.x - padding < b.x + b.width + padding &&
+           b.x - padding < a.x + a.width + padding &&
+           a.y - padding < b.y + b.height + padding &&
+           b.y - padding < a.y + a.height + padding;
+}
+}
+
+BOOST_AUTO_TEST_SUITE(AtlasPackerTests)
+
+BOOST_AUTO_TEST_CASE(skyline_packs_rows_and_reports_occupancy) {
+    Rendering::SkylinePacker packer(64, 64);
+    const auto first = packer.insert(32, 16);
+    const auto second = packer.insert(32, 16);
+    const auto third = packer.insert(64, 8);
+    BOOST_REQUIRE(first && second && third);
+    BOOST_TEST(first->x == 0);
+    BOOST_TEST(first->y == 0);
+    BOOST_TEST(second->x == 32);
+    BOOST_TEST(second->y == 0);
+    BOOST_TEST(third->y == 16);
+    BOOST_TEST(packer.occupancy() == 0.375f);
+
+    BOOST_TEST(!packer.insert(65, 1));
+    BOOST_TEST(!packer.insert(1, 41));
+    packer.reset();
+    BOOST_TEST(packer.usedArea() == 0u);
+    BOOST_CHECK_THROW(packer.insert(0, 4), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(skyline_fills_the_lowest_gap_first) {
+    Rendering::SkylinePacker packer(30, 100);
+    BOOST_REQUIRE(packer.insert(10, 40));
+    BOOST_REQUIRE(packer.insert(10, 10));
+    BOOST_REQUIRE(packer.insert(10, 40));
+    // The 10-wide well in the middle is the lowest place that fits.
+    const auto filler = packer.insert(10, 20);
+    BOOST_REQUIRE(filler);
+    BOOST_TEST(filler->x == 10);
+    BOOST_TEST(filler->y == 10);
+}
+
+BOOST_AUTO_TEST_CASE(atlas_pages_never_overlap_padded_rectangles) {
+    constexpr int padding = 2;
+    Rendering::AtlasPacker atlas(128, 128, padding);
+    std::vector<Rendering::AtlasPacker::Placement> placements;
+    for (int i = 0; i < 40; ++i) {
+        const auto placement = atlas.insert(8 + (i * 7) % 23, 6 + (i * 5) % 19);
+        BOOST_REQUIRE(placement);
+        BOOST_TEST(placement->x >= padding);
+        BOOST_TEST(placement->y >= padding);
+        BOOST_TEST(placement->x + placement->width + padding <= 128);
+        BOOST_TEST(placement->y + placement->height + padding <= 128);
+        placements.push_back(*placement);
+    }
+    for (std::size_t i = 0; i < placements.size(); ++i) {
+        for (std::size_t j = i + 1; j < placements.size(); ++j) {
+            BOOST_TEST(!intersects(placements[i], placements[j], padding));
+        }
+    }
+    BOOST_TEST(atlas.pageCount() > 1u);
+    for (std::size_t page = 0; page < atlas.pageCount(); ++page) {
+        BOOST_TEST(atlas.occupancy(page) > 0.0f);
+        BOOST_TEST(atlas.occupancy(page) <= 1.0f);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(atlas_respects_page_limits_and_reuses_reset_pages) {
+    Rendering::AtlasPacker atlas(32, 32, /*padding=*/1, /*maxPages=*/1);
+    BOOST_TEST(!atlas.insert(31, 4));
+    BOOST_REQUIRE(atlas.insert(30, 30));
+    BOOST_TEST(!atlas.insert(4, 4));
+    BOOST_TEST(atlas.pageCount() == 1u);
+
+    atlas.resetPage(0);
+    BOOST_TEST(atlas.occupancy(0) == 0.0f);
+    const auto placement = atlas.insert(4, 4);
+    BOOST_REQUIRE(placement);
+    BOOST_TEST(placement->page == 0u);
+    BOOST_CHECK_THROW((void)atlas.occupancy(1), std::out_of_range);
+    BOOST_CHECK_THROW(Rendering::AtlasPacker(32, 32, 17), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -2,8 +2,10 @@
 
 #include <limits>
 #include <stdexcept>
+#include <vector>
 
 #include "AISystem/BehaviourTree.hpp"
+#include "AISystem/CompiledBehaviourTree.hpp"
 
 using AI::BehaviourTree;
 using AI::NodeStatus;
@@ -13,6 +15,42 @@ struct BTContext {
     bool flag{false};
 };
 
+namespace {
+// Exercises every node type; the outcome depends on each context's own state.
+BehaviourTree<BTContext> makeMixedTree() {
+    using Tree = BehaviourTree<BTContext>;
+    auto attack = Tree::makeSequence();
+    attack->addChild(Tree::makeCondition([](BTContext* ctx) { return ctx->flag; }));
+    attack->addChild(Tree::makeCooldown(Tree::makeAction([](BTContext* ctx) {
+        ctx->counter += 100;
+        return NodeStatus::Success;
+    }), 0.25f));
+
+    auto work = Tree::makeSequence();
+    work->addChild(Tree::makeInverter(Tree::makeCondition(
+        [](BTContext* ctx) { return ctx->counter % 7 == 3; })));
+    work->addChild(Tree::makeAction([](BTContext* ctx) {
+        // Runs for a tick on every third call.
+        return ++ctx->counter % 3 == 0 ? NodeStatus::Running : NodeStatus::Success;
+    }));
+    work->addChild(Tree::makeFailer(Tree::makeAction([](BTContext* ctx) {
+        ctx->flag = !ctx->flag;
+        return NodeStatus::Success;
+    })));
+
+    auto root = Tree::makeSelector();
+    root->addChild(std::move(attack));
+    root->addChild(std::move(work));
+    root->addChild(Tree::makeSucceeder(Tree::makeRepeater(Tree::makeAction([](BTContext* ctx) {
+        ctx->counter += 10;
+        return NodeStatus::Success;
+    }), 2)));
+    Tree tree;
+    tree.setRoot(std::move(root));
+    return tree;
+}
+}
+
 BOOST_AUTO_TEST_SUITE(BehaviourTreeTests)
 
 BOOST_AUTO_TEST_CASE(selector_picks_first_success) {
@@ -171,4 +209,70 @@ BOOST_AUTO_TEST_CASE(invalid_callbacks_decorators_and_time_are_rejected) {
                       std::invalid_argument);
 }
 
+BOOST_AUTO_TEST_CASE(compiled_tree_ticks_agents_like_separate_trees) {
+    constexpr std::size_t agents = 16;
+    std::vector<BehaviourTree<BTContext>> trees;
+    std::vector<BTContext> expected;
+    std::vector<BTContext> contexts;
+    for (std::size_t i = 0; i < agents; ++i) {
+        trees.push_back(makeMixedTree());
+        expected.push_back(BTContext{static_cast<int>(i), i % 3 == 0});
+    }
+    contexts = expected;
+
+    const AI::CompiledBehaviourTree<BTContext> compiled(makeMixedTree());
+    BOOST_TEST(compiled.nodeCount() == 14u);
+    AI::BTAgentStates states = compiled.makeStates(agents);
+    BOOST_TEST(states.agentCount() == agents);
+    BOOST_TEST(states.slotsPerAgent() == 5u);
+
+    std::vector<NodeStatus> statuses(agents);
+    for (int tick = 0; tick < 40; ++tick) {
+        const float dt = 0.05f * static_cast<float>(tick % 4);
+        compiled.tickAll(states, contexts, dt, statuses);
+        for (std::size_t i = 0; i < agents; ++i) {
+            BOOST_TEST(statuses[i] == trees[i].tick(&expected[i], dt));
+            BOOST_TEST(contexts[i].counter == expected[i].counter);
+            BOOST_TEST(contexts[i].flag == expected[i].flag);
+        }
+    }
+
+    // Single-agent ticks and resets touch only that agent's slots.
+    states.reset(3);
+    trees[3].reset();
+    BOOST_TEST(compiled.tick(states, 3, &contexts[3], 0.1f) == trees[3].tick(&expected[3], 0.1f));
+    BOOST_TEST(contexts[3].counter == expected[3].counter);
+    states.resize(agents + 1);
+    BOOST_TEST(compiled.tick(states, 4, &contexts[4], 0.1f) == trees[4].tick(&expected[4], 0.1f));
+}
+
+BOOST_AUTO_TEST_CASE(compiled_tree_validates_states_and_batches) {
+    using Tree = BehaviourTree<BTContext>;
+    const AI::CompiledBehaviourTree<BTContext> compiled(makeMixedTree());
+    AI::BTAgentStates states = compiled.makeStates(2);
+    std::vector<BTContext> contexts(3);
+
+    BOOST_CHECK_THROW(compiled.tickAll(states, contexts, 0.0f), std::invalid_argument);
+    contexts.resize(2);
+    std::vector<NodeStatus> statuses(1);
+    BOOST_CHECK_THROW(compiled.tickAll(states, contexts, 0.0f, statuses), std::invalid_argument);
+    BOOST_CHECK_THROW(compiled.tickAll(states, contexts, -1.0f), std::invalid_argument);
+    BOOST_CHECK_THROW(compiled.tick(states, 2, &contexts[0], 0.0f), std::out_of_range);
+    BOOST_CHECK_THROW(states.reset(2), std::out_of_range);
+
+    Tree single;
+    single.setRoot(Tree::makeAction([](BTContext*) { return NodeStatus::Success; }));
+    const AI::CompiledBehaviourTree<BTContext> leafOnly(single);
+    BOOST_CHECK_THROW(leafOnly.tick(states, 0, &contexts[0], 0.0f), std::invalid_argument);
+    AI::BTAgentStates leafStates = leafOnly.makeStates(1);
+    BOOST_TEST(leafOnly.tick(leafStates, 0, nullptr, 0.0f) == NodeStatus::Success);
+
+    const AI::CompiledBehaviourTree<BTContext> empty{Tree{}};
+    AI::BTAgentStates emptyStates = empty.makeStates(2);
+    statuses.assign(2, NodeStatus::Running);
+    empty.tickAll(emptyStates, contexts, 0.0f, statuses);
+    BOOST_TEST(statuses[0] == NodeStatus::Failure);
+    BOOST_TEST(statuses[1] == NodeStatus::Failure);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
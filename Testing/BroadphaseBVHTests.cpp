@@ -46,6 +46,36 @@ BOOST_AUTO_TEST_CASE(query_handles_worlds_without_authored_bounds) {
     BOOST_TEST(hits.front() == &near);
 }
 
+BOOST_AUTO_TEST_CASE(segment_query_returns_only_bounds_the_segment_touches) {
+    int users[5]{};
+    int far[40]{};
+    BroadphaseBVH bvh;
+    std::vector<BroadphaseBVH::Entry> entries{
+        {AABB{{4.0f, 4.0f}, {6.0f, 6.0f}}, &users[0]},
+        // Inside the diagonal's bounding box but off the line itself.
+        {AABB{{8.0f, 0.0f}, {9.0f, 1.0f}}, &users[1]},
+        {AABB{{10.0f, 10.0f}, {11.0f, 11.0f}}, &users[2]},
+        {AABB{{12.0f, 12.0f}, {13.0f, 13.0f}}, &users[3]},
+        {AABB{{0.0f, 9.0f}, {1.0f, 10.0f}}, &users[4]}
+    };
+    for (int i = 0; i < 40; ++i) {
+        entries.push_back({AABB{{100.0f + i, 0.0f}, {100.5f + i, 1.0f}}, &far[i]});
+    }
+    bvh.build(entries);
+
+    std::vector<void*> hits;
+    bvh.querySegment(glm::vec2{0.0f}, glm::vec2{11.0f}, hits);
+    std::ranges::sort(hits);
+    BOOST_REQUIRE(hits.size() == 2u);
+    BOOST_TEST(hits[0] == &users[0]);
+    BOOST_TEST(hits[1] == &users[2]);
+
+    hits.clear();
+    bvh.querySegment(glm::vec2{0.5f, 12.0f}, glm::vec2{0.5f, 9.5f}, hits);
+    BOOST_REQUIRE(hits.size() == 1u);
+    BOOST_TEST(hits.front() == &users[4]);
+}
+
 BOOST_AUTO_TEST_CASE(rejects_ambiguous_user_identity) {
     int user = 0;
     BroadphaseBVH bvh;
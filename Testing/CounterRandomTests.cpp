@@ -0,0 +1,60 @@
+#include <boost/test/unit_test.hpp>
+
+#include "ParticleSystem/CounterRandom.hpp"
+#include "ParticleSystem/ParticleEmitter.hpp"
+
+#include <array>
+
+BOOST_AUTO_TEST_SUITE(CounterRandomTests)
+
+BOOST_AUTO_TEST_CASE(streams_are_reproducible_and_jump_ahead) {
+    CounterRandom sequential(1234);
+    CounterRandom jumped(1234);
+    for (int i = 0; i < 1000; ++i) {
+        (void)sequential.next();
+    }
+    jumped.discard(1000);
+    BOOST_TEST(sequential.next() == jumped.next());
+    BOOST_TEST(jumped.at(5) == CounterRandom(1234).at(5));
+    BOOST_TEST(CounterRandom(1).at(0) != CounterRandom(2).at(0));
+    BOOST_TEST(sizeof(CounterRandom) == 16u);
+
+    jumped.seed(1234);
+    BOOST_TEST(jumped.counter() == 0u);
+    BOOST_TEST(jumped.next() == CounterRandom(1234).at(0));
+}
+
+BOOST_AUTO_TEST_CASE(unit_values_cover_the_interval_evenly) {
+    CounterRandom random(42);
+    std::array<int, 10> buckets{};
+    constexpr int samples = 100000;
+    for (int i = 0; i < samples; ++i) {
+        const float value = random.nextUnit();
+        BOOST_REQUIRE(value >= 0.0f);
+        BOOST_REQUIRE(value < 1.0f);
+        ++buckets[static_cast<std::size_t>(value * 10.0f)];
+    }
+    for (const int count : buckets) {
+        BOOST_TEST(count > samples / 10 - 600);
+        BOOST_TEST(count < samples / 10 + 600);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(split_bursts_match_a_single_burst) {
+    ParticleEmitterConfig config{};
+    config.spawnRate = 0.0f;
+    config.spread = 6.0f;
+    ParticleEmitter whole{64, config};
+    ParticleEmitter split{64, config};
+    whole.burst(40);
+    split.burst(15);
+    split.burst(25);
+    for (std::size_t i = 0; i < 40; ++i) {
+        BOOST_TEST(whole.particles().particle(i).lifeTime ==
+                   split.particles().particle(i).lifeTime);
+        BOOST_TEST(whole.particles().particle(i).velocity.y ==
+                   split.particles().particle(i).velocity.y);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -101,14 +101,165 @@ BOOST_AUTO_TEST_CASE(frame_events_accumulate_across_fixed_steps_in_one_frame) {
     ECS::AnimationSystem2D::update(registry, 0.06f);
     ECS::AnimationSystem2D::update(registry, 0.05f);
 
-    const auto& events = registry.get<ECS::AnimationEventQueue2D>(entity).events;
+    const auto& events = registry.get<ECS::AnimationEventQueue2D>(entity);
     BOOST_TEST(events.size() >= 4u);
-    BOOST_TEST(std::ranges::any_of(events, [](const ECS::AnimationEvent2D& event) {
-        return event.kind == ECS::AnimationEventKind2D::Frame && event.name == "footstep";
-    }));
+    const auto footstep = graph->findEvent("footstep");
+    BOOST_REQUIRE(footstep);
+    BOOST_TEST(graph->eventName(*footstep) == "footstep");
+    BOOST_TEST(events.hasFrameEvent(*footstep));
+    BOOST_TEST(events.hasStateEvent(ECS::AnimationEventKind2D::StateEntered,
+                                    *graph->findState("Run")));
 
     ECS::AnimationSystem2D::beginFrame(registry);
-    BOOST_TEST(registry.get<ECS::AnimationEventQueue2D>(entity).events.empty());
+    BOOST_TEST(registry.get<ECS::AnimationEventQueue2D>(entity).empty());
+}
+
+BOOST_AUTO_TEST_CASE(event_queue_keeps_every_event_in_order) {
+    ECS::AnimationEventQueue2D queue;
+    BOOST_TEST(queue.capacity() >= ECS::AnimationEventQueue2D::kDefaultCapacity);
+    const std::size_t total = ECS::AnimationEventQueue2D::kDefaultCapacity * 3 + 3;
+    for (std::size_t i = 0; i < total; ++i) {
+        queue.push({ECS::AnimationEventKind2D::Frame, static_cast<ECS::AnimationEventId2D>(i)});
+    }
+    BOOST_TEST(queue.size() == total);
+    BOOST_TEST(queue[0].event == 0u);
+    BOOST_TEST(queue[queue.size() - 1].event == total - 1);
+    BOOST_TEST(queue.hasFrameEvent(0));
+
+    std::size_t frames = 0;
+    queue.forEach(ECS::AnimationEventKind2D::Frame, [&](const ECS::AnimationEvent2D&) { ++frames; });
+    BOOST_TEST(frames == queue.size());
+    queue.forEach(ECS::AnimationEventKind2D::Completed,
+                  [](const ECS::AnimationEvent2D&) { BOOST_FAIL("unexpected event"); });
+    // Storage grown for a burst is kept for the next frame.
+    const std::size_t grown = queue.capacity();
+    queue.clear();
+    BOOST_TEST(queue.empty());
+    BOOST_TEST(queue.capacity() == grown);
+    BOOST_TEST(ECS::AnimationEventQueue2D(64).capacity() >= 64u);
+}
+
+BOOST_AUTO_TEST_CASE(parameters_and_state_requests_resolve_to_ids) {
+    ECS::Registry registry;
+    const auto graph = makeGraph();
+    const auto moving = graph->findParameter("moving");
+    BOOST_REQUIRE(moving);
+    BOOST_TEST(*moving == 0u);
+    BOOST_TEST(graph->parameterName(*moving) == "moving");
+    BOOST_TEST(graph->parameterCount() == 1u);
+    BOOST_TEST(!graph->findParameter("speed"));
+    BOOST_CHECK_THROW(static_cast<void>(graph->parameterName(1)), std::out_of_range);
+
+    ECS::AnimationParameters2D parameters(graph);
+    BOOST_TEST(!parameters.hasBool(*moving));
+    BOOST_TEST(parameters.getBool(*moving, true));
+    parameters.setBool(*moving, true);
+    parameters.setFloat("moving", 2.5f);
+    BOOST_TEST(parameters.getBool("moving"));
+    BOOST_TEST(parameters.getFloat(*moving) == 2.5f);
+    parameters.setBool("moving", false);
+    BOOST_TEST(!parameters.getBool(*moving, true));
+    BOOST_TEST(parameters.hasFloat(*moving));
+    BOOST_TEST(parameters.getFloat("never_set_parameter", -1.0f) == -1.0f);
+    // Names the graph never reads are kept by name.
+    parameters.setFloat("speed", 3.0f);
+    BOOST_TEST(parameters.getFloat("speed", -1.0f) == 3.0f);
+    BOOST_TEST(!parameters.getBool("speed"));
+
+    auto sprite = std::make_shared<GameObjects::Sprite>(
+        glm::vec2{0.0f}, glm::vec2{32.0f}, glm::vec3{1.0f});
+    const ECS::Entity entity = addAnimated(registry, graph, sprite);
+    auto& animator = registry.get<ECS::Animator2D>(entity);
+    BOOST_CHECK_THROW(animator.requestState("Jump"), std::invalid_argument);
+    animator.requestState("Run");
+    ECS::AnimationSystem2D::update(registry, 0.01f);
+    BOOST_TEST(graph->state(animator.stateIndex).name == "Run");
+    BOOST_TEST(animator.requestedStateIndex == ECS::Animator2D::kNoState);
+}
+
+BOOST_AUTO_TEST_CASE(state_transitions_take_priority_over_any_source) {
+    std::vector<ECS::AnimationState2D> states{
+        {"Idle", {{frame(0.1f, {0.0f, 0.0f, 1.0f, 1.0f})}, ECS::AnimationPlayback2D::Loop}},
+        {"Run", {{frame(0.1f, {0.0f, 0.0f, 1.0f, 1.0f})}, ECS::AnimationPlayback2D::Loop}},
+        {"Hurt", {{frame(0.1f, {0.0f, 0.0f, 1.0f, 1.0f})}, ECS::AnimationPlayback2D::Loop}}
+    };
+    std::vector<ECS::AnimationTransition2D> transitions{
+        {"*", "Hurt", ECS::AnimationCondition2D::BoolEquals, "hurt", 0.0f, true},
+        {"Idle", "Run", ECS::AnimationCondition2D::BoolEquals, "moving", 0.0f, true},
+        {"Hurt", "Idle", ECS::AnimationCondition2D::BoolEquals, "hurt", 0.0f, false}
+    };
+    const auto graph = std::make_shared<const ECS::AnimationGraph2D>(
+        std::move(states), std::move(transitions), "Idle");
+    const auto idle = graph->transitionsFrom(*graph->findState("Idle"));
+    BOOST_REQUIRE_EQUAL(idle.size(), 2u);
+    BOOST_TEST(idle[0].toState == *graph->findState("Run"));
+    BOOST_TEST(idle[1].toState == *graph->findState("Hurt"));
+    // Hurt's own "*" transition would target itself, so only its exit remains.
+    BOOST_TEST(graph->transitionsFrom(*graph->findState("Hurt")).size() == 1u);
+
+    ECS::Registry registry;
+    auto sprite = std::make_shared<GameObjects::Sprite>(
+        glm::vec2{0.0f}, glm::vec2{32.0f}, glm::vec3{1.0f});
+    const ECS::Entity entity = addAnimated(registry, graph, sprite);
+    auto& parameters = registry.get<ECS::AnimationParameters2D>(entity);
+    parameters.setBool("moving", true);
+    parameters.setBool("hurt", true);
+    ECS::AnimationSystem2D::update(registry, 0.01f);
+    BOOST_TEST(graph->state(registry.get<ECS::Animator2D>(entity).stateIndex).name == "Run");
+    ECS::AnimationSystem2D::update(registry, 0.01f);
+    BOOST_TEST(graph->state(registry.get<ECS::Animator2D>(entity).stateIndex).name == "Hurt");
+}
+
+BOOST_AUTO_TEST_CASE(parameters_take_their_slots_from_their_own_graph) {
+    std::vector<ECS::AnimationState2D> states{
+        {"Idle", {{frame(0.1f, {0.0f, 0.0f, 1.0f, 1.0f})}, ECS::AnimationPlayback2D::Loop}},
+        {"Run", {{frame(0.1f, {0.0f, 0.0f, 1.0f, 1.0f})}, ECS::AnimationPlayback2D::Loop}}
+    };
+    std::vector<ECS::AnimationTransition2D> transitions{
+        {"Idle", "Run", ECS::AnimationCondition2D::FloatGreater, "speed", 1.0f},
+        {"Run", "Idle", ECS::AnimationCondition2D::BoolEquals, "moving", 0.0f, false}
+    };
+    const auto other = std::make_shared<const ECS::AnimationGraph2D>(
+        std::move(states), std::move(transitions), "Idle");
+    const auto graph = makeGraph();
+    // Both graphs number their own parameters from zero.
+    BOOST_TEST(*other->findParameter("speed") == 0u);
+    BOOST_TEST(*other->findParameter("moving") == 1u);
+    BOOST_TEST(*graph->findParameter("moving") == 0u);
+
+    ECS::Registry registry;
+    auto sprite = std::make_shared<GameObjects::Sprite>(
+        glm::vec2{0.0f}, glm::vec2{32.0f}, glm::vec3{1.0f});
+    const ECS::Entity entity = registry.create();
+    registry.emplace<ECS::SpriteRender>(entity, ECS::SpriteRender{sprite});
+    auto& parameters = registry.emplace<ECS::AnimationParameters2D>(entity);
+    registry.emplace<ECS::Animator2D>(entity).graph = other;
+    registry.emplace<ECS::AnimationEventQueue2D>(entity);
+    BOOST_TEST(!parameters.graph());
+    // Writes made before a graph is bound are kept and readable by name.
+    parameters.setFloat("speed", 5.0f);
+    parameters.setBool("moving", true);
+    BOOST_TEST(!parameters.hasFloat(0));
+    BOOST_TEST(parameters.getFloat("speed") == 5.0f);
+
+    // The system binds the parameters to the animator's graph, moving the
+    // earlier writes into its slots, so the first update already sees them.
+    ECS::AnimationSystem2D::update(registry, 0.01f);
+    BOOST_TEST((parameters.graph() == other));
+    BOOST_TEST(parameters.getFloat(*other->findParameter("speed")) == 5.0f);
+    BOOST_TEST(other->state(registry.get<ECS::Animator2D>(entity).stateIndex).name == "Run");
+    BOOST_TEST(parameters.getBool(*other->findParameter("moving")));
+
+    // Swapping graphs carries values over by name; names the new graph does
+    // not read stay readable and return to slots on the way back.
+    registry.get<ECS::Animator2D>(entity).graph = graph;
+    parameters.bind(graph);
+    BOOST_TEST(parameters.getBool(*graph->findParameter("moving")));
+    BOOST_TEST(!parameters.hasFloat(*graph->findParameter("moving")));
+    BOOST_TEST(parameters.getFloat("speed", -1.0f) == 5.0f);
+    parameters.bind(other);
+    BOOST_TEST(parameters.getFloat(*other->findParameter("speed")) == 5.0f);
+    BOOST_TEST(parameters.getBool(*other->findParameter("moving")));
 }
 
 BOOST_AUTO_TEST_SUITE_END()
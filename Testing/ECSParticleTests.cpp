@@ -43,12 +43,12 @@ BOOST_AUTO_TEST_CASE(equal_seeds_produce_identical_particles) {
     second.burst(4);
 
     for (std::size_t index = 0; index < 4; ++index) {
-        const Particle& a = first.getParticles()[index];
-        const Particle& b = second.getParticles()[index];
+        const Particle a = first.particles().particle(index);
+        const Particle b = second.particles().particle(index);
         BOOST_TEST(a.position.x == b.position.x);
         BOOST_TEST(a.velocity.x == b.velocity.x);
         BOOST_TEST(a.lifeTime == b.lifeTime);
-        BOOST_TEST(a.size.x == b.size.x);
+        BOOST_TEST(a.size == b.size);
     }
 }
 
@@ -57,10 +57,10 @@ BOOST_AUTO_TEST_CASE(drag_and_size_curves_follow_elapsed_time) {
     emitter.burst(1);
     emitter.update(1.0f);
 
-    const Particle& particle = emitter.getParticles().front();
+    const Particle particle = emitter.particles().particle(0);
     BOOST_TEST(particle.velocity.x == 5.0f,
                boost::test_tools::tolerance(0.0001f));
-    BOOST_TEST(particle.size.x == 5.0f,
+    BOOST_TEST(particle.size == 5.0f,
                boost::test_tools::tolerance(0.0001f));
 }
 
@@ -78,7 +78,7 @@ BOOST_AUTO_TEST_CASE(system_synchronizes_transform_before_deferred_burst) {
 
     ECS::ParticleSystem2D::update(registry, 0.01f);
 
-    const Particle& particle = component.emitter.getParticles().front();
+    const Particle particle = component.emitter.particles().particle(0);
     BOOST_TEST(particle.position.x == 10.0f,
                boost::test_tools::tolerance(0.0001f));
     BOOST_TEST(particle.position.y == 22.0f,
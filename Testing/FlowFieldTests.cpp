@@ -0,0 +1,249 @@
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#include <glm/geometric.hpp>
+
+#include "AISystem/NavMesh/FlowField.hpp"
+#include "AISystem/NavMesh/FlowFieldCache.hpp"
+#include "AISystem/NavMesh/NavRaster.hpp"
+#include "Utils/WorkerPool.hpp"
+
+namespace {
+// Rooms separated by walls with doorways, plus a sealed-off corner.
+NavRaster roomsRaster() {
+    NavRaster raster(40, 30, 0.5f, glm::vec2{-5.0f, 2.0f});
+    for (int y = 0; y < 30; ++y) {
+        raster.setWalkable(13, y, y == 4 || y == 25);
+        raster.setWalkable(27, y, y >= 14 && y <= 16);
+    }
+    for (int x = 0; x < 13; ++x) {
+        raster.setWalkable(x, 15, x == 6);
+    }
+    for (int x = 34; x < 40; ++x) raster.setWalkable(x, 24, false);
+    for (int y = 24; y < 30; ++y) raster.setWalkable(34, y, false);
+    return raster;
+}
+
+glm::vec2 center(const NavRaster& raster, int x, int y) {
+    return raster.cellCenter(x, y);
+}
+
+// Follows the field cell by cell; true when it reaches the goal cell.
+bool reachesGoal(const FlowField& field, const NavRaster& raster, glm::vec2 position) {
+    for (int step = 0; step < 40 * 30; ++step) {
+        int x = 0;
+        int y = 0;
+        BOOST_REQUIRE(raster.worldToCell(position, x, y));
+        if (y * raster.width() + x == field.goalCell()) return true;
+        const glm::vec2 direction = field.direction(position);
+        if (glm::length(direction) < 0.5f) return false;
+        const glm::vec2 next = position + glm::vec2{std::round(direction.x / 0.7f),
+                                                    std::round(direction.y / 0.7f)} *
+                                              raster.cellSize();
+        if (field.distance(next) >= field.distance(position)) return false;
+        position = next;
+    }
+    return false;
+}
+
+FlowField::Settings tiles(int tileSize, float slack = 0.0f) {
+    return {.tileSize = tileSize, .slack = slack};
+}
+
+bool sameField(const FlowField& a, const FlowField& b, const NavRaster& raster,
+               float tolerance) {
+    for (int y = 0; y < raster.height(); ++y) {
+        for (int x = 0; x < raster.width(); ++x) {
+            const glm::vec2 point = center(raster, x, y);
+            const float da = a.distance(point);
+            const float db = b.distance(point);
+            if (std::isinf(da) != std::isinf(db)) return false;
+            if (!std::isinf(da) && std::abs(da - db) > tolerance) return false;
+        }
+    }
+    return true;
+}
+}
+
+BOOST_AUTO_TEST_SUITE(FlowFieldTests)
+
+BOOST_AUTO_TEST_CASE(agents_follow_the_field_to_the_goal) {
+    const NavRaster raster = roomsRaster();
+    FlowField field(tiles(8));
+    const glm::vec2 goal = center(raster, 36, 5) + glm::vec2{0.1f, -0.05f};
+    BOOST_REQUIRE(field.build(raster, goal));
+    BOOST_TEST(field.distance(goal) == 0.0f);
+
+    for (const auto& [x, y] : {std::pair{0, 0}, {3, 29}, {20, 10}, {30, 15}, {39, 0}}) {
+        BOOST_TEST(reachesGoal(field, raster, center(raster, x, y)));
+    }
+    // Cells on either side of a wall are far apart along the field.
+    BOOST_TEST(field.distance(center(raster, 12, 10)) - field.distance(center(raster, 14, 10)) >
+               5.0f);
+
+    // Inside the goal cell agents head straight for the goal point.
+    const glm::vec2 near = goal + glm::vec2{-0.2f, 0.0f};
+    BOOST_TEST(field.direction(near).x == 1.0f, boost::test_tools::tolerance(1e-4f));
+    BOOST_TEST(glm::length(field.direction(goal)) == 0.0f);
+
+    BOOST_TEST(std::isinf(field.distance(center(raster, 37, 27))));
+    BOOST_TEST(glm::length(field.direction(center(raster, 37, 27))) == 0.0f);
+    BOOST_TEST(glm::length(field.direction(glm::vec2{-100.0f})) == 0.0f);
+    BOOST_TEST(glm::length(field.direction(
+                   glm::vec2{std::numeric_limits<float>::quiet_NaN(), 3.0f})) == 0.0f);
+
+    BOOST_TEST(!field.build(raster, center(raster, 13, 0)));
+    BOOST_TEST(!field.valid());
+    BOOST_CHECK_THROW(FlowField(tiles(0)), std::invalid_argument);
+    BOOST_CHECK_THROW(FlowField(tiles(8, -1.0f)), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(tiling_and_workers_do_not_change_the_field) {
+    const NavRaster raster = roomsRaster();
+    const glm::vec2 goal = center(raster, 2, 27);
+    FlowField single(tiles(64));
+    FlowField tiled(tiles(5));
+    FlowField parallel(tiles(5));
+    Utils::WorkerPool workers(3);
+    BOOST_REQUIRE(single.build(raster, goal));
+    BOOST_REQUIRE(tiled.build(raster, goal));
+    BOOST_REQUIRE(parallel.build(raster, goal, &workers));
+    BOOST_TEST(single.lastTilesIntegrated() == 1u);
+    BOOST_TEST(tiled.lastTilesIntegrated() > 48u);
+    BOOST_TEST(sameField(single, tiled, raster, 1e-4f));
+    BOOST_TEST(sameField(tiled, parallel, raster, 0.0f));
+    for (int y = 0; y < raster.height(); ++y) {
+        for (int x = 0; x < raster.width(); ++x) {
+            BOOST_TEST((tiled.direction(center(raster, x, y)) ==
+                        parallel.direction(center(raster, x, y))));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(moving_the_goal_updates_only_what_gets_closer) {
+    const NavRaster raster = roomsRaster();
+    // Without a tile budget every move finishes in its own call.
+    FlowField exact({.tileSize = 5, .slack = 0.0f, .tileBudget = 0});
+    FlowField moving(tiles(5, 3.0f));
+    BOOST_REQUIRE(exact.build(raster, center(raster, 5, 5)));
+    BOOST_REQUIRE(moving.build(raster, center(raster, 5, 5)));
+    const std::size_t fullTiles = moving.lastTilesIntegrated();
+
+    for (const auto& [x, y] : {std::pair{6, 5}, {7, 6}, {7, 7}}) {
+        BOOST_REQUIRE(exact.moveGoal(raster, center(raster, x, y)));
+        BOOST_REQUIRE(moving.moveGoal(raster, center(raster, x, y)));
+        BOOST_TEST(!moving.lastRebuilt());
+        BOOST_TEST(!exact.pending());
+        FlowField fresh(tiles(5));
+        BOOST_REQUIRE(fresh.build(raster, center(raster, x, y)));
+        BOOST_TEST(sameField(exact, fresh, raster, 1e-3f));
+        // With slack, distances may overestimate but never lead astray.
+        for (int cy = 0; cy < raster.height(); ++cy) {
+            for (int cx = 0; cx < raster.width(); ++cx) {
+                const glm::vec2 point = center(raster, cx, cy);
+                if (std::isinf(fresh.distance(point))) continue;
+                BOOST_TEST(moving.distance(point) >= fresh.distance(point) - 1e-3f);
+                BOOST_TEST(reachesGoal(moving, raster, point));
+            }
+        }
+    }
+    BOOST_TEST(moving.lastTilesIntegrated() < fullTiles);
+    // Within the same cell only the goal point moves.
+    BOOST_REQUIRE(moving.moveGoal(raster, center(raster, 7, 7) + glm::vec2{0.1f}));
+    BOOST_TEST(moving.lastTilesIntegrated() == 0u);
+    // A goal the field cannot reach is built from scratch, as is one that
+    // has drifted too far.
+    BOOST_REQUIRE(moving.moveGoal(raster, center(raster, 37, 27)));
+    BOOST_TEST(moving.lastRebuilt());
+    BOOST_TEST(moving.distance(center(raster, 38, 28)) > 0.0f);
+    BOOST_TEST(std::isinf(moving.distance(center(raster, 7, 7))));
+    FlowField drifting({.tileSize = 5, .maxDrift = 3.0f});
+    BOOST_REQUIRE(drifting.build(raster, center(raster, 5, 5)));
+    BOOST_REQUIRE(drifting.moveGoal(raster, center(raster, 7, 5)));
+    BOOST_TEST(!drifting.lastRebuilt());
+    BOOST_REQUIRE(drifting.moveGoal(raster, center(raster, 9, 5)));
+    BOOST_TEST(drifting.lastRebuilt());
+}
+
+BOOST_AUTO_TEST_CASE(goal_moves_spread_their_work_over_calls) {
+    const NavRaster raster = roomsRaster();
+    FlowField budgeted({.tileSize = 5, .slack = 0.0f, .tileBudget = 3});
+    BOOST_REQUIRE(budgeted.build(raster, center(raster, 5, 5)));
+    BOOST_TEST(!budgeted.pending());
+
+    // A move that runs out of budget keeps a usable field, and a second move
+    // on top of the pending one stays consistent.
+    for (const auto& [x, y] : {std::pair{8, 7}, {9, 9}}) {
+        BOOST_REQUIRE(budgeted.moveGoal(raster, center(raster, x, y)));
+        BOOST_TEST(budgeted.lastTilesIntegrated() <= 3u);
+        BOOST_REQUIRE(budgeted.pending());
+        FlowField fresh(tiles(5));
+        BOOST_REQUIRE(fresh.build(raster, center(raster, x, y)));
+        for (int cy = 0; cy < raster.height(); ++cy) {
+            for (int cx = 0; cx < raster.width(); ++cx) {
+                const glm::vec2 point = center(raster, cx, cy);
+                if (std::isinf(fresh.distance(point))) continue;
+                BOOST_TEST(budgeted.distance(point) >= fresh.distance(point) - 1e-3f);
+                BOOST_TEST(reachesGoal(budgeted, raster, point));
+            }
+        }
+    }
+
+    // Asking again for the same cell resumes until the field is exact.
+    int calls = 0;
+    while (budgeted.pending()) {
+        BOOST_REQUIRE(budgeted.moveGoal(raster, center(raster, 9, 9)));
+        BOOST_REQUIRE(budgeted.lastTilesIntegrated() <= 3u);
+        BOOST_REQUIRE(++calls < 200);
+    }
+    FlowField fresh(tiles(5));
+    BOOST_REQUIRE(fresh.build(raster, center(raster, 9, 9)));
+    BOOST_TEST(sameField(budgeted, fresh, raster, 1e-3f));
+
+    // A rebuild drops pending work.
+    BOOST_REQUIRE(budgeted.moveGoal(raster, center(raster, 10, 10)));
+    BOOST_REQUIRE(budgeted.build(raster, center(raster, 20, 20)));
+    BOOST_TEST(!budgeted.pending());
+}
+
+BOOST_AUTO_TEST_CASE(cache_keeps_recent_goals_and_evicts_the_oldest) {
+    NavRaster raster = roomsRaster();
+    FlowFieldCache cache(raster, {.capacity = 2, .field = tiles(8)});
+    const FlowField* player = cache.fieldFor(1, center(raster, 20, 20));
+    BOOST_REQUIRE(player != nullptr);
+    BOOST_TEST(cache.fieldFor(1, center(raster, 20, 20) + glm::vec2{0.1f}) == player);
+    BOOST_TEST(cache.fieldFor(1, center(raster, 21, 20)) == player);
+    BOOST_TEST(player->goalCell() == 20 * raster.width() + 21);
+    BOOST_TEST(cache.fieldFor(2, center(raster, 2, 2)) != nullptr);
+    BOOST_TEST(cache.stats().hits == 1u);
+    BOOST_TEST(cache.stats().incrementalUpdates == 1u);
+    BOOST_TEST(cache.stats().fullBuilds == 2u);
+
+    // Key 1 was used before key 2, so key 3 takes its place.
+    BOOST_TEST(cache.fieldFor(3, center(raster, 30, 3)) != nullptr);
+    BOOST_TEST(cache.size() == 2u);
+    BOOST_TEST(cache.find(1) == nullptr);
+    BOOST_TEST(cache.find(2) != nullptr);
+    BOOST_TEST(cache.stats().evictions == 1u);
+
+    BOOST_TEST(cache.fieldFor(2, center(raster, 13, 1)) == nullptr);
+    BOOST_TEST(cache.find(2) == nullptr);
+
+    // After an edit every field is rebuilt on its next use.
+    raster.setWalkable(13, 25, false);
+    cache.rasterChanged();
+    const FlowField* rebuilt = cache.fieldFor(3, center(raster, 30, 3));
+    BOOST_REQUIRE(rebuilt != nullptr);
+    BOOST_TEST(cache.stats().fullBuilds == 4u);
+    FlowField fresh(tiles(8));
+    BOOST_REQUIRE(fresh.build(raster, center(raster, 30, 3)));
+    BOOST_TEST(sameField(*rebuilt, fresh, raster, 0.0f));
+    cache.erase(3);
+    BOOST_TEST(cache.size() == 1u);
+    BOOST_CHECK_THROW(FlowFieldCache(raster, {.capacity = 0}), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
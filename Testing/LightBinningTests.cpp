@@ -0,0 +1,114 @@
+#include <boost/test/unit_test.hpp>
+
+#include "RenderingSystem/LightBinning.hpp"
+
+#include <glm/ext/matrix_clip_space.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+// One world unit per pixel on a 256x128 framebuffer.
+constexpr int kWidth = 256;
+constexpr int kHeight = 128;
+
+glm::mat4 screenProjection() {
+    return glm::ortho(0.0f, static_cast<float>(kWidth), 0.0f,
+                      static_cast<float>(kHeight), -1.0f, 1.0f);
+}
+
+Light pointLight(const glm::vec2& position, float radius) {
+    Light light{};
+    light.type = LightType::POINT;
+    light.pos = position;
+    light.radius = radius;
+    return light;
+}
+
+std::vector<std::uint32_t> tileLights(const Rendering::LightTileGrid& grid, int x, int y) {
+    const std::size_t tile = static_cast<std::size_t>(y) * grid.tilesX + x;
+    return {grid.indices.begin() + grid.offsets[tile],
+            grid.indices.begin() + grid.offsets[tile + 1]};
+}
+}
+
+BOOST_AUTO_TEST_SUITE(LightBinningTests)
+
+BOOST_AUTO_TEST_CASE(point_light_lands_only_in_overlapping_tiles) {
+    const std::vector<Light> lights{pointLight({40.0f, 40.0f}, 10.0f)};
+    Rendering::LightTileGrid grid;
+    Rendering::binLights(lights, screenProjection(), kWidth, kHeight, 32, grid);
+
+    BOOST_TEST(grid.tilesX == 8);
+    BOOST_TEST(grid.tilesY == 4);
+    BOOST_REQUIRE(grid.offsets.size() == grid.tileCount() + 1);
+    // Bounds 30..50 straddle the tile boundary at 32 on both axes.
+    BOOST_TEST(grid.indices.size() == 4u);
+    BOOST_TEST(tileLights(grid, 0, 0).size() == 1u);
+    BOOST_TEST(tileLights(grid, 1, 1).size() == 1u);
+    BOOST_TEST(tileLights(grid, 2, 1).empty());
+    BOOST_TEST(tileLights(grid, 0, 2).empty());
+}
+
+BOOST_AUTO_TEST_CASE(directional_lights_cover_every_tile_in_light_order) {
+    Light sun{};
+    sun.type = LightType::DIRECTIONAL;
+    const std::vector<Light> lights{pointLight({200.0f, 100.0f}, 5.0f), sun,
+                                    pointLight({201.0f, 101.0f}, 5.0f)};
+    Rendering::LightTileGrid grid;
+    Rendering::binLights(lights, screenProjection(), kWidth, kHeight, 32, grid);
+
+    // The first light straddles the row boundary at y = 96.
+    BOOST_TEST(grid.indices.size() == grid.tileCount() + 3);
+    const auto shared = tileLights(grid, 6, 3);
+    BOOST_TEST(shared == (std::vector<std::uint32_t>{0u, 1u, 2u}));
+    BOOST_TEST(tileLights(grid, 0, 0) == std::vector<std::uint32_t>{1u});
+    BOOST_TEST(std::is_sorted(grid.offsets.begin(), grid.offsets.end()));
+}
+
+BOOST_AUTO_TEST_CASE(lights_without_area_or_off_screen_are_skipped) {
+    const std::vector<Light> lights{
+        pointLight({40.0f, 40.0f}, 0.0f),
+        pointLight({-100.0f, 40.0f}, 20.0f),
+        pointLight({40.0f, 1000.0f}, 20.0f),
+        pointLight({40.0f, 40.0f}, std::numeric_limits<float>::infinity())};
+    Rendering::LightTileGrid grid;
+    Rendering::binLights(lights, screenProjection(), kWidth, kHeight, 32, grid);
+    BOOST_TEST(grid.indices.empty());
+    BOOST_TEST(grid.offsets.back() == 0u);
+
+    // A huge light clamps to the framebuffer instead of overflowing.
+    Rendering::binLights(std::vector<Light>{pointLight({0.0f, 0.0f}, 1.0e30f)},
+                         screenProjection(), kWidth, kHeight, 32, grid);
+    BOOST_TEST(grid.indices.size() == grid.tileCount());
+}
+
+BOOST_AUTO_TEST_CASE(camera_transform_and_partial_tiles_are_respected) {
+    // A camera looking at 1000..1256 puts the light near the right edge; the
+    // last column of tiles is partial on a 250-pixel framebuffer.
+    const glm::mat4 camera = glm::ortho(1000.0f, 1250.0f, 0.0f, 128.0f, -1.0f, 1.0f);
+    const std::vector<Light> lights{pointLight({1245.0f, 10.0f}, 2.0f)};
+    Rendering::LightTileGrid grid;
+    Rendering::binLights(lights, camera, 250, 128, 32, grid);
+
+    BOOST_TEST(grid.tilesX == 8);
+    BOOST_TEST(tileLights(grid, 7, 0).size() == 1u);
+    BOOST_TEST(grid.indices.size() == 1u);
+
+    const glm::vec4 bounds = Rendering::lightScreenBounds(lights[0], camera, 250, 128);
+    BOOST_TEST(bounds.x == 243.0f, boost::test_tools::tolerance(1e-3f));
+    BOOST_TEST(bounds.w == 12.0f, boost::test_tools::tolerance(1e-3f));
+}
+
+BOOST_AUTO_TEST_CASE(invalid_sizes_are_rejected) {
+    Rendering::LightTileGrid grid;
+    const std::vector<Light> lights;
+    BOOST_CHECK_THROW(Rendering::binLights(lights, screenProjection(), 0, kHeight, 32, grid),
+                      std::invalid_argument);
+    BOOST_CHECK_THROW(Rendering::binLights(lights, screenProjection(), kWidth, kHeight, 0, grid),
+                      std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -1,13 +1,19 @@
 #include <boost/test/unit_test.hpp>
 
+#include <algorithm>
 #include <cmath>
 #include <limits>
 #include <stdexcept>
+#include <vector>
 
 #include <glm/geometric.hpp>
 
+#include "AISystem/NavMesh/HierarchicalNavGraph.hpp"
+#include "AISystem/NavMesh/NavQuery.hpp"
 #include "AISystem/NavMesh/NavRaster.hpp"
+#include "AISystem/NavMesh/PathRequestQueue.hpp"
 #include "AISystem/NavMesh/PolyNavMesh.hpp"
+#include "Utils/WorkerPool.hpp"
 
 namespace {
 constexpr float kTolerance = 1e-4f;
@@ -36,6 +42,79 @@ bool pathStaysOnWalkableCells(const NavPath& path, const NavRaster& raster) {
     }
     return true;
 }
+
+// A serpentine of walls so searches need many expansions.
+NavRaster mazeRaster() {
+    NavRaster raster(24, 24, 1.0f, glm::vec2{0.0f});
+    for (int x = 2; x < 24; x += 2) {
+        const int gap = (x / 2) % 2 == 0 ? 0 : 23;
+        for (int y = 0; y < 24; ++y) {
+            raster.setWalkable(x, y, y == gap);
+        }
+    }
+    return raster;
+}
+
+// Consecutive points of a cell-center path must be walkable 8-neighbours
+// that do not cut a blocked corner.
+bool isCellWalk(const NavPath& path, const NavRaster& raster) {
+    if (path.points.size() < 2) return false;
+    for (std::size_t i = 0; i + 1 < path.points.size(); ++i) {
+        int ax = 0, ay = 0, bx = 0, by = 0;
+        if (!raster.worldToCell(path.points[i], ax, ay) ||
+            !raster.worldToCell(path.points[i + 1], bx, by) ||
+            !raster.isWalkable(ax, ay) || !raster.isWalkable(bx, by) ||
+            std::abs(ax - bx) > 1 || std::abs(ay - by) > 1 ||
+            !raster.isWalkable(bx, ay) || !raster.isWalkable(ax, by)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Blocked rooms and pillars spread over several navmesh tiles.
+NavRaster tiledRaster() {
+    NavRaster raster(96, 64, 0.5f, glm::vec2{-4.0f, 1.0f});
+    for (int y = 0; y < 64; ++y) {
+        for (int x = 0; x < 96; ++x) {
+            const bool room = (x / 12 + y / 10) % 3 == 0 && x % 12 > 2 && y % 10 > 3;
+            raster.setWalkable(x, y, !room && (x * 31 + y * 17) % 23 != 0);
+        }
+    }
+    raster.clearDirtyTiles();
+    return raster;
+}
+
+// Live polygons of a mesh as sorted cell rectangles, each with the sorted
+// rectangles of its neighbours, so meshes can be compared whatever their
+// polygon numbering.
+std::vector<std::pair<std::vector<float>, std::vector<std::vector<float>>>>
+meshShape(const PolyNavMesh& mesh) {
+    const auto key = [](const NavPoly& poly) {
+        return std::vector<float>{poly.bounds.getMin().x, poly.bounds.getMin().y,
+                                  poly.bounds.getMax().x, poly.bounds.getMax().y};
+    };
+    std::vector<std::pair<std::vector<float>, std::vector<std::vector<float>>>> shape;
+    for (const NavPoly& poly : mesh.polygons()) {
+        if (poly.id < 0) continue;
+        std::vector<std::vector<float>> neighbors;
+        for (const int neighbor : poly.neighbors) {
+            neighbors.push_back(key(mesh.polygons()[static_cast<std::size_t>(neighbor)]));
+        }
+        std::sort(neighbors.begin(), neighbors.end());
+        shape.emplace_back(key(poly), std::move(neighbors));
+    }
+    std::sort(shape.begin(), shape.end());
+    return shape;
+}
+
+bool samePath(const NavPath& a, const NavPath& b) {
+    if (a.points.size() != b.points.size()) return false;
+    for (std::size_t i = 0; i < a.points.size(); ++i) {
+        if (!near(a.points[i], b.points[i])) return false;
+    }
+    return true;
+}
 }
 
 BOOST_AUTO_TEST_SUITE(NavMeshTests)
@@ -93,6 +172,64 @@ BOOST_AUTO_TEST_CASE(cell_access_is_checked_and_predicate_build_is_validated) {
     BOOST_TEST(!filtered.isWalkable(1, 0));
 }
 
+BOOST_AUTO_TEST_CASE(raster_packs_cells_and_stamps_boxes_and_tile_layers) {
+    NavRaster raster(70, 5, 0.5f, glm::vec2{1.0f, 2.0f});
+    BOOST_TEST(raster.wordsPerRow() == 2);
+    BOOST_TEST(raster.walkableCount() == 350u);
+    BOOST_TEST(raster.memoryBytes() < 70u * 5u);
+    BOOST_TEST(raster.rowWords(4)[1] == 0x3Fu);
+    BOOST_TEST(!raster.isWalkable(70, 0));
+
+    // Clipped to the raster, across a word boundary and two tiles.
+    raster.fillCells(60, -3, 80, 0, false);
+    BOOST_TEST(raster.walkableCount() == 340u);
+    BOOST_TEST(!raster.isWalkable(63, 0));
+    BOOST_TEST(!raster.isWalkable(64, 0));
+    BOOST_TEST(raster.isWalkable(59, 0));
+    BOOST_TEST(raster.isWalkable(64, 1));
+    BOOST_TEST(raster.dirtyTiles().size() == 2u);
+    raster.clearDirtyTiles();
+    raster.fillCells(60, 0, 69, 0, false);
+    BOOST_TEST(raster.dirtyTiles().empty());
+
+    // Boxes block the cells whose interior they overlap, not those they touch.
+    raster.stampBounds(NavAABB{{2.0f, 2.0f}, {3.0f, 2.6f}}, false);
+    for (const auto& [x, y] : {std::pair{2, 0}, {3, 0}, {2, 1}, {3, 1}}) {
+        BOOST_TEST(!raster.isWalkable(x, y));
+    }
+    BOOST_TEST(raster.isWalkable(1, 0));
+    BOOST_TEST(raster.isWalkable(4, 0));
+    BOOST_TEST(raster.isWalkable(2, 2));
+    raster.stampBounds(NavAABB{{-50.0f, -50.0f}, {0.5f, 60.0f}}, false);
+    raster.stampBounds(NavAABB{{5.0f, 3.0f}, {5.0f, 4.0f}}, false);
+    BOOST_TEST(raster.walkableCount() == 336u);
+
+    // Empty tiles (negative indices) leave cells alone.
+    raster.fillCells(0, 0, 69, 4, true);
+    const std::vector<int> layer{-1, 0, 5,
+                                 -1, -1, 2};
+    raster.stampTiles(glm::vec2{1.0f, 2.0f}, glm::vec2{1.0f}, 3, layer, false);
+    BOOST_TEST(raster.walkableCount() == 350u - 8u - 4u);
+    BOOST_TEST(!raster.isWalkable(2, 0));
+    BOOST_TEST(!raster.isWalkable(5, 1));
+    BOOST_TEST(raster.isWalkable(1, 1));
+    BOOST_TEST(!raster.isWalkable(4, 3));
+    BOOST_TEST(raster.isWalkable(3, 3));
+    BOOST_CHECK_THROW(raster.stampTiles(glm::vec2{0.0f}, glm::vec2{0.0f, 1.0f}, 3, layer, false),
+                      std::invalid_argument);
+
+    // Regions cover every walkable cell exactly once.
+    PolyNavMesh mesh;
+    mesh.buildFromRaster(raster);
+    float area = 0.0f;
+    for (const NavPoly& poly : mesh.polygons()) {
+        const glm::vec2 size = poly.bounds.getMax() - poly.bounds.getMin();
+        area += size.x * size.y;
+    }
+    BOOST_TEST(area / (0.5f * 0.5f) == static_cast<float>(raster.walkableCount()),
+               boost::test_tools::tolerance(1e-4f));
+}
+
 BOOST_AUTO_TEST_CASE(navmesh_finds_direct_path_inside_one_polygon) {
     NavRaster raster(4, 3, 1.0f, glm::vec2{0.0f});
     PolyNavMesh mesh;
@@ -142,4 +279,495 @@ BOOST_AUTO_TEST_CASE(navmesh_returns_no_path_for_invalid_or_blocked_endpoints) {
                     .valid());
 }
 
+BOOST_AUTO_TEST_CASE(navmesh_adjacency_matches_shared_polygon_edges) {
+    NavRaster raster(12, 9, 1.0f, glm::vec2{-3.0f, 2.0f});
+    for (int y = 0; y < 9; ++y) {
+        for (int x = 0; x < 12; ++x) {
+            raster.setWalkable(x, y, (x * 7 + y * 5) % 6 != 0);
+        }
+    }
+    PolyNavMesh mesh;
+    mesh.buildFromRaster(raster);
+    const auto& polys = mesh.polygons();
+    BOOST_REQUIRE(polys.size() > 4u);
+
+    const auto sharesEdge = [](const AABB& a, const AABB& b) {
+        const glm::vec2 aMin = a.getMin();
+        const glm::vec2 aMax = a.getMax();
+        const glm::vec2 bMin = b.getMin();
+        const glm::vec2 bMax = b.getMax();
+        const float overlapX = std::min(aMax.x, bMax.x) - std::max(aMin.x, bMin.x);
+        const float overlapY = std::min(aMax.y, bMax.y) - std::max(aMin.y, bMin.y);
+        return (std::abs(overlapX) <= kTolerance && overlapY > kTolerance) ||
+               (std::abs(overlapY) <= kTolerance && overlapX > kTolerance);
+    };
+    for (std::size_t i = 0; i < polys.size(); ++i) {
+        std::vector<int> expected;
+        for (std::size_t j = 0; j < polys.size(); ++j) {
+            if (i != j && sharesEdge(polys[i].bounds, polys[j].bounds)) {
+                expected.push_back(static_cast<int>(j));
+            }
+        }
+        BOOST_TEST(polys[i].neighbors == expected, boost::test_tools::per_element());
+        BOOST_TEST(polys[i].portals.size() == expected.size());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(navmesh_locates_points_on_polygon_edges) {
+    NavRaster raster(4, 2, 2.0f, glm::vec2{0.0f});
+    raster.setWalkable(2, 1, false);
+    raster.setWalkable(3, 1, false);
+    PolyNavMesh mesh;
+    mesh.buildFromRaster(raster);
+
+    // Outer maximum edges and edges next to blocked cells are inside.
+    BOOST_TEST(mesh.findPath(glm::vec2{8.0f, 0.0f}, glm::vec2{0.0f, 4.0f}).valid());
+    BOOST_TEST(mesh.findPath(glm::vec2{6.0f, 2.0f}, glm::vec2{1.0f, 1.0f}).valid());
+    BOOST_TEST(!mesh.findPath(glm::vec2{6.0f, 3.0f}, glm::vec2{1.0f, 1.0f}).valid());
+    BOOST_TEST(!mesh.findPath(glm::vec2{8.01f, 1.0f}, glm::vec2{1.0f, 1.0f}).valid());
+}
+
+BOOST_AUTO_TEST_CASE(nav_query_reuses_its_storage_across_searches) {
+    NavRaster raster(8, 6, 1.0f, glm::vec2{0.0f});
+    for (int y = 0; y < 5; ++y) {
+        raster.setWalkable(3, y, false);
+    }
+    PolyNavMesh mesh;
+    mesh.buildFromRaster(raster);
+    BOOST_TEST(mesh.polyCount() == mesh.polygons().size());
+    for (std::size_t i = 0; i < mesh.polyCount(); ++i) {
+        BOOST_TEST(mesh.links(static_cast<int>(i)).size() == mesh.polygons()[i].neighbors.size());
+    }
+
+    NavQuery query;
+    NavPath path;
+    const glm::vec2 start{0.5f, 0.5f};
+    const glm::vec2 end{7.5f, 0.5f};
+    BOOST_REQUIRE(query.findPath(mesh, start, end, path));
+    BOOST_TEST(pathStaysOnWalkableCells(path, raster));
+    BOOST_TEST(query.corridor().front() == mesh.findPoly(start));
+    BOOST_TEST(query.corridor().back() == mesh.findPoly(end));
+
+    const NavPath expected = mesh.findPath(start, end);
+    const glm::vec2* storage = path.points.data();
+    for (int repeat = 0; repeat < 3; ++repeat) {
+        BOOST_REQUIRE(query.findPath(mesh, start, end, path));
+        BOOST_TEST(path.points.data() == storage);
+        BOOST_REQUIRE(path.points.size() == expected.points.size());
+        for (std::size_t i = 0; i < path.points.size(); ++i) {
+            BOOST_TEST(near(path.points[i], expected.points[i]));
+        }
+    }
+
+    BOOST_TEST(!query.findPath(mesh, start, glm::vec2{3.5f, 0.5f}, path));
+    BOOST_TEST(path.points.empty());
+    BOOST_TEST(query.corridor().empty());
+}
+
+BOOST_AUTO_TEST_CASE(path_queue_slices_searches_by_the_expansion_budget) {
+    const NavRaster raster = mazeRaster();
+    PolyNavMesh mesh;
+    mesh.buildFromRaster(raster);
+    PathRequestQueue queue(mesh, {.expansionBudget = 2, .maxActiveSearches = 1});
+
+    const glm::vec2 start{0.5f, 0.5f};
+    const glm::vec2 goal{23.5f, 0.5f};
+    const PathHandle handle = queue.request(start, goal);
+    BOOST_TEST((queue.status(handle) == PathRequestStatus::Pending));
+    queue.update();
+    BOOST_TEST((queue.status(handle) == PathRequestStatus::Pending));
+    BOOST_TEST(queue.stats().expansionsLastUpdate <= 2u);
+
+    NavPath path;
+    BOOST_TEST(!queue.poll(handle, path));
+    int updates = 1;
+    while (queue.status(handle) == PathRequestStatus::Pending && updates < 1000) {
+        queue.update();
+        ++updates;
+    }
+    BOOST_TEST(updates > 2);
+    BOOST_REQUIRE(queue.poll(handle, path));
+    BOOST_TEST(samePath(path, mesh.findPath(start, goal)));
+
+    // Collected handles are invalid, and their slots are reused safely.
+    BOOST_TEST((queue.status(handle) == PathRequestStatus::Invalid));
+    BOOST_TEST(!queue.poll(handle, path));
+    const PathHandle next = queue.request(start, start);
+    BOOST_TEST(next.index == handle.index);
+    BOOST_TEST(!(next == handle));
+    BOOST_TEST(queue.stats().completed == 1u);
+    BOOST_TEST(queue.stats().maxLatencyUpdates == static_cast<std::uint64_t>(updates));
+
+    BOOST_CHECK_THROW(queue.setSettings({.expansionBudget = 0}), std::invalid_argument);
+    BOOST_CHECK_THROW(PathRequestQueue(mesh, {.maxActiveSearches = 0}), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(path_queue_shares_searches_and_orders_by_priority) {
+    const NavRaster raster = mazeRaster();
+    PolyNavMesh mesh;
+    mesh.buildFromRaster(raster);
+    PathRequestQueue queue(mesh, {.expansionBudget = 100'000, .maxActiveSearches = 1});
+
+    const PathHandle low = queue.request({0.5f, 0.5f}, {23.5f, 0.5f}, PathPriority::Low);
+    const PathHandle high = queue.request({0.5f, 5.5f}, {11.5f, 12.5f}, PathPriority::High);
+    // Same polygons as `low`, different points: joins its search.
+    const PathHandle shared = queue.request({0.75f, 3.5f}, {23.25f, 6.5f}, PathPriority::Normal);
+    const PathHandle offMesh = queue.request({2.5f, 5.5f}, {23.5f, 0.5f});
+    BOOST_TEST(queue.stats().deduplicated == 1u);
+    BOOST_TEST(queue.stats().pending == 3u);
+    BOOST_TEST((queue.status(offMesh) == PathRequestStatus::Ready));
+
+    // One search per update: the high priority one first, though submitted later.
+    queue.update();
+    BOOST_TEST((queue.status(high) == PathRequestStatus::Ready));
+    BOOST_TEST((queue.status(low) == PathRequestStatus::Pending));
+    queue.update();
+    BOOST_TEST((queue.status(low) == PathRequestStatus::Ready));
+    BOOST_TEST((queue.status(shared) == PathRequestStatus::Ready));
+
+    NavPath path;
+    BOOST_REQUIRE(queue.poll(shared, path));
+    BOOST_TEST(samePath(path, mesh.findPath({0.75f, 3.5f}, {23.25f, 6.5f})));
+    BOOST_REQUIRE(queue.poll(offMesh, path));
+    BOOST_TEST(path.points.empty());
+}
+
+BOOST_AUTO_TEST_CASE(path_queue_cancels_and_restarts_after_mesh_changes) {
+    NavRaster raster = mazeRaster();
+    PolyNavMesh mesh;
+    mesh.buildFromRaster(raster);
+    PathRequestQueue queue(mesh, {.expansionBudget = 4, .maxActiveSearches = 2});
+
+    const glm::vec2 start{0.5f, 0.5f};
+    const glm::vec2 goal{23.5f, 0.5f};
+    const PathHandle kept = queue.request(start, goal);
+    const PathHandle dropped = queue.request({1.5f, 20.5f}, {5.5f, 20.5f});
+    queue.update();
+    queue.cancel(dropped);
+    BOOST_TEST((queue.status(dropped) == PathRequestStatus::Invalid));
+    BOOST_TEST(queue.stats().cancelled == 1u);
+    BOOST_TEST(queue.stats().pending == 1u);
+
+    // Open a shortcut through the second wall and restart.
+    raster.setWalkable(2, 12, true);
+    raster.setWalkable(4, 12, true);
+    mesh.buildFromRaster(raster);
+    queue.meshChanged();
+    NavPath path;
+    for (int update = 0; update < 1000 && !queue.poll(kept, path); ++update) {
+        queue.update();
+    }
+    BOOST_TEST(samePath(path, mesh.findPath(start, goal)));
+    BOOST_TEST(queue.stats().pending == 0u);
+}
+
+BOOST_AUTO_TEST_CASE(path_queue_restarts_keep_submission_order) {
+    const NavRaster raster = mazeRaster();
+    PolyNavMesh mesh;
+    mesh.buildFromRaster(raster);
+    PathRequestQueue queue(mesh, {.expansionBudget = 100'000, .maxActiveSearches = 1});
+
+    // `later` reuses the slot `cancelled` freed, below the one `earlier` holds.
+    const PathHandle cancelled = queue.request({1.5f, 20.5f}, {5.5f, 20.5f});
+    const PathHandle earlier = queue.request({0.5f, 0.5f}, {23.5f, 0.5f});
+    queue.cancel(cancelled);
+    const PathHandle later = queue.request({0.5f, 5.5f}, {11.5f, 12.5f});
+    BOOST_REQUIRE(later.index < earlier.index);
+
+    queue.meshChanged();
+    BOOST_TEST(queue.stats().restarted == 2u);
+    queue.update();
+    BOOST_TEST((queue.status(earlier) == PathRequestStatus::Ready));
+    BOOST_TEST((queue.status(later) == PathRequestStatus::Pending));
+    queue.update();
+    BOOST_TEST((queue.status(later) == PathRequestStatus::Ready));
+}
+
+BOOST_AUTO_TEST_CASE(path_queue_results_do_not_depend_on_workers) {
+    const NavRaster raster = mazeRaster();
+    PolyNavMesh mesh;
+    mesh.buildFromRaster(raster);
+    const PathRequestQueue::Settings settings{.expansionBudget = 64, .maxActiveSearches = 4};
+    PathRequestQueue serial(mesh, settings);
+    PathRequestQueue parallel(mesh, settings);
+    Utils::WorkerPool workers(3);
+
+    std::vector<PathHandle> serialHandles;
+    std::vector<PathHandle> parallelHandles;
+    for (int i = 0; i < 12; ++i) {
+        const glm::vec2 start{0.5f + static_cast<float>(i % 2), 0.5f + static_cast<float>(i) * 1.9f};
+        const glm::vec2 goal{23.5f, 23.5f - static_cast<float>(i) * 1.7f};
+        serialHandles.push_back(serial.request(start, goal));
+        parallelHandles.push_back(parallel.request(start, goal));
+    }
+    for (int update = 0; update < 1000 && serial.stats().pending > 0; ++update) {
+        serial.update();
+        parallel.update(&workers);
+        BOOST_TEST(serial.stats().expansionsLastUpdate == parallel.stats().expansionsLastUpdate);
+    }
+    BOOST_TEST(parallel.stats().pending == 0u);
+    for (std::size_t i = 0; i < serialHandles.size(); ++i) {
+        NavPath expected;
+        NavPath actual;
+        BOOST_REQUIRE(serial.poll(serialHandles[i], expected));
+        BOOST_REQUIRE(parallel.poll(parallelHandles[i], actual));
+        BOOST_TEST(samePath(expected, actual));
+        BOOST_TEST(!actual.points.empty());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(hierarchical_graph_finds_routes_wherever_the_navmesh_does) {
+    const NavRaster raster = mazeRaster();
+    HierarchicalNavGraph graph(5);
+    graph.buildFromRaster(raster);
+    PolyNavMesh mesh;
+    mesh.buildFromRaster(raster);
+    BOOST_TEST(graph.clusterColumns() == 5);
+    BOOST_TEST(graph.nodeCount() > 0u);
+    BOOST_CHECK_THROW(HierarchicalNavGraph(0), std::invalid_argument);
+
+    const std::vector<glm::vec2> points{{0.5f, 0.5f},   {23.5f, 0.5f}, {11.5f, 12.5f},
+                                        {5.25f, 22.5f}, {2.5f, 5.5f},  {17.9f, 3.1f},
+                                        {23.5f, 23.5f}};
+    for (const glm::vec2& start : points) {
+        for (const glm::vec2& goal : points) {
+            const NavPath flat = mesh.findPath(start, goal);
+            const NavPath path = graph.findPath(start, goal);
+            BOOST_TEST(path.valid() == flat.valid());
+            if (!path.valid()) continue;
+            BOOST_TEST(near(path.points.front(), start));
+            BOOST_TEST(near(path.points.back(), goal));
+            if (path.points.size() > 1) {
+                // Endpoints are exact; the walk between runs through cell centers.
+                NavPath cells = path;
+                int x = 0, y = 0;
+                BOOST_REQUIRE(raster.worldToCell(start, x, y));
+                cells.points.front() = raster.cellCenter(x, y);
+                BOOST_REQUIRE(raster.worldToCell(goal, x, y));
+                cells.points.back() = raster.cellCenter(x, y);
+                BOOST_TEST(isCellWalk(cells, raster));
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(hierarchical_paths_refine_one_segment_at_a_time) {
+    const NavRaster raster = mazeRaster();
+    HierarchicalNavGraph graph(6);
+    graph.buildFromRaster(raster);
+
+    const glm::vec2 start{0.5f, 0.5f};
+    const glm::vec2 goal{23.5f, 0.5f};
+    HierarchicalPath route;
+    BOOST_REQUIRE(graph.findAbstractPath(start, goal, route));
+    BOOST_TEST(route.segmentCount() > 3u);
+    BOOST_TEST(route.abstractExpansions > 0u);
+
+    NavPath next;
+    BOOST_TEST(graph.refine(route, 1, next) == 1u);
+    BOOST_TEST(route.refinedSegments == 1u);
+    BOOST_TEST(near(next.points.front(), start));
+    BOOST_TEST(near(next.points.back(), route.waypoints[1]));
+
+    NavPath walked = next;
+    while (!route.fullyRefined()) {
+        BOOST_REQUIRE(graph.refine(route, 2, walked) > 0u);
+    }
+    BOOST_TEST(graph.refine(route, 1, walked) == 0u);
+    BOOST_TEST(samePath(walked, graph.findPath(start, goal)));
+    BOOST_TEST(!graph.findAbstractPath(start, {2.5f, 0.5f}, route));
+    BOOST_TEST(!route.valid());
+}
+
+BOOST_AUTO_TEST_CASE(hierarchical_graph_rebuilds_only_changed_clusters) {
+    NavRaster raster = mazeRaster();
+    HierarchicalNavGraph graph(4);
+    graph.buildFromRaster(raster);
+    BOOST_TEST(graph.lastRebuiltClusterCount() == 36u);
+
+    // Open a shortcut through the second wall, inside one cluster.
+    raster.setWalkable(4, 13, true);
+    graph.updateCells(raster, 4, 13, 4, 13);
+    BOOST_TEST(graph.lastRebuiltClusterCount() < 4u);
+    HierarchicalNavGraph fresh(4);
+    fresh.buildFromRaster(raster);
+    BOOST_TEST(graph.nodeCount() == fresh.nodeCount());
+    BOOST_TEST(graph.edgeCount() == fresh.edgeCount());
+
+    // Block the corridor behind the first wall's gap, cutting off the start.
+    raster.setWalkable(3, 23, false);
+    graph.rebuildCluster(raster, 0, 5);
+    fresh.buildFromRaster(raster);
+    BOOST_TEST(graph.nodeCount() == fresh.nodeCount());
+    BOOST_TEST(graph.edgeCount() == fresh.edgeCount());
+    for (const glm::vec2 goal : {glm::vec2{23.5f, 0.5f}, glm::vec2{5.5f, 20.5f}}) {
+        BOOST_TEST(samePath(graph.findPath({0.5f, 0.5f}, goal), fresh.findPath({0.5f, 0.5f}, goal)));
+    }
+    BOOST_TEST(!graph.findPath({0.5f, 0.5f}, {23.5f, 0.5f}).valid());
+
+    BOOST_CHECK_THROW(graph.rebuildCluster(raster, 6, 0), std::out_of_range);
+    BOOST_CHECK_THROW(graph.updateCells(NavRaster(8, 8, 1.0f, glm::vec2{0.0f}), 0, 0, 1, 1),
+                      std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(tiled_navmesh_keeps_polygons_inside_their_tiles) {
+    const NavRaster raster = tiledRaster();
+    PolyNavMesh tiled;
+    tiled.buildTiled(raster);
+    PolyNavMesh whole;
+    whole.buildFromRaster(raster);
+    BOOST_TEST(tiled.tiled());
+    BOOST_TEST(!whole.tiled());
+    BOOST_TEST(tiled.polyCount() > whole.polyCount());
+
+    const float tileWorld = static_cast<float>(NavRaster::kTileSize) * raster.cellSize();
+    for (std::size_t i = 0; i < tiled.polyCount(); ++i) {
+        const NavPoly& poly = tiled.polygons()[i];
+        BOOST_REQUIRE(poly.id == static_cast<int>(i));
+        const glm::vec2 min = (poly.bounds.getMin() - raster.origin()) / tileWorld;
+        const glm::vec2 max = (poly.bounds.getMax() - raster.origin()) / tileWorld;
+        BOOST_TEST(std::floor(min.x + kTolerance) == std::ceil(max.x - kTolerance) - 1.0f);
+        BOOST_TEST(std::floor(min.y + kTolerance) == std::ceil(max.y - kTolerance) - 1.0f);
+        BOOST_TEST(tiled.links(static_cast<int>(i)).size() == poly.neighbors.size());
+        BOOST_TEST(std::is_sorted(poly.neighbors.begin(), poly.neighbors.end()));
+    }
+    for (const auto& [start, goal] : {std::pair{glm::vec2{-3.7f, 1.2f}, glm::vec2{43.6f, 32.8f}},
+                                      {glm::vec2{10.1f, 20.3f}, glm::vec2{30.2f, 3.3f}}}) {
+        const NavPath path = tiled.findPath(start, goal);
+        BOOST_TEST(path.valid() == whole.findPath(start, goal).valid());
+        if (path.valid()) {
+            BOOST_TEST(near(path.points.front(), start));
+            BOOST_TEST(near(path.points.back(), goal));
+        }
+    }
+    BOOST_CHECK_THROW(whole.updateTiles(raster), std::invalid_argument);
+    BOOST_CHECK_THROW(tiled.updateTiles(raster, std::vector<int>{6}), std::out_of_range);
+}
+
+BOOST_AUTO_TEST_CASE(tiled_navmesh_rebuilds_only_dirty_tiles) {
+    NavRaster raster = tiledRaster();
+    PolyNavMesh mesh;
+    mesh.buildTiled(raster);
+    BOOST_TEST(raster.dirtyTiles().empty());
+
+    // Close a corridor along the border of tiles 0 and 1, and set a cell to
+    // the value it already has.
+    for (int y = 0; y < 32; ++y) raster.setWalkable(32, y, false);
+    raster.setWalkable(70, 40, raster.isWalkable(70, 40));
+    BOOST_TEST(raster.dirtyTiles().size() == 1u);
+    BOOST_TEST(raster.dirtyTiles().front() == 1);
+
+    const std::vector<NavPoly> before = mesh.polygons();
+    mesh.updateTiles(raster);
+    raster.clearDirtyTiles();
+    BOOST_TEST(raster.dirtyTiles().empty());
+    BOOST_TEST(!mesh.lastRemovedPolys().empty());
+    BOOST_TEST(std::is_sorted(mesh.lastRemovedPolys().begin(), mesh.lastRemovedPolys().end()));
+
+    PolyNavMesh fresh;
+    fresh.buildTiled(raster);
+    BOOST_TEST((meshShape(mesh) == meshShape(fresh)));
+    // Polygons of untouched tiles keep their indices and rectangles.
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < before.size(); ++i) {
+        if (std::binary_search(mesh.lastRemovedPolys().begin(), mesh.lastRemovedPolys().end(),
+                               static_cast<int>(i))) {
+            continue;
+        }
+        BOOST_TEST((mesh.polygons()[i].bounds.getMin() == before[i].bounds.getMin()));
+        ++kept;
+    }
+    BOOST_TEST(kept + mesh.lastRemovedPolys().size() == before.size());
+
+    // Reopen it through the dirty-tile list again; repeated updates compact
+    // the link array instead of growing it.
+    for (int round = 0; round < 20; ++round) {
+        raster.setWalkable(32, 12, round % 2 == 0);
+        mesh.updateTiles(raster);
+        raster.clearDirtyTiles();
+    }
+    fresh.buildTiled(raster);
+    BOOST_TEST((meshShape(mesh) == meshShape(fresh)));
+    const glm::vec2 start = raster.cellCenter(31, 12);
+    const glm::vec2 goal = raster.cellCenter(33, 12);
+    BOOST_TEST(mesh.findPath(start, goal).valid() == fresh.findPath(start, goal).valid());
+}
+
+BOOST_AUTO_TEST_CASE(path_queue_restarts_only_searches_touching_changed_tiles) {
+    NavRaster raster(96, 64, 1.0f, glm::vec2{0.0f});
+    for (int x = 4; x < 96; x += 4) {
+        for (int y = 0; y < 64; ++y) raster.setWalkable(x, y, y == ((x / 4) % 2 == 0 ? 0 : 63));
+    }
+    raster.clearDirtyTiles();
+    PolyNavMesh mesh;
+    mesh.buildTiled(raster);
+    PathRequestQueue queue(mesh, {.expansionBudget = 4, .maxActiveSearches = 2});
+
+    const glm::vec2 nearStart{1.5f, 1.5f};
+    const glm::vec2 farStart{94.5f, 62.5f};
+    const PathHandle nearRequest = queue.request(nearStart, {90.5f, 1.5f});
+    const PathHandle farRequest = queue.request(farStart, {6.5f, 60.5f});
+    queue.update();
+
+    // Tile 0 holds the first search's start; the second has not come near it.
+    raster.setWalkable(2, 30, false);
+    mesh.updateTiles(raster);
+    raster.clearDirtyTiles();
+    queue.meshChanged(mesh.lastRemovedPolys(), mesh.lastChangedPolys());
+    BOOST_TEST(queue.stats().restarted == 1u);
+    BOOST_TEST(queue.stats().pending == 2u);
+
+    NavPath nearPath;
+    NavPath farPath;
+    for (int update = 0; update < 2000 && queue.stats().pending > 0; ++update) {
+        queue.update();
+    }
+    BOOST_REQUIRE(queue.poll(nearRequest, nearPath));
+    BOOST_REQUIRE(queue.poll(farRequest, farPath));
+    BOOST_TEST(samePath(nearPath, mesh.findPath(nearStart, {90.5f, 1.5f})));
+    BOOST_TEST(samePath(farPath, mesh.findPath(farStart, {6.5f, 60.5f})));
+}
+
+BOOST_AUTO_TEST_CASE(path_queue_restarts_searches_when_a_door_opens) {
+    // A serpentine in tile 0 sealed off from tiles 1 and 2 by a wall at x = 32.
+    NavRaster raster(96, 32, 1.0f, glm::vec2{0.0f});
+    for (int x = 4; x < 32; x += 4) {
+        for (int y = 0; y < 32; ++y) raster.setWalkable(x, y, y == ((x / 4) % 2 == 0 ? 0 : 31));
+    }
+    for (int y = 0; y < 32; ++y) raster.setWalkable(32, y, false);
+    raster.clearDirtyTiles();
+    PolyNavMesh mesh;
+    mesh.buildTiled(raster);
+    PathRequestQueue queue(mesh, {.expansionBudget = 2, .maxActiveSearches = 1});
+
+    const glm::vec2 start{30.5f, 16.5f};
+    const glm::vec2 goal{80.5f, 16.5f};
+    const PathHandle request = queue.request(start, goal);
+    queue.update();
+    BOOST_TEST((queue.status(request) == PathRequestStatus::Pending));
+
+    // The door is in tile 1; the search's start polygon, already expanded,
+    // gains a link to it.
+    raster.setWalkable(32, 16, true);
+    mesh.updateTiles(raster);
+    raster.clearDirtyTiles();
+    const int startPoly = mesh.findPoly(start);
+    BOOST_TEST(std::binary_search(mesh.lastChangedPolys().begin(), mesh.lastChangedPolys().end(),
+                                  startPoly));
+    for (const int poly : mesh.lastChangedPolys()) {
+        BOOST_TEST(!std::binary_search(mesh.lastRemovedPolys().begin(),
+                                       mesh.lastRemovedPolys().end(), poly));
+    }
+    queue.meshChanged(mesh.lastRemovedPolys(), mesh.lastChangedPolys());
+    BOOST_TEST(queue.stats().restarted == 1u);
+
+    NavPath path;
+    for (int update = 0; update < 2000 && queue.stats().pending > 0; ++update) {
+        queue.update();
+    }
+    BOOST_REQUIRE(queue.poll(request, path));
+    BOOST_TEST(path.valid());
+    BOOST_TEST(samePath(path, mesh.findPath(start, goal)));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,117 @@
+#include <boost/test/unit_test.hpp>
+
+#include "ECS/Components/ParticleEmitter2D.hpp"
+#include "ECS/Components/Transform2D.hpp"
+#include "ECS/Registry.hpp"
+#include "ECS/Systems/ParticleSystem2D.hpp"
+#include "ParticleSystem/ParticleEffectSystem.hpp"
+#include "ParticleSystem/ParticleStepScheduler.hpp"
+#include "Utils/WorkerPool.hpp"
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+ParticleEmitterConfig swirlingConfig(std::uint32_t seed) {
+    ParticleEmitterConfig config{};
+    config.spawnRate = 20000.0f;
+    config.minLifeTime = 0.05f;
+    config.maxLifeTime = 3.0f;
+    config.drag = 0.3f;
+    config.homingStrength = 15.0f;
+    config.orbitStrength = 5.0f;
+    config.endColor = {0.2f, 0.1f, 0.0f, 0.0f};
+    config.endSizeMultiplier = 0.5f;
+    config.randomSeed = seed;
+    return config;
+}
+
+// Three emitters, one large enough to be split into several ranges.
+std::vector<ECS::Entity> buildEmitters(ECS::Registry& registry) {
+    std::vector<ECS::Entity> entities;
+    const std::size_t capacities[] = {3 * kParticleStepRangeSize + 100, 500, 64};
+    for (std::uint32_t i = 0; i < 3; ++i) {
+        const ECS::Entity entity = registry.create();
+        registry.emplace<ECS::Transform2D>(entity).position = {10.0f * i, 0.0f};
+        auto& component = registry.emplace<ECS::ParticleEmitter2D>(
+            entity, capacities[i], swirlingConfig(7 + i));
+        component.targetOffset = {30.0f, 5.0f};
+        component.requestBurst(static_cast<unsigned int>(capacities[i] / 2));
+        entities.push_back(entity);
+    }
+    return entities;
+}
+
+void expectIdentical(const ParticlePool& a, const ParticlePool& b) {
+    BOOST_REQUIRE(a.size() == b.size());
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        const Particle left = a.particle(i);
+        const Particle right = b.particle(i);
+        BOOST_REQUIRE(left.position == right.position);
+        BOOST_REQUIRE(left.velocity == right.velocity);
+        BOOST_REQUIRE(left.color == right.color);
+        BOOST_REQUIRE(left.size == right.size);
+        BOOST_REQUIRE(left.age == right.age);
+    }
+}
+}
+
+BOOST_AUTO_TEST_SUITE(ParallelParticleTests)
+
+BOOST_AUTO_TEST_CASE(worker_pool_runs_every_index_once) {
+    Utils::WorkerPool pool(3);
+    std::vector<std::atomic<int>> hits(1000);
+    pool.parallelFor(hits.size(), [&hits](std::size_t index) { ++hits[index]; });
+    for (const auto& hit : hits) {
+        BOOST_REQUIRE(hit.load() == 1);
+    }
+
+    BOOST_CHECK_THROW(pool.parallelFor(64, [](std::size_t index) {
+        if (index == 17) throw std::runtime_error("task failed");
+    }), std::runtime_error);
+    // The pool stays usable after a failed loop.
+    std::atomic<int> total{0};
+    pool.parallelFor(10, [&total](std::size_t) { ++total; });
+    BOOST_TEST(total.load() == 10);
+}
+
+BOOST_AUTO_TEST_CASE(parallel_ecs_update_matches_serial) {
+    ECS::Registry serial;
+    ECS::Registry parallel;
+    const auto serialEntities = buildEmitters(serial);
+    const auto parallelEntities = buildEmitters(parallel);
+    Utils::WorkerPool workers(3);
+
+    for (int step = 0; step < 40; ++step) {
+        ECS::ParticleSystem2D::update(serial, 1.0f / 60.0f);
+        ECS::ParticleSystem2D::update(parallel, 1.0f / 60.0f, &workers);
+    }
+    for (std::size_t i = 0; i < serialEntities.size(); ++i) {
+        const auto* expected = serial.tryGet<ECS::ParticleEmitter2D>(serialEntities[i]);
+        const auto* actual = parallel.tryGet<ECS::ParticleEmitter2D>(parallelEntities[i]);
+        BOOST_REQUIRE(expected != nullptr);
+        BOOST_REQUIRE(actual != nullptr);
+        BOOST_TEST(expected->emitter.liveParticleCount() > 0u);
+        expectIdentical(expected->emitter.particles(), actual->emitter.particles());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(parallel_effects_expire_like_serial_ones) {
+    ParticleEffectDefinition definition{};
+    definition.maxParticles = 200;
+    definition.config = swirlingConfig(3);
+    definition.config.maxLifeTime = 0.2f;
+    definition.config.burstCount = 150;
+
+    ParticleEffectSystem serial;
+    ParticleEffectSystem parallel;
+    Utils::WorkerPool workers(2);
+    ParticleEmitter* expected = serial.spawnOneShot({0.0f, 0.0f}, definition);
+    ParticleEmitter* actual = parallel.spawnOneShot({0.0f, 0.0f}, definition);
+    serial.update(0.1f);
+    parallel.update(0.1f, &workers);
+    expectIdentical(expected->particles(), actual->particles());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,287 @@
+#include <boost/test/unit_test.hpp>
+
+#include "ECS/Components/ParticleEmitter2D.hpp"
+#include "ECS/Components/Transform2D.hpp"
+#include "ECS/Registry.hpp"
+#include "ECS/Systems/ParticleSystem2D.hpp"
+#include "Engine/Scene.hpp"
+#include "Exceptions/SubsystemExceptions.hpp"
+#include "ParticleSystem/ParticleBudget.hpp"
+#include "ParticleSystem/ParticleEffectSystem.hpp"
+#include "ParticleSystem/ParticleEmitter.hpp"
+#include "ParticleSystem/ParticlePool.hpp"
+#include "ParticleSystem/ParticleStorageCache.hpp"
+
+#include <memory>
+#include <utility>
+
+namespace {
+constexpr float kStep = 1.0f / 60.0f;
+
+ParticleEmitterConfig shortLivedConfig() {
+    ParticleEmitterConfig config{};
+    config.spawnRate = 0.0f;
+    config.minLifeTime = 0.1f;
+    config.maxLifeTime = 0.2f;
+    config.randomSeed = 5;
+    return config;
+}
+
+ParticleBudget::Settings budgetSettings(std::size_t maxLive, float lowShare = 1.0f,
+                                        float normalShare = 1.0f) {
+    ParticleBudget::Settings settings{};
+    settings.maxLiveParticles = maxLive;
+    settings.lowPriorityShare = lowShare;
+    settings.normalPriorityShare = normalShare;
+    return settings;
+}
+
+std::shared_ptr<ParticleBudget> makeBudget(std::size_t maxLive, float lowShare = 1.0f,
+                                           float normalShare = 1.0f) {
+    return std::make_shared<ParticleBudget>(budgetSettings(maxLive, lowShare, normalShare));
+}
+
+void runFor(ParticleEmitter& emitter, float seconds) {
+    for (float elapsed = 0.0f; elapsed < seconds; elapsed += kStep) {
+        emitter.update(kStep);
+    }
+}
+}
+
+BOOST_AUTO_TEST_SUITE(ParticleBudgetTests)
+
+BOOST_AUTO_TEST_CASE(priorities_fill_only_their_share) {
+    ParticleBudget budget(budgetSettings(100, 0.5f, 0.8f));
+    BOOST_TEST(budget.acquire(80, ParticlePriority::Low) == 50u);
+    BOOST_TEST(budget.acquire(50, ParticlePriority::Normal) == 30u);
+    BOOST_TEST(budget.acquire(50, ParticlePriority::High) == 20u);
+    BOOST_TEST(budget.acquire(1, ParticlePriority::High) == 0u);
+
+    ParticleBudget::Usage usage = budget.usage();
+    BOOST_TEST(usage.live == 100u);
+    BOOST_TEST(usage.granted == 100u);
+    BOOST_TEST(usage.denied == 81u);
+    BOOST_TEST(usage.liveByPriority[0] == 50u);
+
+    budget.release(40, ParticlePriority::Low);
+    budget.resetCounters();
+    usage = budget.usage();
+    BOOST_TEST(usage.live == 60u);
+    BOOST_TEST(usage.peak == 60u);
+    BOOST_TEST(usage.denied == 0u);
+    // Shares cap the total, so Low waits while others hold more than its share.
+    BOOST_TEST(budget.acquire(100, ParticlePriority::Low) == 0u);
+    BOOST_TEST(budget.acquire(100, ParticlePriority::Normal) == 20u);
+}
+
+BOOST_AUTO_TEST_CASE(spawn_rate_falls_off_with_view_distance) {
+    ParticleBudget::Settings settings{};
+    settings.fullRateDistance = 100.0f;
+    settings.minRateDistance = 300.0f;
+    settings.minRateScale = 0.2f;
+    ParticleBudget budget(settings);
+    BOOST_TEST(budget.spawnRateScale({5000.0f, 0.0f}) == 1.0f);
+
+    budget.setViewCenter(glm::vec2{0.0f});
+    BOOST_TEST(budget.spawnRateScale({0.0f, 90.0f}) == 1.0f);
+    BOOST_TEST(budget.spawnRateScale({200.0f, 0.0f}) == 0.6f,
+               boost::test_tools::tolerance(0.0001f));
+    BOOST_TEST(budget.spawnRateScale({0.0f, -1000.0f}) == 0.2f);
+
+    settings.minRateDistance = 50.0f;
+    BOOST_CHECK_THROW(budget.setSettings(settings), Engine::ParticleException);
+    settings = {};
+    settings.lowPriorityShare = 0.9f;
+    settings.normalPriorityShare = 0.5f;
+    BOOST_CHECK_THROW(ParticleBudget{settings}, Engine::ParticleException);
+}
+
+BOOST_AUTO_TEST_CASE(emitters_spawn_within_the_budget_and_return_expired_particles) {
+    const auto budget = makeBudget(50);
+    ParticleEmitter first{64, shortLivedConfig()};
+    ParticleEmitter second{64, shortLivedConfig()};
+    first.setBudget(budget);
+    second.setBudget(budget);
+
+    first.burst(40);
+    second.burst(40);
+    BOOST_TEST(first.liveParticleCount() == 40u);
+    BOOST_TEST(second.liveParticleCount() == 10u);
+    BOOST_TEST(budget->live() == 50u);
+
+    runFor(first, 0.5f);
+    BOOST_TEST(first.isFinished());
+    BOOST_TEST(budget->live() == 10u);
+
+    {
+        // Moves carry the held share; the moved-from emitter returns nothing.
+        ParticleEmitter moved = std::move(second);
+        BOOST_TEST(budget->live() == 10u);
+    }
+    BOOST_TEST(budget->live() == 0u);
+}
+
+BOOST_AUTO_TEST_CASE(attaching_adopts_live_particles_and_detaching_releases_them) {
+    const auto budget = makeBudget(8);
+    ParticleEmitter emitter{32, shortLivedConfig()};
+    emitter.burst(20);
+    emitter.setBudget(budget, ParticlePriority::High);
+    BOOST_TEST(budget->live() == 20u);
+    BOOST_TEST(budget->usage().liveByPriority[2] == 20u);
+
+    // Over budget: nothing more spawns until enough particles expire.
+    emitter.burst(5);
+    BOOST_TEST(emitter.liveParticleCount() == 20u);
+    emitter.setBudget(nullptr);
+    BOOST_TEST(budget->live() == 0u);
+}
+
+BOOST_AUTO_TEST_CASE(distant_emitters_spawn_at_a_reduced_rate) {
+    auto config = shortLivedConfig();
+    config.spawnRate = 600.0f;
+    config.minLifeTime = 5.0f;
+    config.maxLifeTime = 5.0f;
+    const auto budget = makeBudget(100'000);
+    budget->setViewCenter(glm::vec2{0.0f});
+    ParticleEmitter near{1024, config};
+    ParticleEmitter far{1024, config};
+    near.setBudget(budget);
+    far.setBudget(budget);
+    far.setPosition({1.0e6f, 0.0f});
+    for (int step = 0; step < 60; ++step) {
+        near.update(kStep);
+        far.update(kStep);
+    }
+    BOOST_TEST(near.liveParticleCount() == 600u);
+    BOOST_TEST(far.liveParticleCount() == 60u);
+}
+
+BOOST_AUTO_TEST_CASE(storage_cache_reuses_and_bounds_released_blocks) {
+    ParticleStorageCache cache(1000);
+    auto block = cache.acquire(100);
+    float* const address = block.get();
+    cache.release(std::move(block), 100);
+    BOOST_TEST(cache.stats().cachedBytes == 400u);
+    BOOST_TEST(cache.acquire(100).get() == address);
+    BOOST_TEST(cache.stats().hits == 1u);
+    BOOST_TEST(cache.stats().misses == 1u);
+
+    cache.release(cache.acquire(300), 300);
+    BOOST_TEST(cache.stats().cachedBlocks == 0u);
+    auto a = cache.acquire(100);
+    auto b = cache.acquire(100);
+    auto c = cache.acquire(50);
+    auto d = cache.acquire(100);
+    cache.release(std::move(a), 100);
+    cache.release(std::move(b), 100);
+    cache.release(std::move(c), 50);
+    cache.release(std::move(d), 100);
+    // The oldest block made room for the newest.
+    BOOST_TEST(cache.stats().cachedBlocks == 3u);
+    BOOST_TEST(cache.stats().cachedBytes == 1000u);
+    cache.trim();
+    BOOST_TEST(cache.stats().cachedBytes == 0u);
+}
+
+BOOST_AUTO_TEST_CASE(pools_return_storage_to_the_shared_cache) {
+    ParticleStorageCache& cache = ParticleStorageCache::shared();
+    { ParticlePool warm(96); }
+    const auto before = cache.stats();
+    {
+        ParticlePool pool(96);
+        ParticlePool moved = std::move(pool);
+        BOOST_TEST(pool.capacity() == 0u);
+        BOOST_TEST(moved.capacity() == 96u);
+    }
+    BOOST_TEST(cache.stats().hits == before.hits + 1);
+    BOOST_TEST(cache.stats().misses == before.misses);
+}
+
+BOOST_AUTO_TEST_CASE(effect_system_recycles_finished_emitters) {
+    ParticleEffectSystem effects;
+    const auto budget = makeBudget(100);
+    effects.setBudget(budget);
+    ParticleEffectDefinition def{};
+    def.maxParticles = 16;
+    def.priority = ParticlePriority::High;
+    def.config = shortLivedConfig();
+
+    ParticleEmitter* first = effects.spawnOneShot({0.0f, 0.0f}, def, 12);
+    BOOST_TEST(budget->usage().liveByPriority[2] == 12u);
+    for (int step = 0; step < 30; ++step) {
+        effects.update(kStep);
+    }
+    BOOST_TEST(effects.activeEffectCount() == 0u);
+    BOOST_TEST(effects.retiredEffectCount() == 1u);
+    BOOST_TEST(budget->live() == 0u);
+
+    ParticleEmitter* second = effects.spawnOneShot({5.0f, 5.0f}, def, 4);
+    BOOST_TEST(second == first);
+    BOOST_TEST(effects.retiredEffectCount() == 0u);
+    BOOST_TEST(second->liveParticleCount() == 4u);
+    BOOST_TEST((second->particles().position(0) == glm::vec2{5.0f, 5.0f}));
+
+    def.maxParticles = 32;
+    effects.update(1.0f);
+    BOOST_TEST(effects.spawnOneShot({0.0f, 0.0f}, def, 4) != first);
+}
+
+BOOST_AUTO_TEST_CASE(ecs_emitters_draw_from_the_budget_at_their_priority) {
+    ECS::Registry registry;
+    auto config = shortLivedConfig();
+    config.spawnRate = 6000.0f;
+    config.minLifeTime = 1.0f;
+    config.maxLifeTime = 1.0f;
+    const auto budget = makeBudget(200, 0.25f, 0.5f);
+    const ECS::Entity ambient = registry.create();
+    registry.emplace<ECS::Transform2D>(ambient);
+    registry.emplace<ECS::ParticleEmitter2D>(ambient, 1024, config).priority =
+        ParticlePriority::Low;
+    const ECS::Entity impact = registry.create();
+    registry.emplace<ECS::Transform2D>(impact);
+    registry.emplace<ECS::ParticleEmitter2D>(impact, 1024, config).priority =
+        ParticlePriority::High;
+
+    for (int step = 0; step < 10; ++step) {
+        ECS::ParticleSystem2D::update(registry, kStep, nullptr, std::nullopt, budget);
+    }
+    BOOST_TEST(registry.tryGet<ECS::ParticleEmitter2D>(ambient)->emitter.liveParticleCount() <= 50u);
+    BOOST_TEST(budget->live() == 200u);
+
+    registry.destroy(impact);
+    BOOST_TEST(budget->live() <= 50u);
+}
+
+BOOST_AUTO_TEST_CASE(scene_budget_is_opt_in) {
+    Scene scene;
+    BOOST_TEST(!scene.particleBudget());
+    ECS::Registry& registry = scene.registry();
+    auto config = shortLivedConfig();
+    config.spawnRate = 6000.0f;
+    config.minLifeTime = 1.0f;
+    config.maxLifeTime = 1.0f;
+    const ECS::Entity entity = registry.create();
+    registry.emplace<ECS::Transform2D>(entity);
+    registry.emplace<ECS::ParticleEmitter2D>(entity, 1024, config);
+    const auto live = [&] {
+        return registry.tryGet<ECS::ParticleEmitter2D>(entity)->emitter.liveParticleCount();
+    };
+
+    scene.update(kStep);
+    BOOST_TEST(live() == 100u);
+
+    const auto budget = makeBudget(150);
+    scene.setParticleBudget(budget);
+    for (int step = 0; step < 5; ++step) {
+        scene.update(kStep);
+    }
+    BOOST_TEST(live() == 150u);
+    BOOST_TEST(budget->live() == 150u);
+
+    scene.setParticleBudget(nullptr);
+    BOOST_TEST(budget->live() == 0u);
+    scene.update(kStep);
+    BOOST_TEST(live() > 150u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,276 @@
+#include <boost/test/unit_test.hpp>
+
+#include "ECS/Components/Collision2D.hpp"
+#include "ECS/Components/ParticleEmitter2D.hpp"
+#include "ECS/Components/Transform2D.hpp"
+#include "ECS/Registry.hpp"
+#include "ECS/Systems/ParticleSystem2D.hpp"
+#include "Engine/Scene.hpp"
+#include "Exceptions/SubsystemExceptions.hpp"
+#include "GameObjects/Components/TilemapComponent.hpp"
+#include "GameObjects/Components/TransformComponent.hpp"
+#include "ParticleSystem/ParticleCollisionWorld.hpp"
+#include "ParticleSystem/ParticleEmitter.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace {
+constexpr float kStep = 1.0f / 60.0f;
+
+// 4x3 tiles of 10 units with a solid bottom row and one solid tile above it:
+//   row 2: . . . .
+//   row 1: . . # .
+//   row 0: # # # #
+std::shared_ptr<TilemapData> floorTiles() {
+    auto data = std::make_shared<TilemapData>();
+    data->width = 4;
+    data->height = 3;
+    data->tileSize = {10.0f, 10.0f};
+    data->tiles = {0, 0, 0, 0,
+                   -1, -1, 3, -1,
+                   -1, -1, -1, -1};
+    return data;
+}
+
+ParticleEmitterConfig fallingConfig(ParticleCollisionResponse response) {
+    ParticleEmitterConfig config{};
+    config.spawnRate = 0.0f;
+    config.minLifeTime = 10.0f;
+    config.maxLifeTime = 10.0f;
+    config.minSpeed = 0.0f;
+    config.maxSpeed = 0.0f;
+    config.gravity = {0.0f, -600.0f};
+    config.collisionResponse = response;
+    config.restitution = 0.5f;
+    config.collisionFriction = 0.0f;
+    return config;
+}
+
+void runFor(ParticleEmitter& emitter, float seconds) {
+    for (float elapsed = 0.0f; elapsed < seconds; elapsed += kStep) {
+        emitter.update(kStep);
+    }
+}
+}
+
+BOOST_AUTO_TEST_SUITE(ParticleCollisionTests)
+
+BOOST_AUTO_TEST_CASE(tile_layers_are_solid_where_tiles_are_set) {
+    ParticleCollisionWorld world;
+    BOOST_TEST(world.empty());
+    world.addTileLayer(floorTiles(), {100.0f, 0.0f}, {2.0f, 1.0f});
+    BOOST_TEST(world.tileLayerCount() == 1u);
+    BOOST_TEST(world.solidAt({101.0f, 5.0f}));
+    BOOST_TEST(world.solidAt({179.0f, 9.0f}));
+    BOOST_TEST(!world.solidAt({101.0f, 15.0f}));
+    BOOST_TEST(world.solidAt({145.0f, 15.0f}));
+    BOOST_TEST(!world.solidAt({99.0f, 5.0f}));
+    BOOST_TEST(!world.solidAt({181.0f, 5.0f}));
+    BOOST_TEST(!world.solidAt({150.0f, -1.0f}));
+
+    auto broken = floorTiles();
+    broken->tileSize = {0.0f, 10.0f};
+    BOOST_CHECK_THROW(world.addTileLayer(broken, {0.0f, 0.0f}), Engine::ParticleException);
+    world.clearTileLayers();
+    BOOST_TEST(world.empty());
+}
+
+BOOST_AUTO_TEST_CASE(static_boxes_are_found_through_the_grid) {
+    ParticleCollisionWorld world(16.0f);
+    const std::vector<glm::vec4> boxes{{0.0f, 0.0f, 100.0f, 10.0f},
+                                       {-500.0f, 200.0f, -480.0f, 260.0f},
+                                       {40.0f, 40.0f, 41.0f, 41.0f}};
+    world.setBoxes(boxes);
+    BOOST_TEST(world.boxCount() == 3u);
+    BOOST_TEST(world.solidAt({50.0f, 5.0f}));
+    BOOST_TEST(world.solidAt({-490.0f, 259.0f}));
+    BOOST_TEST(world.solidAt({40.5f, 40.5f}));
+    BOOST_TEST(!world.solidAt({50.0f, 11.0f}));
+    BOOST_TEST(!world.solidAt({-470.0f, 230.0f}));
+    BOOST_TEST(!world.solidAt({1000.0f, 5.0f}));
+
+    const std::vector<glm::vec4> inverted{{10.0f, 0.0f, 0.0f, 10.0f}};
+    BOOST_CHECK_THROW(world.setBoxes(inverted), Engine::ParticleException);
+    world.setBoxes({});
+    BOOST_TEST(!world.solidAt({50.0f, 5.0f}));
+}
+
+BOOST_AUTO_TEST_CASE(bouncing_particles_rest_on_the_floor) {
+    ParticleCollisionWorld world;
+    world.addTileLayer(floorTiles(), {0.0f, 0.0f});
+    ParticleEmitter emitter{8, fallingConfig(ParticleCollisionResponse::Bounce)};
+    emitter.setCollisionWorld(&world);
+    emitter.setPosition({5.0f, 25.0f});
+    emitter.burst(1);
+
+    float highestAfterFirstBounce = 0.0f;
+    bool bounced = false;
+    for (int step = 0; step < 180; ++step) {
+        emitter.update(kStep);
+        const glm::vec2 position = emitter.particles().position(0);
+        BOOST_TEST(position.y >= 10.0f);
+        const glm::vec2 velocity = emitter.particles().particle(0).velocity;
+        bounced = bounced || velocity.y > 0.0f;
+        if (bounced) {
+            highestAfterFirstBounce = std::max(highestAfterFirstBounce, position.y);
+        }
+    }
+    BOOST_TEST(bounced);
+    BOOST_TEST(highestAfterFirstBounce < 25.0f);
+}
+
+BOOST_AUTO_TEST_CASE(bouncing_off_a_wall_reflects_only_the_blocked_axis) {
+    ParticleCollisionWorld world;
+    const std::vector<glm::vec4> wall{{20.0f, -100.0f, 30.0f, 100.0f}};
+    world.setBoxes(wall);
+    auto config = fallingConfig(ParticleCollisionResponse::Bounce);
+    config.gravity = {0.0f, 0.0f};
+    config.minSpeed = 300.0f;
+    config.maxSpeed = 300.0f;
+    config.direction = 0.5f;
+    config.spread = 0.0f;
+    config.collisionFriction = 0.5f;
+    ParticleEmitter emitter{8, config};
+    emitter.setCollisionWorld(&world);
+    emitter.burst(1);
+    const glm::vec2 launch = emitter.particles().particle(0).velocity;
+
+    runFor(emitter, 0.2f);
+    const glm::vec2 velocity = emitter.particles().particle(0).velocity;
+    BOOST_TEST(velocity.x == -launch.x * 0.5f, boost::test_tools::tolerance(0.001f));
+    BOOST_TEST(velocity.y == launch.y * 0.5f, boost::test_tools::tolerance(0.001f));
+    BOOST_TEST(emitter.particles().position(0).x < 20.0f);
+}
+
+BOOST_AUTO_TEST_CASE(stick_and_kill_responses) {
+    ParticleCollisionWorld world;
+    world.addTileLayer(floorTiles(), {0.0f, 0.0f});
+
+    ParticleEmitter sticky{8, fallingConfig(ParticleCollisionResponse::Stick)};
+    sticky.setCollisionWorld(&world);
+    sticky.setPosition({5.0f, 25.0f});
+    sticky.burst(1);
+    runFor(sticky, 1.0f);
+    BOOST_TEST(sticky.liveParticleCount() == 1u);
+    BOOST_TEST(sticky.particles().position(0).y >= 10.0f);
+    BOOST_TEST(sticky.particles().position(0).y < 12.0f);
+
+    ParticleEmitter doomed{8, fallingConfig(ParticleCollisionResponse::Kill)};
+    doomed.setCollisionWorld(&world);
+    doomed.setPosition({5.0f, 25.0f});
+    doomed.burst(4);
+    runFor(doomed, 1.0f);
+    BOOST_TEST(doomed.isFinished());
+
+    // Collision is opt-in: without a response the world is ignored.
+    ParticleEmitter ghost{8, fallingConfig(ParticleCollisionResponse::None)};
+    ghost.setCollisionWorld(&world);
+    ghost.setPosition({5.0f, 25.0f});
+    ghost.burst(1);
+    runFor(ghost, 1.0f);
+    BOOST_TEST(ghost.particles().position(0).y < 0.0f);
+}
+
+BOOST_AUTO_TEST_CASE(config_validates_collision_coefficients) {
+    auto config = fallingConfig(ParticleCollisionResponse::Bounce);
+    config.restitution = 1.5f;
+    BOOST_CHECK_THROW(validateParticleEmitterConfig(8, config), Engine::ParticleException);
+    config.restitution = 0.5f;
+    config.collisionFriction = -0.1f;
+    BOOST_CHECK_THROW(validateParticleEmitterConfig(8, config), Engine::ParticleException);
+}
+
+BOOST_AUTO_TEST_CASE(ecs_emitters_collide_with_the_given_world) {
+    ECS::Registry registry;
+    ParticleCollisionWorld world;
+    const std::vector<glm::vec4> floor{{-50.0f, -10.0f, 50.0f, 0.0f}};
+    world.setBoxes(floor);
+    const ECS::Entity entity = registry.create();
+    registry.emplace<ECS::Transform2D>(entity).position = {0.0f, 20.0f};
+    auto& particles = registry.emplace<ECS::ParticleEmitter2D>(
+        entity, 16, fallingConfig(ParticleCollisionResponse::Stick));
+    particles.requestBurst(3);
+
+    for (int step = 0; step < 60; ++step) {
+        ECS::ParticleSystem2D::update(registry, kStep, nullptr, std::nullopt, nullptr, &world);
+    }
+    const ParticleEmitter& emitter = registry.tryGet<ECS::ParticleEmitter2D>(entity)->emitter;
+    BOOST_TEST(emitter.collisionWorld() == &world);
+    BOOST_TEST(emitter.liveParticleCount() == 3u);
+    for (std::size_t i = 0; i < emitter.liveParticleCount(); ++i) {
+        BOOST_TEST(emitter.particles().position(i).y >= 0.0f);
+        BOOST_TEST(emitter.particles().position(i).y < 2.0f);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(scene_rebuilds_particle_collision_only_when_needed) {
+    Scene scene;
+    ECS::Registry& registry = scene.registry();
+    const ParticleCollisionWorld& world = scene.particleCollisionWorld();
+    const auto addStatic = [&registry](const glm::vec2& position) {
+        const ECS::Entity entity = registry.create();
+        registry.emplace<ECS::Transform2D>(entity).position = position;
+        registry.emplace<ECS::AabbCollider2D>(entity).halfExtents = {5.0f, 5.0f};
+        registry.emplace<ECS::StaticCollider2D>(entity);
+        return entity;
+    };
+    const ECS::Entity wall = addStatic({0.0f, 0.0f});
+
+    // No emitter collides yet, so nothing is built.
+    const ECS::Entity emitter = registry.create();
+    registry.emplace<ECS::Transform2D>(emitter).position = {0.0f, 50.0f};
+    registry.emplace<ECS::ParticleEmitter2D>(emitter, 16, fallingConfig(ParticleCollisionResponse::None));
+    scene.update(kStep);
+    BOOST_TEST(world.empty());
+
+    registry.get<ECS::ParticleEmitter2D>(emitter).emitter.setConfig(
+        fallingConfig(ParticleCollisionResponse::Stick));
+    scene.update(kStep);
+    BOOST_TEST(world.boxCount() == 1u);
+    BOOST_TEST(world.solidAt({0.0f, 0.0f}));
+
+    // Moving a static collider directly needs an explicit invalidation.
+    registry.get<ECS::Transform2D>(wall).position = {100.0f, 0.0f};
+    scene.update(kStep);
+    BOOST_TEST(world.solidAt({0.0f, 0.0f}));
+    scene.invalidateParticleCollision();
+    scene.update(kStep);
+    BOOST_TEST(!world.solidAt({0.0f, 0.0f}));
+    BOOST_TEST(world.solidAt({100.0f, 0.0f}));
+
+    // Moving platforms and new colliders are picked up by themselves.
+    registry.emplace<ECS::SurfaceVelocity2D>(wall).velocity = {60.0f, 0.0f};
+    scene.update(kStep);
+    BOOST_TEST(world.solidAt({105.5f, 0.0f}));
+    registry.remove<ECS::SurfaceVelocity2D>(wall);
+    addStatic({-100.0f, 0.0f});
+    scene.update(kStep);
+    BOOST_TEST(world.boxCount() == 2u);
+    BOOST_TEST(world.solidAt({-100.0f, 0.0f}));
+
+    // Legacy tilemaps are found on their first step and dropped with their entity.
+    Entity& map = scene.createEntity();
+    map.addComponent<TransformComponent>().setPosition({-300.0f, -300.0f});
+    map.addComponent<TilemapComponent>(floorTiles(), 0, true);
+    scene.update(kStep);
+    BOOST_TEST(world.tileLayerCount() == 1u);
+    BOOST_TEST(world.solidAt({-295.0f, -295.0f}));
+    map.getComponent<TransformComponent>()->setPosition({-400.0f, -300.0f});
+    scene.update(kStep);
+    BOOST_TEST(world.solidAt({-395.0f, -295.0f}));
+    // Resizing the tile data in place reallocates the tiles the layer reads.
+    const auto data = map.getComponent<TilemapComponent>()->data();
+    data->width = 8;
+    data->tiles.assign(24, -1);
+    data->tiles[6] = 0;
+    scene.update(kStep);
+    BOOST_TEST(!world.solidAt({-395.0f, -295.0f}));
+    BOOST_TEST(world.solidAt({-335.0f, -295.0f}));
+    scene.destroyEntity(map);
+    scene.update(kStep);
+    BOOST_TEST(world.tileLayerCount() == 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
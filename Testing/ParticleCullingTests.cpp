@@ -0,0 +1,171 @@
+#include <boost/test/unit_test.hpp>
+
+#include "ECS/Components/ParticleEmitter2D.hpp"
+#include "ECS/Components/Transform2D.hpp"
+#include "ECS/Registry.hpp"
+#include "ECS/Systems/ParticleSystem2D.hpp"
+#include "ParticleSystem/ParticleEmitter.hpp"
+
+#include <stdexcept>
+
+namespace {
+constexpr float kStep = 1.0f / 60.0f;
+const glm::vec4 kNearView{-100.0f, -100.0f, 100.0f, 100.0f};
+const glm::vec4 kFarView{50000.0f, 50000.0f, 50100.0f, 50100.0f};
+
+ParticleEmitterConfig fountainConfig() {
+    ParticleEmitterConfig config{};
+    config.spawnRate = 120.0f;
+    config.minLifeTime = 0.5f;
+    config.maxLifeTime = 1.0f;
+    config.minSpeed = 20.0f;
+    config.maxSpeed = 80.0f;
+    config.gravity = {0.0f, -150.0f};
+    config.orbitStrength = 30.0f;
+    config.endSizeMultiplier = 2.0f;
+    config.randomSeed = 99;
+    return config;
+}
+
+bool contains(const glm::vec4& bounds, const glm::vec2& point) {
+    return point.x >= bounds.x && point.x <= bounds.z &&
+           point.y >= bounds.y && point.y <= bounds.w;
+}
+
+ECS::Entity addEmitter(ECS::Registry& registry, const glm::vec2& position) {
+    const ECS::Entity entity = registry.create();
+    registry.emplace<ECS::Transform2D>(entity).position = position;
+    registry.emplace<ECS::ParticleEmitter2D>(entity, 512, fountainConfig());
+    return entity;
+}
+
+const ParticlePool& particlesOf(ECS::Registry& registry, ECS::Entity entity) {
+    return registry.tryGet<ECS::ParticleEmitter2D>(entity)->emitter.particles();
+}
+}
+
+BOOST_AUTO_TEST_SUITE(ParticleCullingTests)
+
+BOOST_AUTO_TEST_CASE(simulation_bounds_contain_moving_emitter_particles) {
+    ParticleEmitter emitter{512, fountainConfig()};
+    emitter.setTarget({40.0f, 0.0f});
+    for (int step = 0; step < 240; ++step) {
+        emitter.setPosition({static_cast<float>(step) * 3.0f, 0.0f});
+        emitter.update(kStep);
+        const glm::vec4 bounds = emitter.simulationBounds();
+        for (std::size_t i = 0; i < emitter.liveParticleCount(); ++i) {
+            BOOST_REQUIRE(contains(bounds, emitter.particles().position(i)));
+        }
+    }
+    // Spawns older than a lifetime no longer widen the bounds.
+    BOOST_TEST(emitter.simulationBounds().x > 0.0f);
+}
+
+BOOST_AUTO_TEST_CASE(short_offscreen_spans_fast_forward_exactly) {
+    ECS::Registry reference;
+    ECS::Registry culled;
+    const ECS::Entity expected = addEmitter(reference, {0.0f, 0.0f});
+    const ECS::Entity actual = addEmitter(culled, {0.0f, 0.0f});
+
+    for (int step = 0; step < 30; ++step) {
+        ECS::ParticleSystem2D::update(reference, kStep);
+        const auto stats = ECS::ParticleSystem2D::update(culled, kStep, nullptr, kFarView);
+        BOOST_REQUIRE(stats.culled == 1u);
+        BOOST_REQUIRE(stats.simulated == 0u);
+    }
+    ECS::ParticleSystem2D::update(reference, kStep);
+    auto stats = ECS::ParticleSystem2D::update(culled, kStep, nullptr, kNearView);
+    BOOST_TEST(stats.simulated == 1u);
+    BOOST_TEST(stats.fastForwarded == 1u);
+    // The 30 skipped steps and this one are replayed a few per update.
+    const auto& component = *culled.tryGet<ECS::ParticleEmitter2D>(actual);
+    BOOST_TEST(component.emitter.skippedSteps() == 31u - component.fastForwardStepsPerUpdate);
+
+    int updates = 1;
+    while (component.emitter.hasSkippedTime()) {
+        ECS::ParticleSystem2D::update(reference, kStep);
+        stats = ECS::ParticleSystem2D::update(culled, kStep, nullptr, kNearView);
+        BOOST_REQUIRE(stats.fastForwarded == 1u);
+        BOOST_REQUIRE(++updates < 10);
+    }
+
+    const ParticlePool& a = particlesOf(reference, expected);
+    const ParticlePool& b = particlesOf(culled, actual);
+    BOOST_REQUIRE(a.size() == b.size());
+    BOOST_REQUIRE(a.size() > 0u);
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        BOOST_TEST((a.particle(i).position == b.particle(i).position));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(long_offscreen_spans_replay_only_the_last_lifetime) {
+    ECS::Registry first;
+    ECS::Registry second;
+    const ECS::Entity a = addEmitter(first, {0.0f, 0.0f});
+    const ECS::Entity b = addEmitter(second, {0.0f, 0.0f});
+    for (ECS::Registry* registry : {&first, &second}) {
+        for (int step = 0; step < 600; ++step) {
+            ECS::ParticleSystem2D::update(*registry, kStep, nullptr, kFarView);
+        }
+        while (ECS::ParticleSystem2D::update(*registry, kStep, nullptr, kNearView)
+                   .fastForwarded > 0) {
+        }
+    }
+
+    // Steady state holds roughly spawnRate * mean lifetime particles.
+    const ParticlePool& pool = particlesOf(first, a);
+    BOOST_TEST(pool.size() > 60u);
+    BOOST_TEST(pool.size() < 120u);
+    BOOST_REQUIRE(pool.size() == particlesOf(second, b).size());
+    for (std::size_t i = 0; i < pool.size(); ++i) {
+        BOOST_TEST((pool.particle(i).position == particlesOf(second, b).particle(i).position));
+        BOOST_TEST(pool.particle(i).age <= 1.0f);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(offscreen_transient_emitters_still_expire) {
+    ECS::Registry registry;
+    const ECS::Entity entity = addEmitter(registry, {0.0f, 0.0f});
+    auto& component = *registry.tryGet<ECS::ParticleEmitter2D>(entity);
+    component.emitting = false;
+    component.autoDestroyWhenFinished = true;
+    component.requestBurst(20);
+    ECS::ParticleSystem2D::update(registry, kStep);
+
+    for (int step = 0; step < 70 && registry.alive(entity); ++step) {
+        ECS::ParticleSystem2D::update(registry, kStep, nullptr, kFarView);
+    }
+    BOOST_TEST(!registry.alive(entity));
+
+    const ECS::Entity optedOut = addEmitter(registry, {0.0f, 0.0f});
+    registry.tryGet<ECS::ParticleEmitter2D>(optedOut)->cullWhenOffscreen = false;
+    const auto stats = ECS::ParticleSystem2D::update(registry, kStep, nullptr, kFarView);
+    BOOST_TEST(stats.simulated == 1u);
+    BOOST_TEST(stats.culled == 0u);
+}
+
+BOOST_AUTO_TEST_CASE(fast_forward_steps_per_update_still_gains_on_the_backlog) {
+    ECS::Registry registry;
+    const ECS::Entity slow = addEmitter(registry, {0.0f, 0.0f});
+    const ECS::Entity stalled = addEmitter(registry, {0.0f, 0.0f});
+    for (int step = 0; step < 10; ++step) {
+        ECS::ParticleSystem2D::update(registry, kStep, nullptr, kFarView);
+    }
+    auto& slowParticles = *registry.tryGet<ECS::ParticleEmitter2D>(slow);
+    auto& stalledParticles = *registry.tryGet<ECS::ParticleEmitter2D>(stalled);
+    slowParticles.fastForwardStepsPerUpdate = 1;
+    stalledParticles.fastForwardStepsPerUpdate = 0;
+
+    // Both replay two steps per update, one more than each update adds.
+    const auto stats = ECS::ParticleSystem2D::update(registry, kStep, nullptr, kNearView);
+    BOOST_TEST(stats.fastForwarded == 2u);
+    BOOST_TEST(slowParticles.emitter.skippedSteps() == 9u);
+    BOOST_TEST(stalledParticles.emitter.skippedSteps() == 9u);
+    for (int step = 0; step < 9; ++step) {
+        ECS::ParticleSystem2D::update(registry, kStep, nullptr, kNearView);
+    }
+    BOOST_TEST(!slowParticles.emitter.hasSkippedTime());
+    BOOST_TEST(!stalledParticles.emitter.hasSkippedTime());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
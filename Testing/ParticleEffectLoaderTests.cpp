@@ -58,4 +58,20 @@ BOOST_AUTO_TEST_CASE(rejects_wrong_vector_shapes_instead_of_hiding_them) {
     std::filesystem::remove(path);
 }
 
+BOOST_AUTO_TEST_CASE(loads_budget_priority_by_name) {
+    const auto path = writeParticleDocument(
+        R"([{"name":"hit","priority":"high"},{"name":"dust"}])", "priority");
+    const auto effects = ParticleEffectLoader::loadFromFile(path.string());
+    std::filesystem::remove(path);
+    BOOST_REQUIRE_EQUAL(effects.size(), 2u);
+    BOOST_TEST((effects[0].priority == ParticlePriority::High));
+    BOOST_TEST((effects[1].priority == ParticlePriority::Normal));
+
+    const auto bad = writeParticleDocument(
+        R"([{"name":"bad","priority":2}])", "bad_priority");
+    BOOST_CHECK_THROW(ParticleEffectLoader::loadFromFile(bad.string()),
+                      Engine::ParticleException);
+    std::filesystem::remove(bad);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,129 @@
+#include <boost/test/unit_test.hpp>
+
+#include "ParticleSystem/ParticleEmitter.hpp"
+#include "ParticleSystem/ParticlePool.hpp"
+
+#include <cmath>
+#include <set>
+
+namespace {
+Particle makeParticle(float x, float lifeTime) {
+    Particle particle{};
+    particle.position = {x, 0.0f};
+    particle.velocity = {1.0f, 2.0f};
+    particle.angularVelocity = 0.5f;
+    particle.lifeTime = lifeTime;
+    particle.size = 4.0f;
+    particle.initialSize = 4.0f;
+    return particle;
+}
+}
+
+BOOST_AUTO_TEST_SUITE(ParticlePoolTests)
+
+BOOST_AUTO_TEST_CASE(vector_and_tail_lanes_integrate_identically) {
+    // 19 particles cover full AVX2/SSE vectors plus a scalar tail.
+    ParticlePool pool(32);
+    for (int i = 0; i < 19; ++i) {
+        BOOST_REQUIRE(pool.push(makeParticle(static_cast<float>(i), 10.0f)));
+    }
+    ParticleStepParams step{};
+    step.gravity = {0.0f, -10.0f};
+    step.dragFactor = 0.5f;
+    step.startColor = {1.0f, 1.0f, 1.0f, 1.0f};
+    step.endColor = {0.0f, 0.5f, 1.0f, 0.0f};
+    step.endSizeMultiplier = 0.0f;
+    BOOST_TEST(pool.update(step, 1.0f) == 0u);
+
+    for (std::size_t i = 0; i < pool.size(); ++i) {
+        const Particle particle = pool.particle(i);
+        BOOST_TEST(particle.velocity.x == 0.5f);
+        BOOST_TEST(particle.velocity.y == -4.0f);
+        BOOST_TEST(particle.position.x == static_cast<float>(i) + 0.5f);
+        BOOST_TEST(particle.rotation == 0.5f);
+        BOOST_TEST(particle.color.g == 0.95f, boost::test_tools::tolerance(1e-6f));
+        BOOST_TEST(particle.color.a == 0.9f, boost::test_tools::tolerance(1e-6f));
+        BOOST_TEST(particle.size == 3.6f, boost::test_tools::tolerance(1e-6f));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(expired_particles_are_swap_removed) {
+    ParticlePool pool(16);
+    for (int i = 0; i < 10; ++i) {
+        pool.push(makeParticle(static_cast<float>(i), i % 3 == 0 ? 0.5f : 5.0f));
+    }
+    BOOST_TEST(pool.update(ParticleStepParams{}, 1.0f) == 4u);
+    BOOST_REQUIRE(pool.size() == 6u);
+
+    std::set<float> survivors;
+    for (std::size_t i = 0; i < pool.size(); ++i) {
+        BOOST_TEST(pool.particle(i).lifeTime == 5.0f);
+        survivors.insert(pool.particle(i).position.x - 1.0f);
+    }
+    BOOST_TEST(survivors == (std::set<float>{1.0f, 2.0f, 4.0f, 5.0f, 7.0f, 8.0f}));
+}
+
+BOOST_AUTO_TEST_CASE(steering_skips_particles_at_the_target) {
+    ParticlePool pool(8);
+    for (int i = 0; i < 5; ++i) {
+        Particle particle = makeParticle(0.0f, 10.0f);
+        particle.position = {i == 0 ? 0.0f : 10.0f, 0.0f};
+        particle.velocity = {0.0f, 0.0f};
+        pool.push(particle);
+    }
+    ParticleStepParams step{};
+    step.homingStrength = 2.0f;
+    step.orbitStrength = 1.0f;
+    pool.update(step, 1.0f);
+
+    const Particle atTarget = pool.particle(0);
+    BOOST_TEST(atTarget.velocity.x == 0.0f);
+    BOOST_TEST(atTarget.velocity.y == 0.0f);
+    const Particle steered = pool.particle(4);
+    // Homing pulls toward the origin; orbit pushes along the tangent.
+    BOOST_TEST(steered.velocity.x == -2.0f);
+    BOOST_TEST(steered.velocity.y == -1.0f);
+}
+
+BOOST_AUTO_TEST_CASE(full_pool_rejects_spawns) {
+    ParticleEmitterConfig config{};
+    config.spawnRate = 0.0f;
+    ParticleEmitter emitter{3, config};
+    emitter.burst(10);
+    BOOST_TEST(emitter.liveParticleCount() == 3u);
+    BOOST_TEST(emitter.particles().full());
+
+    ParticlePool pool(1);
+    BOOST_TEST(pool.push(makeParticle(0.0f, 1.0f)));
+    BOOST_TEST(!pool.push(makeParticle(0.0f, 1.0f)));
+    pool.clear();
+    BOOST_TEST(pool.empty());
+}
+
+BOOST_AUTO_TEST_CASE(render_columns_view_the_live_particles) {
+    ParticlePool pool(8);
+    for (int i = 0; i < 3; ++i) {
+        Particle particle = makeParticle(static_cast<float>(i), i == 1 ? 0.5f : 10.0f);
+        particle.color = {0.1f * static_cast<float>(i), 0.2f, 0.3f, 0.4f};
+        pool.push(particle);
+    }
+    ParticleStepParams fade{};
+    fade.startColor = {1.0f, 0.5f, 0.25f, 1.0f};
+    fade.endColor = fade.startColor;
+    pool.update(fade, 1.0f);
+
+    const ParticleRenderColumns columns = pool.renderColumns();
+    BOOST_REQUIRE(columns.count == 2u);
+    for (std::size_t i = 0; i < columns.count; ++i) {
+        BOOST_TEST(columns.positionX[i] == pool.position(i).x);
+        BOOST_TEST(columns.positionY[i] == pool.position(i).y);
+        BOOST_TEST(columns.size[i] == pool.particleSize(i));
+        BOOST_TEST(columns.rotation[i] == pool.rotation(i));
+        BOOST_TEST((glm::vec4(columns.red[i], columns.green[i], columns.blue[i],
+                              columns.alpha[i]) == pool.color(i)));
+    }
+    BOOST_TEST(columns.green[1] == 0.5f);
+    BOOST_TEST(ParticlePool(0).renderColumns().count == 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
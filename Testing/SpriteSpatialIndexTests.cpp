@@ -0,0 +1,133 @@
+#include <boost/test/unit_test.hpp>
+
+#include "Engine/Scene.hpp"
+#include "GameObjects/Components/RigidBodyComponent.hpp"
+#include "GameObjects/Components/SpriteComponent.hpp"
+#include "GameObjects/Components/TransformComponent.hpp"
+#include "GameObjects/Sprite.hpp"
+#include "Physics/RigidBody.hpp"
+#include "RenderingSystem/SpriteSpatialIndex.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+using Handle = Rendering::SpriteSpatialIndex::Handle;
+
+std::vector<Handle> queryIndex(const Rendering::SpriteSpatialIndex& index,
+                               const glm::vec4& bounds) {
+    std::vector<Handle> hits;
+    index.query(bounds, hits);
+    std::sort(hits.begin(), hits.end());
+    return hits;
+}
+
+Entity& addSpriteEntity(Scene& scene, const glm::vec2& position) {
+    Entity& entity = scene.createEntity();
+    entity.addComponent<TransformComponent>().setPosition(position);
+    entity.addComponent<SpriteComponent>(std::make_shared<GameObjects::Sprite>(
+        glm::vec2{0.0f}, glm::vec2{10.0f, 10.0f}, glm::vec3{1.0f}));
+    return entity;
+}
+
+std::vector<const Entity*> visibleEntities(Scene& scene, const glm::vec4& view) {
+    scene.refreshSpriteIndex();
+    std::vector<Handle> hits;
+    scene.spriteIndex().query(view, hits);
+    std::vector<const Entity*> entities;
+    for (const Handle handle : hits) {
+        entities.push_back(scene.spriteIndexRecord(handle).entity);
+    }
+    return entities;
+}
+}
+
+BOOST_AUTO_TEST_SUITE(SpriteSpatialIndexTests)
+
+BOOST_AUTO_TEST_CASE(query_reports_overlapping_entries_once) {
+    Rendering::SpriteSpatialIndex index(100.0f);
+    const Handle spanning = index.insert({90.0f, 90.0f, 210.0f, 110.0f});
+    const Handle far = index.insert({5000.0f, 5000.0f, 5010.0f, 5010.0f});
+
+    const auto hits = queryIndex(index, {0.0f, 0.0f, 300.0f, 300.0f});
+    BOOST_REQUIRE(hits.size() == 1u);
+    BOOST_TEST(hits[0] == spanning);
+    BOOST_TEST(queryIndex(index, {4990.0f, 4990.0f, 5001.0f, 5001.0f}).front() == far);
+    // Cell neighbours that do not overlap the exact bounds are rejected.
+    BOOST_TEST(queryIndex(index, {0.0f, 0.0f, 50.0f, 50.0f}).empty());
+}
+
+BOOST_AUTO_TEST_CASE(update_rebins_and_remove_recycles_handles) {
+    Rendering::SpriteSpatialIndex index(64.0f);
+    const Handle handle = index.insert({0.0f, 0.0f, 8.0f, 8.0f});
+    index.update(handle, {1000.0f, 0.0f, 1008.0f, 8.0f});
+
+    BOOST_TEST(queryIndex(index, {0.0f, 0.0f, 16.0f, 16.0f}).empty());
+    BOOST_TEST(queryIndex(index, {990.0f, 0.0f, 1010.0f, 10.0f}).size() == 1u);
+
+    index.remove(handle);
+    BOOST_TEST(index.empty());
+    BOOST_TEST(index.occupiedCells() == 0u);
+    BOOST_TEST(!index.contains(handle));
+    BOOST_TEST(index.insert({0.0f, 0.0f, 1.0f, 1.0f}) == handle);
+    BOOST_CHECK_THROW(index.update(Handle{7}, {0.0f, 0.0f, 1.0f, 1.0f}),
+                      std::out_of_range);
+}
+
+BOOST_AUTO_TEST_CASE(oversized_entries_skip_the_grid) {
+    Rendering::SpriteSpatialIndex index(10.0f, /*maxCellsPerEntry=*/4);
+    const Handle backdrop = index.insert({-500.0f, -500.0f, 500.0f, 500.0f});
+    BOOST_TEST(index.oversizedCount() == 1u);
+    BOOST_TEST(index.occupiedCells() == 0u);
+    BOOST_TEST(queryIndex(index, {400.0f, 400.0f, 401.0f, 401.0f}).front() == backdrop);
+    BOOST_CHECK_THROW(index.insert({1.0f, 0.0f, 0.0f, 1.0f}), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(scene_indexes_sprites_added_after_entity_creation) {
+    Scene scene;
+    Entity& visible = addSpriteEntity(scene, {0.0f, 0.0f});
+    addSpriteEntity(scene, {10000.0f, 0.0f});
+    Entity& late = scene.createEntity();
+    late.addComponent<TransformComponent>().setPosition({20.0f, 0.0f});
+
+    auto entities = visibleEntities(scene, {-50.0f, -50.0f, 50.0f, 50.0f});
+    BOOST_REQUIRE(entities.size() == 1u);
+    BOOST_TEST(entities[0] == &visible);
+
+    late.addComponent<SpriteComponent>(std::make_shared<GameObjects::Sprite>(
+        glm::vec2{0.0f}, glm::vec2{4.0f, 4.0f}, glm::vec3{1.0f}));
+    BOOST_TEST(visibleEntities(scene, {-50.0f, -50.0f, 50.0f, 50.0f}).size() == 2u);
+
+    scene.destroyEntity(visible);
+    BOOST_TEST(visibleEntities(scene, {-50.0f, -50.0f, 50.0f, 50.0f}).size() == 1u);
+    scene.clear();
+    BOOST_TEST(scene.spriteIndex().empty());
+}
+
+BOOST_AUTO_TEST_CASE(scene_tracks_mobile_sprites_and_invalidated_static_ones) {
+    Scene scene;
+    scene.configureFixedStep({1.0 / 128.0, 0.25, 16});
+    Entity& mover = addSpriteEntity(scene, {0.0f, 0.0f});
+    auto& moverTransform = *mover.getComponent<TransformComponent>();
+    auto body = std::make_unique<RigidBody>(1.0f, RigidBodyType::KINEMATIC);
+    body->setTransform(&moverTransform.getTransform());
+    mover.addComponent<RigidBodyComponent>(std::move(body));
+    Entity& decoration = addSpriteEntity(scene, {0.0f, 0.0f});
+
+    scene.refreshSpriteIndex();
+    moverTransform.setPosition({2000.0f, 0.0f});
+    decoration.getComponent<TransformComponent>()->setPosition({2000.0f, 0.0f});
+
+    // Mobile sprites follow their transform; static ones wait for invalidation.
+    const glm::vec4 destination{1990.0f, -10.0f, 2020.0f, 20.0f};
+    auto entities = visibleEntities(scene, destination);
+    BOOST_REQUIRE(entities.size() == 1u);
+    BOOST_TEST(entities[0] == &mover);
+
+    scene.invalidateSpriteBounds(decoration);
+    BOOST_TEST(visibleEntities(scene, destination).size() == 2u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,176 @@
+#include <boost/test/unit_test.hpp>
+
+#include "Engine/Scene.hpp"
+#include "GameObjects/Components/RigidBodyComponent.hpp"
+#include "GameObjects/Components/SpriteComponent.hpp"
+#include "GameObjects/Components/TransformComponent.hpp"
+#include "GameObjects/Sprite.hpp"
+#include "Physics/RigidBody.hpp"
+#include "RenderingSystem/StaticSpriteBatch.hpp"
+
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace {
+using Batch = Rendering::StaticSpriteBatch;
+
+Rendering::SpriteQuad makeQuad(const glm::vec2& origin, float size = 10.0f,
+                               GLuint texture = 1, int layer = 0, int zIndex = 0) {
+    Rendering::SpriteQuad quad{};
+    quad.textureId = texture;
+    quad.normalTextureId = 2;
+    quad.layer = layer;
+    quad.zIndex = zIndex;
+    const glm::vec2 corners[] = {{0.0f, size}, {size, size}, {size, 0.0f}, {0.0f, 0.0f}};
+    for (int i = 0; i < 4; ++i) {
+        quad.verts[i].position = origin + corners[i];
+        quad.verts[i].color = glm::vec4(1.0f);
+    }
+    return quad;
+}
+
+std::vector<std::pair<const Batch::ChunkKey*, Batch::Chunk*>>
+visibleChunks(Batch& batch, const glm::vec4& view) {
+    std::vector<std::pair<const Batch::ChunkKey*, Batch::Chunk*>> chunks;
+    batch.collectVisible(view, chunks);
+    return chunks;
+}
+
+Entity& addStaticSprite(Scene& scene, const glm::vec2& position) {
+    Entity& entity = scene.createEntity();
+    entity.addComponent<TransformComponent>().setPosition(position);
+    auto& sprite = entity.addComponent<SpriteComponent>(std::make_shared<GameObjects::Sprite>(
+        glm::vec2{0.0f}, glm::vec2{10.0f, 10.0f}, glm::vec3{1.0f}));
+    sprite.setStatic(true);
+    return entity;
+}
+}
+
+BOOST_AUTO_TEST_SUITE(StaticSpriteBatchTests)
+
+BOOST_AUTO_TEST_CASE(members_are_grouped_by_texture_and_chunk) {
+    Batch batch(100.0f);
+    batch.set(1, makeQuad({0.0f, 0.0f}));
+    batch.set(2, makeQuad({20.0f, 0.0f}));
+    batch.set(3, makeQuad({20.0f, 0.0f}, 10.0f, /*texture=*/5));
+    batch.set(4, makeQuad({500.0f, 0.0f}));
+
+    BOOST_TEST(batch.memberCount() == 4u);
+    BOOST_TEST(batch.chunkCount() == 3u);
+    BOOST_TEST(batch.dirtyChunkCount() == 3u);
+
+    const auto chunks = visibleChunks(batch, {-10.0f, -10.0f, 50.0f, 50.0f});
+    BOOST_REQUIRE(chunks.size() == 2u);
+    BOOST_TEST(chunks[0].first->textureId == 1u);
+    BOOST_TEST(chunks[1].first->textureId == 5u);
+
+    std::vector<Vertex> vertices;
+    std::vector<std::uint32_t> indices;
+    batch.buildGeometry(*chunks[0].second, vertices, indices);
+    BOOST_TEST(vertices.size() == 8u);
+    BOOST_REQUIRE(indices.size() == 12u);
+    BOOST_TEST(indices[6] == 4u);
+    BOOST_TEST(vertices[4].position.x == 20.0f);
+}
+
+BOOST_AUTO_TEST_CASE(chunks_iterate_in_layer_then_z_order) {
+    Batch batch;
+    batch.set(1, makeQuad({0.0f, 0.0f}, 10.0f, 1, /*layer=*/2, /*zIndex=*/0));
+    batch.set(2, makeQuad({0.0f, 0.0f}, 10.0f, 1, /*layer=*/1, /*zIndex=*/3));
+    batch.set(3, makeQuad({0.0f, 0.0f}, 10.0f, 9, /*layer=*/1, /*zIndex=*/-1));
+
+    const auto chunks = visibleChunks(batch, {-1.0f, -1.0f, 1.0f, 1.0f});
+    BOOST_REQUIRE(chunks.size() == 3u);
+    BOOST_TEST(chunks[0].first->zIndex == -1);
+    BOOST_TEST(chunks[1].first->zIndex == 3);
+    BOOST_TEST(chunks[2].first->layer == 2);
+}
+
+BOOST_AUTO_TEST_CASE(changes_dirty_only_the_affected_chunks) {
+    Batch batch(100.0f);
+    batch.set(1, makeQuad({0.0f, 0.0f}));
+    batch.set(2, makeQuad({30.0f, 0.0f}));
+    batch.set(3, makeQuad({400.0f, 0.0f}));
+    for (auto& [key, chunk] : visibleChunks(batch, {-1000.0f, -1000.0f, 1000.0f, 1000.0f})) {
+        chunk->dirty = false;
+    }
+
+    batch.set(3, makeQuad({410.0f, 0.0f}));
+    BOOST_TEST(batch.dirtyChunkCount() == 1u);
+
+    // Moving a member across cells dirties both chunks and shrinks the bounds
+    // of the one it left.
+    batch.set(2, makeQuad({420.0f, 0.0f}));
+    BOOST_TEST(batch.dirtyChunkCount() == 2u);
+    BOOST_TEST(visibleChunks(batch, {25.0f, 0.0f, 35.0f, 5.0f}).empty());
+
+    BOOST_TEST(batch.remove(1));
+    BOOST_TEST(!batch.remove(1));
+    BOOST_TEST(batch.chunkCount() == 1u);
+    BOOST_TEST(!batch.contains(1));
+}
+
+BOOST_AUTO_TEST_CASE(tagged_keys_are_counted_and_bad_quads_rejected) {
+    Batch batch;
+    batch.set(Batch::kTaggedKeyBit | 7u, makeQuad({0.0f, 0.0f}));
+    batch.set(Batch::kTaggedKeyBit | 7u, makeQuad({5000.0f, 0.0f}));
+    batch.set(8, makeQuad({0.0f, 0.0f}));
+    BOOST_TEST(batch.taggedMemberCount() == 1u);
+
+    BOOST_TEST(batch.removeIf([](std::uint64_t key) {
+        return (key & Batch::kTaggedKeyBit) != 0;
+    }) == 1u);
+    BOOST_TEST(batch.taggedMemberCount() == 0u);
+    BOOST_TEST(batch.memberCount() == 1u);
+
+    auto broken = makeQuad({0.0f, 0.0f});
+    broken.verts[2].position.x = std::numeric_limits<float>::infinity();
+    BOOST_CHECK_THROW(batch.set(9, broken), std::invalid_argument);
+    BOOST_CHECK_THROW(Batch(0.0f), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(scene_reports_static_sprite_changes) {
+    Scene scene;
+    Entity& decoration = addStaticSprite(scene, {0.0f, 0.0f});
+    Entity& plain = scene.createEntity();
+    plain.addComponent<TransformComponent>();
+    plain.addComponent<SpriteComponent>(std::make_shared<GameObjects::Sprite>(
+        glm::vec2{0.0f}, glm::vec2{4.0f, 4.0f}, glm::vec3{1.0f}));
+
+    scene.refreshSpriteIndex();
+    BOOST_TEST(scene.staticSpriteChanges().size() == 1u);
+    BOOST_TEST(scene.staticSpriteChanges().contains(decoration.getId()));
+    BOOST_REQUIRE(scene.staticSpriteRecord(decoration.getId()) != nullptr);
+    BOOST_TEST(scene.staticSpriteRecord(plain.getId()) == nullptr);
+    scene.clearStaticSpriteChanges();
+
+    // Gaining a moving body takes the sprite out of the static batch.
+    auto body = std::make_unique<RigidBody>(1.0f, RigidBodyType::KINEMATIC);
+    body->setTransform(&decoration.getComponent<TransformComponent>()->getTransform());
+    decoration.addComponent<RigidBodyComponent>(std::move(body));
+    scene.invalidateSpriteBounds(decoration);
+    scene.refreshSpriteIndex();
+    BOOST_TEST(scene.staticSpriteChanges().contains(decoration.getId()));
+    BOOST_TEST(scene.staticSpriteRecord(decoration.getId()) == nullptr);
+    scene.clearStaticSpriteChanges();
+
+    Entity& other = addStaticSprite(scene, {50.0f, 0.0f});
+    scene.refreshSpriteIndex();
+    scene.clearStaticSpriteChanges();
+    scene.requeueStaticSprites();
+    BOOST_TEST(scene.staticSpriteChanges().size() == 1u);
+    scene.clearStaticSpriteChanges();
+    scene.destroyEntity(other);
+    BOOST_TEST(scene.staticSpriteChanges().size() == 1u);
+
+    const auto epoch = scene.spriteIndexEpoch();
+    scene.clear();
+    BOOST_TEST(scene.spriteIndexEpoch() != epoch);
+    BOOST_TEST(scene.staticSpriteChanges().empty());
+    BOOST_TEST(Scene().spriteIndexEpoch() != scene.spriteIndexEpoch());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,49 @@
+#include <boost/test/unit_test.hpp>
+
+#include "GameObjects/Vertex.hpp"
+#include "RenderingSystem/VertexLayout.hpp"
+
+#include <cstring>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(VertexFormatTests)
+
+BOOST_AUTO_TEST_CASE(compact_vertex_quantizes_color_and_uv) {
+    const Vertex vertex{{12.5f, -3.0f}, {1.0f, 0.5f, 0.0f, 1.0f}, {0.25f, 1.0f}};
+    const CompactVertex compact = compactVertex(vertex);
+    BOOST_TEST(compact.position.x == 12.5f);
+    BOOST_TEST(compact.position.y == -3.0f);
+    BOOST_TEST(compact.color[0] == 255u);
+    BOOST_TEST(compact.color[1] == 128u);
+    BOOST_TEST(compact.color[2] == 0u);
+    BOOST_TEST(compact.uv[0] == 16384u);
+    BOOST_TEST(compact.uv[1] == 65535u);
+
+    // Out-of-range inputs clamp instead of wrapping.
+    const CompactVertex clamped = compactVertex({{0.0f, 0.0f}, {2.0f, -1.0f, 0.0f, 0.0f}, {1.5f, -0.5f}});
+    BOOST_TEST(clamped.color[0] == 255u);
+    BOOST_TEST(clamped.color[1] == 0u);
+    BOOST_TEST(clamped.uv[0] == 65535u);
+    BOOST_TEST(clamped.uv[1] == 0u);
+}
+
+BOOST_AUTO_TEST_CASE(append_vertices_encodes_the_selected_format) {
+    const Vertex quad[4] = {{{0.0f, 1.0f}, glm::vec4(1.0f), {0.0f, 1.0f}},
+                            {{1.0f, 1.0f}, glm::vec4(1.0f), {1.0f, 1.0f}},
+                            {{1.0f, 0.0f}, glm::vec4(1.0f), {1.0f, 0.0f}},
+                            {{0.0f, 0.0f}, glm::vec4(1.0f), {0.0f, 0.0f}}};
+    std::vector<std::byte> standard;
+    std::vector<std::byte> compact;
+    Rendering::appendVertices(Rendering::VertexFormat::Standard, quad, 4, standard);
+    Rendering::appendVertices(Rendering::VertexFormat::Compact, quad, 4, compact);
+    BOOST_TEST(standard.size() == 4u * sizeof(Vertex));
+    BOOST_TEST(compact.size() == 64u);
+    BOOST_TEST(Rendering::vertexStride(Rendering::VertexFormat::Compact) * 2u ==
+               Rendering::vertexStride(Rendering::VertexFormat::Standard));
+
+    CompactVertex second{};
+    std::memcpy(&second, compact.data() + sizeof(CompactVertex), sizeof(CompactVertex));
+    BOOST_TEST((second == compactVertex(quad[1])));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
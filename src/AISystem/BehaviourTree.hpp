@@ -37,6 +37,7 @@ inline std::ostream& operator<<(std::ostream& os, const NodeStatus status) {
 }
 
 template<typename TContext> class BehaviourTree;
+template<typename TContext> class CompiledBehaviourTree;
 
 template<typename TContext>
 class BTNode {
@@ -61,6 +62,7 @@ public:
 
 private:
     friend class BehaviourTree<TContext>;
+    friend class CompiledBehaviourTree<TContext>;
     explicit BTNode(NodeType type) : m_type(type) {}
 
     NodeType m_type;
@@ -105,6 +107,8 @@ public:
     void reset();
 
 private:
+    friend class CompiledBehaviourTree<TContext>;
+
     NodeStatus tickNode(Node& node, TContext* ctx, float dt);
     static void resetNode(Node& node);
 
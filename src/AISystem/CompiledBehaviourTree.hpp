@@ -0,0 +1,124 @@
+#ifndef COMPILED_BEHAVIOUR_TREE_HPP
+#define COMPILED_BEHAVIOUR_TREE_HPP
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "BehaviourTree.hpp"
+
+namespace AI {
+
+// Runtime state of one compiled tree for many agents: each agent owns a
+// fixed run of plain slots (running composite children and repeater counts,
+// then cooldown timers), stored agent after agent. Create it with
+// CompiledBehaviourTree::makeStates() and only tick it with that tree.
+class BTAgentStates {
+public:
+    BTAgentStates() = default;
+
+    [[nodiscard]] std::size_t agentCount() const noexcept { return m_agents; }
+    [[nodiscard]] std::size_t slotsPerAgent() const noexcept { return m_indexSlots + m_timerSlots; }
+
+    // Keeps existing agents' state; added agents start reset.
+    void resize(std::size_t agents);
+    void reset(std::size_t agent);
+    void resetAll() noexcept;
+
+private:
+    template<typename> friend class CompiledBehaviourTree;
+
+    BTAgentStates(std::size_t indexSlots, std::size_t timerSlots, std::size_t agents)
+        : m_indexSlots(indexSlots), m_timerSlots(timerSlots) {
+        resize(agents);
+    }
+
+    std::size_t m_indexSlots{0};
+    std::size_t m_timerSlots{0};
+    std::size_t m_agents{0};
+    // One past the node index of a composite's running child (0 for none),
+    // or a repeater's completed cycles.
+    std::vector<std::int32_t> m_indices;
+    std::vector<float> m_timers;
+};
+
+// Immutable, flattened copy of a BehaviourTree for ticking many agents with
+// one definition. Nodes are stored contiguously in depth-first order, each
+// knowing where its subtree ends, so children are visited by walking forward
+// through the array; leaf callbacks sit in their own table. All runtime state
+// lives in a BTAgentStates, so one compiled tree serves any number of agents
+// and tickAll() runs them back to back over a contiguous array of contexts.
+//
+// Ticks have exactly the semantics of BehaviourTree::tick(). The source tree
+// can be discarded after compiling; its runtime state is not copied.
+template<typename TContext>
+class CompiledBehaviourTree {
+public:
+    explicit CompiledBehaviourTree(const BehaviourTree<TContext>& tree);
+
+    [[nodiscard]] BTAgentStates makeStates(std::size_t agents) const;
+
+    // Ticks one agent. Throws std::invalid_argument for an invalid delta or
+    // states made for another tree, std::out_of_range for a bad agent.
+    NodeStatus tick(BTAgentStates& states, std::size_t agent, TContext* ctx, float dt) const;
+    // Ticks agent i with contexts[i] for every agent in `states`. There must
+    // be one context per agent; `statuses` is empty or receives one result
+    // per agent.
+    void tickAll(BTAgentStates& states, std::span<TContext> contexts, float dt,
+                 std::span<NodeStatus> statuses = {}) const;
+
+    [[nodiscard]] std::size_t nodeCount() const noexcept { return m_nodes.size(); }
+
+private:
+    static constexpr std::uint32_t kNoSlot = 0xFFFFFFFFu;
+
+    struct Node {
+        NodeType type{NodeType::Action};
+        // Index one past this node's subtree; the first child is index + 1
+        // and each child's `end` is its next sibling.
+        std::uint32_t end{0};
+        // Leaf callback, state slot, or kNoSlot.
+        std::uint32_t slot{kNoSlot};
+        // Cooldown seconds or repeat limit.
+        float duration{0.0f};
+        int repeatLimit{-1};
+    };
+
+    std::uint32_t flatten(const BTNode<TContext>& node);
+    void checkStates(const BTAgentStates& states) const;
+    NodeStatus tickNode(std::uint32_t index, std::int32_t* indices, float* timers,
+                        TContext* ctx, float dt) const;
+
+    std::vector<Node> m_nodes;
+    std::vector<std::function<NodeStatus(TContext*)>> m_leaves;
+    std::size_t m_indexSlots{0};
+    std::size_t m_timerSlots{0};
+};
+
+inline void BTAgentStates::resize(std::size_t agents) {
+    m_indices.resize(agents * m_indexSlots, 0);
+    m_timers.resize(agents * m_timerSlots, 0.0f);
+    m_agents = agents;
+}
+
+inline void BTAgentStates::reset(std::size_t agent) {
+    if (agent >= m_agents) {
+        throw std::out_of_range("BehaviourTree agent index is out of range");
+    }
+    std::fill_n(m_indices.begin() + static_cast<std::ptrdiff_t>(agent * m_indexSlots), m_indexSlots, 0);
+    std::fill_n(m_timers.begin() + static_cast<std::ptrdiff_t>(agent * m_timerSlots), m_timerSlots, 0.0f);
+}
+
+inline void BTAgentStates::resetAll() noexcept {
+    std::fill(m_indices.begin(), m_indices.end(), 0);
+    std::fill(m_timers.begin(), m_timers.end(), 0.0f);
+}
+
+} // namespace AI
+
+#include "CompiledBehaviourTree.inl"
+
+#endif // COMPILED_BEHAVIOUR_TREE_HPP
@@ -0,0 +1,178 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace AI {
+
+template<typename TContext>
+CompiledBehaviourTree<TContext>::CompiledBehaviourTree(const BehaviourTree<TContext>& tree) {
+    if (tree.m_root) {
+        flatten(*tree.m_root);
+    }
+}
+
+template<typename TContext>
+std::uint32_t CompiledBehaviourTree<TContext>::flatten(const BTNode<TContext>& node) {
+    if (m_nodes.size() >= std::numeric_limits<std::uint32_t>::max() - 1) {
+        throw std::length_error("BehaviourTree has too many nodes to compile");
+    }
+    const auto index = static_cast<std::uint32_t>(m_nodes.size());
+    Node flat{};
+    flat.type = node.m_type;
+    switch (node.m_type) {
+        case NodeType::Selector:
+        case NodeType::Sequence:
+        case NodeType::Repeater:
+            flat.slot = static_cast<std::uint32_t>(m_indexSlots++);
+            flat.repeatLimit = node.m_repeatLimit;
+            break;
+        case NodeType::Cooldown:
+            flat.slot = static_cast<std::uint32_t>(m_timerSlots++);
+            flat.duration = node.m_durationSeconds;
+            break;
+        case NodeType::Action:
+        case NodeType::Condition:
+            flat.slot = static_cast<std::uint32_t>(m_leaves.size());
+            m_leaves.push_back(node.m_tickFn);
+            break;
+        case NodeType::Inverter:
+        case NodeType::Succeeder:
+        case NodeType::Failer:
+            break;
+    }
+    m_nodes.push_back(flat);
+    for (const auto& child : node.m_children) {
+        if (child) flatten(*child);
+    }
+    m_nodes[index].end = static_cast<std::uint32_t>(m_nodes.size());
+    return index;
+}
+
+template<typename TContext>
+BTAgentStates CompiledBehaviourTree<TContext>::makeStates(std::size_t agents) const {
+    return BTAgentStates(m_indexSlots, m_timerSlots, agents);
+}
+
+template<typename TContext>
+void CompiledBehaviourTree<TContext>::checkStates(const BTAgentStates& states) const {
+    if (states.m_indexSlots != m_indexSlots || states.m_timerSlots != m_timerSlots) {
+        throw std::invalid_argument("BehaviourTree agent states were made for another tree");
+    }
+}
+
+template<typename TContext>
+NodeStatus CompiledBehaviourTree<TContext>::tick(BTAgentStates& states, std::size_t agent,
+                                                 TContext* ctx, float dt) const {
+    if (!std::isfinite(dt) || dt < 0.0f) {
+        throw std::invalid_argument("BehaviourTree tick delta must be finite and non-negative");
+    }
+    checkStates(states);
+    if (agent >= states.m_agents) {
+        throw std::out_of_range("BehaviourTree agent index is out of range");
+    }
+    if (m_nodes.empty()) return NodeStatus::Failure;
+    return tickNode(0, states.m_indices.data() + agent * m_indexSlots,
+                    states.m_timers.data() + agent * m_timerSlots, ctx, dt);
+}
+
+template<typename TContext>
+void CompiledBehaviourTree<TContext>::tickAll(BTAgentStates& states, std::span<TContext> contexts,
+                                              float dt, std::span<NodeStatus> statuses) const {
+    if (!std::isfinite(dt) || dt < 0.0f) {
+        throw std::invalid_argument("BehaviourTree tick delta must be finite and non-negative");
+    }
+    checkStates(states);
+    if (contexts.size() != states.m_agents ||
+        (!statuses.empty() && statuses.size() != states.m_agents)) {
+        throw std::invalid_argument("BehaviourTree batch needs one context (and status) per agent");
+    }
+    if (m_nodes.empty()) {
+        std::fill(statuses.begin(), statuses.end(), NodeStatus::Failure);
+        return;
+    }
+    std::int32_t* indices = states.m_indices.data();
+    float* timers = states.m_timers.data();
+    for (std::size_t agent = 0; agent < contexts.size(); ++agent) {
+        const NodeStatus status = tickNode(0, indices, timers, &contexts[agent], dt);
+        if (!statuses.empty()) statuses[agent] = status;
+        indices += m_indexSlots;
+        timers += m_timerSlots;
+    }
+}
+
+template<typename TContext>
+NodeStatus CompiledBehaviourTree<TContext>::tickNode(std::uint32_t index, std::int32_t* indices,
+                                                     float* timers, TContext* ctx, float dt) const {
+    const Node& node = m_nodes[index];
+    switch (node.type) {
+        case NodeType::Selector:
+        case NodeType::Sequence: {
+            // Success ends a selector, failure a sequence.
+            const NodeStatus done = node.type == NodeType::Selector ? NodeStatus::Success
+                                                                    : NodeStatus::Failure;
+            std::int32_t& running = indices[node.slot];
+            std::uint32_t child = running > 0 ? static_cast<std::uint32_t>(running - 1) : index + 1;
+            running = 0;
+            for (; child < node.end; child = m_nodes[child].end) {
+                const NodeStatus s = tickNode(child, indices, timers, ctx, dt);
+                if (s == done) return s;
+                if (s == NodeStatus::Running) {
+                    running = static_cast<std::int32_t>(child + 1);
+                    return s;
+                }
+            }
+            return node.type == NodeType::Selector ? NodeStatus::Failure : NodeStatus::Success;
+        }
+        case NodeType::Action:
+        case NodeType::Condition: {
+            const auto& fn = m_leaves[node.slot];
+            return fn ? fn(ctx) : NodeStatus::Failure;
+        }
+        case NodeType::Inverter: {
+            const NodeStatus status = tickNode(index + 1, indices, timers, ctx, dt);
+            if (status == NodeStatus::Success) return NodeStatus::Failure;
+            if (status == NodeStatus::Failure) return NodeStatus::Success;
+            return NodeStatus::Running;
+        }
+        case NodeType::Succeeder: {
+            const NodeStatus status = tickNode(index + 1, indices, timers, ctx, dt);
+            return status == NodeStatus::Running ? NodeStatus::Running : NodeStatus::Success;
+        }
+        case NodeType::Failer: {
+            const NodeStatus status = tickNode(index + 1, indices, timers, ctx, dt);
+            return status == NodeStatus::Running ? NodeStatus::Running : NodeStatus::Failure;
+        }
+        case NodeType::Cooldown: {
+            float& remaining = timers[node.slot];
+            if (remaining > 0.0f) {
+                remaining = std::max(0.0f, remaining - dt);
+                if (remaining > 0.0f) return NodeStatus::Failure;
+            }
+            const NodeStatus status = tickNode(index + 1, indices, timers, ctx, dt);
+            if (status == NodeStatus::Success) {
+                remaining = node.duration;
+            }
+            return status;
+        }
+        case NodeType::Repeater: {
+            if (node.repeatLimit == 0) return NodeStatus::Success;
+
+            const NodeStatus status = tickNode(index + 1, indices, timers, ctx, dt);
+            if (status == NodeStatus::Running) return NodeStatus::Running;
+
+            std::int32_t& repetitions = indices[node.slot];
+            ++repetitions;
+            if (node.repeatLimit >= 0 && repetitions >= node.repeatLimit) {
+                repetitions = 0;
+                return NodeStatus::Success;
+            }
+            return NodeStatus::Running;
+        }
+    }
+    return NodeStatus::Failure;
+}
+
+} // namespace AI
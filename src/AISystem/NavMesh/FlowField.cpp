@@ -0,0 +1,391 @@
+#include "FlowField.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+
+#include "Utils/WorkerPool.hpp"
+
+namespace {
+constexpr float kInfinity = std::numeric_limits<float>::infinity();
+constexpr float kDiagonalCost = 1.41421356f;
+constexpr float kGoalEpsilon = 1e-4f;
+
+constexpr std::uint8_t kGoalDirection = 8;
+constexpr std::uint8_t kNoDirection = 0xFF;
+
+constexpr int kNeighborX[8] = {1, -1, 0, 0, 1, -1, 1, -1};
+constexpr int kNeighborY[8] = {0, 0, 1, -1, 1, 1, -1, -1};
+constexpr float kHalfSqrt2 = 0.70710678f;
+const glm::vec2 kDirections[8] = {{1.0f, 0.0f},          {-1.0f, 0.0f},
+                                  {0.0f, 1.0f},          {0.0f, -1.0f},
+                                  {kHalfSqrt2, kHalfSqrt2},  {-kHalfSqrt2, kHalfSqrt2},
+                                  {kHalfSqrt2, -kHalfSqrt2}, {-kHalfSqrt2, -kHalfSqrt2}};
+
+template<typename Task>
+void forEachTile(Utils::WorkerPool* workers, const std::vector<int>& tiles, Task&& task) {
+    if (workers != nullptr && workers->workerCount() > 0 && tiles.size() > 1) {
+        workers->parallelFor(tiles.size(), [&](std::size_t i) { task(tiles[i]); });
+    } else {
+        for (const int tile : tiles) task(tile);
+    }
+}
+}
+
+FlowField::FlowField() : FlowField(Settings{}) {}
+
+FlowField::FlowField(const Settings& settings)
+    : m_settings(settings), m_tileSize(settings.tileSize) {
+    if (settings.tileSize <= 0) {
+        throw std::invalid_argument("FlowField tile size must be positive");
+    }
+    if (!(settings.slack >= 0.0f) || !(settings.maxDrift >= 0.0f)) {
+        throw std::invalid_argument("FlowField slack and drift must not be negative");
+    }
+}
+
+void FlowField::clear() {
+    for (const int tile : m_activeTiles) {
+        m_tiles[static_cast<std::size_t>(tile)].active = false;
+        m_tiles[static_cast<std::size_t>(tile)].seeds.clear();
+    }
+    m_activeTiles.clear();
+    m_goalCell = -1;
+    m_drift = 0.0f;
+    m_lastTilesIntegrated = 0;
+    std::fill(m_costs.begin(), m_costs.end(), kInfinity);
+    std::fill(m_directions.begin(), m_directions.end(), kNoDirection);
+}
+
+void FlowField::prepare(const NavRaster& raster) {
+    if (raster.width() != m_width || raster.height() != m_height) {
+        m_width = raster.width();
+        m_height = raster.height();
+        const std::size_t cells =
+            static_cast<std::size_t>(m_width) * static_cast<std::size_t>(m_height);
+        m_walkable.resize(cells);
+        m_costs.resize(cells);
+        m_directions.resize(cells);
+        m_tileColumns = (m_width + m_tileSize - 1) / m_tileSize;
+        m_tileRows = (m_height + m_tileSize - 1) / m_tileSize;
+        m_activeTiles.clear();
+        m_tiles.assign(static_cast<std::size_t>(m_tileColumns) *
+                           static_cast<std::size_t>(m_tileRows), Tile{});
+    }
+    m_cellSize = raster.cellSize();
+    m_origin = raster.origin();
+    raster.forEachCell([&](int x, int y, bool walkable) {
+        m_walkable[static_cast<std::size_t>(y) * static_cast<std::size_t>(m_width) +
+                   static_cast<std::size_t>(x)] = walkable ? 1 : 0;
+    });
+}
+
+bool FlowField::build(const NavRaster& raster, const glm::vec2& goal,
+                      Utils::WorkerPool* workers) {
+    prepare(raster);
+    clear();
+    const int goalCell = locate(goal);
+    if (goalCell < 0) return false;
+    m_goal = goal;
+    m_goalCell = goalCell;
+    m_lastRebuilt = true;
+    m_seeds.assign(1, {goalCell, 0.0f});
+    integrate(0.0f, 0, workers);
+    return true;
+}
+
+bool FlowField::moveGoal(const NavRaster& raster, const glm::vec2& goal,
+                         Utils::WorkerPool* workers) {
+    if (!valid() || raster.width() != m_width || raster.height() != m_height ||
+        raster.cellSize() != m_cellSize || raster.origin() != m_origin) {
+        return build(raster, goal, workers);
+    }
+    const int goalCell = locate(goal);
+    if (goalCell < 0) {
+        clear();
+        return false;
+    }
+    m_lastTilesIntegrated = 0;
+    m_lastRebuilt = false;
+    if (goalCell == m_goalCell) {
+        m_goal = goal;
+        if (pending()) {
+            m_seeds.clear();
+            integrate(m_settings.slack, m_settings.tileBudget, workers);
+        }
+        return true;
+    }
+    if (m_costs[static_cast<std::size_t>(goalCell)] == kInfinity) {
+        return build(raster, goal, workers);
+    }
+
+    // Walk the field down from the new goal cell to the old goal. Reaching
+    // the new goal along that route bounds every cost from above; the route
+    // itself is lowered outright, which leaves the old goal a way down, and
+    // integration then only lowers cells that get more than the slack closer.
+    m_seeds.clear();
+    float offset = 0.0f;
+    for (int cell = goalCell;;) {
+        m_seeds.emplace_back(cell, offset);
+        const std::uint8_t code = m_directions[static_cast<std::size_t>(cell)];
+        if (code >= kGoalDirection) break;
+        cell += kNeighborY[code] * m_width + kNeighborX[code];
+        offset += code >= 4 ? kDiagonalCost : 1.0f;
+    }
+    if (m_drift + offset > m_settings.maxDrift) {
+        return build(raster, goal, workers);
+    }
+    for (float& cost : m_costs) cost += offset;
+    // Seeds still waiting in pending tiles were costs toward the old goal.
+    for (const int tile : m_activeTiles) {
+        for (auto& seed : m_tiles[static_cast<std::size_t>(tile)].seeds) seed.second += offset;
+    }
+    m_drift += offset;
+    // The route is lowered here rather than by integration, so the field
+    // leads to the new goal even if the budget stops before its tiles; its
+    // seeds then only spread it further.
+    for (const auto& [cell, cost] : m_seeds) {
+        m_costs[static_cast<std::size_t>(cell)] = cost;
+        m_tiles[static_cast<std::size_t>(tileOf(cell))].changed = true;
+    }
+    m_goal = goal;
+    m_goalCell = goalCell;
+    integrate(m_settings.slack, m_settings.tileBudget, workers);
+    return true;
+}
+
+int FlowField::locate(const glm::vec2& position) const noexcept {
+    if (m_walkable.empty()) return -1;
+    const float fx = std::floor((position.x - m_origin.x) / m_cellSize);
+    const float fy = std::floor((position.y - m_origin.y) / m_cellSize);
+    // Also rejects NaN.
+    if (!(fx >= 0.0f && fx < static_cast<float>(m_width) && fy >= 0.0f &&
+          fy < static_cast<float>(m_height))) {
+        return -1;
+    }
+    const int x = static_cast<int>(fx);
+    const int y = static_cast<int>(fy);
+    return walkable(x, y) ? y * m_width + x : -1;
+}
+
+bool FlowField::walkable(int x, int y) const noexcept {
+    return m_walkable[static_cast<std::size_t>(y) * static_cast<std::size_t>(m_width) +
+                      static_cast<std::size_t>(x)] != 0;
+}
+
+int FlowField::tileOf(int cell) const noexcept {
+    return (cell / m_width / m_tileSize) * m_tileColumns + cell % m_width / m_tileSize;
+}
+
+void FlowField::integrate(float slack, std::size_t budget, Utils::WorkerPool* workers) {
+    m_slack = slack;
+    for (const auto& [cell, cost] : m_seeds) {
+        const int tile = tileOf(cell);
+        Tile& entry = m_tiles[static_cast<std::size_t>(tile)];
+        entry.seeds.emplace_back(cell, cost);
+        if (!entry.active) {
+            entry.active = true;
+            m_activeTiles.push_back(tile);
+        }
+    }
+    while (!m_activeTiles.empty()) {
+        // Over budget, the oldest tiles go first and the rest wait, still
+        // active, for the next call.
+        std::size_t count = m_activeTiles.size();
+        if (budget > 0) {
+            if (m_lastTilesIntegrated >= budget) break;
+            count = std::min(count, budget - m_lastTilesIntegrated);
+        }
+        const auto split = m_activeTiles.begin() + static_cast<std::ptrdiff_t>(count);
+        m_roundTiles.assign(m_activeTiles.begin(), split);
+        m_activeTiles.erase(m_activeTiles.begin(), split);
+
+        // Seeds only read costs and integration only writes the tile's own
+        // cells, so each phase is free of races and of ordering effects.
+        forEachTile(workers, m_roundTiles, [this](int tile) { gatherSeeds(tile); });
+        forEachTile(workers, m_roundTiles, [this](int tile) { integrateTile(tile); });
+        m_lastTilesIntegrated += m_roundTiles.size();
+
+        for (const int tile : m_roundTiles) {
+            m_tiles[static_cast<std::size_t>(tile)].active = false;
+        }
+        for (const int tile : m_roundTiles) {
+            Tile& entry = m_tiles[static_cast<std::size_t>(tile)];
+            if (!entry.edgeImproved) continue;
+            entry.edgeImproved = false;
+            const int tx = tile % m_tileColumns;
+            const int ty = tile / m_tileColumns;
+            for (int direction = 0; direction < 8; ++direction) {
+                const int nx = tx + kNeighborX[direction];
+                const int ny = ty + kNeighborY[direction];
+                if (nx < 0 || nx >= m_tileColumns || ny < 0 || ny >= m_tileRows) continue;
+                Tile& neighbor = m_tiles[static_cast<std::size_t>(ny * m_tileColumns + nx)];
+                if (!neighbor.active) {
+                    neighbor.active = true;
+                    m_activeTiles.push_back(ny * m_tileColumns + nx);
+                }
+            }
+        }
+    }
+    refreshDirections(workers);
+}
+
+void FlowField::refreshDirections(Utils::WorkerPool* workers) {
+    // Directions of changed tiles, and of their neighbours' edge cells,
+    // depend on the new costs.
+    for (std::size_t tile = 0; tile < m_tiles.size(); ++tile) {
+        if (!m_tiles[tile].changed) continue;
+        m_tiles[tile].changed = false;
+        const int tx = static_cast<int>(tile) % m_tileColumns;
+        const int ty = static_cast<int>(tile) / m_tileColumns;
+        for (int ny = std::max(ty - 1, 0); ny <= std::min(ty + 1, m_tileRows - 1); ++ny) {
+            for (int nx = std::max(tx - 1, 0); nx <= std::min(tx + 1, m_tileColumns - 1); ++nx) {
+                Tile& neighbor = m_tiles[static_cast<std::size_t>(ny * m_tileColumns + nx)];
+                if (!neighbor.refresh) {
+                    neighbor.refresh = true;
+                    m_refreshTiles.push_back(ny * m_tileColumns + nx);
+                }
+            }
+        }
+    }
+    forEachTile(workers, m_refreshTiles, [this](int tile) { updateDirections(tile); });
+    for (const int tile : m_refreshTiles) {
+        m_tiles[static_cast<std::size_t>(tile)].refresh = false;
+    }
+    m_refreshTiles.clear();
+}
+
+void FlowField::gatherSeeds(int tile) {
+    Tile& entry = m_tiles[static_cast<std::size_t>(tile)];
+    const int minX = (tile % m_tileColumns) * m_tileSize;
+    const int minY = (tile / m_tileColumns) * m_tileSize;
+    const int maxX = std::min(minX + m_tileSize, m_width) - 1;
+    const int maxY = std::min(minY + m_tileSize, m_height) - 1;
+    const auto seedFromOutside = [&](int x, int y) {
+        if (!walkable(x, y)) return;
+        const int cell = y * m_width + x;
+        float best = m_costs[static_cast<std::size_t>(cell)];
+        for (int direction = 0; direction < 8; ++direction) {
+            const int nx = x + kNeighborX[direction];
+            const int ny = y + kNeighborY[direction];
+            if (nx >= minX && nx <= maxX && ny >= minY && ny <= maxY) continue;
+            if (nx < 0 || nx >= m_width || ny < 0 || ny >= m_height || !walkable(nx, ny)) continue;
+            const bool diagonal = direction >= 4;
+            if (diagonal && (!walkable(nx, y) || !walkable(x, ny))) continue;
+            const float cost = m_costs[static_cast<std::size_t>(ny * m_width + nx)] +
+                               (diagonal ? kDiagonalCost : 1.0f);
+            best = std::min(best, cost);
+        }
+        if (best + m_slack < m_costs[static_cast<std::size_t>(cell)]) {
+            entry.seeds.emplace_back(cell, best);
+        }
+    };
+    for (int y = minY; y <= maxY; ++y) {
+        if (y == minY || y == maxY) {
+            for (int x = minX; x <= maxX; ++x) seedFromOutside(x, y);
+        } else {
+            seedFromOutside(minX, y);
+            if (maxX != minX) seedFromOutside(maxX, y);
+        }
+    }
+}
+
+void FlowField::integrateTile(int tile) {
+    Tile& entry = m_tiles[static_cast<std::size_t>(tile)];
+    const int minX = (tile % m_tileColumns) * m_tileSize;
+    const int minY = (tile / m_tileColumns) * m_tileSize;
+    const int maxX = std::min(minX + m_tileSize, m_width) - 1;
+    const int maxY = std::min(minY + m_tileSize, m_height) - 1;
+
+    thread_local std::vector<std::pair<float, int>> heap;
+    heap.clear();
+    const auto lower = [&](int cell, int x, int y, float cost) {
+        m_costs[static_cast<std::size_t>(cell)] = cost;
+        heap.emplace_back(cost, cell);
+        std::push_heap(heap.begin(), heap.end(), std::greater<>{});
+        entry.changed = true;
+        if (x == minX || x == maxX || y == minY || y == maxY) {
+            entry.edgeImproved = true;
+        }
+    };
+    // A seed at the cell's current cost still spreads from it.
+    for (const auto& [cell, cost] : entry.seeds) {
+        if (cost <= m_costs[static_cast<std::size_t>(cell)]) {
+            lower(cell, cell % m_width, cell / m_width, cost);
+        }
+    }
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), std::greater<>{});
+        const auto [cost, cell] = heap.back();
+        heap.pop_back();
+        if (cost > m_costs[static_cast<std::size_t>(cell)]) continue;
+        const int x = cell % m_width;
+        const int y = cell / m_width;
+        for (int direction = 0; direction < 8; ++direction) {
+            const int nx = x + kNeighborX[direction];
+            const int ny = y + kNeighborY[direction];
+            if (nx < minX || nx > maxX || ny < minY || ny > maxY || !walkable(nx, ny)) continue;
+            const bool diagonal = direction >= 4;
+            if (diagonal && (!walkable(nx, y) || !walkable(x, ny))) continue;
+            const int next = ny * m_width + nx;
+            const float nextCost = cost + (diagonal ? kDiagonalCost : 1.0f);
+            if (nextCost + m_slack < m_costs[static_cast<std::size_t>(next)]) {
+                lower(next, nx, ny, nextCost);
+            }
+        }
+    }
+    entry.seeds.clear();
+}
+
+void FlowField::updateDirections(int tile) {
+    const int minX = (tile % m_tileColumns) * m_tileSize;
+    const int minY = (tile / m_tileColumns) * m_tileSize;
+    const int maxX = std::min(minX + m_tileSize, m_width) - 1;
+    const int maxY = std::min(minY + m_tileSize, m_height) - 1;
+    for (int y = minY; y <= maxY; ++y) {
+        for (int x = minX; x <= maxX; ++x) {
+            const int cell = y * m_width + x;
+            float best = m_costs[static_cast<std::size_t>(cell)];
+            std::uint8_t code = kNoDirection;
+            if (cell == m_goalCell) {
+                code = kGoalDirection;
+            } else if (best < kInfinity) {
+                for (int direction = 0; direction < 8; ++direction) {
+                    const int nx = x + kNeighborX[direction];
+                    const int ny = y + kNeighborY[direction];
+                    if (nx < 0 || nx >= m_width || ny < 0 || ny >= m_height ||
+                        !walkable(nx, ny)) {
+                        continue;
+                    }
+                    if (direction >= 4 && (!walkable(nx, y) || !walkable(x, ny))) continue;
+                    const float cost = m_costs[static_cast<std::size_t>(ny * m_width + nx)];
+                    if (cost < best) {
+                        best = cost;
+                        code = static_cast<std::uint8_t>(direction);
+                    }
+                }
+            }
+            m_directions[static_cast<std::size_t>(cell)] = code;
+        }
+    }
+}
+
+glm::vec2 FlowField::direction(const glm::vec2& position) const noexcept {
+    const int cell = valid() ? locate(position) : -1;
+    if (cell < 0) return glm::vec2{0.0f};
+    const std::uint8_t code = m_directions[static_cast<std::size_t>(cell)];
+    if (code == kGoalDirection) {
+        const glm::vec2 delta = m_goal - position;
+        const float length = std::sqrt(delta.x * delta.x + delta.y * delta.y);
+        return length > kGoalEpsilon ? delta / length : glm::vec2{0.0f};
+    }
+    return code == kNoDirection ? glm::vec2{0.0f} : kDirections[code];
+}
+
+float FlowField::distance(const glm::vec2& position) const noexcept {
+    const int cell = valid() ? locate(position) : -1;
+    return cell < 0 ? kInfinity : m_costs[static_cast<std::size_t>(cell)] * m_cellSize;
+}
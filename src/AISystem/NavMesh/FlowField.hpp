@@ -0,0 +1,140 @@
+#ifndef FLOW_FIELD_HPP
+#define FLOW_FIELD_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <glm/vec2.hpp>
+
+#include "NavRaster.hpp"
+
+namespace Utils { class WorkerPool; }
+
+// Distance field toward one goal over a NavRaster, plus the direction of
+// steepest descent in every cell, so any number of agents heading for the
+// same goal each sample their direction with one lookup. Cells connect to
+// their 8 neighbours; diagonal steps may not cut blocked corners.
+//
+// The raster is integrated in square tiles. Each round runs Dijkstra inside
+// every active tile, seeded from its neighbours' edges, and tiles whose edge
+// improved wake their neighbours; the rounds optionally run in parallel on a
+// WorkerPool and give the same field either way.
+//
+// Moving the goal to another cell reuses the previous field: every cost is
+// raised by the length of the old route from the new goal cell down to the
+// old goal, that route is lowered outright, and only cells that then get
+// more than `slack` cells closer are integrated again. Directions keep
+// leading to the goal, but distances may overestimate until the next full
+// build, which happens once the goal has drifted `maxDrift` cells since the
+// last one. The default slack lets a single step go without integration; a
+// slack of zero keeps the field exact.
+//
+// A goal move can still redo a large share of the raster (about a third of
+// the tiles per one-cell step on the navmesh benchmark map), so each
+// moveGoal() call integrates at most `tileBudget` tiles and leaves the rest
+// pending(); later calls, including ones for the same goal cell, resume it.
+// While work is pending, directions already lead to the current goal and
+// distances only overestimate. build(), and the rebuilds moveGoal() falls
+// back to, always integrate the whole raster at once.
+class FlowField {
+public:
+    struct Settings {
+        int tileSize{32};
+        float slack{3.0f};
+        float maxDrift{32.0f};
+        // Tile integrations per moveGoal() call; zero finishes every move
+        // in the call that starts it.
+        std::size_t tileBudget{128};
+    };
+
+    FlowField();
+    explicit FlowField(const Settings& settings);
+
+    // Integrates the whole raster toward `goal`. Returns valid(); the field
+    // is cleared when the goal is not on a walkable cell.
+    bool build(const NavRaster& raster, const glm::vec2& goal,
+               Utils::WorkerPool* workers = nullptr);
+    // Moves the goal, updating the field incrementally when it was built on
+    // this raster layout and reaches the new goal cell; otherwise builds it.
+    // Resumes pending work within the tile budget either way. Call build()
+    // instead after the raster's walkable cells change.
+    bool moveGoal(const NavRaster& raster, const glm::vec2& goal,
+                  Utils::WorkerPool* workers = nullptr);
+    void clear();
+
+    [[nodiscard]] bool valid() const noexcept { return m_goalCell >= 0; }
+    // Whether a goal move ran out of tile budget and has tiles left to
+    // integrate.
+    [[nodiscard]] bool pending() const noexcept { return !m_activeTiles.empty(); }
+    [[nodiscard]] const glm::vec2& goal() const noexcept { return m_goal; }
+    // Raster cell index (y * width + x) of the goal, or -1.
+    [[nodiscard]] int goalCell() const noexcept { return m_goalCell; }
+    [[nodiscard]] const Settings& settings() const noexcept { return m_settings; }
+
+    // Unit direction to move from `position`: toward the next cell down the
+    // field, or straight at the goal inside its cell. Zero off the raster,
+    // on cells that cannot reach the goal, and at the goal itself.
+    [[nodiscard]] glm::vec2 direction(const glm::vec2& position) const noexcept;
+    // Path distance from the cell containing `position` to the goal cell, in
+    // world units; infinity when unreachable or off the raster.
+    [[nodiscard]] float distance(const glm::vec2& position) const noexcept;
+
+    // Tile integrations run by the last build or goal move, and whether that
+    // was a full build.
+    [[nodiscard]] std::size_t lastTilesIntegrated() const noexcept { return m_lastTilesIntegrated; }
+    [[nodiscard]] bool lastRebuilt() const noexcept { return m_lastRebuilt; }
+
+private:
+    struct Tile {
+        // Candidate costs for this tile's cells from neighbouring tiles.
+        std::vector<std::pair<int, float>> seeds;
+        bool active{false};
+        bool edgeImproved{false};
+        bool changed{false};
+        bool refresh{false};
+    };
+
+    [[nodiscard]] int locate(const glm::vec2& position) const noexcept;
+    [[nodiscard]] bool walkable(int x, int y) const noexcept;
+    [[nodiscard]] int tileOf(int cell) const noexcept;
+    void prepare(const NavRaster& raster);
+    // Integrates from m_seeds, whose costs are applied unconditionally;
+    // other cells are only lowered by more than `slack`. Stops after
+    // `budget` tile integrations (none: zero), leaving the rest active.
+    void integrate(float slack, std::size_t budget, Utils::WorkerPool* workers);
+    void refreshDirections(Utils::WorkerPool* workers);
+    void gatherSeeds(int tile);
+    void integrateTile(int tile);
+    void updateDirections(int tile);
+
+    Settings m_settings;
+    int m_tileSize;
+    int m_width{0};
+    int m_height{0};
+    float m_cellSize{1.0f};
+    glm::vec2 m_origin{0.0f};
+    std::vector<std::uint8_t> m_walkable;
+    // Per cell: path cost to the goal in cells, and the neighbour to step to.
+    std::vector<float> m_costs;
+    std::vector<std::uint8_t> m_directions;
+    int m_tileColumns{0};
+    int m_tileRows{0};
+    std::vector<Tile> m_tiles;
+    // Tiles waiting for integration; only non-empty between calls while a
+    // goal move is pending.
+    std::vector<int> m_activeTiles;
+    std::vector<int> m_roundTiles;
+    std::vector<int> m_refreshTiles;
+    std::vector<std::pair<int, float>> m_seeds;
+    // Cells the goal has moved since the last full build.
+    float m_drift{0.0f};
+    float m_slack{0.0f};
+    glm::vec2 m_goal{0.0f};
+    int m_goalCell{-1};
+    std::size_t m_lastTilesIntegrated{0};
+    bool m_lastRebuilt{false};
+};
+
+#endif // FLOW_FIELD_HPP
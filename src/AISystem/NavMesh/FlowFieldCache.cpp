@@ -0,0 +1,76 @@
+#include "FlowFieldCache.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "NavRaster.hpp"
+
+FlowFieldCache::FlowFieldCache(const NavRaster& raster)
+    : FlowFieldCache(raster, Settings{}) {}
+
+FlowFieldCache::FlowFieldCache(const NavRaster& raster, const Settings& settings)
+    : m_raster(&raster), m_settings(settings) {
+    if (settings.capacity == 0) {
+        throw std::invalid_argument("FlowFieldCache capacity must be positive");
+    }
+    // Rejects invalid field settings before any field is needed.
+    static_cast<void>(FlowField{settings.field});
+    m_entries.reserve(settings.capacity);
+}
+
+const FlowField* FlowFieldCache::fieldFor(std::uint64_t key, const glm::vec2& goal,
+                                          Utils::WorkerPool* workers) {
+    auto entry = std::find_if(m_entries.begin(), m_entries.end(),
+                              [key](const Entry& e) { return e.key == key; });
+    if (entry == m_entries.end()) {
+        if (m_entries.size() < m_settings.capacity) {
+            m_entries.push_back({key, 0, true, std::make_unique<FlowField>(m_settings.field)});
+            entry = m_entries.end() - 1;
+        } else {
+            entry = std::min_element(m_entries.begin(), m_entries.end(),
+                                     [](const Entry& a, const Entry& b) {
+                                         return a.lastUse < b.lastUse;
+                                     });
+            entry->key = key;
+            entry->stale = true;
+            ++m_stats.evictions;
+        }
+    }
+    entry->lastUse = ++m_useCounter;
+
+    FlowField& field = *entry->field;
+    int x = 0;
+    int y = 0;
+    if (!m_raster->worldToCell(goal, x, y) || !m_raster->isWalkable(x, y)) {
+        field.clear();
+        return nullptr;
+    }
+    bool ready = false;
+    if (entry->stale) {
+        ready = field.build(*m_raster, goal, workers);
+        entry->stale = false;
+        ++m_stats.fullBuilds;
+    } else if (field.goalCell() == y * m_raster->width() + x) {
+        ready = field.moveGoal(*m_raster, goal, workers);
+        ++m_stats.hits;
+    } else {
+        ready = field.moveGoal(*m_raster, goal, workers);
+        ++(field.lastRebuilt() ? m_stats.fullBuilds : m_stats.incrementalUpdates);
+    }
+    m_stats.tilesIntegrated += field.lastTilesIntegrated();
+    return ready ? &field : nullptr;
+}
+
+const FlowField* FlowFieldCache::find(std::uint64_t key) const noexcept {
+    const auto entry = std::find_if(m_entries.begin(), m_entries.end(),
+                                    [key](const Entry& e) { return e.key == key; });
+    return entry != m_entries.end() && entry->field->valid() ? entry->field.get() : nullptr;
+}
+
+void FlowFieldCache::erase(std::uint64_t key) noexcept {
+    std::erase_if(m_entries, [key](const Entry& e) { return e.key == key; });
+}
+
+void FlowFieldCache::rasterChanged() noexcept {
+    for (Entry& entry : m_entries) entry.stale = true;
+}
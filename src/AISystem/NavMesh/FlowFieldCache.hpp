@@ -0,0 +1,89 @@
+#ifndef FLOW_FIELD_CACHE_HPP
+#define FLOW_FIELD_CACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <glm/vec2.hpp>
+
+#include "FlowField.hpp"
+
+class NavRaster;
+namespace Utils { class WorkerPool; }
+
+// Flow fields for the goals crowds are currently heading to, one per goal
+// key (the chased entity, or a fixed goal's cell index). Asking for a key
+// again while its goal stays in one cell only resumes pending work; when the
+// goal moves to another cell its field is updated incrementally. At most
+// `capacity` fields are kept and the least recently used one is evicted, its
+// storage reused for the next goal.
+//
+// Cost per request: an incremental update integrates at most
+// `field.tileBudget` tiles and finishes on later requests, so it is safe to
+// ask every frame. A full build integrates every tile of the raster in one
+// call (about 5400 on the navmesh benchmark map, against the default budget
+// of 128), so treat it as a loading-time cost. It happens for a new or
+// evicted key, after rasterChanged(), when the goal jumps somewhere the field
+// does not reach, and once the goal has drifted `field.maxDrift` cells. Size
+// `capacity` to the number of live goals so keys are not rebuilt in turn.
+//
+// Returned fields stay valid until their key is evicted or erased. Call
+// rasterChanged() after editing the raster so every field is rebuilt on its
+// next use. The cache must be used from one thread; pass a WorkerPool to
+// integrate fields in parallel.
+class FlowFieldCache {
+public:
+    struct Settings {
+        std::size_t capacity{8};
+        FlowField::Settings field{};
+    };
+
+    struct Stats {
+        // Requests whose goal stayed in its cell.
+        std::uint64_t hits{0};
+        std::uint64_t incrementalUpdates{0};
+        std::uint64_t fullBuilds{0};
+        std::uint64_t evictions{0};
+        // Tile integrations over all updates and builds.
+        std::uint64_t tilesIntegrated{0};
+    };
+
+    explicit FlowFieldCache(const NavRaster& raster);
+    FlowFieldCache(const NavRaster& raster, const Settings& settings);
+
+    FlowFieldCache(const FlowFieldCache&) = delete;
+    FlowFieldCache& operator=(const FlowFieldCache&) = delete;
+
+    // Field toward `goal` for `key`, or nullptr when the goal is not on a
+    // walkable cell.
+    [[nodiscard]] const FlowField* fieldFor(std::uint64_t key, const glm::vec2& goal,
+                                            Utils::WorkerPool* workers = nullptr);
+    // Cached field for `key`, without updating it or its recency.
+    [[nodiscard]] const FlowField* find(std::uint64_t key) const noexcept;
+    void erase(std::uint64_t key) noexcept;
+    void rasterChanged() noexcept;
+
+    [[nodiscard]] std::size_t size() const noexcept { return m_entries.size(); }
+    [[nodiscard]] const Settings& settings() const noexcept { return m_settings; }
+    [[nodiscard]] const Stats& stats() const noexcept { return m_stats; }
+    void resetStats() noexcept { m_stats = {}; }
+
+private:
+    struct Entry {
+        std::uint64_t key{0};
+        std::uint64_t lastUse{0};
+        // Built on an older raster; rebuild rather than update.
+        bool stale{false};
+        std::unique_ptr<FlowField> field;
+    };
+
+    const NavRaster* m_raster;
+    Settings m_settings;
+    Stats m_stats;
+    std::vector<Entry> m_entries;
+    std::uint64_t m_useCounter{0};
+};
+
+#endif // FLOW_FIELD_CACHE_HPP
@@ -0,0 +1,623 @@
+#include "HierarchicalNavGraph.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+constexpr float kInfinity = std::numeric_limits<float>::infinity();
+constexpr float kDiagonalCost = 1.41421356f;
+// Border runs at least this long get a transition at each end instead of
+// one in the middle, so agents are not funnelled through one cell of a wide
+// opening.
+constexpr int kSplitEntranceLength = 6;
+
+constexpr int kNeighborX[8] = {1, -1, 0, 0, 1, -1, 1, -1};
+constexpr int kNeighborY[8] = {0, 0, 1, -1, 1, 1, -1, -1};
+
+float octile(int dx, int dy) {
+    const auto ax = static_cast<float>(std::abs(dx));
+    const auto ay = static_cast<float>(std::abs(dy));
+    return std::max(ax, ay) + (kDiagonalCost - 1.0f) * std::min(ax, ay);
+}
+}
+
+// Node state stamped per search, with a lazy-deletion open list.
+struct HierarchicalNavGraph::SearchScratch {
+    std::vector<float> g;
+    std::vector<int> parent;
+    std::vector<std::uint32_t> stamps;
+    std::vector<std::uint8_t> closed;
+    std::vector<std::pair<float, int>> heap;
+    std::uint32_t generation{0};
+
+    void prepare(std::size_t count) {
+        if (g.size() < count) {
+            g.resize(count);
+            parent.resize(count);
+            stamps.resize(count, 0);
+            closed.resize(count);
+        }
+        if (++generation == 0) {
+            std::fill(stamps.begin(), stamps.end(), 0);
+            generation = 1;
+        }
+        heap.clear();
+    }
+    void touch(int node) {
+        const auto index = static_cast<std::size_t>(node);
+        if (stamps[index] != generation) {
+            stamps[index] = generation;
+            g[index] = kInfinity;
+            parent[index] = -1;
+            closed[index] = 0;
+        }
+    }
+    [[nodiscard]] float cost(int node) const {
+        const auto index = static_cast<std::size_t>(node);
+        return stamps[index] == generation ? g[index] : kInfinity;
+    }
+    // Lowers `node` to `cost` through `from` unless it is closed or cheaper.
+    void relax(int node, int from, float cost, float heuristic) {
+        touch(node);
+        const auto index = static_cast<std::size_t>(node);
+        if (closed[index] != 0 || cost >= g[index]) return;
+        g[index] = cost;
+        parent[index] = from;
+        heap.emplace_back(cost + heuristic, node);
+        std::push_heap(heap.begin(), heap.end(), std::greater<>{});
+    }
+    // Next open node, or -1.
+    int pop() {
+        while (!heap.empty()) {
+            std::pop_heap(heap.begin(), heap.end(), std::greater<>{});
+            const int node = heap.back().second;
+            heap.pop_back();
+            auto& isClosed = closed[static_cast<std::size_t>(node)];
+            if (isClosed == 0) {
+                isClosed = 1;
+                return node;
+            }
+        }
+        return -1;
+    }
+};
+
+HierarchicalNavGraph::HierarchicalNavGraph(int clusterSize) : m_clusterSize(clusterSize) {
+    if (clusterSize <= 0) {
+        throw std::invalid_argument("HierarchicalNavGraph cluster size must be positive");
+    }
+}
+
+void HierarchicalNavGraph::clear() {
+    m_width = 0;
+    m_height = 0;
+    m_walkable.clear();
+    m_clusterColumns = 0;
+    m_clusterRows = 0;
+    m_verticalBorders.clear();
+    m_horizontalBorders.clear();
+    m_clusters.clear();
+    m_nodeCells.clear();
+    m_clusterNodeOffsets.clear();
+    m_edgeCount = 0;
+    m_lastRebuiltClusters = 0;
+}
+
+void HierarchicalNavGraph::buildFromRaster(const NavRaster& raster) {
+    clear();
+    if (raster.empty()) return;
+    m_width = raster.width();
+    m_height = raster.height();
+    m_cellSize = raster.cellSize();
+    m_origin = raster.origin();
+    m_walkable.resize(static_cast<std::size_t>(m_width) * static_cast<std::size_t>(m_height));
+    copyCells(raster, {0, 0, m_width - 1, m_height - 1});
+
+    m_clusterColumns = (m_width + m_clusterSize - 1) / m_clusterSize;
+    m_clusterRows = (m_height + m_clusterSize - 1) / m_clusterSize;
+    m_verticalBorders.resize(static_cast<std::size_t>(m_clusterColumns - 1) *
+                             static_cast<std::size_t>(m_clusterRows));
+    m_horizontalBorders.resize(static_cast<std::size_t>(m_clusterColumns) *
+                               static_cast<std::size_t>(m_clusterRows - 1));
+    m_clusters.resize(static_cast<std::size_t>(m_clusterColumns) *
+                      static_cast<std::size_t>(m_clusterRows));
+    rebuildClusters(0, 0, m_clusterColumns - 1, m_clusterRows - 1);
+}
+
+void HierarchicalNavGraph::checkRaster(const NavRaster& raster) const {
+    if (m_walkable.empty() || raster.width() != m_width || raster.height() != m_height ||
+        raster.cellSize() != m_cellSize || raster.origin() != m_origin) {
+        throw std::invalid_argument(
+            "HierarchicalNavGraph updates need the raster layout it was built from");
+    }
+}
+
+void HierarchicalNavGraph::copyCells(const NavRaster& raster, const Rect& rect) {
+    for (int y = rect.minY; y <= rect.maxY; ++y) {
+        for (int x = rect.minX; x <= rect.maxX; ++x) {
+            m_walkable[static_cast<std::size_t>(y) * static_cast<std::size_t>(m_width) +
+                       static_cast<std::size_t>(x)] = raster.isWalkable(x, y) ? 1 : 0;
+        }
+    }
+}
+
+void HierarchicalNavGraph::updateCells(const NavRaster& raster, int minX, int minY, int maxX,
+                                       int maxY) {
+    checkRaster(raster);
+    minX = std::max(minX, 0);
+    minY = std::max(minY, 0);
+    maxX = std::min(maxX, m_width - 1);
+    maxY = std::min(maxY, m_height - 1);
+    if (minX > maxX || minY > maxY) return;
+    copyCells(raster, {minX, minY, maxX, maxY});
+    rebuildClusters(minX / m_clusterSize, minY / m_clusterSize, maxX / m_clusterSize,
+                    maxY / m_clusterSize);
+}
+
+void HierarchicalNavGraph::rebuildCluster(const NavRaster& raster, int clusterX, int clusterY) {
+    checkRaster(raster);
+    if (clusterX < 0 || clusterX >= m_clusterColumns || clusterY < 0 ||
+        clusterY >= m_clusterRows) {
+        throw std::out_of_range("HierarchicalNavGraph cluster coordinates are out of bounds");
+    }
+    copyCells(raster, clusterRect(clusterX, clusterY));
+    rebuildClusters(clusterX, clusterY, clusterX, clusterY);
+}
+
+bool HierarchicalNavGraph::walkable(int x, int y) const noexcept {
+    return m_walkable[static_cast<std::size_t>(y) * static_cast<std::size_t>(m_width) +
+                      static_cast<std::size_t>(x)] != 0;
+}
+
+int HierarchicalNavGraph::clusterOf(int cell) const noexcept {
+    const int x = cell % m_width;
+    const int y = cell / m_width;
+    return (y / m_clusterSize) * m_clusterColumns + x / m_clusterSize;
+}
+
+HierarchicalNavGraph::Rect HierarchicalNavGraph::clusterRect(int clusterX,
+                                                             int clusterY) const noexcept {
+    return {clusterX * m_clusterSize, clusterY * m_clusterSize,
+            std::min((clusterX + 1) * m_clusterSize, m_width) - 1,
+            std::min((clusterY + 1) * m_clusterSize, m_height) - 1};
+}
+
+void HierarchicalNavGraph::rebuildClusters(int minClusterX, int minClusterY, int maxClusterX,
+                                           int maxClusterY) {
+    // Changed cells move the entrances on every border of their clusters.
+    for (int cy = minClusterY; cy <= maxClusterY; ++cy) {
+        for (int cx = std::max(minClusterX - 1, 0);
+             cx <= std::min(maxClusterX, m_clusterColumns - 2); ++cx) {
+            buildVerticalBorder(cx, cy);
+        }
+    }
+    for (int cy = std::max(minClusterY - 1, 0); cy <= std::min(maxClusterY, m_clusterRows - 2);
+         ++cy) {
+        for (int cx = minClusterX; cx <= maxClusterX; ++cx) {
+            buildHorizontalBorder(cx, cy);
+        }
+    }
+
+    // Changed clusters need new costs; neighbours only if their entrances moved.
+    m_lastRebuiltClusters = 0;
+    for (int cy = std::max(minClusterY - 1, 0); cy <= std::min(maxClusterY + 1, m_clusterRows - 1);
+         ++cy) {
+        for (int cx = std::max(minClusterX - 1, 0);
+             cx <= std::min(maxClusterX + 1, m_clusterColumns - 1); ++cx) {
+            const int index = cy * m_clusterColumns + cx;
+            Cluster& cluster = m_clusters[static_cast<std::size_t>(index)];
+            Cluster entrances = findEntrances(cx, cy);
+            cluster.partnerOffsets = std::move(entrances.partnerOffsets);
+            cluster.partners = std::move(entrances.partners);
+            const bool changed = cx >= minClusterX && cx <= maxClusterX &&
+                                 cy >= minClusterY && cy <= maxClusterY;
+            if (!changed && entrances.cells == cluster.cells) continue;
+            cluster.cells = std::move(entrances.cells);
+            computeCosts(index);
+            ++m_lastRebuiltClusters;
+        }
+    }
+    indexNodes();
+}
+
+void HierarchicalNavGraph::buildVerticalBorder(int clusterX, int clusterY) {
+    auto& transitions = m_verticalBorders[static_cast<std::size_t>(clusterY) *
+                                              static_cast<std::size_t>(m_clusterColumns - 1) +
+                                          static_cast<std::size_t>(clusterX)];
+    transitions.clear();
+    const Rect rect = clusterRect(clusterX, clusterY);
+    const int x = rect.maxX;
+    const auto addTransition = [&](int y) {
+        const int cell = y * m_width + x;
+        transitions.emplace_back(cell, cell + 1);
+    };
+    for (int y = rect.minY; y <= rect.maxY;) {
+        if (!walkable(x, y) || !walkable(x + 1, y)) {
+            ++y;
+            continue;
+        }
+        const int runStart = y;
+        while (y <= rect.maxY && walkable(x, y) && walkable(x + 1, y)) ++y;
+        const int runEnd = y - 1;
+        if (runEnd - runStart + 1 >= kSplitEntranceLength) {
+            addTransition(runStart);
+            addTransition(runEnd);
+        } else {
+            addTransition((runStart + runEnd) / 2);
+        }
+    }
+}
+
+void HierarchicalNavGraph::buildHorizontalBorder(int clusterX, int clusterY) {
+    auto& transitions = m_horizontalBorders[static_cast<std::size_t>(clusterY) *
+                                                static_cast<std::size_t>(m_clusterColumns) +
+                                            static_cast<std::size_t>(clusterX)];
+    transitions.clear();
+    const Rect rect = clusterRect(clusterX, clusterY);
+    const int y = rect.maxY;
+    const auto addTransition = [&](int x) {
+        const int cell = y * m_width + x;
+        transitions.emplace_back(cell, cell + m_width);
+    };
+    for (int x = rect.minX; x <= rect.maxX;) {
+        if (!walkable(x, y) || !walkable(x, y + 1)) {
+            ++x;
+            continue;
+        }
+        const int runStart = x;
+        while (x <= rect.maxX && walkable(x, y) && walkable(x, y + 1)) ++x;
+        const int runEnd = x - 1;
+        if (runEnd - runStart + 1 >= kSplitEntranceLength) {
+            addTransition(runStart);
+            addTransition(runEnd);
+        } else {
+            addTransition((runStart + runEnd) / 2);
+        }
+    }
+}
+
+HierarchicalNavGraph::Cluster HierarchicalNavGraph::findEntrances(int clusterX,
+                                                                 int clusterY) const {
+    // (own cell, cell across the border) for every transition of the cluster.
+    std::vector<std::pair<int, int>> links;
+    const auto vertical = [&](int cx, int cy) -> const auto& {
+        return m_verticalBorders[static_cast<std::size_t>(cy) *
+                                     static_cast<std::size_t>(m_clusterColumns - 1) +
+                                 static_cast<std::size_t>(cx)];
+    };
+    const auto horizontal = [&](int cx, int cy) -> const auto& {
+        return m_horizontalBorders[static_cast<std::size_t>(cy) *
+                                       static_cast<std::size_t>(m_clusterColumns) +
+                                   static_cast<std::size_t>(cx)];
+    };
+    if (clusterX > 0) {
+        for (const auto& [lower, upper] : vertical(clusterX - 1, clusterY)) {
+            links.emplace_back(upper, lower);
+        }
+    }
+    if (clusterX < m_clusterColumns - 1) {
+        for (const auto& [lower, upper] : vertical(clusterX, clusterY)) {
+            links.emplace_back(lower, upper);
+        }
+    }
+    if (clusterY > 0) {
+        for (const auto& [lower, upper] : horizontal(clusterX, clusterY - 1)) {
+            links.emplace_back(upper, lower);
+        }
+    }
+    if (clusterY < m_clusterRows - 1) {
+        for (const auto& [lower, upper] : horizontal(clusterX, clusterY)) {
+            links.emplace_back(lower, upper);
+        }
+    }
+    std::sort(links.begin(), links.end());
+
+    Cluster cluster;
+    cluster.partnerOffsets.push_back(0);
+    for (const auto& [cell, partner] : links) {
+        if (cluster.cells.empty() || cluster.cells.back() != cell) {
+            cluster.cells.push_back(cell);
+            cluster.partnerOffsets.push_back(cluster.partnerOffsets.back());
+        }
+        cluster.partners.push_back(partner);
+        ++cluster.partnerOffsets.back();
+    }
+    return cluster;
+}
+
+void HierarchicalNavGraph::computeCosts(int cluster) {
+    Cluster& entry = m_clusters[static_cast<std::size_t>(cluster)];
+    const Rect rect = clusterRect(cluster % m_clusterColumns, cluster / m_clusterColumns);
+    const int rectWidth = rect.maxX - rect.minX + 1;
+    const std::size_t count = entry.cells.size();
+    entry.costs.assign(count * count, kInfinity);
+    entry.connectedPairs = 0;
+    SearchScratch scratch;
+    const std::span<const int> cells(entry.cells);
+    for (std::size_t from = 0; from < count; ++from) {
+        entry.costs[from * count + from] = 0.0f;
+        if (from + 1 == count) break;
+        // Costs are symmetric: one Dijkstra per entrance to all later ones.
+        searchRect(rect, cells[from], -1, scratch, cells.subspan(from + 1));
+        for (std::size_t to = from + 1; to < count; ++to) {
+            const int cell = cells[to];
+            const float cost = scratch.cost((cell / m_width - rect.minY) * rectWidth +
+                                            cell % m_width - rect.minX);
+            entry.costs[from * count + to] = cost;
+            entry.costs[to * count + from] = cost;
+            if (cost < kInfinity) entry.connectedPairs += 2;
+        }
+    }
+}
+
+int HierarchicalNavGraph::nodeAt(int cell) const {
+    const auto cluster = static_cast<std::size_t>(clusterOf(cell));
+    const auto& cells = m_clusters[cluster].cells;
+    const auto found = std::lower_bound(cells.begin(), cells.end(), cell);
+    if (found == cells.end() || *found != cell) return -1;
+    return static_cast<int>(m_clusterNodeOffsets[cluster]) +
+           static_cast<int>(found - cells.begin());
+}
+
+void HierarchicalNavGraph::indexNodes() {
+    m_nodeCells.clear();
+    m_clusterNodeOffsets.assign(m_clusters.size() + 1, 0);
+    m_edgeCount = 0;
+    for (std::size_t c = 0; c < m_clusters.size(); ++c) {
+        const Cluster& cluster = m_clusters[c];
+        m_clusterNodeOffsets[c] = static_cast<std::uint32_t>(m_nodeCells.size());
+        m_nodeCells.insert(m_nodeCells.end(), cluster.cells.begin(), cluster.cells.end());
+        m_edgeCount += cluster.connectedPairs + cluster.partners.size();
+    }
+    m_clusterNodeOffsets.back() = static_cast<std::uint32_t>(m_nodeCells.size());
+}
+
+std::size_t HierarchicalNavGraph::searchRect(const Rect& rect, int startCell, int goalCell,
+                                             SearchScratch& scratch,
+                                             std::span<const int> targets) const {
+    const int rectWidth = rect.maxX - rect.minX + 1;
+    const int rectHeight = rect.maxY - rect.minY + 1;
+    scratch.prepare(static_cast<std::size_t>(rectWidth) * static_cast<std::size_t>(rectHeight));
+    const auto toLocal = [&](int cell) {
+        return (cell / m_width - rect.minY) * rectWidth + cell % m_width - rect.minX;
+    };
+    const int goalX = goalCell >= 0 ? goalCell % m_width : 0;
+    const int goalY = goalCell >= 0 ? goalCell / m_width : 0;
+    const bool directed = goalCell >= 0 && targets.empty();
+    const int goalLocal = directed ? toLocal(goalCell) : -1;
+    const auto heuristic = [&](int x, int y) {
+        return directed ? octile(goalX - x, goalY - y) : 0.0f;
+    };
+    std::size_t unsettled = targets.size();
+    if (goalCell >= 0 && !targets.empty() &&
+        !std::binary_search(targets.begin(), targets.end(), goalCell)) {
+        ++unsettled;
+    }
+
+    const int startLocal = toLocal(startCell);
+    scratch.relax(startLocal, -1, 0.0f, heuristic(startCell % m_width, startCell / m_width));
+    std::size_t expansions = 0;
+    for (int current = scratch.pop(); current >= 0; current = scratch.pop()) {
+        ++expansions;
+        if (current == goalLocal) break;
+        const int x = rect.minX + current % rectWidth;
+        const int y = rect.minY + current / rectWidth;
+        if (!targets.empty()) {
+            const int cell = y * m_width + x;
+            if ((cell == goalCell || std::binary_search(targets.begin(), targets.end(), cell)) &&
+                --unsettled == 0) {
+                break;
+            }
+        }
+        const float g = scratch.g[static_cast<std::size_t>(current)];
+        for (int direction = 0; direction < 8; ++direction) {
+            const int nx = x + kNeighborX[direction];
+            const int ny = y + kNeighborY[direction];
+            if (nx < rect.minX || nx > rect.maxX || ny < rect.minY || ny > rect.maxY ||
+                !walkable(nx, ny)) {
+                continue;
+            }
+            const bool diagonal = direction >= 4;
+            if (diagonal && (!walkable(nx, y) || !walkable(x, ny))) continue;
+            const int next = (ny - rect.minY) * rectWidth + nx - rect.minX;
+            scratch.relax(next, current, g + (diagonal ? kDiagonalCost : 1.0f),
+                          heuristic(nx, ny));
+        }
+    }
+    return expansions;
+}
+
+bool HierarchicalNavGraph::findAbstractPath(const glm::vec2& start, const glm::vec2& end,
+                                            HierarchicalPath& out) const {
+    out.waypoints.clear();
+    out.cells.clear();
+    out.refinedSegments = 0;
+    out.abstractExpansions = 0;
+    out.refineExpansions = 0;
+    if (m_walkable.empty()) return false;
+
+    const auto locate = [&](const glm::vec2& point) {
+        const float fx = std::floor((point.x - m_origin.x) / m_cellSize);
+        const float fy = std::floor((point.y - m_origin.y) / m_cellSize);
+        // Also rejects NaN.
+        if (!(fx >= 0.0f && fx < static_cast<float>(m_width) && fy >= 0.0f &&
+              fy < static_cast<float>(m_height))) {
+            return -1;
+        }
+        const int x = static_cast<int>(fx);
+        const int y = static_cast<int>(fy);
+        return walkable(x, y) ? y * m_width + x : -1;
+    };
+    const int startCell = locate(start);
+    const int goalCell = locate(end);
+    if (startCell < 0 || goalCell < 0) return false;
+
+    thread_local SearchScratch grid;
+    thread_local SearchScratch abstract;
+    thread_local std::vector<float> startCosts;
+    thread_local std::vector<float> goalCosts;
+
+    const int startCluster = clusterOf(startCell);
+    const int goalCluster = clusterOf(goalCell);
+    // Costs from an endpoint to the entrances of its own cluster (and, from
+    // the start, to the goal when it shares the cluster).
+    const auto costsToEntrances = [&](int cell, int cluster, int target,
+                                      std::vector<float>& costs) {
+        const auto& cells = m_clusters[static_cast<std::size_t>(cluster)].cells;
+        costs.assign(cells.size(), kInfinity);
+        if (cells.empty() && target < 0) return kInfinity;
+        const Rect rect = clusterRect(cluster % m_clusterColumns, cluster / m_clusterColumns);
+        const int rectWidth = rect.maxX - rect.minX + 1;
+        const auto toLocal = [&](int c) {
+            return (c / m_width - rect.minY) * rectWidth + c % m_width - rect.minX;
+        };
+        out.abstractExpansions += searchRect(rect, cell, target, grid, cells);
+        for (std::size_t i = 0; i < cells.size(); ++i) {
+            costs[i] = grid.cost(toLocal(cells[i]));
+        }
+        return target >= 0 ? grid.cost(toLocal(target)) : kInfinity;
+    };
+    const float directCost = costsToEntrances(
+        startCell, startCluster, startCluster == goalCluster ? goalCell : -1, startCosts);
+    costsToEntrances(goalCell, goalCluster, -1, goalCosts);
+
+    // Abstract A*; the endpoints are extra nodes after the entrances.
+    const int nodes = static_cast<int>(m_nodeCells.size());
+    const int startNode = nodes;
+    const int goalNode = nodes + 1;
+    const auto cellOf = [&](int node) {
+        return node == startNode ? startCell : node == goalNode ? goalCell
+                                             : m_nodeCells[static_cast<std::size_t>(node)];
+    };
+    const auto relax = [&](int node, int from, float cost) {
+        const int cell = cellOf(node);
+        abstract.relax(node, from, cost,
+                       octile(goalCell % m_width - cell % m_width, goalCell / m_width - cell / m_width));
+    };
+    const auto startBase = static_cast<int>(m_clusterNodeOffsets[static_cast<std::size_t>(startCluster)]);
+    const auto goalBase = static_cast<int>(m_clusterNodeOffsets[static_cast<std::size_t>(goalCluster)]);
+    const auto goalEnd = static_cast<int>(m_clusterNodeOffsets[static_cast<std::size_t>(goalCluster) + 1]);
+
+    abstract.prepare(static_cast<std::size_t>(nodes) + 2);
+    relax(startNode, -1, 0.0f);
+    bool found = false;
+    for (int current = abstract.pop(); current >= 0; current = abstract.pop()) {
+        ++out.abstractExpansions;
+        if (current == goalNode) {
+            found = true;
+            break;
+        }
+        const float g = abstract.g[static_cast<std::size_t>(current)];
+        if (current == startNode) {
+            for (std::size_t i = 0; i < startCosts.size(); ++i) {
+                if (startCosts[i] < kInfinity) {
+                    relax(startBase + static_cast<int>(i), current, startCosts[i]);
+                }
+            }
+            if (directCost < kInfinity) relax(goalNode, current, directCost);
+            continue;
+        }
+        const auto clusterIndex =
+            static_cast<std::size_t>(clusterOf(m_nodeCells[static_cast<std::size_t>(current)]));
+        const Cluster& cluster = m_clusters[clusterIndex];
+        const int base = static_cast<int>(m_clusterNodeOffsets[clusterIndex]);
+        const auto local = static_cast<std::size_t>(current - base);
+        const std::size_t count = cluster.cells.size();
+        for (std::size_t to = 0; to < count; ++to) {
+            const float cost = cluster.costs[local * count + to];
+            if (to != local && cost < kInfinity) {
+                relax(base + static_cast<int>(to), current, g + cost);
+            }
+        }
+        for (std::uint32_t p = cluster.partnerOffsets[local]; p < cluster.partnerOffsets[local + 1];
+             ++p) {
+            relax(nodeAt(cluster.partners[p]), current, g + 1.0f);
+        }
+        if (current >= goalBase && current < goalEnd) {
+            const float toGoal = goalCosts[static_cast<std::size_t>(current - goalBase)];
+            if (toGoal < kInfinity) relax(goalNode, current, g + toGoal);
+        }
+    }
+    if (!found) return false;
+
+    for (int node = goalNode; node != -1; node = abstract.parent[static_cast<std::size_t>(node)]) {
+        out.cells.push_back(cellOf(node));
+    }
+    std::reverse(out.cells.begin(), out.cells.end());
+    // Entrances on an endpoint's own cell add nothing; keep the exact endpoints.
+    const int last = out.cells.back();
+    out.cells.erase(std::unique(out.cells.begin(), out.cells.end()), out.cells.end());
+    if (out.cells.size() == 1) out.cells.push_back(last);
+    out.waypoints.reserve(out.cells.size());
+    for (const int cell : out.cells) {
+        out.waypoints.push_back(m_origin + (glm::vec2{static_cast<float>(cell % m_width),
+                                                      static_cast<float>(cell / m_width)} +
+                                            0.5f) * m_cellSize);
+    }
+    out.waypoints.front() = start;
+    out.waypoints.back() = end;
+    return true;
+}
+
+std::size_t HierarchicalNavGraph::refine(HierarchicalPath& path, std::size_t segments,
+                                         NavPath& out) const {
+    thread_local SearchScratch grid;
+    thread_local std::vector<int> cells;
+    std::size_t refined = 0;
+    while (refined < segments && !path.fullyRefined()) {
+        const std::size_t segment = path.refinedSegments;
+        const int from = path.cells[segment];
+        const int to = path.cells[segment + 1];
+        if (out.points.empty() || out.points.back() != path.waypoints[segment]) {
+            out.points.push_back(path.waypoints[segment]);
+        }
+        // Segments across a border join neighbouring cells; the rest stay
+        // inside one cluster, where their cost was found.
+        if (from != to && clusterOf(from) == clusterOf(to)) {
+            const int cluster = clusterOf(from);
+            const Rect rect = clusterRect(cluster % m_clusterColumns, cluster / m_clusterColumns);
+            const int rectWidth = rect.maxX - rect.minX + 1;
+            const auto toLocal = [&](int cell) {
+                return (cell / m_width - rect.minY) * rectWidth + cell % m_width - rect.minX;
+            };
+            path.refineExpansions += searchRect(rect, from, to, grid);
+            if (grid.cost(toLocal(to)) == kInfinity) {
+                // The graph changed since the abstract search; plan again.
+                path.waypoints.clear();
+                path.cells.clear();
+                path.refinedSegments = 0;
+                return refined;
+            }
+            cells.clear();
+            for (int local = grid.parent[static_cast<std::size_t>(toLocal(to))];
+                 local != toLocal(from); local = grid.parent[static_cast<std::size_t>(local)]) {
+                cells.push_back(local);
+            }
+            for (auto it = cells.rbegin(); it != cells.rend(); ++it) {
+                const int x = rect.minX + *it % rectWidth;
+                const int y = rect.minY + *it / rectWidth;
+                out.points.push_back(
+                    m_origin + (glm::vec2{static_cast<float>(x), static_cast<float>(y)} + 0.5f) *
+                                   m_cellSize);
+            }
+        }
+        if (out.points.back() != path.waypoints[segment + 1]) {
+            out.points.push_back(path.waypoints[segment + 1]);
+        }
+        ++path.refinedSegments;
+        ++refined;
+    }
+    return refined;
+}
+
+NavPath HierarchicalNavGraph::findPath(const glm::vec2& start, const glm::vec2& end) const {
+    NavPath path;
+    HierarchicalPath route;
+    if (findAbstractPath(start, end, route)) {
+        refine(route, route.segmentCount(), path);
+    }
+    return path;
+}
@@ -0,0 +1,144 @@
+#ifndef HIERARCHICAL_NAV_GRAPH_HPP
+#define HIERARCHICAL_NAV_GRAPH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <glm/vec2.hpp>
+
+#include "INavMesh.hpp"
+
+// Route found on a HierarchicalNavGraph's abstract graph: the start, the
+// cluster entrance cells it passes, and the goal. Segments between
+// consecutive waypoints are refined into cell paths only when asked for.
+struct HierarchicalPath {
+    std::vector<glm::vec2> waypoints;
+    // Raster cell index (y * width + x) of each waypoint.
+    std::vector<int> cells;
+    std::size_t refinedSegments{0};
+    // Nodes expanded by the abstract search (including locating the endpoints
+    // in their clusters) and by refinement so far.
+    std::size_t abstractExpansions{0};
+    std::size_t refineExpansions{0};
+
+    [[nodiscard]] bool valid() const { return !waypoints.empty(); }
+    [[nodiscard]] std::size_t segmentCount() const {
+        return waypoints.empty() ? 0 : waypoints.size() - 1;
+    }
+    [[nodiscard]] bool fullyRefined() const { return refinedSegments >= segmentCount(); }
+};
+
+// HPA*-style hierarchical search over a NavRaster. The raster is split into
+// square clusters; walkable runs along each cluster border become entrances
+// (one transition in the middle of a short run, one at each end of a long
+// one), and the costs between every pair of entrances inside a cluster are
+// cached. Queries search this small abstract graph, then refine the route
+// cluster by cluster with A* confined to one cluster, so an agent only pays
+// for the segments it is about to walk. Cells connect to their 8 neighbours;
+// diagonal steps may not cut blocked corners.
+//
+// Paths run through cell centers between the exact endpoints and are close to,
+// but not always, the shortest. Clusters can be rebuilt individually after
+// the raster changes. Queries are safe from several threads while the graph
+// is not being modified.
+class HierarchicalNavGraph final : public INavMesh {
+public:
+    static constexpr int kDefaultClusterSize = 16;
+
+    explicit HierarchicalNavGraph(int clusterSize = kDefaultClusterSize);
+
+    void buildFromRaster(const NavRaster& raster) override;
+    void clear() override;
+    // Abstract search with every segment refined; empty when either endpoint
+    // is not on a walkable cell or no route exists.
+    [[nodiscard]] NavPath findPath(const glm::vec2& start,
+                                   const glm::vec2& end) const override;
+
+    // Abstract search only. Returns out.valid().
+    bool findAbstractPath(const glm::vec2& start, const glm::vec2& end,
+                          HierarchicalPath& out) const;
+    // Appends the points of up to `segments` next unrefined segments of
+    // `path` to `out` and returns how many were refined.
+    std::size_t refine(HierarchicalPath& path, std::size_t segments, NavPath& out) const;
+
+    // Copies the raster cells in the inclusive rectangle and rebuilds the
+    // clusters they touch, plus neighbours whose entrances changed. The
+    // raster must have the dimensions the graph was built with.
+    void updateCells(const NavRaster& raster, int minX, int minY, int maxX, int maxY);
+    void rebuildCluster(const NavRaster& raster, int clusterX, int clusterY);
+
+    [[nodiscard]] int clusterSize() const noexcept { return m_clusterSize; }
+    [[nodiscard]] int clusterColumns() const noexcept { return m_clusterColumns; }
+    [[nodiscard]] int clusterRows() const noexcept { return m_clusterRows; }
+    [[nodiscard]] std::size_t nodeCount() const noexcept { return m_nodeCells.size(); }
+    [[nodiscard]] std::size_t edgeCount() const noexcept { return m_edgeCount; }
+    // Clusters whose entrance costs the last build or update recomputed.
+    [[nodiscard]] std::size_t lastRebuiltClusterCount() const noexcept {
+        return m_lastRebuiltClusters;
+    }
+
+private:
+    struct Rect {
+        int minX;
+        int minY;
+        int maxX;
+        int maxY;
+    };
+    // A cluster's part of the abstract graph, so rebuilding one touches no
+    // other cluster's edges.
+    struct Cluster {
+        // Entrance cells, sorted, and the cost between each pair (row-major,
+        // infinity when the pair is not connected inside the cluster).
+        std::vector<int> cells;
+        std::vector<float> costs;
+        std::size_t connectedPairs{0};
+        // Cells across a border from entrance i: [offset[i], offset[i + 1]).
+        std::vector<std::uint32_t> partnerOffsets;
+        std::vector<int> partners;
+    };
+    struct SearchScratch;
+
+    void checkRaster(const NavRaster& raster) const;
+    void copyCells(const NavRaster& raster, const Rect& rect);
+    [[nodiscard]] bool walkable(int x, int y) const noexcept;
+    [[nodiscard]] int clusterOf(int cell) const noexcept;
+    [[nodiscard]] Rect clusterRect(int clusterX, int clusterY) const noexcept;
+    void rebuildClusters(int minClusterX, int minClusterY, int maxClusterX, int maxClusterY);
+    void buildVerticalBorder(int clusterX, int clusterY);
+    void buildHorizontalBorder(int clusterX, int clusterY);
+    [[nodiscard]] Cluster findEntrances(int clusterX, int clusterY) const;
+    void computeCosts(int cluster);
+    void indexNodes();
+    [[nodiscard]] int nodeAt(int cell) const;
+
+    // Search over the cells of `rect`; fills the scratch with costs and
+    // parents and returns the expansions. Without targets this is A* to
+    // `goalCell`; with them, Dijkstra until every target cell (sorted) and
+    // `goalCell` (if not negative) is settled.
+    std::size_t searchRect(const Rect& rect, int startCell, int goalCell, SearchScratch& scratch,
+                           std::span<const int> targets = {}) const;
+
+    int m_clusterSize;
+    int m_width{0};
+    int m_height{0};
+    float m_cellSize{1.0f};
+    glm::vec2 m_origin{0.0f};
+    std::vector<std::uint8_t> m_walkable;
+    int m_clusterColumns{0};
+    int m_clusterRows{0};
+    // Transitions (cell on the lower side, cell on the upper side) across the
+    // border right of / above each cluster.
+    std::vector<std::vector<std::pair<int, int>>> m_verticalBorders;
+    std::vector<std::vector<std::pair<int, int>>> m_horizontalBorders;
+    std::vector<Cluster> m_clusters;
+    // Abstract graph nodes: the clusters' entrance cells in cluster order.
+    std::vector<int> m_nodeCells;
+    std::vector<std::uint32_t> m_clusterNodeOffsets;
+    std::size_t m_edgeCount{0};
+    std::size_t m_lastRebuiltClusters{0};
+};
+
+#endif // HIERARCHICAL_NAV_GRAPH_HPP
@@ -0,0 +1,283 @@
+#include "NavQuery.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#include <glm/geometric.hpp>
+
+#include "PolyNavMesh.hpp"
+
+namespace {
+constexpr float kEps = 1e-4f;
+
+bool isFinite(const glm::vec2& value) {
+    return std::isfinite(value.x) && std::isfinite(value.y);
+}
+
+float signedArea(const glm::vec2& apex, const glm::vec2& a, const glm::vec2& b) {
+    return (a.x - apex.x) * (b.y - apex.y) -
+           (a.y - apex.y) * (b.x - apex.x);
+}
+
+bool nearlyEqual(const glm::vec2& a, const glm::vec2& b) {
+    const glm::vec2 delta = a - b;
+    return glm::dot(delta, delta) <= kEps * kEps;
+}
+}
+
+NavPath NavQuery::findPath(const PolyNavMesh& mesh, const glm::vec2& start,
+                           const glm::vec2& end) {
+    NavPath path;
+    findPath(mesh, start, end, path);
+    return path;
+}
+
+bool NavQuery::findPath(const PolyNavMesh& mesh, const glm::vec2& start, const glm::vec2& end,
+                        NavPath& out) {
+    out.points.clear();
+    m_corridor.clear();
+    if (!isFinite(start) || !isFinite(end)) return false;
+    const int startPoly = mesh.findPoly(start);
+    const int endPoly = mesh.findPoly(end);
+    if (startPoly < 0 || endPoly < 0) {
+        return false;
+    }
+    beginSearch(mesh, startPoly, endPoly);
+    if (continueSearch(mesh, std::numeric_limits<std::size_t>::max()) != NavSearchStatus::Found) {
+        return false;
+    }
+    return buildPath(mesh, start, end, out);
+}
+
+bool NavQuery::buildPath(const PolyNavMesh& mesh, const glm::vec2& start, const glm::vec2& end,
+                         NavPath& out) {
+    out.points.clear();
+    if (m_status != NavSearchStatus::Found) {
+        return false;
+    }
+    if (m_corridor.size() == 1) {
+        out.points.push_back(start);
+        if (!nearlyEqual(start, end)) out.points.push_back(end);
+        return true;
+    }
+    buildPortals(mesh, start, end);
+    funnel(start, end, out);
+    return true;
+}
+
+void NavQuery::prepare(std::size_t polyCount) {
+    if (m_nodes.size() < polyCount) {
+        m_nodes.resize(polyCount);
+    }
+    if (++m_generation == 0) {
+        // Wrapped: stale stamps could now look current, so clear them once.
+        for (Node& n : m_nodes) n.generation = 0;
+        m_generation = 1;
+    }
+    m_heap.clear();
+    m_heap.reserve(polyCount);
+}
+
+NavQuery::Node& NavQuery::node(int poly) {
+    Node& n = m_nodes[static_cast<std::size_t>(poly)];
+    if (n.generation != m_generation) {
+        n = Node{std::numeric_limits<float>::infinity(), 0.0f, -1, kNotQueued, m_generation};
+    }
+    return n;
+}
+
+bool NavQuery::reached(int poly) const noexcept {
+    return m_status != NavSearchStatus::Idle && poly >= 0 &&
+           static_cast<std::size_t>(poly) < m_nodes.size() &&
+           m_nodes[static_cast<std::size_t>(poly)].generation == m_generation;
+}
+
+bool NavQuery::expanded(int poly) const noexcept {
+    return reached(poly) && m_nodes[static_cast<std::size_t>(poly)].heapIndex == kClosed;
+}
+
+void NavQuery::beginSearch(const PolyNavMesh& mesh, int startPoly, int endPoly) {
+    prepare(mesh.polyCount());
+    m_corridor.clear();
+    m_endPoly = endPoly;
+    m_goal = mesh.polyCenter(endPoly);
+    m_expansions = 0;
+    Node& first = node(startPoly);
+    first.g = 0.0f;
+    first.f = glm::length(m_goal - mesh.polyCenter(startPoly));
+    push(startPoly);
+    m_status = NavSearchStatus::InProgress;
+}
+
+NavSearchStatus NavQuery::continueSearch(const PolyNavMesh& mesh, std::size_t maxExpansions) {
+    // A tiled update may have added polygons since the search began.
+    if (m_nodes.size() < mesh.polyCount()) {
+        m_nodes.resize(mesh.polyCount());
+    }
+    for (std::size_t expanded = 0;
+         m_status == NavSearchStatus::InProgress && expanded < maxExpansions; ++expanded) {
+        if (m_heap.empty()) {
+            m_status = NavSearchStatus::NoPath;
+            break;
+        }
+        const int current = pop();
+        ++m_expansions;
+        if (current == m_endPoly) {
+            for (int poly = m_endPoly; poly != -1;
+                 poly = m_nodes[static_cast<std::size_t>(poly)].parent) {
+                m_corridor.push_back(poly);
+            }
+            std::reverse(m_corridor.begin(), m_corridor.end());
+            m_status = NavSearchStatus::Found;
+            break;
+        }
+        const float currentG = m_nodes[static_cast<std::size_t>(current)].g;
+        for (const NavLink& link : mesh.links(current)) {
+            Node& next = node(link.neighbor);
+            if (next.heapIndex == kClosed) continue;
+            const float tentativeG = currentG + link.cost;
+            if (tentativeG < next.g - kEps) {
+                next.parent = current;
+                next.g = tentativeG;
+                next.f = tentativeG + glm::length(m_goal - mesh.polyCenter(link.neighbor));
+                if (next.heapIndex == kNotQueued) {
+                    push(link.neighbor);
+                } else {
+                    siftUp(static_cast<std::size_t>(next.heapIndex));
+                }
+            }
+        }
+    }
+    if (m_status == NavSearchStatus::InProgress && m_heap.empty()) {
+        m_status = NavSearchStatus::NoPath;
+    }
+    return m_status;
+}
+
+void NavQuery::buildPortals(const PolyNavMesh& mesh, const glm::vec2& start,
+                            const glm::vec2& end) {
+    m_portals.clear();
+    m_portals.push_back({start, start});
+    for (std::size_t i = 0; i + 1 < m_corridor.size(); ++i) {
+        const auto links = mesh.links(m_corridor[i]);
+        const auto link = std::find_if(links.begin(), links.end(), [&](const NavLink& l) {
+            return l.neighbor == m_corridor[i + 1];
+        });
+        if (link == links.end()) {
+            throw std::logic_error("Navmesh path corridor is missing a shared portal");
+        }
+        m_portals.push_back({link->left, link->right});
+    }
+    m_portals.push_back({end, end});
+}
+
+void NavQuery::funnel(const glm::vec2& start, const glm::vec2& end, NavPath& out) const {
+    const auto& portals = m_portals;
+    glm::vec2 apex = start;
+    glm::vec2 left = portals[0].left;
+    glm::vec2 right = portals[0].right;
+    std::size_t apexIndex = 0, leftIndex = 0, rightIndex = 0;
+    out.points.push_back(apex);
+
+    for (std::size_t i = 1; i < portals.size(); ++i) {
+        const glm::vec2 newLeft = portals[i].left;
+        const glm::vec2 newRight = portals[i].right;
+
+        // Tighten right
+        if (signedArea(apex, right, newRight) <= 0.0f) {
+            if (nearlyEqual(apex, right) || signedArea(apex, left, newRight) > 0.0f) {
+                right = newRight;
+                rightIndex = i;
+            } else {
+                apex = left;
+                if (!nearlyEqual(out.points.back(), apex)) out.points.push_back(apex);
+                apexIndex = leftIndex;
+                left = apex;
+                right = apex;
+                leftIndex = apexIndex;
+                rightIndex = apexIndex;
+                i = apexIndex;
+                continue;
+            }
+        }
+
+        // Tighten left
+        if (signedArea(apex, left, newLeft) >= 0.0f) {
+            if (nearlyEqual(apex, left) || signedArea(apex, right, newLeft) < 0.0f) {
+                left = newLeft;
+                leftIndex = i;
+            } else {
+                apex = right;
+                if (!nearlyEqual(out.points.back(), apex)) out.points.push_back(apex);
+                apexIndex = rightIndex;
+                left = apex;
+                right = apex;
+                leftIndex = apexIndex;
+                rightIndex = apexIndex;
+                i = apexIndex;
+                continue;
+            }
+        }
+    }
+
+    if (glm::length(out.points.back() - end) > kEps) {
+        out.points.push_back(end);
+    }
+}
+
+bool NavQuery::before(int a, int b) const noexcept {
+    // Ties go to the lower polygon index so results match a (f, index) queue.
+    const float fa = m_nodes[static_cast<std::size_t>(a)].f;
+    const float fb = m_nodes[static_cast<std::size_t>(b)].f;
+    return fa < fb || (fa == fb && a < b);
+}
+
+void NavQuery::push(int poly) {
+    m_heap.push_back(poly);
+    m_nodes[static_cast<std::size_t>(poly)].heapIndex = static_cast<std::int32_t>(m_heap.size() - 1);
+    siftUp(m_heap.size() - 1);
+}
+
+int NavQuery::pop() {
+    const int top = m_heap.front();
+    m_nodes[static_cast<std::size_t>(top)].heapIndex = kClosed;
+    const int last = m_heap.back();
+    m_heap.pop_back();
+    if (!m_heap.empty()) {
+        m_heap.front() = last;
+        m_nodes[static_cast<std::size_t>(last)].heapIndex = 0;
+        siftDown(0);
+    }
+    return top;
+}
+
+void NavQuery::siftUp(std::size_t index) {
+    const int poly = m_heap[index];
+    while (index > 0) {
+        const std::size_t parent = (index - 1) / 2;
+        if (!before(poly, m_heap[parent])) break;
+        m_heap[index] = m_heap[parent];
+        m_nodes[static_cast<std::size_t>(m_heap[index])].heapIndex = static_cast<std::int32_t>(index);
+        index = parent;
+    }
+    m_heap[index] = poly;
+    m_nodes[static_cast<std::size_t>(poly)].heapIndex = static_cast<std::int32_t>(index);
+}
+
+void NavQuery::siftDown(std::size_t index) {
+    const int poly = m_heap[index];
+    const std::size_t count = m_heap.size();
+    while (true) {
+        std::size_t child = index * 2 + 1;
+        if (child >= count) break;
+        if (child + 1 < count && before(m_heap[child + 1], m_heap[child])) ++child;
+        if (!before(m_heap[child], poly)) break;
+        m_heap[index] = m_heap[child];
+        m_nodes[static_cast<std::size_t>(m_heap[index])].heapIndex = static_cast<std::int32_t>(index);
+        index = child;
+    }
+    m_heap[index] = poly;
+    m_nodes[static_cast<std::size_t>(poly)].heapIndex = static_cast<std::int32_t>(index);
+}
@@ -0,0 +1,99 @@
+#ifndef NAV_QUERY_HPP
+#define NAV_QUERY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/vec2.hpp>
+
+#include "NavPath.hpp"
+
+class PolyNavMesh;
+
+enum class NavSearchStatus : std::uint8_t {
+    Idle,
+    InProgress,
+    Found,
+    NoPath
+};
+
+// Reusable path search context for PolyNavMesh. Node state is stamped with a
+// per-search generation instead of being cleared, and the open list is an
+// indexed binary heap with decrease-key, so once its buffers have grown to
+// the mesh size repeated searches allocate nothing. A context is not safe to
+// share between threads; give each worker its own.
+class NavQuery {
+public:
+    NavQuery() = default;
+
+    // Writes the path into `out`, reusing its storage. Returns out.valid();
+    // `out` is empty when either endpoint is off the mesh or no route exists.
+    bool findPath(const PolyNavMesh& mesh, const glm::vec2& start, const glm::vec2& end,
+                  NavPath& out);
+    [[nodiscard]] NavPath findPath(const PolyNavMesh& mesh, const glm::vec2& start,
+                                   const glm::vec2& end);
+
+    // Resumable form of findPath for time-sliced callers: begin a polygon to
+    // polygon search, advance it by at most `maxExpansions` node expansions
+    // per call, then build paths along the found corridor. The mesh must stay
+    // unchanged until the search finishes, except for tiled updates that
+    // remove none of the polygons it has reached and relink none it has
+    // expanded.
+    void beginSearch(const PolyNavMesh& mesh, int startPoly, int endPoly);
+    NavSearchStatus continueSearch(const PolyNavMesh& mesh, std::size_t maxExpansions);
+    [[nodiscard]] NavSearchStatus status() const noexcept { return m_status; }
+    // Node expansions of the current search so far.
+    [[nodiscard]] std::size_t expansions() const noexcept { return m_expansions; }
+    // True when the current search has queued or expanded `poly`.
+    [[nodiscard]] bool reached(int poly) const noexcept;
+    // True when the current search has expanded `poly`, so later changes to
+    // its links are not seen.
+    [[nodiscard]] bool expanded(int poly) const noexcept;
+    // Funnels `start` to `end` through the corridor of a Found search; the
+    // points must lie in its first and last polygons.
+    bool buildPath(const PolyNavMesh& mesh, const glm::vec2& start, const glm::vec2& end,
+                   NavPath& out);
+
+    // Polygons of the last successful search, start to end.
+    [[nodiscard]] const std::vector<int>& corridor() const noexcept { return m_corridor; }
+
+private:
+    static constexpr std::int32_t kNotQueued = -1;
+    static constexpr std::int32_t kClosed = -2;
+
+    struct Node {
+        float g{0.0f};
+        float f{0.0f};
+        int parent{-1};
+        std::int32_t heapIndex{kNotQueued};
+        std::uint32_t generation{0};
+    };
+    struct Portal {
+        glm::vec2 left;
+        glm::vec2 right;
+    };
+
+    void prepare(std::size_t polyCount);
+    [[nodiscard]] Node& node(int poly);
+    void buildPortals(const PolyNavMesh& mesh, const glm::vec2& start, const glm::vec2& end);
+    void funnel(const glm::vec2& start, const glm::vec2& end, NavPath& out) const;
+
+    [[nodiscard]] bool before(int a, int b) const noexcept;
+    void push(int poly);
+    int pop();
+    void siftUp(std::size_t index);
+    void siftDown(std::size_t index);
+
+    std::vector<Node> m_nodes;
+    std::vector<int> m_heap;
+    std::vector<int> m_corridor;
+    std::vector<Portal> m_portals;
+    std::uint32_t m_generation{0};
+    NavSearchStatus m_status{NavSearchStatus::Idle};
+    int m_endPoly{-1};
+    glm::vec2 m_goal{0.0f};
+    std::size_t m_expansions{0};
+};
+
+#endif // NAV_QUERY_HPP
@@ -1,13 +1,39 @@
 #include "NavRaster.hpp"
 
+#include <algorithm>
+#include <bit>
 #include <cmath>
 #include <limits>
 #include <stdexcept>
 
 namespace {
+static_assert(NavRaster::kCellsPerWord % NavRaster::kTileSize == 0,
+              "Tiles must not straddle raster words");
+
 bool isFinite(const glm::vec2& value) {
     return std::isfinite(value.x) && std::isfinite(value.y);
 }
+
+// Bits of word `word` covering cells [minX, maxX].
+std::uint64_t cellMask(int word, int minX, int maxX) {
+    const int first = std::max(minX - word * NavRaster::kCellsPerWord, 0);
+    const int last = std::min(maxX - word * NavRaster::kCellsPerWord, NavRaster::kCellsPerWord - 1);
+    if (first > last) return 0;
+    const std::uint64_t upTo = last == 63 ? ~std::uint64_t{0} : (std::uint64_t{1} << (last + 1)) - 1;
+    return upTo & ~((std::uint64_t{1} << first) - 1);
+}
+
+// Cells [first, last] along one axis whose interior overlaps [min, max].
+bool overlappedCells(double min, double max, double origin, double cellSize, int count,
+                     int& first, int& last) {
+    if (!(max > min)) return false;
+    const double lo = std::floor((min - origin) / cellSize);
+    const double hi = std::ceil((max - origin) / cellSize) - 1.0;
+    if (hi < 0.0 || lo >= count) return false;
+    first = static_cast<int>(std::max(lo, 0.0));
+    last = static_cast<int>(std::min(hi, static_cast<double>(count - 1)));
+    return first <= last;
+}
 }
 
 NavRaster::NavRaster(int width, int height, float cellSize, const glm::vec2& origin)
@@ -37,11 +63,21 @@ NavRaster::NavRaster(int width, int height, float cellSize, const glm::vec2& ori
     if (widthSize > std::numeric_limits<std::size_t>::max() / heightSize) {
         throw std::length_error("NavRaster cell count overflows size_t");
     }
-    const std::size_t count = widthSize * heightSize;
-    if (count > m_walkableCells.max_size()) {
+    m_wordsPerRow = (width + kCellsPerWord - 1) / kCellsPerWord;
+    const auto wordsPerRow = static_cast<std::size_t>(m_wordsPerRow);
+    if (wordsPerRow > m_words.max_size() / heightSize) {
         throw std::length_error("NavRaster is too large");
     }
-    m_walkableCells.assign(count, std::uint8_t{1});
+    // Everything starts walkable; the padding past the width does not.
+    m_words.assign(wordsPerRow * heightSize, ~std::uint64_t{0});
+    const int tail = width % kCellsPerWord;
+    if (tail != 0) {
+        for (std::size_t y = 0; y < heightSize; ++y) {
+            m_words[(y + 1) * wordsPerRow - 1] = (std::uint64_t{1} << tail) - 1;
+        }
+    }
+    m_dirtyTileFlags.assign(static_cast<std::size_t>(tileColumns()) *
+                                static_cast<std::size_t>(tileRows()), std::uint8_t{0});
 }
 
 bool NavRaster::inBounds(int x, int y) const
@@ -49,19 +85,14 @@ bool NavRaster::inBounds(int x, int y) const
     return x >= 0 && x < m_width && y >= 0 && y < m_height;
 }
 
-std::size_t NavRaster::indexUnchecked(int x, int y) const
-{
-    return static_cast<std::size_t>(y) * static_cast<std::size_t>(m_width) +
-           static_cast<std::size_t>(x);
-}
-
 bool NavRaster::isWalkable(int x, int y) const
 {
     if (!inBounds(x, y))
     {
         return false;
     }
-    return m_walkableCells[indexUnchecked(x, y)] != 0;
+    const std::uint64_t word = rowWords(y)[static_cast<std::size_t>(x / kCellsPerWord)];
+    return (word >> (x % kCellsPerWord) & 1u) != 0;
 }
 
 void NavRaster::setWalkable(int x, int y, bool walkable)
@@ -70,7 +101,118 @@ void NavRaster::setWalkable(int x, int y, bool walkable)
     {
         throw std::out_of_range("NavRaster cell coordinates are out of bounds");
     }
-    m_walkableCells[indexUnchecked(x, y)] = walkable ? 1 : 0;
+    writeWord(y, x / kCellsPerWord, std::uint64_t{1} << (x % kCellsPerWord), walkable);
+}
+
+void NavRaster::writeWord(int y, int word, std::uint64_t mask, bool walkable)
+{
+    std::uint64_t& bits = m_words[static_cast<std::size_t>(y) * static_cast<std::size_t>(m_wordsPerRow) +
+                                  static_cast<std::size_t>(word)];
+    const std::uint64_t updated = walkable ? bits | mask : bits & ~mask;
+    std::uint64_t changed = bits ^ updated;
+    if (changed == 0) {
+        return;
+    }
+    bits = updated;
+    const int rowTile = (y / kTileSize) * tileColumns();
+    while (changed != 0) {
+        const int part = std::countr_zero(changed) / kTileSize;
+        markDirty(rowTile + word * (kCellsPerWord / kTileSize) + part);
+        // Skip the rest of this tile's bits.
+        const int next = (part + 1) * kTileSize;
+        changed = next >= kCellsPerWord ? 0 : changed & ~((std::uint64_t{1} << next) - 1);
+    }
+}
+
+void NavRaster::markDirty(int tile)
+{
+    std::uint8_t& dirty = m_dirtyTileFlags[static_cast<std::size_t>(tile)];
+    if (!dirty) {
+        dirty = 1;
+        m_dirtyTiles.push_back(tile);
+    }
+}
+
+void NavRaster::fillCells(int minX, int minY, int maxX, int maxY, bool walkable)
+{
+    minX = std::max(minX, 0);
+    minY = std::max(minY, 0);
+    maxX = std::min(maxX, m_width - 1);
+    maxY = std::min(maxY, m_height - 1);
+    if (minX > maxX || minY > maxY) {
+        return;
+    }
+    for (int y = minY; y <= maxY; ++y) {
+        for (int word = minX / kCellsPerWord; word <= maxX / kCellsPerWord; ++word) {
+            writeWord(y, word, cellMask(word, minX, maxX), walkable);
+        }
+    }
+}
+
+void NavRaster::stampBounds(const NavAABB& bounds, bool walkable)
+{
+    int minX = 0;
+    int maxX = 0;
+    int minY = 0;
+    int maxY = 0;
+    if (empty() ||
+        !overlappedCells(bounds.min.x, bounds.max.x, m_origin.x, m_cellSize, m_width, minX, maxX) ||
+        !overlappedCells(bounds.min.y, bounds.max.y, m_origin.y, m_cellSize, m_height, minY, maxY)) {
+        return;
+    }
+    fillCells(minX, minY, maxX, maxY, walkable);
+}
+
+void NavRaster::stampTiles(const glm::vec2& layerOrigin, const glm::vec2& tileSize, int columns,
+                           std::span<const int> tiles, bool walkable)
+{
+    if (columns <= 0 || !(tileSize.x > 0.0f) || !(tileSize.y > 0.0f) ||
+        !isFinite(layerOrigin) || !std::isfinite(tileSize.x) || !std::isfinite(tileSize.y)) {
+        throw std::invalid_argument("NavRaster tile layer needs positive columns and tile size");
+    }
+    const auto width = static_cast<std::size_t>(columns);
+    for (std::size_t row = 0; row * width < tiles.size(); ++row) {
+        const std::size_t rowEnd = std::min(tiles.size(), (row + 1) * width);
+        // Runs of non-empty tiles become one rectangle each.
+        for (std::size_t column = 0; row * width + column < rowEnd;) {
+            if (tiles[row * width + column] < 0) {
+                ++column;
+                continue;
+            }
+            std::size_t end = column + 1;
+            while (row * width + end < rowEnd && tiles[row * width + end] >= 0) ++end;
+            const glm::vec2 min = layerOrigin + glm::vec2{static_cast<float>(column) * tileSize.x,
+                                                          static_cast<float>(row) * tileSize.y};
+            const glm::vec2 max = layerOrigin + glm::vec2{static_cast<float>(end) * tileSize.x,
+                                                          static_cast<float>(row + 1) * tileSize.y};
+            stampBounds(NavAABB{min, max}, walkable);
+            column = end;
+        }
+    }
+}
+
+std::size_t NavRaster::walkableCount() const
+{
+    std::size_t count = 0;
+    for (const std::uint64_t word : m_words) {
+        count += static_cast<std::size_t>(std::popcount(word));
+    }
+    return count;
+}
+
+std::size_t NavRaster::memoryBytes() const
+{
+    return m_words.capacity() * sizeof(std::uint64_t) +
+           m_dirtyTileFlags.capacity() * sizeof(std::uint8_t) +
+           m_dirtyTiles.capacity() * sizeof(int);
+}
+
+void NavRaster::clearDirtyTiles()
+{
+    for (const int tile : m_dirtyTiles) {
+        m_dirtyTileFlags[static_cast<std::size_t>(tile)] = 0;
+    }
+    m_dirtyTiles.clear();
 }
 
 glm::vec2 NavRaster::cellCenter(int x, int y) const
@@ -138,10 +280,13 @@ NavRaster NavRaster::buildFromPredicate(int width, int height, float cellSize, c
     NavRaster raster(width, height, cellSize, origin);
     for (int y = 0; y < height; ++y)
     {
+        std::uint64_t* row = raster.m_words.data() +
+                             static_cast<std::size_t>(y) * static_cast<std::size_t>(raster.m_wordsPerRow);
         for (int x = 0; x < width; ++x)
         {
-            NavAABB cellAABB = raster.cellBounds(x, y);
-            raster.setWalkable(x, y, isWalkablePredicate(cellAABB));
+            if (!isWalkablePredicate(raster.cellBounds(x, y))) {
+                row[x / kCellsPerWord] &= ~(std::uint64_t{1} << (x % kCellsPerWord));
+            }
         }
     }
     return raster;
@@ -3,14 +3,24 @@
 #include <cstddef>
 #include <cstdint>
 #include <functional>
+#include <span>
 #include <vector>
 
 #include <glm/vec2.hpp>
 
 #include "NavAABB.hpp"
 
+// Walkability grid, bit-packed: each row is a run of 64-bit words, cell x of
+// row y being bit x % 64 of word x / 64 (padding bits past the width stay
+// clear). Region extraction scans whole words; bulk stamping of boxes and
+// tile layers writes whole words.
 class NavRaster {
 public:
+    static constexpr int kCellsPerWord = 64;
+    // Edge of the square tiles, in cells, that setWalkable() marks dirty and
+    // a tiled PolyNavMesh rebuilds.
+    static constexpr int kTileSize = 32;
+
     NavRaster() = default;
     NavRaster(int width, int height, float cellSize, const glm::vec2& origin);
 
@@ -18,15 +28,41 @@ public:
     [[nodiscard]] int height() const { return m_height; }
     [[nodiscard]] float cellSize() const { return m_cellSize; }
     [[nodiscard]] const glm::vec2& origin() const { return m_origin; }
-    [[nodiscard]] bool empty() const { return m_walkableCells.empty(); }
+    [[nodiscard]] bool empty() const { return m_words.empty(); }
     [[nodiscard]] bool inBounds(int x, int y) const;
     [[nodiscard]] bool isWalkable(int x, int y) const;
+    // Marks the cell's tile dirty when its walkability changes.
     void setWalkable(int x, int y, bool walkable);
+    // Sets every cell of the inclusive rectangle, clipped to the raster.
+    void fillCells(int minX, int minY, int maxX, int maxY, bool walkable);
+    // Sets every cell whose interior overlaps `bounds` (a collider's box).
+    void stampBounds(const NavAABB& bounds, bool walkable);
+    // Sets every cell overlapped by a non-empty tile (index >= 0) of a
+    // row-major tile layer `columns` wide placed at `layerOrigin`.
+    void stampTiles(const glm::vec2& layerOrigin, const glm::vec2& tileSize, int columns,
+                    std::span<const int> tiles, bool walkable);
+
+    // Words of row `y`, for word-level scans.
+    [[nodiscard]] int wordsPerRow() const { return m_wordsPerRow; }
+    [[nodiscard]] std::span<const std::uint64_t> rowWords(int y) const {
+        return {m_words.data() + static_cast<std::size_t>(y) * static_cast<std::size_t>(m_wordsPerRow),
+                static_cast<std::size_t>(m_wordsPerRow)};
+    }
+    [[nodiscard]] std::size_t walkableCount() const;
+    // Heap bytes held by the grid and its dirty-tile tracking.
+    [[nodiscard]] std::size_t memoryBytes() const;
     [[nodiscard]] glm::vec2 cellCenter(int x, int y) const;
     [[nodiscard]] NavAABB cellBounds(int x, int y) const;
     [[nodiscard]] bool worldToCell(const glm::vec2& worldPos, int& outX, int& outY) const;
     [[nodiscard]] glm::vec2 cellToWorld(int x, int y) const;
 
+    [[nodiscard]] int tileColumns() const { return (m_width + kTileSize - 1) / kTileSize; }
+    [[nodiscard]] int tileRows() const { return (m_height + kTileSize - 1) / kTileSize; }
+    // Tiles (ty * tileColumns() + tx) with cells changed since the last
+    // clearDirtyTiles(), in the order they were first changed.
+    [[nodiscard]] std::span<const int> dirtyTiles() const { return m_dirtyTiles; }
+    void clearDirtyTiles();
+
     template<typename Func>
     void forEachCell(Func&& func) const {
         for (int y = 0; y < m_height; ++y) {
@@ -39,12 +75,18 @@ public:
                                         const std::function<bool(const NavAABB&)>& isWalkablePredicate);
 
 private:
-    [[nodiscard]] std::size_t indexUnchecked(int x, int y) const;
+    // Replaces the bits of `mask` in word `word` of row `y`, marking the
+    // tiles of the cells that change.
+    void writeWord(int y, int word, std::uint64_t mask, bool walkable);
+    void markDirty(int tile);
 
     int m_width{0};
     int m_height{0};
     float m_cellSize{0.0f};
     glm::vec2 m_origin{0.0f};
-    std::vector<std::uint8_t> m_walkableCells;
+    int m_wordsPerRow{0};
+    std::vector<std::uint64_t> m_words;
+    std::vector<std::uint8_t> m_dirtyTileFlags;
+    std::vector<int> m_dirtyTiles;
 };
 #endif // NAV_RASTER_HPP
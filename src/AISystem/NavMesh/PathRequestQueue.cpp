@@ -0,0 +1,330 @@
+#include "PathRequestQueue.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+#include "PolyNavMesh.hpp"
+#include "Utils/WorkerPool.hpp"
+
+namespace {
+void validate(const PathRequestQueue::Settings& settings) {
+    if (settings.expansionBudget == 0 || settings.maxActiveSearches == 0) {
+        throw std::invalid_argument(
+            "PathRequestQueue expansion budget and active search count must be positive");
+    }
+}
+
+std::uint64_t polyPairKey(int startPoly, int endPoly) {
+    return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(startPoly)) << 32) |
+           static_cast<std::uint32_t>(endPoly);
+}
+}
+
+PathRequestQueue::PathRequestQueue(const PolyNavMesh& mesh)
+    : PathRequestQueue(mesh, Settings{}) {}
+
+PathRequestQueue::PathRequestQueue(const PolyNavMesh& mesh, const Settings& settings)
+    : m_mesh(&mesh), m_settings(settings) {
+    validate(settings);
+}
+
+PathRequestQueue::~PathRequestQueue() = default;
+
+void PathRequestQueue::setSettings(const Settings& settings) {
+    validate(settings);
+    m_settings = settings;
+}
+
+void PathRequestQueue::resetStats() noexcept {
+    const std::size_t pending = m_stats.pending;
+    m_stats = Stats{};
+    m_stats.pending = pending;
+    m_latencyMsTotal = 0.0;
+    m_latencyUpdatesTotal = 0.0;
+}
+
+PathHandle PathRequestQueue::request(const glm::vec2& start, const glm::vec2& goal,
+                                     PathPriority priority) {
+    std::uint32_t index = 0;
+    if (!m_freeRequests.empty()) {
+        index = m_freeRequests.back();
+        m_freeRequests.pop_back();
+    } else {
+        if (m_requests.size() >= std::numeric_limits<std::uint32_t>::max()) {
+            throw std::length_error("Too many outstanding path requests");
+        }
+        index = static_cast<std::uint32_t>(m_requests.size());
+        m_requests.emplace_back();
+    }
+    Request& request = m_requests[index];
+    request.status = PathRequestStatus::Pending;
+    request.start = start;
+    request.goal = goal;
+    request.priority = priority;
+    request.search = kNoSearch;
+    request.submitted = Clock::now();
+    request.submittedUpdate = m_updates;
+    request.path.points.clear();
+    ++m_stats.submitted;
+    ++m_stats.pending;
+    const PathHandle handle{index, request.generation};
+    enqueue(index, m_sequence++);
+    return handle;
+}
+
+void PathRequestQueue::enqueue(std::uint32_t requestIndex, std::uint64_t sequence) {
+    Request& request = m_requests[requestIndex];
+    const int startPoly = m_mesh->findPoly(request.start);
+    const int endPoly = m_mesh->findPoly(request.goal);
+    if (startPoly < 0 || endPoly < 0) {
+        complete(requestIndex);
+        return;
+    }
+
+    const std::uint64_t key = polyPairKey(startPoly, endPoly);
+    if (const auto found = m_searchByPolys.find(key); found != m_searchByPolys.end()) {
+        Search& search = m_searches[found->second];
+        search.waiters.push_back(requestIndex);
+        search.priority = std::max(search.priority, request.priority);
+        search.sequence = std::min(search.sequence, sequence);
+        request.search = found->second;
+        ++m_stats.deduplicated;
+        return;
+    }
+
+    std::uint32_t searchIndex = 0;
+    if (!m_freeSearches.empty()) {
+        searchIndex = m_freeSearches.back();
+        m_freeSearches.pop_back();
+    } else {
+        searchIndex = static_cast<std::uint32_t>(m_searches.size());
+        m_searches.emplace_back();
+    }
+    Search& search = m_searches[searchIndex];
+    search.startPoly = startPoly;
+    search.endPoly = endPoly;
+    search.priority = request.priority;
+    search.sequence = sequence;
+    search.live = true;
+    search.expandedThisUpdate = 0;
+    search.waiters.assign(1, requestIndex);
+    request.search = searchIndex;
+    m_searchByPolys.emplace(key, searchIndex);
+    m_waiting.push_back(searchIndex);
+}
+
+PathRequestQueue::Request* PathRequestQueue::find(PathHandle handle) noexcept {
+    if (handle.index >= m_requests.size()) return nullptr;
+    Request& request = m_requests[handle.index];
+    return request.generation == handle.generation &&
+           request.status != PathRequestStatus::Invalid ? &request : nullptr;
+}
+
+const PathRequestQueue::Request* PathRequestQueue::find(PathHandle handle) const noexcept {
+    return const_cast<PathRequestQueue*>(this)->find(handle);
+}
+
+PathRequestStatus PathRequestQueue::status(PathHandle handle) const noexcept {
+    const Request* request = find(handle);
+    return request ? request->status : PathRequestStatus::Invalid;
+}
+
+bool PathRequestQueue::poll(PathHandle handle, NavPath& out) {
+    Request* request = find(handle);
+    if (!request || request->status != PathRequestStatus::Ready) {
+        return false;
+    }
+    std::swap(out.points, request->path.points);
+    freeRequest(handle.index);
+    return true;
+}
+
+void PathRequestQueue::cancel(PathHandle handle) {
+    Request* request = find(handle);
+    if (!request) return;
+    if (request->status == PathRequestStatus::Pending) {
+        if (request->search != kNoSearch) {
+            Search& search = m_searches[request->search];
+            std::erase(search.waiters, handle.index);
+            if (search.waiters.empty()) {
+                releaseSearch(request->search);
+            }
+        }
+        --m_stats.pending;
+        ++m_stats.cancelled;
+    }
+    freeRequest(handle.index);
+}
+
+void PathRequestQueue::complete(std::uint32_t requestIndex) {
+    Request& request = m_requests[requestIndex];
+    request.status = PathRequestStatus::Ready;
+    request.search = kNoSearch;
+    --m_stats.pending;
+    ++m_stats.completed;
+    const double latencyMs =
+        std::chrono::duration<double, std::milli>(Clock::now() - request.submitted).count();
+    const std::uint64_t latencyUpdates = m_updates - request.submittedUpdate;
+    m_latencyMsTotal += latencyMs;
+    m_latencyUpdatesTotal += static_cast<double>(latencyUpdates);
+    const auto completed = static_cast<double>(m_stats.completed);
+    m_stats.averageLatencyMs = m_latencyMsTotal / completed;
+    m_stats.averageLatencyUpdates = m_latencyUpdatesTotal / completed;
+    m_stats.maxLatencyMs = std::max(m_stats.maxLatencyMs, latencyMs);
+    m_stats.maxLatencyUpdates = std::max(m_stats.maxLatencyUpdates, latencyUpdates);
+}
+
+void PathRequestQueue::freeRequest(std::uint32_t requestIndex) {
+    Request& request = m_requests[requestIndex];
+    request.status = PathRequestStatus::Invalid;
+    request.search = kNoSearch;
+    if (++request.generation == 0) {
+        request.generation = 1;
+    }
+    m_freeRequests.push_back(requestIndex);
+}
+
+void PathRequestQueue::releaseSearch(std::uint32_t searchIndex) {
+    Search& search = m_searches[searchIndex];
+    m_searchByPolys.erase(polyPairKey(search.startPoly, search.endPoly));
+    std::erase(m_waiting, searchIndex);
+    std::erase(m_active, searchIndex);
+    if (search.query) {
+        m_spareQueries.push_back(std::move(search.query));
+    }
+    search.live = false;
+    search.waiters.clear();
+    m_freeSearches.push_back(searchIndex);
+}
+
+void PathRequestQueue::activateSearches() {
+    if (m_active.size() >= m_settings.maxActiveSearches || m_waiting.empty()) {
+        return;
+    }
+    std::sort(m_waiting.begin(), m_waiting.end(), [this](std::uint32_t a, std::uint32_t b) {
+        const Search& left = m_searches[a];
+        const Search& right = m_searches[b];
+        if (left.priority != right.priority) return left.priority > right.priority;
+        return left.sequence < right.sequence;
+    });
+    const std::size_t count =
+        std::min(m_waiting.size(), m_settings.maxActiveSearches - m_active.size());
+    for (std::size_t i = 0; i < count; ++i) {
+        Search& search = m_searches[m_waiting[i]];
+        if (!m_spareQueries.empty()) {
+            search.query = std::move(m_spareQueries.back());
+            m_spareQueries.pop_back();
+        } else {
+            search.query = std::make_unique<NavQuery>();
+        }
+        search.query->beginSearch(*m_mesh, search.startPoly, search.endPoly);
+        m_active.push_back(m_waiting[i]);
+    }
+    m_waiting.erase(m_waiting.begin(), m_waiting.begin() + static_cast<std::ptrdiff_t>(count));
+}
+
+void PathRequestQueue::advance(Search& search, std::size_t budget) {
+    NavQuery& query = *search.query;
+    const std::size_t before = query.expansions();
+    const NavSearchStatus status = query.continueSearch(*m_mesh, budget);
+    search.expandedThisUpdate = query.expansions() - before;
+    if (status != NavSearchStatus::Found) {
+        return;
+    }
+    // Every waiter shares the corridor but gets its own endpoints.
+    for (const std::uint32_t waiter : search.waiters) {
+        Request& request = m_requests[waiter];
+        query.buildPath(*m_mesh, request.start, request.goal, request.path);
+    }
+}
+
+void PathRequestQueue::update(Utils::WorkerPool* workers) {
+    ++m_updates;
+    activateSearches();
+    m_stats.expansionsLastUpdate = 0;
+    if (m_active.empty()) {
+        return;
+    }
+
+    const std::size_t budget = std::max<std::size_t>(
+        1, m_settings.expansionBudget / m_active.size());
+    if (workers != nullptr && workers->workerCount() > 0 && m_active.size() > 1) {
+        workers->parallelFor(m_active.size(), [this, budget](std::size_t index) {
+            advance(m_searches[m_active[index]], budget);
+        });
+    } else {
+        for (const std::uint32_t searchIndex : m_active) {
+            advance(m_searches[searchIndex], budget);
+        }
+    }
+
+    for (std::size_t i = 0; i < m_active.size();) {
+        const std::uint32_t searchIndex = m_active[i];
+        Search& search = m_searches[searchIndex];
+        m_stats.expansionsLastUpdate += search.expandedThisUpdate;
+        if (search.query->status() == NavSearchStatus::InProgress) {
+            ++i;
+            continue;
+        }
+        for (const std::uint32_t waiter : search.waiters) {
+            complete(waiter);
+        }
+        releaseSearch(searchIndex);
+    }
+}
+
+void PathRequestQueue::meshChanged() {
+    std::vector<std::uint32_t> live;
+    for (std::uint32_t searchIndex = 0; searchIndex < m_searches.size(); ++searchIndex) {
+        if (m_searches[searchIndex].live) {
+            live.push_back(searchIndex);
+        }
+    }
+    restartSearches(live);
+}
+
+void PathRequestQueue::meshChanged(std::span<const int> removedPolys,
+                                   std::span<const int> changedPolys) {
+    std::vector<int> removed(removedPolys.begin(), removedPolys.end());
+    std::sort(removed.begin(), removed.end());
+    const auto isRemoved = [&removed](int poly) {
+        return std::binary_search(removed.begin(), removed.end(), poly);
+    };
+    std::vector<std::uint32_t> affected;
+    for (std::uint32_t searchIndex = 0; searchIndex < m_searches.size(); ++searchIndex) {
+        const Search& search = m_searches[searchIndex];
+        if (!search.live) continue;
+        bool touched = isRemoved(search.startPoly) || isRemoved(search.endPoly);
+        if (!touched && search.query) {
+            touched = std::any_of(removed.begin(), removed.end(),
+                                  [&search](int poly) { return search.query->reached(poly); }) ||
+                      std::any_of(changedPolys.begin(), changedPolys.end(),
+                                  [&search](int poly) { return search.query->expanded(poly); });
+        }
+        if (touched) {
+            affected.push_back(searchIndex);
+        }
+    }
+    restartSearches(affected);
+}
+
+void PathRequestQueue::restartSearches(const std::vector<std::uint32_t>& searches) {
+    // Waiters are re-enqueued in the order their searches were submitted.
+    std::vector<std::pair<std::uint64_t, std::uint32_t>> pending;
+    for (const std::uint32_t searchIndex : searches) {
+        const Search& search = m_searches[searchIndex];
+        for (const std::uint32_t waiter : search.waiters) {
+            pending.emplace_back(search.sequence, waiter);
+        }
+        releaseSearch(searchIndex);
+        ++m_stats.restarted;
+    }
+    std::stable_sort(pending.begin(), pending.end(), [](const auto& left, const auto& right) {
+        return left.first < right.first;
+    });
+    for (const auto& [sequence, index] : pending) {
+        m_requests[index].search = kNoSearch;
+        enqueue(index, sequence);
+    }
+}
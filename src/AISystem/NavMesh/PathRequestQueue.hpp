@@ -0,0 +1,167 @@
+#ifndef PATH_REQUEST_QUEUE_HPP
+#define PATH_REQUEST_QUEUE_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/vec2.hpp>
+
+#include "NavPath.hpp"
+#include "NavQuery.hpp"
+
+class PolyNavMesh;
+namespace Utils { class WorkerPool; }
+
+enum class PathPriority : std::uint8_t {
+    Low,
+    Normal,
+    High
+};
+
+enum class PathRequestStatus : std::uint8_t {
+    // Unknown, already collected, or cancelled handle.
+    Invalid,
+    Pending,
+    // A result is waiting in poll(); its path is empty when no route exists.
+    Ready
+};
+
+struct PathHandle {
+    std::uint32_t index{std::numeric_limits<std::uint32_t>::max()};
+    std::uint32_t generation{0};
+
+    [[nodiscard]] bool valid() const noexcept { return generation != 0; }
+    friend bool operator==(const PathHandle&, const PathHandle&) = default;
+};
+
+// Time-sliced path requests against one PolyNavMesh. AI code submits
+// requests, the game calls update() once per frame, and each requester polls
+// its handle until the path is ready. Each update advances at most
+// `maxActiveSearches` searches by a shared budget of A* node expansions, on
+// the calling thread or split across a WorkerPool. The results do not depend
+// on which is used. Requests between the same start and goal polygons share
+// one search (so identical start/goal cells always do), and each requester
+// still gets a path between its own endpoints. Higher priorities start first,
+// then requests in submission order.
+//
+// The queue must be used from one thread. After rebuilding the mesh call
+// meshChanged(), which restarts every outstanding request. After a tiled
+// update pass the mesh's lastRemovedPolys() and lastChangedPolys(): only
+// searches that start or end in a removed polygon, reached one, or already
+// expanded a relinked polygon (and so missed its new links) are restarted.
+class PathRequestQueue {
+public:
+    struct Settings {
+        // A* node expansions per update, split evenly between active searches.
+        std::size_t expansionBudget{4096};
+        // Searches advanced concurrently; each keeps a NavQuery sized to the mesh.
+        std::size_t maxActiveSearches{8};
+    };
+
+    struct Stats {
+        std::uint64_t submitted{0};
+        std::uint64_t completed{0};
+        // Requests that joined a search already queued for the same polygons.
+        std::uint64_t deduplicated{0};
+        std::uint64_t cancelled{0};
+        // Searches dropped and requeued by meshChanged().
+        std::uint64_t restarted{0};
+        std::size_t pending{0};
+        std::size_t expansionsLastUpdate{0};
+        // Submission to completion, for completed requests.
+        double averageLatencyMs{0.0};
+        double maxLatencyMs{0.0};
+        double averageLatencyUpdates{0.0};
+        std::uint64_t maxLatencyUpdates{0};
+    };
+
+    explicit PathRequestQueue(const PolyNavMesh& mesh);
+    PathRequestQueue(const PolyNavMesh& mesh, const Settings& settings);
+    ~PathRequestQueue();
+
+    PathRequestQueue(const PathRequestQueue&) = delete;
+    PathRequestQueue& operator=(const PathRequestQueue&) = delete;
+
+    // Endpoints off the mesh complete immediately with an empty path.
+    [[nodiscard]] PathHandle request(const glm::vec2& start, const glm::vec2& goal,
+                                     PathPriority priority = PathPriority::Normal);
+    [[nodiscard]] PathRequestStatus status(PathHandle handle) const noexcept;
+    // Moves a ready result into `out` and frees the handle. Returns false
+    // (leaving `out` alone) while the request is pending or the handle is invalid.
+    bool poll(PathHandle handle, NavPath& out);
+    void cancel(PathHandle handle);
+
+    void update(Utils::WorkerPool* workers = nullptr);
+    void meshChanged();
+    void meshChanged(std::span<const int> removedPolys, std::span<const int> changedPolys);
+
+    void setSettings(const Settings& settings);
+    [[nodiscard]] const Settings& settings() const noexcept { return m_settings; }
+    [[nodiscard]] const Stats& stats() const noexcept { return m_stats; }
+    // Clears counters and latency figures; `pending` stays current.
+    void resetStats() noexcept;
+
+private:
+    using Clock = std::chrono::steady_clock;
+    static constexpr std::uint32_t kNoSearch = std::numeric_limits<std::uint32_t>::max();
+
+    struct Request {
+        std::uint32_t generation{1};
+        PathRequestStatus status{PathRequestStatus::Invalid};
+        glm::vec2 start{0.0f};
+        glm::vec2 goal{0.0f};
+        PathPriority priority{PathPriority::Normal};
+        std::uint32_t search{kNoSearch};
+        Clock::time_point submitted{};
+        std::uint64_t submittedUpdate{0};
+        NavPath path;
+    };
+
+    struct Search {
+        int startPoly{-1};
+        int endPoly{-1};
+        PathPriority priority{PathPriority::Normal};
+        std::uint64_t sequence{0};
+        bool live{false};
+        std::size_t expandedThisUpdate{0};
+        std::vector<std::uint32_t> waiters;
+        std::unique_ptr<NavQuery> query;
+    };
+
+    [[nodiscard]] Request* find(PathHandle handle) noexcept;
+    [[nodiscard]] const Request* find(PathHandle handle) const noexcept;
+    void enqueue(std::uint32_t requestIndex, std::uint64_t sequence);
+    void complete(std::uint32_t requestIndex);
+    void freeRequest(std::uint32_t requestIndex);
+    void releaseSearch(std::uint32_t searchIndex);
+    void restartSearches(const std::vector<std::uint32_t>& searches);
+    void activateSearches();
+    void advance(Search& search, std::size_t budget);
+
+    const PolyNavMesh* m_mesh;
+    Settings m_settings;
+    Stats m_stats;
+    std::vector<Request> m_requests;
+    std::vector<std::uint32_t> m_freeRequests;
+    std::vector<Search> m_searches;
+    std::vector<std::uint32_t> m_freeSearches;
+    // Live searches by (start polygon, end polygon), for deduplication.
+    std::unordered_map<std::uint64_t, std::uint32_t> m_searchByPolys;
+    // Searches not yet started, and those being advanced.
+    std::vector<std::uint32_t> m_waiting;
+    std::vector<std::uint32_t> m_active;
+    // Idle contexts kept for reuse so activating a search allocates nothing.
+    std::vector<std::unique_ptr<NavQuery>> m_spareQueries;
+    std::uint64_t m_sequence{0};
+    std::uint64_t m_updates{0};
+    double m_latencyMsTotal{0.0};
+    double m_latencyUpdatesTotal{0.0};
+};
+
+#endif // PATH_REQUEST_QUEUE_HPP
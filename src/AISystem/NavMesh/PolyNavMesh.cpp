@@ -1,223 +1,484 @@
 #include "PolyNavMesh.hpp"
 
 #include <algorithm>
+#include <bit>
 #include <cmath>
+#include <functional>
+#include <iterator>
 #include <limits>
-#include <queue>
 #include <stdexcept>
+#include <utility>
 
 #include <glm/geometric.hpp>
 
+#include "NavQuery.hpp"
 #include "Physics/Collision/AABB.hpp"
 
 namespace {
 constexpr float kEps = 1e-4f;
 
-bool isFinite(const glm::vec2& value) {
-    return std::isfinite(value.x) && std::isfinite(value.y);
+// Bits of raster word `word` covering cells [minX, maxX].
+std::uint64_t cellMask(int word, int minX, int maxX) {
+    const int first = std::max(minX - word * NavRaster::kCellsPerWord, 0);
+    const int last = std::min(maxX - word * NavRaster::kCellsPerWord, NavRaster::kCellsPerWord - 1);
+    if (first > last) return 0;
+    const std::uint64_t upTo = last == 63 ? ~std::uint64_t{0} : (std::uint64_t{1} << (last + 1)) - 1;
+    return upTo & ~((std::uint64_t{1} << first) - 1);
 }
 
 float signedArea(const glm::vec2& apex, const glm::vec2& a, const glm::vec2& b) {
     return (a.x - apex.x) * (b.y - apex.y) -
            (a.y - apex.y) * (b.x - apex.x);
 }
-
-bool nearlyEqual(const glm::vec2& a, const glm::vec2& b) {
-    const glm::vec2 delta = a - b;
-    return glm::dot(delta, delta) <= kEps * kEps;
-}
 }
 
 void PolyNavMesh::buildFromRaster(const NavRaster& raster) {
     clear();
-    auto regions = buildRegions(raster);
+    auto regions = buildRegions(raster, NavRegion{0, raster.width() - 1, 0, raster.height() - 1});
     buildPolygonsFromRegion(raster, regions);
-    buildAdjacencies();
+    buildCellLookup(raster, regions);
+    buildAdjacencies(regions);
+    buildLinks();
 }
 
 void PolyNavMesh::clear() {
     m_polys.clear();
+    m_cellPolys.clear();
+    m_cellColumns = 0;
+    m_cellRows = 0;
+    m_centers.clear();
+    m_linkRanges.clear();
+    m_links.clear();
+    m_tileSize = 0;
+    m_tileColumns = 0;
+    m_tileRows = 0;
+    m_polyRegions.clear();
+    m_tilePolys.clear();
+    m_freePolys.clear();
+    m_lastRemovedPolys.clear();
+    m_lastChangedPolys.clear();
+    m_staleLinks = 0;
 }
 
-NavPath PolyNavMesh::findPath(const glm::vec2& start, const glm::vec2& end) const {
-    if (!isFinite(start) || !isFinite(end)) return {};
-    const int startPoly = findPolyContainingPoint(start);
-    const int endPoly = findPolyContainingPoint(end);
-    if (startPoly < 0 || endPoly < 0) {
-        return {};
+void PolyNavMesh::buildTiled(const NavRaster& raster) {
+    clear();
+    m_tileSize = NavRaster::kTileSize;
+    m_tileColumns = raster.tileColumns();
+    m_tileRows = raster.tileRows();
+    m_cellColumns = raster.width();
+    m_cellRows = raster.height();
+    m_cellSize = raster.cellSize();
+    m_origin = raster.origin();
+    m_cellPolys.assign(static_cast<std::size_t>(m_cellColumns) *
+                       static_cast<std::size_t>(m_cellRows), -1);
+    m_tilePolys.resize(static_cast<std::size_t>(m_tileColumns) *
+                       static_cast<std::size_t>(m_tileRows));
+    std::vector<int> tiles(m_tilePolys.size());
+    for (std::size_t i = 0; i < tiles.size(); ++i) {
+        tiles[i] = static_cast<int>(i);
+    }
+    rebuildTiles(raster, tiles);
+    // Headroom for polygons that outgrow their link blocks, so updates
+    // rarely reallocate the whole array.
+    m_links.reserve(m_links.size() + m_links.size() / 4);
+}
+
+void PolyNavMesh::updateTiles(const NavRaster& raster) {
+    updateTiles(raster, raster.dirtyTiles());
+}
+
+void PolyNavMesh::updateTiles(const NavRaster& raster, std::span<const int> tiles) {
+    if (!tiled() || raster.width() != m_cellColumns || raster.height() != m_cellRows ||
+        raster.cellSize() != m_cellSize || raster.origin() != m_origin) {
+        throw std::invalid_argument("PolyNavMesh was not built tiled from this raster layout");
     }
-    auto polyPath = findPathPolys(startPoly, endPoly);
-    if (polyPath.empty()) {
-        return {};
+    for (const int tile : tiles) {
+        if (tile < 0 || static_cast<std::size_t>(tile) >= m_tilePolys.size()) {
+            throw std::out_of_range("PolyNavMesh tile index is out of range");
+        }
     }
-    return buildPathWithFunnel(polyPath, start, end);
+    rebuildTiles(raster, tiles);
 }
 
-std::vector<NavRegion> PolyNavMesh::buildRegions(const NavRaster& raster) const {
-    std::vector<NavRegion> regions;
-    const int w = raster.width();
-    const int h = raster.height();
-    std::vector<std::uint8_t> visited(static_cast<std::size_t>(w) *
-                                      static_cast<std::size_t>(h), 0);
-    auto idx = [w](int x, int y) {
-        return static_cast<std::size_t>(y) * static_cast<std::size_t>(w) +
-               static_cast<std::size_t>(x);
-    };
+int PolyNavMesh::allocatePoly() {
+    if (!m_freePolys.empty()) {
+        const int poly = m_freePolys.back();
+        m_freePolys.pop_back();
+        return poly;
+    }
+    m_polys.emplace_back();
+    m_centers.emplace_back(0.0f);
+    m_linkRanges.emplace_back();
+    m_polyRegions.emplace_back();
+    return static_cast<int>(m_polys.size() - 1);
+}
 
-    for (int y = 0; y < h; ++y) {
-        for (int x = 0; x < w; ++x) {
-            if (!raster.isWalkable(x, y) || visited[idx(x, y)]) continue;
+void PolyNavMesh::rebuildTiles(const NavRaster& raster, std::span<const int> requested) {
+    std::vector<int> tiles(requested.begin(), requested.end());
+    std::sort(tiles.begin(), tiles.end());
+    tiles.erase(std::unique(tiles.begin(), tiles.end()), tiles.end());
+
+    // Drop the tiles' polygons and every portal to them.
+    std::vector<int> relinked;
+    m_lastRemovedPolys.clear();
+    for (const int tile : tiles) {
+        for (const int poly : m_tilePolys[static_cast<std::size_t>(tile)]) {
+            for (const NavPortal& portal : m_polys[static_cast<std::size_t>(poly)].portals) {
+                NavPoly& neighbor = m_polys[static_cast<std::size_t>(portal.neighbor)];
+                std::erase(neighbor.neighbors, poly);
+                std::erase_if(neighbor.portals,
+                              [poly](const NavPortal& p) { return p.neighbor == poly; });
+                relinked.push_back(portal.neighbor);
+            }
+            const auto index = static_cast<std::size_t>(poly);
+            m_polys[index] = NavPoly{};
+            // The next polygon given this index reuses the link block.
+            m_linkRanges[index].end = m_linkRanges[index].begin;
+            const NavRegion& r = m_polyRegions[index];
+            for (int y = r.yMin; y <= r.yMax; ++y) {
+                const auto row = static_cast<std::size_t>(y) * static_cast<std::size_t>(m_cellColumns);
+                std::fill(m_cellPolys.begin() + static_cast<std::ptrdiff_t>(row + r.xMin),
+                          m_cellPolys.begin() + static_cast<std::ptrdiff_t>(row + r.xMax + 1), -1);
+            }
+            m_freePolys.push_back(poly);
+            m_lastRemovedPolys.push_back(poly);
+        }
+        m_tilePolys[static_cast<std::size_t>(tile)].clear();
+    }
+    std::sort(m_lastRemovedPolys.begin(), m_lastRemovedPolys.end());
+    // Reuse the lowest free indices first, keeping the numbering dense.
+    std::sort(m_freePolys.begin(), m_freePolys.end(), std::greater<>{});
+
+    std::vector<int> created;
+    for (const int tile : tiles) {
+        const int minX = (tile % m_tileColumns) * m_tileSize;
+        const int minY = (tile / m_tileColumns) * m_tileSize;
+        const NavRegion area{minX, std::min(minX + m_tileSize, m_cellColumns) - 1,
+                             minY, std::min(minY + m_tileSize, m_cellRows) - 1};
+        for (const NavRegion& r : buildRegions(raster, area)) {
+            const int poly = allocatePoly();
+            const auto index = static_cast<std::size_t>(poly);
+            m_polys[index] = makePoly(raster, r, poly);
+            m_centers[index] = computePolyCenter(m_polys[index]);
+            m_polyRegions[index] = r;
+            for (int y = r.yMin; y <= r.yMax; ++y) {
+                const auto row = static_cast<std::size_t>(y) * static_cast<std::size_t>(m_cellColumns);
+                std::fill(m_cellPolys.begin() + static_cast<std::ptrdiff_t>(row + r.xMin),
+                          m_cellPolys.begin() + static_cast<std::ptrdiff_t>(row + r.xMax + 1), poly);
+            }
+            m_tilePolys[static_cast<std::size_t>(tile)].push_back(poly);
+            created.push_back(poly);
+        }
+    }
 
-            int maxW = 0;
-            while (x + maxW < w && raster.isWalkable(x + maxW, y) && !visited[idx(x + maxW, y)]) {
-                ++maxW;
+    // New polygons meet their neighbours, old or new, along their outer cells.
+    std::vector<std::pair<int, int>> pairs;
+    for (const int poly : created) {
+        const NavRegion& r = m_polyRegions[static_cast<std::size_t>(poly)];
+        const auto addNeighbor = [&](int other) {
+            if (other < 0) return;
+            const std::pair pair{std::min(poly, other), std::max(poly, other)};
+            if (pairs.empty() || pairs.back() != pair) {
+                pairs.push_back(pair);
             }
+        };
+        for (int y = r.yMin; y <= r.yMax; ++y) {
+            addNeighbor(polyAtCell(r.xMin - 1, y));
+            addNeighbor(polyAtCell(r.xMax + 1, y));
+        }
+        for (int x = r.xMin; x <= r.xMax; ++x) {
+            addNeighbor(polyAtCell(x, r.yMin - 1));
+            addNeighbor(polyAtCell(x, r.yMax + 1));
+        }
+    }
+    std::sort(pairs.begin(), pairs.end());
+    pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+    for (const auto& [i, j] : pairs) {
+        connect(i, j);
+        relinked.push_back(i);
+        relinked.push_back(j);
+    }
 
-            int maxH = 1;
-            bool canGrow = true;
-            while (y + maxH < h && canGrow) {
-                for (int dx = 0; dx < maxW; ++dx) {
-                    if (!raster.isWalkable(x + dx, y + maxH) || visited[idx(x + dx, y + maxH)]) {
-                        canGrow = false;
-                        break;
-                    }
+    std::sort(relinked.begin(), relinked.end());
+    relinked.erase(std::unique(relinked.begin(), relinked.end()), relinked.end());
+    std::sort(created.begin(), created.end());
+    // Surviving polygons whose links change; new polygons are not reported.
+    m_lastChangedPolys.clear();
+    std::set_difference(relinked.begin(), relinked.end(), created.begin(), created.end(),
+                        std::back_inserter(m_lastChangedPolys));
+    std::erase_if(m_lastChangedPolys,
+                  [this](int poly) { return m_polys[static_cast<std::size_t>(poly)].id < 0; });
+
+    relinked.insert(relinked.end(), created.begin(), created.end());
+    std::sort(relinked.begin(), relinked.end());
+    relinked.erase(std::unique(relinked.begin(), relinked.end()), relinked.end());
+    for (const int poly : relinked) {
+        NavPoly& p = m_polys[static_cast<std::size_t>(poly)];
+        if (p.id < 0) continue;
+        // Neighbours in index order, as a full build lists them.
+        std::sort(p.portals.begin(), p.portals.end(),
+                  [](const NavPortal& a, const NavPortal& b) { return a.neighbor < b.neighbor; });
+        p.neighbors.clear();
+        for (const NavPortal& portal : p.portals) {
+            p.neighbors.push_back(portal.neighbor);
+        }
+        writeLinks(static_cast<std::size_t>(poly));
+    }
+    if (m_staleLinks > m_links.size() / 2) {
+        compactLinks();
+    }
+}
+
+NavPath PolyNavMesh::findPath(const glm::vec2& start, const glm::vec2& end) const {
+    // One search context per thread: concurrent queries stay safe and
+    // repeated ones reuse its storage.
+    thread_local NavQuery query;
+    return query.findPath(*this, start, end);
+}
+
+std::vector<NavRegion> PolyNavMesh::buildRegions(const NavRaster& raster,
+                                                 const NavRegion& area) const {
+    // Greedy rectangles over a copy of the area's walkable bits: take the
+    // first free cell in row-major order, extend it along its run of free
+    // cells, grow it upward while the rows above are free across its width,
+    // then clear the rectangle. Every step works on whole words.
+    constexpr int kBits = NavRaster::kCellsPerWord;
+    const int firstWord = area.xMin / kBits;
+    const int words = area.xMax / kBits - firstWord + 1;
+    const int rows = area.yMax - area.yMin + 1;
+    std::vector<std::uint64_t> free(static_cast<std::size_t>(words) * static_cast<std::size_t>(rows));
+    const auto row = [&free, words](int r) {
+        return free.data() + static_cast<std::size_t>(r) * static_cast<std::size_t>(words);
+    };
+    for (int r = 0; r < rows; ++r) {
+        const std::span<const std::uint64_t> source = raster.rowWords(area.yMin + r);
+        for (int w = 0; w < words; ++w) {
+            row(r)[w] = source[static_cast<std::size_t>(firstWord + w)] &
+                        cellMask(firstWord + w, area.xMin, area.xMax);
+        }
+    }
+    // Whether cells [x, x + width) are all free in `bits` (one row).
+    const auto allFree = [&](const std::uint64_t* bits, int x, int width) {
+        for (int w = x / kBits; w <= (x + width - 1) / kBits; ++w) {
+            const std::uint64_t mask = cellMask(w, x, x + width - 1);
+            if ((bits[w - firstWord] & mask) != mask) return false;
+        }
+        return true;
+    };
+
+    std::vector<NavRegion> regions;
+    for (int r = 0; r < rows; ++r) {
+        std::uint64_t* bits = row(r);
+        for (int w = 0; w < words; ++w) {
+            while (bits[w] != 0) {
+                const int bit = std::countr_zero(bits[w]);
+                const int x = (firstWord + w) * kBits + bit;
+                int width = std::countr_one(bits[w] >> bit);
+                for (int next = w + 1; bit + width == (next - w) * kBits && next < words; ++next) {
+                    width += std::countr_one(bits[next]);
                 }
-                if (canGrow) {
-                    ++maxH;
+                int height = 1;
+                while (r + height < rows && allFree(row(r + height), x, width)) {
+                    ++height;
                 }
-            }
-
-            for (int dy = 0; dy < maxH; ++dy) {
-                for (int dx = 0; dx < maxW; ++dx) {
-                    visited[idx(x + dx, y + dy)] = 1;
+                for (int dy = 0; dy < height; ++dy) {
+                    std::uint64_t* cleared = row(r + dy);
+                    for (int cw = x / kBits; cw <= (x + width - 1) / kBits; ++cw) {
+                        cleared[cw - firstWord] &= ~cellMask(cw, x, x + width - 1);
+                    }
                 }
+                regions.push_back(NavRegion{x, x + width - 1, area.yMin + r, area.yMin + r + height - 1});
             }
-
-            NavRegion r{};
-            r.xMin = x;
-            r.xMax = x + maxW - 1;
-            r.yMin = y;
-            r.yMax = y + maxH - 1;
-            regions.push_back(r);
         }
     }
     return regions;
 }
 
-void PolyNavMesh::buildPolygonsFromRegion(const NavRaster& raster, const std::vector<NavRegion>& regions) {
-    m_polys.clear();
-    m_polys.reserve(regions.size());
+NavPoly PolyNavMesh::makePoly(const NavRaster& raster, const NavRegion& r, int id) const {
     const float cellSize = raster.cellSize();
     const glm::vec2 origin = raster.origin();
+    const float minX = origin.x + static_cast<float>(r.xMin) * cellSize;
+    const float maxX = origin.x + static_cast<float>(r.xMax + 1) * cellSize;
+    const float minY = origin.y + static_cast<float>(r.yMin) * cellSize;
+    const float maxY = origin.y + static_cast<float>(r.yMax + 1) * cellSize;
+
+    NavPoly poly{};
+    poly.id = id;
+    poly.vertices.push_back(glm::vec2{minX, minY});
+    poly.vertices.push_back(glm::vec2{maxX, minY});
+    poly.vertices.push_back(glm::vec2{maxX, maxY});
+    poly.vertices.push_back(glm::vec2{minX, maxY});
+    poly.bounds = AABB(glm::vec2{minX, minY}, glm::vec2{maxX, maxY});
+    return poly;
+}
 
+void PolyNavMesh::buildPolygonsFromRegion(const NavRaster& raster, const std::vector<NavRegion>& regions) {
+    m_polys.clear();
+    m_polys.reserve(regions.size());
     for (size_t i = 0; i < regions.size(); ++i) {
-        const auto& r = regions[i];
-        const float minX = origin.x + static_cast<float>(r.xMin) * cellSize;
-        const float maxX = origin.x + static_cast<float>(r.xMax + 1) * cellSize;
-        const float minY = origin.y + static_cast<float>(r.yMin) * cellSize;
-        const float maxY = origin.y + static_cast<float>(r.yMax + 1) * cellSize;
-
-        NavPoly poly{};
-        poly.id = static_cast<int>(i);
-        poly.vertices.push_back(glm::vec2{minX, minY});
-        poly.vertices.push_back(glm::vec2{maxX, minY});
-        poly.vertices.push_back(glm::vec2{maxX, maxY});
-        poly.vertices.push_back(glm::vec2{minX, maxY});
-        poly.bounds = AABB(glm::vec2{minX, minY}, glm::vec2{maxX, maxY});
-        m_polys.push_back(std::move(poly));
+        m_polys.push_back(makePoly(raster, regions[i], static_cast<int>(i)));
+    }
+}
+
+void PolyNavMesh::buildCellLookup(const NavRaster& raster, const std::vector<NavRegion>& regions) {
+    m_cellColumns = raster.width();
+    m_cellRows = raster.height();
+    m_cellSize = raster.cellSize();
+    m_origin = raster.origin();
+    m_cellPolys.assign(static_cast<std::size_t>(m_cellColumns) *
+                       static_cast<std::size_t>(m_cellRows), -1);
+    for (std::size_t i = 0; i < regions.size(); ++i) {
+        const NavRegion& r = regions[i];
+        for (int y = r.yMin; y <= r.yMax; ++y) {
+            const auto row = static_cast<std::size_t>(y) * static_cast<std::size_t>(m_cellColumns);
+            std::fill(m_cellPolys.begin() + static_cast<std::ptrdiff_t>(row + r.xMin),
+                      m_cellPolys.begin() + static_cast<std::ptrdiff_t>(row + r.xMax + 1),
+                      static_cast<int>(i));
+        }
+    }
+}
+
+int PolyNavMesh::polyAtCell(int x, int y) const {
+    if (x < 0 || y < 0 || x >= m_cellColumns || y >= m_cellRows) {
+        return -1;
     }
+    return m_cellPolys[static_cast<std::size_t>(y) * static_cast<std::size_t>(m_cellColumns) +
+                       static_cast<std::size_t>(x)];
 }
 
-void PolyNavMesh::buildAdjacencies() {
-    const float eps = kEps;
+void PolyNavMesh::buildAdjacencies(const std::vector<NavRegion>& regions) {
     for (auto& p : m_polys) {
         p.neighbors.clear();
         p.portals.clear();
     }
-    for (size_t i = 0; i < m_polys.size(); ++i) {
-        for (size_t j = i + 1; j < m_polys.size(); ++j) {
-            glm::vec2 a0, a1;
-            if (sharesEdge(m_polys[i], m_polys[j], eps, a0, a1)) {
-                const int ni = static_cast<int>(j);
-                const int nj = static_cast<int>(i);
-                m_polys[i].neighbors.push_back(ni);
-                m_polys[j].neighbors.push_back(nj);
-
-                const glm::vec2 centerI = computePolyCenter(m_polys[i]);
-                const glm::vec2 centerJ = computePolyCenter(m_polys[j]);
-                // The funnel implementation consumes clockwise portal winding
-                // (its "left" endpoint is the lower signed-area endpoint in
-                // GL2D's x/y coordinate system).
-                const bool a0IsLeftFromI = signedArea(centerI, centerJ, a0) <=
-                                           signedArea(centerI, centerJ, a1);
-                m_polys[i].portals.push_back(
-                    NavPortal{ni, a0IsLeftFromI ? a0 : a1, a0IsLeftFromI ? a1 : a0});
-                m_polys[j].portals.push_back(
-                    NavPortal{nj, a0IsLeftFromI ? a1 : a0, a0IsLeftFromI ? a0 : a1});
+    // Rectangles only touch along their outer cell rows, so walking the cells
+    // just past each region's right and top edges finds every neighbour pair
+    // once, in time proportional to the regions' perimeters.
+    std::vector<std::pair<int, int>> pairs;
+    for (std::size_t i = 0; i < regions.size(); ++i) {
+        const NavRegion& r = regions[i];
+        const int self = static_cast<int>(i);
+        const auto addNeighbor = [&](int other) {
+            if (other < 0) return;
+            const std::pair pair{std::min(self, other), std::max(self, other)};
+            // Runs of cells along an edge usually belong to the same neighbour.
+            if (pairs.empty() || pairs.back() != pair) {
+                pairs.push_back(pair);
             }
+        };
+        for (int y = r.yMin; y <= r.yMax; ++y) {
+            addNeighbor(polyAtCell(r.xMax + 1, y));
         }
+        for (int x = r.xMin; x <= r.xMax; ++x) {
+            addNeighbor(polyAtCell(x, r.yMax + 1));
+        }
+    }
+    // Sorted pairs reproduce the neighbour order of an all-pairs scan, which
+    // keeps A* tie-breaking (and so the returned paths) stable.
+    std::sort(pairs.begin(), pairs.end());
+    pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+
+    for (const auto& [i, j] : pairs) {
+        connect(i, j);
     }
 }
 
-int PolyNavMesh::findPolyContainingPoint(const glm::vec2& point) const {
-    for (size_t i = 0; i < m_polys.size(); ++i) {
-        if (m_polys[i].bounds.contains(point)) {
-            return static_cast<int>(i);
-        }
+void PolyNavMesh::connect(int i, int j) {
+    glm::vec2 a0, a1;
+    if (!sharesEdge(m_polys[i], m_polys[j], kEps, a0, a1)) {
+        return;
     }
-    return -1;
+    const int ni = j;
+    const int nj = i;
+    m_polys[i].neighbors.push_back(ni);
+    m_polys[j].neighbors.push_back(nj);
+
+    const glm::vec2 centerI = computePolyCenter(m_polys[i]);
+    const glm::vec2 centerJ = computePolyCenter(m_polys[j]);
+    // The funnel implementation consumes clockwise portal winding
+    // (its "left" endpoint is the lower signed-area endpoint in
+    // GL2D's x/y coordinate system).
+    const bool a0IsLeftFromI = signedArea(centerI, centerJ, a0) <=
+                               signedArea(centerI, centerJ, a1);
+    m_polys[i].portals.push_back(
+        NavPortal{ni, a0IsLeftFromI ? a0 : a1, a0IsLeftFromI ? a1 : a0});
+    m_polys[j].portals.push_back(
+        NavPortal{nj, a0IsLeftFromI ? a1 : a0, a0IsLeftFromI ? a0 : a1});
 }
 
-std::vector<int> PolyNavMesh::findPathPolys(int startPolyIdx, int endPolyIdx) const {
-    auto heuristic = [&](int a, int b) {
-        const glm::vec2 ca = computePolyCenter(m_polys[a]);
-        const glm::vec2 cb = computePolyCenter(m_polys[b]);
-        return glm::length(cb - ca);
-    };
+void PolyNavMesh::buildLinks() {
+    m_centers.clear();
+    m_linkRanges.assign(m_polys.size(), LinkRange{});
+    m_links.clear();
+    m_centers.reserve(m_polys.size());
+    for (const NavPoly& poly : m_polys) {
+        m_centers.push_back(computePolyCenter(poly));
+    }
+    for (std::size_t i = 0; i < m_polys.size(); ++i) {
+        writeLinks(i);
+    }
+}
 
-    std::priority_queue<std::pair<float, int>,
-                        std::vector<std::pair<float, int>>,
-                        std::greater<>> open;
-    std::vector<float> gScores(m_polys.size(), std::numeric_limits<float>::infinity());
-    std::vector<int> parents(m_polys.size(), -1);
-    std::vector<std::uint8_t> closed(m_polys.size(), 0);
-
-    gScores[static_cast<std::size_t>(startPolyIdx)] = 0.0f;
-    open.push({heuristic(startPolyIdx, endPolyIdx), startPolyIdx});
-    bool reachedEnd = false;
-
-    while (!open.empty()) {
-        const auto [_, currentIdx] = open.top();
-        open.pop();
-        const auto current = static_cast<std::size_t>(currentIdx);
-        if (closed[current]) continue;
-        if (currentIdx == endPolyIdx) {
-            reachedEnd = true;
-            break;
-        }
-        closed[current] = 1;
-
-        for (int nei : m_polys[currentIdx].neighbors) {
-            const auto neighbor = static_cast<std::size_t>(nei);
-            if (closed[neighbor]) continue;
-            const float tentativeG = gScores[current] + heuristic(currentIdx, nei);
-            if (tentativeG < gScores[neighbor] - kEps) {
-                parents[neighbor] = currentIdx;
-                gScores[neighbor] = tentativeG;
-                open.push({tentativeG + heuristic(nei, endPolyIdx), nei});
-            }
+void PolyNavMesh::writeLinks(std::size_t poly) {
+    LinkRange& range = m_linkRanges[poly];
+    const std::vector<NavPortal>& portals = m_polys[poly].portals;
+    if (portals.size() > range.capacity - range.begin) {
+        // Outgrown: move to the end, with a little room for later updates.
+        m_staleLinks += range.capacity - range.begin;
+        const std::size_t capacity = m_links.size() + portals.size() + (m_tileSize > 0 ? 2 : 0);
+        if (capacity > std::numeric_limits<std::uint32_t>::max()) {
+            throw std::length_error("Navmesh has too many polygon links");
         }
+        range.begin = static_cast<std::uint32_t>(m_links.size());
+        range.capacity = static_cast<std::uint32_t>(capacity);
+        m_links.resize(capacity);
+    }
+    range.end = range.begin;
+    for (const NavPortal& portal : portals) {
+        const glm::vec2 delta =
+            m_centers[static_cast<std::size_t>(portal.neighbor)] - m_centers[poly];
+        m_links[range.end++] = {portal.neighbor, glm::length(delta), portal.left, portal.right};
     }
+}
 
-    std::vector<int> path;
-    if (!reachedEnd) return path;
-    int cur = endPolyIdx;
-    while (cur != -1) {
-        path.push_back(cur);
-        cur = parents[static_cast<std::size_t>(cur)];
+void PolyNavMesh::compactLinks() {
+    std::vector<NavLink> links;
+    links.reserve(m_links.size() - m_staleLinks);
+    for (LinkRange& range : m_linkRanges) {
+        const auto begin = static_cast<std::uint32_t>(links.size());
+        links.insert(links.end(), m_links.begin() + range.begin, m_links.begin() + range.capacity);
+        range = {begin, begin + (range.end - range.begin), static_cast<std::uint32_t>(links.size())};
     }
-    std::reverse(path.begin(), path.end());
-    return path;
+    m_links = std::move(links);
+    m_staleLinks = 0;
+}
+
+int PolyNavMesh::findPoly(const glm::vec2& point) const {
+    if (m_cellPolys.empty()) {
+        return -1;
+    }
+    const double cellX = (static_cast<double>(point.x) - m_origin.x) / m_cellSize;
+    const double cellY = (static_cast<double>(point.y) - m_origin.y) / m_cellSize;
+    if (!(cellX >= 0.0 && cellY >= 0.0 && cellX <= m_cellColumns && cellY <= m_cellRows)) {
+        return -1;
+    }
+    const int x = static_cast<int>(cellX);
+    const int y = static_cast<int>(cellY);
+    // Polygon bounds are closed, so a point on a cell's lower edge also
+    // belongs to the cell below or to the left of it. Of the polygons that
+    // contain it, the lowest index wins.
+    const bool onLeftEdge = x > 0 && static_cast<double>(x) == cellX;
+    const bool onBottomEdge = y > 0 && static_cast<double>(y) == cellY;
+    int found = -1;
+    for (const int candidate : {polyAtCell(x, y),
+                                onLeftEdge ? polyAtCell(x - 1, y) : -1,
+                                onBottomEdge ? polyAtCell(x, y - 1) : -1,
+                                onLeftEdge && onBottomEdge ? polyAtCell(x - 1, y - 1) : -1}) {
+        if (candidate >= 0 && (found < 0 || candidate < found)) {
+            found = candidate;
+        }
+    }
+    return found;
 }
 
 glm::vec2 PolyNavMesh::computePolyCenter(const NavPoly& poly) const {
@@ -281,95 +542,3 @@ bool PolyNavMesh::sharesEdge(const NavPoly& a, const NavPoly& b, float epsilon,
     }
     return false;
 }
-
-bool PolyNavMesh::getPortal(int aIdx, int bIdx, glm::vec2& outLeft, glm::vec2& outRight) const {
-    if (aIdx < 0 || aIdx >= static_cast<int>(m_polys.size())) return false;
-    for (const auto& p : m_polys[aIdx].portals) {
-        if (p.neighbor == bIdx) {
-            outLeft = p.left;
-            outRight = p.right;
-            return true;
-        }
-    }
-    return false;
-}
-
-NavPath PolyNavMesh::buildPathWithFunnel(const std::vector<int>& polyPath,
-                                         const glm::vec2& start,
-                                         const glm::vec2& end) const {
-    NavPath path;
-    if (polyPath.empty()) return path;
-    if (polyPath.size() == 1) {
-        path.points = nearlyEqual(start, end) ? std::vector<glm::vec2>{start}
-                                              : std::vector<glm::vec2>{start, end};
-        return path;
-    }
-
-    struct PortalSeg { glm::vec2 left; glm::vec2 right; };
-    std::vector<PortalSeg> portals;
-    portals.reserve(polyPath.size() + 1);
-    portals.push_back({start, start});
-
-    for (size_t i = 0; i + 1 < polyPath.size(); ++i) {
-        glm::vec2 p0, p1;
-        if (!getPortal(polyPath[i], polyPath[i + 1], p0, p1)) {
-            throw std::logic_error("Navmesh path corridor is missing a shared portal");
-        }
-        portals.push_back({p0, p1});
-    }
-    portals.push_back({end, end});
-
-    glm::vec2 apex = portals[0].left;
-    glm::vec2 left = portals[0].left;
-    glm::vec2 right = portals[0].right;
-    size_t apexIndex = 0, leftIndex = 0, rightIndex = 0;
-
-    path.points.clear();
-    path.points.push_back(apex);
-
-    for (size_t i = 1; i < portals.size(); ++i) {
-        const glm::vec2 newLeft = portals[i].left;
-        const glm::vec2 newRight = portals[i].right;
-
-        // Tighten right
-        if (signedArea(apex, right, newRight) <= 0.0f) {
-            if (nearlyEqual(apex, right) || signedArea(apex, left, newRight) > 0.0f) {
-                right = newRight;
-                rightIndex = i;
-            } else {
-                apex = left;
-                if (!nearlyEqual(path.points.back(), apex)) path.points.push_back(apex);
-                apexIndex = leftIndex;
-                left = apex;
-                right = apex;
-                leftIndex = apexIndex;
-                rightIndex = apexIndex;
-                i = apexIndex;
-                continue;
-            }
-        }
-
-        // Tighten left
-        if (signedArea(apex, left, newLeft) >= 0.0f) {
-            if (nearlyEqual(apex, left) || signedArea(apex, right, newLeft) < 0.0f) {
-                left = newLeft;
-                leftIndex = i;
-            } else {
-                apex = right;
-                if (!nearlyEqual(path.points.back(), apex)) path.points.push_back(apex);
-                apexIndex = rightIndex;
-                left = apex;
-                right = apex;
-                leftIndex = apexIndex;
-                rightIndex = apexIndex;
-                i = apexIndex;
-                continue;
-            }
-        }
-    }
-
-    if (path.points.empty() || glm::length(path.points.back() - end) > kEps) {
-        path.points.push_back(end);
-    }
-    return path;
-}
@@ -1,5 +1,8 @@
 #ifndef POLY_NAV_MESH_HPP
 #define POLY_NAV_MESH_HPP
+#include <cstddef>
+#include <cstdint>
+#include <span>
 #include <vector>
 
 #include "NavRaster.hpp"
@@ -7,30 +10,110 @@
 #include "INavMesh.hpp"
 #include "NavRegion.hpp"
 
+// One directed polygon-to-polygon edge of the flattened adjacency.
+struct NavLink {
+    int neighbor{-1};
+    // Distance between the two polygon centers; the A* step cost.
+    float cost{0.0f};
+    glm::vec2 left{0.0f};
+    glm::vec2 right{0.0f};
+};
+
 class PolyNavMesh final : public INavMesh {
 public:
     PolyNavMesh() = default;
     void buildFromRaster(const NavRaster& raster) override;
     void clear() override;
+
+    // Tiled build: polygons never cross the raster's NavRaster::kTileSize
+    // tiles, so a changed tile can be rebuilt alone. updateTiles() rebuilds
+    // the given tiles (by default the raster's dirty tiles; clear them
+    // afterwards) and reconnects their border portals, reusing freed polygon
+    // indices. Removed polygons stay in polygons() with an id of -1 and no
+    // vertices or links. Throws std::invalid_argument when the mesh was not
+    // built tiled from a raster of the same dimensions.
+    void buildTiled(const NavRaster& raster);
+    void updateTiles(const NavRaster& raster);
+    void updateTiles(const NavRaster& raster, std::span<const int> tiles);
+    [[nodiscard]] bool tiled() const noexcept { return m_tileSize > 0; }
+    // Indices of the polygons the last updateTiles() removed, sorted. Some
+    // may already hold new polygons; pass them to PathRequestQueue::meshChanged.
+    [[nodiscard]] std::span<const int> lastRemovedPolys() const noexcept {
+        return m_lastRemovedPolys;
+    }
+    // Polygons outside the updated tiles whose portals the last updateTiles()
+    // added or removed (an opened door links its neighbours to new
+    // polygons), sorted; pass them to PathRequestQueue::meshChanged too.
+    [[nodiscard]] std::span<const int> lastChangedPolys() const noexcept {
+        return m_lastChangedPolys;
+    }
+
     [[nodiscard]] NavPath findPath(const glm::vec2& start,
                                    const glm::vec2& end) const override;
     [[nodiscard]] const std::vector<NavPoly>& polygons() const { return m_polys; }
 
+    // Compact query layout: centers and links of every polygon in flat
+    // arrays (links of one polygon are contiguous). NavQuery
+    // searches these; polygons() keeps the per-polygon view for tools.
+    [[nodiscard]] std::size_t polyCount() const noexcept { return m_centers.size(); }
+    [[nodiscard]] const glm::vec2& polyCenter(int poly) const noexcept {
+        return m_centers[static_cast<std::size_t>(poly)];
+    }
+    [[nodiscard]] std::span<const NavLink> links(int poly) const noexcept {
+        const LinkRange& range = m_linkRanges[static_cast<std::size_t>(poly)];
+        return {m_links.data() + range.begin, m_links.data() + range.end};
+    }
+    // Index of the polygon containing `point`, or -1.
+    [[nodiscard]] int findPoly(const glm::vec2& point) const;
+
 private:
+    // Links in [begin, end); tiled updates rewrite them in place while
+    // they fit below `capacity`.
+    struct LinkRange {
+        std::uint32_t begin{0};
+        std::uint32_t end{0};
+        std::uint32_t capacity{0};
+    };
+
     std::vector<NavPoly> m_polys;
+    // Polygon index of every raster cell (-1 where not walkable), row-major.
+    // Adjacency and point location read this instead of comparing polygons.
+    std::vector<int> m_cellPolys;
+    int m_cellColumns{0};
+    int m_cellRows{0};
+    float m_cellSize{1.0f};
+    glm::vec2 m_origin{0.0f};
+    std::vector<glm::vec2> m_centers;
+    std::vector<LinkRange> m_linkRanges;
+    std::vector<NavLink> m_links;
+    // Tiled meshes only: the cell rectangle of every polygon, the polygons of
+    // each tile, free polygon indices, and links no range refers to any more.
+    int m_tileSize{0};
+    int m_tileColumns{0};
+    int m_tileRows{0};
+    std::vector<NavRegion> m_polyRegions;
+    std::vector<std::vector<int>> m_tilePolys;
+    std::vector<int> m_freePolys;
+    std::vector<int> m_lastRemovedPolys;
+    std::vector<int> m_lastChangedPolys;
+    std::size_t m_staleLinks{0};
 
-    std::vector<NavRegion> buildRegions(const NavRaster& raster) const;
+    std::vector<NavRegion> buildRegions(const NavRaster& raster, const NavRegion& area) const;
+    [[nodiscard]] NavPoly makePoly(const NavRaster& raster, const NavRegion& region, int id) const;
     void buildPolygonsFromRegion(const NavRaster& raster, const std::vector<NavRegion>& regions);
-    void buildAdjacencies();
-    int findPolyContainingPoint(const glm::vec2& point) const;
-    std::vector<int> findPathPolys(int startPolyIdx, int endPolyIdx) const;
-    NavPath buildPathWithFunnel(const std::vector<int>& polyPath,
-                                const glm::vec2& start,
-                                const glm::vec2& end) const;
+    void buildCellLookup(const NavRaster& raster, const std::vector<NavRegion>& regions);
+    void buildAdjacencies(const std::vector<NavRegion>& regions);
+    // Adds portals between polygons i and j when they share an edge.
+    void connect(int i, int j);
+    [[nodiscard]] int polyAtCell(int x, int y) const;
+    void buildLinks();
+    void writeLinks(std::size_t poly);
+    void compactLinks();
+    void rebuildTiles(const NavRaster& raster, std::span<const int> tiles);
+    [[nodiscard]] int allocatePoly();
 
     glm::vec2 computePolyCenter(const NavPoly& poly) const;
     bool sharesEdge(const NavPoly& a, const NavPoly& b,float epsilon, glm::vec2& outA, glm::vec2& outB) const;
-    bool getPortal(int aIdx, int bIdx, glm::vec2& outLeft, glm::vec2& outRight) const;
 };
 
 #endif // POLY_NAV_MESH_HPP
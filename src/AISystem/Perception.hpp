@@ -11,6 +11,9 @@ class Entity;
 
 namespace AI {
 
+// Immediate queries over every collider. Agents that perceive every tick
+// should batch through PerceptionService instead.
+
 // Simple line-of-sight check using physics ray casts and layer masks.
 bool hasLineOfSight(const glm::vec2& from,
                     const glm::vec2& to,
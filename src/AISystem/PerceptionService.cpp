@@ -0,0 +1,413 @@
+#include "PerceptionService.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <stdexcept>
+
+#include <glm/glm.hpp>
+
+#include "GameObjects/Components/ColliderComponent.hpp"
+#include "GameObjects/Entity.hpp"
+#include "Physics/Collision/AABB.hpp"
+#include "Physics/Collision/ACollider.hpp"
+#include "Physics/PhysicsCasts.hpp"
+
+namespace AI {
+
+namespace {
+
+constexpr float kInfinity = std::numeric_limits<float>::infinity();
+// hasLineOfSight() treats a hit this close to the end as unobstructed; the
+// occlusion grid keeps the same distance again as margin.
+constexpr float kEndTolerance = 1e-3f;
+
+bool finite(const glm::vec2& value) {
+    return std::isfinite(value.x) && std::isfinite(value.y);
+}
+
+std::size_t mix(std::size_t seed, std::size_t value) {
+    return seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2));
+}
+
+std::size_t floatBits(float value) {
+    // +0.0f folds -0.0f into 0.0f, which compares equal.
+    return std::bit_cast<std::uint32_t>(value + 0.0f);
+}
+
+} // namespace
+
+std::size_t PerceptionService::QueryHash::operator()(const Query& query) const noexcept {
+    std::size_t seed = static_cast<std::size_t>(query.kind);
+    seed = mix(seed, floatBits(query.a.x));
+    seed = mix(seed, floatBits(query.a.y));
+    seed = mix(seed, floatBits(query.b.x));
+    seed = mix(seed, floatBits(query.b.y));
+    seed = mix(seed, query.layerMask);
+    seed = mix(seed, reinterpret_cast<std::uintptr_t>(query.ignore));
+    return mix(seed, reinterpret_cast<std::uintptr_t>(query.target));
+}
+
+PerceptionService::PerceptionService() : PerceptionService(Settings{}) {}
+
+PerceptionService::PerceptionService(const Settings& settings) {
+    setSettings(settings);
+}
+
+void PerceptionService::setSettings(const Settings& settings) {
+    if (settings.retainedBatches == 0) {
+        throw std::invalid_argument("PerceptionService must retain at least one batch");
+    }
+    std::vector<ResolvedBatch> resolved(settings.retainedBatches);
+    const std::uint64_t newest = m_batch - 1;
+    for (ResolvedBatch& batch : m_resolved) {
+        if (batch.batch != 0 && newest - batch.batch < settings.retainedBatches) {
+            resolved[batch.batch % settings.retainedBatches] = std::move(batch);
+        }
+    }
+    m_resolved = std::move(resolved);
+    m_settings = settings;
+}
+
+PerceptionTicket PerceptionService::requestLineOfSight(const glm::vec2& from,
+                                                       const glm::vec2& to,
+                                                       std::uint32_t layerMask,
+                                                       const Entity* ignore,
+                                                       const Entity* target) {
+    if (!finite(from) || !finite(to)) {
+        throw std::invalid_argument("Line-of-sight endpoints must be finite");
+    }
+    return submit(Query{Kind::LineOfSight, from, to, layerMask, ignore, target});
+}
+
+PerceptionTicket PerceptionService::requestHearing(const glm::vec2& listener,
+                                                   float radius,
+                                                   std::uint32_t layerMask,
+                                                   const Entity* ignore) {
+    if (!finite(listener) || !std::isfinite(radius) || radius < 0.0f) {
+        throw std::invalid_argument("Hearing position and radius must be finite; radius cannot be negative");
+    }
+    return submit(Query{Kind::Hearing, listener, glm::vec2{radius, 0.0f}, layerMask, ignore, nullptr});
+}
+
+PerceptionTicket PerceptionService::submit(const Query& query) {
+    if (m_requests.size() >= std::numeric_limits<std::uint32_t>::max()) {
+        throw std::length_error("Too many perception requests in one batch");
+    }
+    const auto [it, inserted] = m_pendingIndex.try_emplace(
+        query, static_cast<std::uint32_t>(m_pending.size()));
+    if (inserted) {
+        m_pending.push_back(query);
+    } else {
+        ++m_stats.deduplicated;
+    }
+    ++m_stats.requested;
+    m_requests.push_back(it->second);
+    return PerceptionTicket{static_cast<std::uint32_t>(m_requests.size() - 1), m_batch};
+}
+
+void PerceptionService::update(const std::vector<std::unique_ptr<Entity>>& entities) {
+    gatherColliders(entities);
+
+    // Overwrites the oldest retained batch.
+    ResolvedBatch& resolved = m_resolved[m_batch % m_resolved.size()];
+    resolved.results.assign(m_pending.size(), Result{});
+    resolved.heardEntities.clear();
+    for (std::size_t i = 0; i < m_pending.size(); ++i) {
+        const Query& query = m_pending[i];
+        Result& result = resolved.results[i];
+        result.kind = query.kind;
+        if (query.kind == Kind::LineOfSight) {
+            result.value = resolveLineOfSight(query);
+            ++m_stats.lineOfSightResolved;
+        } else {
+            result.heardBegin = static_cast<std::uint32_t>(resolved.heardEntities.size());
+            result.value = resolveHearing(query, resolved.heardEntities);
+            result.heardEnd = static_cast<std::uint32_t>(resolved.heardEntities.size());
+            ++m_stats.hearingResolved;
+        }
+    }
+    m_stats.queriesLastUpdate = m_pending.size();
+
+    resolved.requests.swap(m_requests);
+    resolved.batch = m_batch++;
+    m_requests.clear();
+    m_pending.clear();
+    m_pendingIndex.clear();
+}
+
+const PerceptionService::ResolvedBatch* PerceptionService::findBatch(PerceptionTicket ticket) const noexcept {
+    if (!ticket.valid()) return nullptr;
+    const ResolvedBatch& resolved = m_resolved[ticket.batch % m_resolved.size()];
+    return resolved.batch == ticket.batch && ticket.index < resolved.requests.size() ? &resolved : nullptr;
+}
+
+const PerceptionService::Result* PerceptionService::find(PerceptionTicket ticket) const noexcept {
+    const ResolvedBatch* resolved = findBatch(ticket);
+    return resolved ? &resolved->results[resolved->requests[ticket.index]] : nullptr;
+}
+
+std::optional<bool> PerceptionService::lineOfSight(PerceptionTicket ticket) const noexcept {
+    const Result* result = find(ticket);
+    if (!result || result->kind != Kind::LineOfSight) return std::nullopt;
+    return result->value;
+}
+
+std::optional<bool> PerceptionService::heard(PerceptionTicket ticket) const noexcept {
+    const Result* result = find(ticket);
+    if (!result || result->kind != Kind::Hearing) return std::nullopt;
+    return result->value;
+}
+
+std::span<Entity* const> PerceptionService::heardEntities(PerceptionTicket ticket) const noexcept {
+    const ResolvedBatch* resolved = findBatch(ticket);
+    if (!resolved) return {};
+    const Result* result = &resolved->results[resolved->requests[ticket.index]];
+    if (result->kind != Kind::Hearing) return {};
+    return std::span<Entity* const>(resolved->heardEntities).subspan(
+        result->heardBegin, result->heardEnd - result->heardBegin);
+}
+
+void PerceptionService::gatherColliders(const std::vector<std::unique_ptr<Entity>>& entities) {
+    m_colliders.clear();
+    for (const auto& entity : entities) {
+        if (!entity) continue;
+        auto* component = entity->getComponent<ColliderComponent>();
+        if (!component) continue;
+        component->ensureCollider(*entity);
+        if (auto* collider = component->collider()) {
+            m_colliders.push_back(ColliderEntry{entity.get(), collider});
+        }
+    }
+    // Users point into m_colliders, which no longer grows until the next update.
+    m_bvhEntries.clear();
+    for (ColliderEntry& entry : m_colliders) {
+        m_bvhEntries.push_back(BroadphaseBVH::Entry{entry.collider->getAABB(), &entry});
+    }
+    m_bvh.build(m_bvhEntries);
+    m_stats.collidersLastUpdate = m_colliders.size();
+}
+
+void PerceptionService::orderCandidates() {
+    // Test in entity order so ties resolve as in PhysicsCasts.
+    m_candidateIndices.clear();
+    for (void* user : m_candidates) {
+        m_candidateIndices.push_back(static_cast<std::uint32_t>(
+            static_cast<const ColliderEntry*>(user) - m_colliders.data()));
+    }
+    std::ranges::sort(m_candidateIndices);
+}
+
+bool PerceptionService::resolveLineOfSight(const Query& query) {
+    const glm::vec2 delta = query.b - query.a;
+    const float length = glm::length(delta);
+    if (length < 1e-4f) {
+        return true;
+    }
+    const glm::vec2 direction = delta / length;
+    const PhysicsCasts::CastFilter filter{.ignore = query.ignore, .includeTriggers = false,
+                                          .layerMask = query.layerMask};
+
+    if (!m_occlusion.empty() && !bakedEntity(query.ignore)) {
+        const float blocked = occlusionDistance(query, length);
+        if (blocked + kEndTolerance < length - kEndTolerance) {
+            // The covering box is hit no later than `blocked`; the line is
+            // clear only if the target's own collider comes first.
+            float targetDistance = kInfinity;
+            if (query.target) {
+                const auto* component = query.target->getComponent<ColliderComponent>();
+                ACollider* collider = component ? component->collider() : nullptr;
+                PhysicsCasts::CastHit hit{};
+                ++m_stats.colliderTests;
+                if (collider && PhysicsCasts::accepts(filter, query.target, *collider) &&
+                    PhysicsCasts::rayCastCollider(query.a, direction, length, nullptr, *collider, hit)) {
+                    targetDistance = hit.distance;
+                }
+            }
+            if (blocked + kEndTolerance < targetDistance) {
+                ++m_stats.occlusionRejects;
+                return false;
+            }
+        }
+    }
+
+    m_candidates.clear();
+    m_bvh.querySegment(query.a, query.b, m_candidates);
+    orderCandidates();
+    PhysicsCasts::CastHit best{};
+    float closest = length;
+    for (const std::uint32_t index : m_candidateIndices) {
+        const ColliderEntry& entry = m_colliders[index];
+        if (!PhysicsCasts::accepts(filter, entry.entity, *entry.collider)) continue;
+        ++m_stats.colliderTests;
+        if (PhysicsCasts::rayCastCollider(query.a, direction, closest, entry.entity,
+                                          *entry.collider, best)) {
+            closest = best.distance;
+        }
+    }
+    return !best.hit || (query.target && best.entity == query.target) ||
+           best.distance >= length - kEndTolerance;
+}
+
+bool PerceptionService::resolveHearing(const Query& query, std::vector<Entity*>& heard) {
+    const float radius = query.b.x;
+    if (radius == 0.0f) {
+        return false;
+    }
+    m_candidates.clear();
+    m_bvh.query(AABB{query.a - glm::vec2{radius}, query.a + glm::vec2{radius}}, m_candidates);
+    orderCandidates();
+    const PhysicsCasts::CastFilter filter{.ignore = query.ignore, .includeTriggers = false,
+                                          .layerMask = query.layerMask};
+    bool heardAny = false;
+    for (const std::uint32_t index : m_candidateIndices) {
+        const ColliderEntry& entry = m_colliders[index];
+        if (!PhysicsCasts::accepts(filter, entry.entity, *entry.collider)) continue;
+        ++m_stats.colliderTests;
+        PhysicsCasts::CastHit hit{};
+        if (PhysicsCasts::overlapCircleCollider(query.a, radius, entry.entity, *entry.collider, hit)) {
+            heardAny = true;
+            heard.push_back(entry.entity);
+        }
+    }
+    return heardAny;
+}
+
+void PerceptionService::bakeOcclusion(const std::vector<std::unique_ptr<Entity>>& entities,
+                                      std::uint32_t layerMask, float cellSize) {
+    if (!std::isfinite(cellSize) || cellSize <= 0.0f) {
+        throw std::invalid_argument("Occlusion cell size must be finite and positive");
+    }
+    clearOcclusion();
+
+    struct Box {
+        const Entity* entity;
+        AABB bounds;
+        std::uint32_t layerBit;
+    };
+    std::vector<Box> boxes;
+    glm::vec2 min{kInfinity};
+    glm::vec2 max{-kInfinity};
+    for (const auto& entity : entities) {
+        if (!entity) continue;
+        auto* component = entity->getComponent<ColliderComponent>();
+        if (!component) continue;
+        component->ensureCollider(*entity);
+        const ACollider* collider = component->collider();
+        if (!collider || collider->getType() != ColliderType::AABB || collider->isTrigger()) continue;
+        const std::uint32_t bit = 1u << collider->getLayer();
+        if ((layerMask & bit) == 0u) continue;
+        const AABB bounds = collider->getAABB();
+        boxes.push_back(Box{entity.get(), bounds, bit});
+        min = glm::min(min, bounds.getMin());
+        max = glm::max(max, bounds.getMax());
+    }
+    if (boxes.empty()) {
+        return;
+    }
+
+    const double columns = std::ceil(static_cast<double>(max.x - min.x) / cellSize);
+    const double rows = std::ceil(static_cast<double>(max.y - min.y) / cellSize);
+    if (columns * rows > static_cast<double>(std::numeric_limits<int>::max())) {
+        throw std::length_error("Occlusion grid is too large for its cell size");
+    }
+    m_occlusionOrigin = min;
+    m_occlusionCellSize = cellSize;
+    m_occlusionColumns = std::max(1, static_cast<int>(columns));
+    m_occlusionRows = std::max(1, static_cast<int>(rows));
+    m_occlusion.assign(static_cast<std::size_t>(m_occlusionColumns) * m_occlusionRows, 0u);
+
+    for (const Box& box : boxes) {
+        const glm::vec2 low = (box.bounds.getMin() - min) / cellSize;
+        const glm::vec2 high = (box.bounds.getMax() - min) / cellSize;
+        const int minX = std::max(0, static_cast<int>(std::ceil(low.x)));
+        const int minY = std::max(0, static_cast<int>(std::ceil(low.y)));
+        const int maxX = std::min(m_occlusionColumns, static_cast<int>(std::floor(high.x))) - 1;
+        const int maxY = std::min(m_occlusionRows, static_cast<int>(std::floor(high.y))) - 1;
+        if (minX > maxX || minY > maxY) continue;
+        for (int y = minY; y <= maxY; ++y) {
+            std::uint32_t* row = m_occlusion.data() + static_cast<std::size_t>(y) * m_occlusionColumns;
+            for (int x = minX; x <= maxX; ++x) {
+                row[x] |= box.layerBit;
+            }
+        }
+        m_bakedEntities.push_back(box.entity);
+    }
+    std::ranges::sort(m_bakedEntities);
+}
+
+void PerceptionService::clearOcclusion() noexcept {
+    m_occlusion.clear();
+    m_bakedEntities.clear();
+    m_occlusionColumns = 0;
+    m_occlusionRows = 0;
+}
+
+std::size_t PerceptionService::occludedCells() const noexcept {
+    return static_cast<std::size_t>(std::ranges::count_if(
+        m_occlusion, [](std::uint32_t layers) { return layers != 0u; }));
+}
+
+bool PerceptionService::bakedEntity(const Entity* entity) const noexcept {
+    return entity && std::ranges::binary_search(m_bakedEntities, entity);
+}
+
+float PerceptionService::occlusionDistance(const Query& query, float length) const noexcept {
+    // Clip the line, in cell units, to the grid, then walk the cells it
+    // crosses in order (Amanatides-Woo).
+    const glm::vec2 start = (query.a - m_occlusionOrigin) / m_occlusionCellSize;
+    const glm::vec2 delta = (query.b - query.a) / m_occlusionCellSize;
+    const glm::vec2 extent{static_cast<float>(m_occlusionColumns),
+                           static_cast<float>(m_occlusionRows)};
+    float tEnter = 0.0f;
+    float tExit = 1.0f;
+    for (int axis = 0; axis < 2; ++axis) {
+        if (delta[axis] == 0.0f) {
+            if (start[axis] < 0.0f || start[axis] >= extent[axis]) return kInfinity;
+            continue;
+        }
+        float t0 = -start[axis] / delta[axis];
+        float t1 = (extent[axis] - start[axis]) / delta[axis];
+        if (t0 > t1) std::swap(t0, t1);
+        tEnter = std::max(tEnter, t0);
+        tExit = std::min(tExit, t1);
+    }
+    if (tEnter > tExit) return kInfinity;
+
+    const glm::vec2 entry = start + delta * tEnter;
+    int x = std::clamp(static_cast<int>(std::floor(entry.x)), 0, m_occlusionColumns - 1);
+    int y = std::clamp(static_cast<int>(std::floor(entry.y)), 0, m_occlusionRows - 1);
+    const int stepX = delta.x > 0.0f ? 1 : -1;
+    const int stepY = delta.y > 0.0f ? 1 : -1;
+    const float deltaX = delta.x != 0.0f ? std::abs(1.0f / delta.x) : kInfinity;
+    const float deltaY = delta.y != 0.0f ? std::abs(1.0f / delta.y) : kInfinity;
+    float nextX = delta.x != 0.0f
+        ? (static_cast<float>(x + (stepX > 0 ? 1 : 0)) - start.x) / delta.x : kInfinity;
+    float nextY = delta.y != 0.0f
+        ? (static_cast<float>(y + (stepY > 0 ? 1 : 0)) - start.y) / delta.y : kInfinity;
+
+    float t = tEnter;
+    while (t <= tExit) {
+        const std::uint32_t layers =
+            m_occlusion[static_cast<std::size_t>(y) * m_occlusionColumns + x];
+        // Cells the line merely grazes are left to the exact test.
+        const float leave = std::min({nextX, nextY, tExit});
+        if ((layers & query.layerMask) != 0u && (leave - t) * length > kEndTolerance) {
+            return t * length;
+        }
+        if (nextX < nextY) {
+            t = nextX;
+            nextX += deltaX;
+            x += stepX;
+            if (x < 0 || x >= m_occlusionColumns) break;
+        } else {
+            t = nextY;
+            nextY += deltaY;
+            y += stepY;
+            if (y < 0 || y >= m_occlusionRows) break;
+        }
+    }
+    return kInfinity;
+}
+
+} // namespace AI
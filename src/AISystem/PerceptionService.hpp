@@ -0,0 +1,203 @@
+#ifndef AI_PERCEPTION_SERVICE_HPP
+#define AI_PERCEPTION_SERVICE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/vec2.hpp>
+
+#include "Physics/BroadphaseBVH.hpp"
+
+class ACollider;
+class Entity;
+
+namespace AI {
+
+struct PerceptionTicket {
+    std::uint32_t index{std::numeric_limits<std::uint32_t>::max()};
+    // Batch the query was submitted in; 0 for a default-constructed ticket.
+    std::uint64_t batch{0};
+
+    [[nodiscard]] bool valid() const noexcept { return batch != 0; }
+    friend bool operator==(const PerceptionTicket&, const PerceptionTicket&) = default;
+};
+
+// Batched line-of-sight and hearing queries for a whole tick. Agents submit
+// queries while they think, the game calls update() once per tick, and each
+// agent reads its answers on the next tick. update() gathers the colliders
+// once, indexes them in a BroadphaseBVH, and resolves every distinct query
+// against it; identical queries from several agents are resolved once.
+// Answers match hasLineOfSight() and canHear() for the world at the time of
+// update().
+//
+// An optional occlusion grid baked from static colliders answers blocked
+// sight lines without touching the BVH: a line that crosses a grid cell
+// covered by a static box before it could reach the target is blocked.
+// Rebake after static colliders move, change layer or are destroyed.
+//
+// Answers of the last `retainedBatches` updates stay readable, so an agent
+// that thinks only every Nth tick (see UpdateScheduler) can read a ticket
+// on its next update as long as N <= retainedBatches. Heard entity pointers
+// are only as valid as the entities passed to the update that resolved
+// them. Use from one thread.
+class PerceptionService {
+public:
+    struct Settings {
+        // Resolved batches kept readable; the default covers the slowest
+        // UpdateScheduler rate.
+        std::size_t retainedBatches{16};
+    };
+
+    struct Stats {
+        std::uint64_t requested{0};
+        // Requests that joined an identical query of the same batch.
+        std::uint64_t deduplicated{0};
+        std::uint64_t lineOfSightResolved{0};
+        std::uint64_t hearingResolved{0};
+        // Sight lines answered by the occlusion grid alone.
+        std::uint64_t occlusionRejects{0};
+        // Exact collider tests run after the BVH.
+        std::uint64_t colliderTests{0};
+        std::size_t collidersLastUpdate{0};
+        std::size_t queriesLastUpdate{0};
+    };
+
+    PerceptionService();
+    explicit PerceptionService(const Settings& settings);
+
+    PerceptionService(const PerceptionService&) = delete;
+    PerceptionService& operator=(const PerceptionService&) = delete;
+
+    // Same arguments as hasLineOfSight() and canHear(); invalid positions
+    // or radii throw std::invalid_argument here rather than in update().
+    [[nodiscard]] PerceptionTicket requestLineOfSight(const glm::vec2& from,
+                                                      const glm::vec2& to,
+                                                      std::uint32_t layerMask = 0xFFFFFFFFu,
+                                                      const Entity* ignore = nullptr,
+                                                      const Entity* target = nullptr);
+    [[nodiscard]] PerceptionTicket requestHearing(const glm::vec2& listener,
+                                                  float radius,
+                                                  std::uint32_t layerMask = 0xFFFFFFFFu,
+                                                  const Entity* ignore = nullptr);
+
+    // Resolves every query submitted since the last update.
+    void update(const std::vector<std::unique_ptr<Entity>>& entities);
+
+    // Answers for tickets of the retained batches; nullopt for tickets still
+    // pending, from older batches, or of the other query kind.
+    [[nodiscard]] std::optional<bool> lineOfSight(PerceptionTicket ticket) const noexcept;
+    [[nodiscard]] std::optional<bool> heard(PerceptionTicket ticket) const noexcept;
+    // Entities heard by a resolved hearing ticket, in entity order.
+    [[nodiscard]] std::span<Entity* const> heardEntities(PerceptionTicket ticket) const noexcept;
+
+    // Marks grid cells of `cellSize` that lie wholly inside a non-trigger box
+    // collider on one of `layerMask`'s layers. Circles and capsules are
+    // never baked; they are still tested exactly.
+    void bakeOcclusion(const std::vector<std::unique_ptr<Entity>>& entities,
+                       std::uint32_t layerMask, float cellSize);
+    void clearOcclusion() noexcept;
+    [[nodiscard]] std::size_t occludedCells() const noexcept;
+
+    // Shrinking the retention drops the oldest answers.
+    void setSettings(const Settings& settings);
+    [[nodiscard]] const Settings& settings() const noexcept { return m_settings; }
+
+    // Distinct queries waiting for the next update().
+    [[nodiscard]] std::size_t pending() const noexcept { return m_pending.size(); }
+    [[nodiscard]] const Stats& stats() const noexcept { return m_stats; }
+    void resetStats() noexcept { m_stats = {}; }
+
+private:
+    enum class Kind : std::uint8_t {
+        LineOfSight,
+        Hearing
+    };
+
+    struct Query {
+        Kind kind{Kind::LineOfSight};
+        glm::vec2 a{0.0f};
+        // Sight line end; x holds the hearing radius.
+        glm::vec2 b{0.0f};
+        std::uint32_t layerMask{0};
+        const Entity* ignore{nullptr};
+        const Entity* target{nullptr};
+
+        friend bool operator==(const Query&, const Query&) = default;
+    };
+
+    struct QueryHash {
+        std::size_t operator()(const Query& query) const noexcept;
+    };
+
+    struct Result {
+        Kind kind{Kind::LineOfSight};
+        bool value{false};
+        // Range in the batch's heardEntities.
+        std::uint32_t heardBegin{0};
+        std::uint32_t heardEnd{0};
+    };
+
+    struct ResolvedBatch {
+        std::uint64_t batch{0};
+        // Index into `results` per request.
+        std::vector<std::uint32_t> requests;
+        std::vector<Result> results;
+        std::vector<Entity*> heardEntities;
+    };
+
+    struct ColliderEntry {
+        Entity* entity{nullptr};
+        ACollider* collider{nullptr};
+    };
+
+    [[nodiscard]] PerceptionTicket submit(const Query& query);
+    [[nodiscard]] const ResolvedBatch* findBatch(PerceptionTicket ticket) const noexcept;
+    [[nodiscard]] const Result* find(PerceptionTicket ticket) const noexcept;
+    void gatherColliders(const std::vector<std::unique_ptr<Entity>>& entities);
+    // Turns the BVH hits in m_candidates into sorted collider indices.
+    void orderCandidates();
+    [[nodiscard]] bool resolveLineOfSight(const Query& query);
+    [[nodiscard]] bool resolveHearing(const Query& query, std::vector<Entity*>& heard);
+    // Distance along the sight line to the first occluded cell of its
+    // layers, or infinity.
+    [[nodiscard]] float occlusionDistance(const Query& query, float length) const noexcept;
+    [[nodiscard]] bool bakedEntity(const Entity* entity) const noexcept;
+
+    // Distinct queries of the batch being collected, and every request's
+    // index into them.
+    std::vector<Query> m_pending;
+    std::unordered_map<Query, std::uint32_t, QueryHash> m_pendingIndex;
+    std::vector<std::uint32_t> m_requests;
+    std::uint64_t m_batch{1};
+
+    // Retained answers; batch b lives in slot b % retainedBatches, and its
+    // storage is reused by later batches.
+    Settings m_settings;
+    std::vector<ResolvedBatch> m_resolved;
+
+    std::vector<ColliderEntry> m_colliders;
+    std::vector<BroadphaseBVH::Entry> m_bvhEntries;
+    BroadphaseBVH m_bvh;
+    std::vector<void*> m_candidates;
+    std::vector<std::uint32_t> m_candidateIndices;
+
+    // Layers of the static boxes covering each cell, 0 when open.
+    std::vector<std::uint32_t> m_occlusion;
+    std::vector<const Entity*> m_bakedEntities;
+    glm::vec2 m_occlusionOrigin{0.0f};
+    float m_occlusionCellSize{1.0f};
+    int m_occlusionColumns{0};
+    int m_occlusionRows{0};
+
+    Stats m_stats;
+};
+
+} // namespace AI
+
+#endif // AI_PERCEPTION_SERVICE_HPP
@@ -0,0 +1,175 @@
+#include "UpdateScheduler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include <glm/geometric.hpp>
+
+namespace AI {
+
+namespace {
+bool finite(const glm::vec2& value) {
+    return std::isfinite(value.x) && std::isfinite(value.y);
+}
+
+void validateImportance(float importance) {
+    if (!std::isfinite(importance) || importance <= 0.0f) {
+        throw std::invalid_argument("AI agent importance must be finite and positive");
+    }
+}
+
+UpdateRate rateFor(float distance, float nearDistance, float farDistance) noexcept {
+    if (distance <= nearDistance) return UpdateRate::EveryTick;
+    if (distance <= farDistance) return UpdateRate::Every4th;
+    return UpdateRate::Every16th;
+}
+}
+
+UpdateScheduler::UpdateScheduler() : UpdateScheduler(Settings{}) {}
+
+UpdateScheduler::UpdateScheduler(const Settings& settings) {
+    setSettings(settings);
+}
+
+void UpdateScheduler::setSettings(const Settings& settings) {
+    if (!std::isfinite(settings.nearDistance) || !std::isfinite(settings.farDistance) ||
+        settings.nearDistance < 0.0f || settings.farDistance < settings.nearDistance) {
+        throw std::invalid_argument("AI update distances must be finite with 0 <= near <= far");
+    }
+    if (!std::isfinite(settings.hysteresis) || settings.hysteresis < 0.0f) {
+        throw std::invalid_argument("AI update hysteresis must be finite and non-negative");
+    }
+    m_settings = settings;
+}
+
+AgentHandle UpdateScheduler::add(std::uint64_t user, const glm::vec2& position, float importance) {
+    if (!finite(position)) {
+        throw std::invalid_argument("AI agent position must be finite");
+    }
+    validateImportance(importance);
+    std::uint32_t index = 0;
+    if (!m_freeAgents.empty()) {
+        index = m_freeAgents.back();
+        m_freeAgents.pop_back();
+    } else {
+        if (m_agents.size() >= std::numeric_limits<std::uint32_t>::max()) {
+            throw std::length_error("Too many AI agents");
+        }
+        index = static_cast<std::uint32_t>(m_agents.size());
+        m_agents.emplace_back();
+    }
+    Agent& agent = m_agents[index];
+    agent.live = true;
+    agent.fresh = true;
+    agent.user = user;
+    agent.position = position;
+    agent.importance = importance;
+    agent.pendingDt = 0.0f;
+    return AgentHandle{index, agent.generation};
+}
+
+void UpdateScheduler::remove(AgentHandle handle) {
+    Agent& agent = find(handle);
+    agent.live = false;
+    // Generation 0 marks invalid handles, so skip it on wrap-around.
+    if (++agent.generation == 0) agent.generation = 1;
+    m_freeAgents.push_back(handle.index);
+}
+
+bool UpdateScheduler::contains(AgentHandle handle) const noexcept {
+    return tryFind(handle) != nullptr;
+}
+
+void UpdateScheduler::setPosition(AgentHandle handle, const glm::vec2& position) {
+    if (!finite(position)) {
+        throw std::invalid_argument("AI agent position must be finite");
+    }
+    find(handle).position = position;
+}
+
+void UpdateScheduler::setImportance(AgentHandle handle, float importance) {
+    validateImportance(importance);
+    find(handle).importance = importance;
+}
+
+UpdateRate UpdateScheduler::rate(AgentHandle handle) const {
+    const Agent* agent = tryFind(handle);
+    if (!agent) {
+        throw std::out_of_range("Unknown AI agent handle");
+    }
+    return agent->rate;
+}
+
+void UpdateScheduler::resetStats() noexcept {
+    m_stats.ticks = 0;
+    for (BucketStats& bucket : m_stats.buckets) {
+        bucket = BucketStats{bucket.agents};
+    }
+}
+
+UpdateScheduler::Agent& UpdateScheduler::find(AgentHandle handle) {
+    if (!tryFind(handle)) {
+        throw std::out_of_range("Unknown AI agent handle");
+    }
+    return m_agents[handle.index];
+}
+
+const UpdateScheduler::Agent* UpdateScheduler::tryFind(AgentHandle handle) const noexcept {
+    if (!handle.valid() || handle.index >= m_agents.size()) return nullptr;
+    const Agent& agent = m_agents[handle.index];
+    return agent.live && agent.generation == handle.generation ? &agent : nullptr;
+}
+
+UpdateRate UpdateScheduler::chooseRate(const Agent& agent, std::span<const glm::vec2> focus) const noexcept {
+    float nearest2 = std::numeric_limits<float>::infinity();
+    for (const glm::vec2& point : focus) {
+        const glm::vec2 offset = point - agent.position;
+        nearest2 = std::min(nearest2, glm::dot(offset, offset));
+    }
+    const float distance = std::sqrt(nearest2) / agent.importance;
+    const UpdateRate rate = rateFor(distance, m_settings.nearDistance, m_settings.farDistance);
+    if (agent.fresh || rate <= agent.rate) {
+        return rate;
+    }
+    // Slower bucket: demote only as far as the widened boundaries allow.
+    const float grace = 1.0f + m_settings.hysteresis;
+    const UpdateRate widened = rateFor(distance, m_settings.nearDistance * grace,
+                                       m_settings.farDistance * grace);
+    return std::max(agent.rate, widened);
+}
+
+void UpdateScheduler::schedule(float dt, std::span<const glm::vec2> focus) {
+    if (!std::isfinite(dt) || dt < 0.0f) {
+        throw std::invalid_argument("AI update delta must be finite and non-negative");
+    }
+    if (!std::ranges::all_of(focus, [](const glm::vec2& point) { return finite(point); })) {
+        throw std::invalid_argument("AI focus points must be finite");
+    }
+    for (auto& due : m_due) {
+        due.clear();
+    }
+    std::array<std::size_t, kUpdateRateCount> counts{};
+    for (std::uint32_t index = 0; index < m_agents.size(); ++index) {
+        Agent& agent = m_agents[index];
+        if (!agent.live) continue;
+        agent.rate = chooseRate(agent, focus);
+        agent.pendingDt += dt;
+        const auto bucket = static_cast<std::size_t>(agent.rate);
+        ++counts[bucket];
+        const std::uint32_t period = updatePeriod(agent.rate);
+        if (agent.fresh || (m_tick + index) % period == 0) {
+            m_due[bucket].push_back(Update{AgentHandle{index, agent.generation}, agent.user,
+                                           agent.pendingDt, agent.rate});
+            agent.pendingDt = 0.0f;
+            agent.fresh = false;
+        }
+    }
+    for (std::size_t bucket = 0; bucket < kUpdateRateCount; ++bucket) {
+        m_stats.buckets[bucket].agents = counts[bucket];
+    }
+    ++m_tick;
+    ++m_stats.ticks;
+}
+
+} // namespace AI
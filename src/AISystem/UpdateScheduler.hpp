@@ -0,0 +1,161 @@
+#ifndef AI_UPDATE_SCHEDULER_HPP
+#define AI_UPDATE_SCHEDULER_HPP
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+#include <glm/vec2.hpp>
+
+namespace AI {
+
+// How often an agent thinks, in fixed ticks.
+enum class UpdateRate : std::uint8_t {
+    EveryTick,
+    Every4th,
+    Every16th
+};
+
+inline constexpr std::size_t kUpdateRateCount = 3;
+
+[[nodiscard]] constexpr std::uint32_t updatePeriod(UpdateRate rate) noexcept {
+    constexpr std::uint32_t periods[kUpdateRateCount]{1, 4, 16};
+    return periods[static_cast<std::size_t>(rate)];
+}
+
+struct AgentHandle {
+    std::uint32_t index{std::numeric_limits<std::uint32_t>::max()};
+    std::uint32_t generation{0};
+
+    [[nodiscard]] bool valid() const noexcept { return generation != 0; }
+    friend bool operator==(const AgentHandle&, const AgentHandle&) = default;
+};
+
+// Level-of-detail scheduling for AI updates. The scheduler does not own
+// entities: the game registers each agent with an id of its own, keeps its
+// position (and optionally importance) current, and calls tick() once per
+// fixed step with the points that matter (player, camera). Every agent is
+// put in a rate bucket by its distance to the nearest focus point divided by
+// its importance; only the agents due this tick are passed to the update
+// callback, with the time accumulated since their last update, so timers
+// such as AICombatBrain cooldowns advance by the same total either way.
+//
+// Slower buckets are staggered: an agent with period P is due on the ticks
+// where tick + index is a multiple of P, so about 1/P of the bucket runs on
+// any tick. Agents are demoted only once they are `hysteresis` beyond a
+// boundary, which stops agents on the boundary flapping between buckets.
+// Newly added agents update on their first tick. Do not add or remove
+// agents from inside the callback. A PerceptionService ticket submitted in
+// one update can be read in the next as long as the service retains at
+// least as many batches as the agent's period.
+class UpdateScheduler {
+public:
+    struct Settings {
+        // Effective distance up to which agents update every tick, and every
+        // 4th tick; beyond it they update every 16th.
+        float nearDistance{24.0f};
+        float farDistance{64.0f};
+        // Fraction of a boundary an agent must pass before it is demoted.
+        float hysteresis{0.1f};
+    };
+
+    struct Update {
+        AgentHandle handle;
+        std::uint64_t user{0};
+        // Seconds since this agent's last update.
+        float dt{0.0f};
+        UpdateRate rate{UpdateRate::EveryTick};
+    };
+
+    struct BucketStats {
+        // Agents assigned to the bucket on the last tick.
+        std::size_t agents{0};
+        std::size_t updatedLastTick{0};
+        double msLastTick{0.0};
+        std::uint64_t updates{0};
+        double totalMs{0.0};
+    };
+
+    struct Stats {
+        std::uint64_t ticks{0};
+        std::array<BucketStats, kUpdateRateCount> buckets{};
+    };
+
+    UpdateScheduler();
+    explicit UpdateScheduler(const Settings& settings);
+
+    // `importance` scales distance down: an agent of importance 2 is
+    // scheduled as if it were half as far away. It must be positive.
+    [[nodiscard]] AgentHandle add(std::uint64_t user, const glm::vec2& position,
+                                  float importance = 1.0f);
+    void remove(AgentHandle handle);
+    [[nodiscard]] bool contains(AgentHandle handle) const noexcept;
+    void setPosition(AgentHandle handle, const glm::vec2& position);
+    void setImportance(AgentHandle handle, float importance);
+    // Bucket the agent was assigned on the last tick.
+    [[nodiscard]] UpdateRate rate(AgentHandle handle) const;
+
+    // Advances one fixed step of `dt` seconds and calls update(const Update&)
+    // for every agent due, fastest bucket first. With no focus points every
+    // agent counts as far away.
+    template<typename UpdateFn>
+    void tick(float dt, std::span<const glm::vec2> focus, UpdateFn&& update);
+
+    void setSettings(const Settings& settings);
+    [[nodiscard]] const Settings& settings() const noexcept { return m_settings; }
+    [[nodiscard]] std::size_t size() const noexcept { return m_agents.size() - m_freeAgents.size(); }
+    [[nodiscard]] const Stats& stats() const noexcept { return m_stats; }
+    // Clears counters and timings; bucket sizes stay current.
+    void resetStats() noexcept;
+
+private:
+    struct Agent {
+        std::uint32_t generation{1};
+        bool live{false};
+        bool fresh{false};
+        UpdateRate rate{UpdateRate::EveryTick};
+        std::uint64_t user{0};
+        glm::vec2 position{0.0f};
+        float importance{1.0f};
+        float pendingDt{0.0f};
+    };
+
+    [[nodiscard]] Agent& find(AgentHandle handle);
+    [[nodiscard]] const Agent* tryFind(AgentHandle handle) const noexcept;
+    [[nodiscard]] UpdateRate chooseRate(const Agent& agent, std::span<const glm::vec2> focus) const noexcept;
+    // Assigns buckets and fills m_due for this tick.
+    void schedule(float dt, std::span<const glm::vec2> focus);
+
+    Settings m_settings;
+    Stats m_stats;
+    std::vector<Agent> m_agents;
+    std::vector<std::uint32_t> m_freeAgents;
+    std::array<std::vector<Update>, kUpdateRateCount> m_due;
+    std::uint64_t m_tick{0};
+};
+
+template<typename UpdateFn>
+void UpdateScheduler::tick(float dt, std::span<const glm::vec2> focus, UpdateFn&& update) {
+    using Clock = std::chrono::steady_clock;
+    schedule(dt, focus);
+    for (std::size_t bucket = 0; bucket < kUpdateRateCount; ++bucket) {
+        const auto start = Clock::now();
+        for (const Update& due : m_due[bucket]) {
+            update(due);
+        }
+        const double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        BucketStats& stats = m_stats.buckets[bucket];
+        stats.updatedLastTick = m_due[bucket].size();
+        stats.msLastTick = ms;
+        stats.updates += m_due[bucket].size();
+        stats.totalMs += ms;
+    }
+}
+
+} // namespace AI
+
+#endif // AI_UPDATE_SCHEDULER_HPP
@@ -10,6 +10,7 @@
 #include "Physics/RigidBody.hpp"
 #include "RenderingSystem/DebugDraw2D.hpp"
 #include "RenderingSystem/Renderer.hpp"
+#include <algorithm>
 #include <cmath>
 
 bool DebugOverlay::s_enabled = false;
@@ -67,6 +68,42 @@ void DebugOverlay::render(const Scene& scene,
         {overlayTopLeft.x + 18.0f, overlayTopLeft.y - 6.0f},
         lineThickness, overlayColor, zIndex);
 
+    // Particle budget meter: live particles stacked by priority, a tick at
+    // the frame's peak, outlined red when spawns were refused this frame.
+    const ParticleBudget::Usage usage = scene.particleBudget()->usage();
+    if (usage.limit > 0) {
+        const float meterLeft = overlayTopLeft.x + 12.0f;
+        const float meterWidth = overlayWidth - 24.0f;
+        const float meterY = overlayTopLeft.y - 42.0f;
+        const float meterThickness = 8.0f;
+        const auto meterX = [&](std::size_t count) {
+            const float fraction = std::min(
+                static_cast<float>(count) / static_cast<float>(usage.limit), 1.0f);
+            return meterLeft + meterWidth * fraction;
+        };
+        const glm::vec4 priorityColors[] = {{0.35f, 0.55f, 0.95f, 0.9f},
+                                            {0.3f, 0.9f, 0.5f, 0.9f},
+                                            {0.95f, 0.85f, 0.3f, 0.9f}};
+        std::size_t stacked = 0;
+        for (std::size_t priority = 0; priority < usage.liveByPriority.size(); ++priority) {
+            const std::size_t count = usage.liveByPriority[priority];
+            if (count == 0) continue;
+            Rendering::DebugDraw2D::line(renderer, {meterX(stacked), meterY},
+                                         {meterX(stacked + count), meterY},
+                                         meterThickness, priorityColors[priority], zIndex);
+            stacked += count;
+        }
+        const float peakX = meterX(usage.peak);
+        Rendering::DebugDraw2D::line(renderer, {peakX, meterY - meterThickness},
+                                     {peakX, meterY + meterThickness},
+                                     lineThickness, overlayColor, zIndex);
+        const glm::vec4 meterColor = usage.denied > 0 ? frustumColor : overlayColor;
+        Rendering::DebugDraw2D::rectangle(renderer,
+            {meterLeft, meterY + meterThickness * 0.5f},
+            {meterLeft + meterWidth, meterY - meterThickness * 0.5f},
+            lineThickness, meterColor, zIndex);
+    }
+
     const glm::vec4 velocityColor(0.3f, 0.9f, 0.4f, 0.9f);
     for (const auto &entityPtr : scene.getEntities()) {
         if (!entityPtr) continue;
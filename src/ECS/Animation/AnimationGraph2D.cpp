@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <array>
 #include <cmath>
+#include <limits>
 #include <stdexcept>
 #include <utility>
 
@@ -21,7 +22,7 @@ AnimationGraph2D::AnimationGraph2D(
     std::vector<AnimationTransition2D> transitions,
     std::string initialState)
     : m_states(std::move(states)) {
-    if (m_states.empty()) {
+    if (m_states.empty() || m_states.size() > std::numeric_limits<std::uint32_t>::max()) {
         throw std::invalid_argument("AnimationGraph2D requires at least one state");
     }
 
@@ -41,9 +42,28 @@ AnimationGraph2D::AnimationGraph2D(
                 throw std::invalid_argument(
                     "Animation state '" + animationState.name + "' has an invalid frame");
             }
+            AnimationEventId2D event = kNoAnimationEvent2D;
+            if (!frame.event.empty()) {
+                const auto known = std::ranges::find(m_eventNames, frame.event);
+                event = static_cast<AnimationEventId2D>(known - m_eventNames.begin());
+                if (known == m_eventNames.end()) {
+                    m_eventNames.push_back(frame.event);
+                }
+            }
+            m_frameEvents.push_back(event);
         }
     }
 
+    if (m_frameEvents.size() > std::numeric_limits<std::uint32_t>::max()) {
+        throw std::invalid_argument("Animation graph has too many frames");
+    }
+    m_frameOffsets.reserve(m_states.size());
+    std::uint32_t frameOffset = 0;
+    for (const AnimationState2D& animationState : m_states) {
+        m_frameOffsets.push_back(frameOffset);
+        frameOffset += static_cast<std::uint32_t>(animationState.clip.frames.size());
+    }
+
     const auto initial = findState(initialState);
     if (!initial) {
         throw std::invalid_argument("Animation initial state does not exist: " + initialState);
@@ -65,13 +85,47 @@ AnimationGraph2D::AnimationGraph2D(
             transition.minimumStateSeconds < 0.0f) {
             throw std::invalid_argument("Animation transition contains invalid timing or threshold data");
         }
+        AnimationParameterId2D parameter = 0;
+        if (transition.condition != AnimationCondition2D::Always) {
+            const auto known = std::ranges::find(m_parameterNames, transition.parameter);
+            parameter = static_cast<AnimationParameterId2D>(known - m_parameterNames.begin());
+            if (known == m_parameterNames.end()) {
+                m_parameterNames.push_back(transition.parameter);
+            }
+        }
         m_transitions.push_back({
             transition.fromState == "*" ? 0u : *findState(transition.fromState),
             *findState(transition.toState), transition.fromState == "*",
-            transition.condition, std::move(transition.parameter), transition.threshold,
+            transition.condition, parameter, transition.threshold,
             transition.expectedBool, transition.minimumStateSeconds
         });
     }
+
+    const auto appendRule = [this](const CompiledAnimationTransition2D& transition) {
+        m_rules.push_back({static_cast<std::uint32_t>(transition.toState),
+                           transition.parameter, transition.threshold,
+                           transition.minimumStateSeconds, transition.condition,
+                           transition.expectedBool});
+    };
+    m_ruleOffsets.reserve(m_states.size() + 1);
+    m_ruleOffsets.push_back(0);
+    for (std::size_t stateIndex = 0; stateIndex < m_states.size(); ++stateIndex) {
+        for (const CompiledAnimationTransition2D& transition : m_transitions) {
+            if (!transition.anySource && transition.fromState == stateIndex) {
+                appendRule(transition);
+            }
+        }
+        // A "*" transition into the current state never fires, so it is left out.
+        for (const CompiledAnimationTransition2D& transition : m_transitions) {
+            if (transition.anySource && transition.toState != stateIndex) {
+                appendRule(transition);
+            }
+        }
+        if (m_rules.size() > std::numeric_limits<std::uint32_t>::max()) {
+            throw std::invalid_argument("Animation graph has too many transitions");
+        }
+        m_ruleOffsets.push_back(static_cast<std::uint32_t>(m_rules.size()));
+    }
 }
 
 const AnimationState2D& AnimationGraph2D::state(std::size_t index) const {
@@ -87,4 +141,34 @@ std::optional<std::size_t> AnimationGraph2D::findState(std::string_view name) co
         ? std::nullopt : std::optional<std::size_t>{found->second};
 }
 
+std::optional<AnimationEventId2D> AnimationGraph2D::findEvent(std::string_view name) const {
+    const auto found = std::ranges::find(m_eventNames, name);
+    return found == m_eventNames.end()
+        ? std::nullopt
+        : std::optional<AnimationEventId2D>{
+              static_cast<AnimationEventId2D>(found - m_eventNames.begin())};
+}
+
+const std::string& AnimationGraph2D::eventName(AnimationEventId2D id) const {
+    if (id >= m_eventNames.size()) {
+        throw std::out_of_range("Animation event id is out of range");
+    }
+    return m_eventNames[id];
+}
+
+std::optional<AnimationParameterId2D> AnimationGraph2D::findParameter(std::string_view name) const {
+    const auto found = std::ranges::find(m_parameterNames, name);
+    return found == m_parameterNames.end()
+        ? std::nullopt
+        : std::optional<AnimationParameterId2D>{
+              static_cast<AnimationParameterId2D>(found - m_parameterNames.begin())};
+}
+
+const std::string& AnimationGraph2D::parameterName(AnimationParameterId2D id) const {
+    if (id >= m_parameterNames.size()) {
+        throw std::out_of_range("Animation parameter id is out of range");
+    }
+    return m_parameterNames[id];
+}
+
 } // namespace ECS
@@ -3,8 +3,10 @@
 #include <glm/vec4.hpp>
 
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <optional>
+#include <span>
 #include <string>
 #include <string_view>
 #include <unordered_map>
@@ -43,7 +45,7 @@ struct AnimationState2D {
     AnimationClip2D clip;
 };
 
-enum class AnimationCondition2D {
+enum class AnimationCondition2D : std::uint8_t {
     Always,
     BoolEquals,
     FloatGreater,
@@ -52,6 +54,17 @@ enum class AnimationCondition2D {
     FloatLessEqual
 };
 
+// Each graph numbers the parameters its transitions read densely from zero,
+// in declaration order, when it is built. Ids are only meaningful for the
+// graph that issued them; kNoAnimationParameter2D never names a slot.
+using AnimationParameterId2D = std::uint32_t;
+inline constexpr AnimationParameterId2D kNoAnimationParameter2D = 0xFFFFFFFFu;
+
+// Frame event names are interned per graph; kNoAnimationEvent2D marks
+// frames without one.
+using AnimationEventId2D = std::uint32_t;
+inline constexpr AnimationEventId2D kNoAnimationEvent2D = 0xFFFFFFFFu;
+
 struct AnimationTransition2D {
     // "*" matches every source state.
     std::string fromState;
@@ -68,12 +81,23 @@ struct CompiledAnimationTransition2D {
     std::size_t toState{0};
     bool anySource{false};
     AnimationCondition2D condition{AnimationCondition2D::Always};
-    std::string parameter;
+    AnimationParameterId2D parameter{0};
     float threshold{0.0f};
     bool expectedBool{true};
     float minimumStateSeconds{0.0f};
 };
 
+// Compact form of a transition as evaluated each step; the source state is
+// implied by the table it sits in.
+struct AnimationTransitionRule2D {
+    std::uint32_t toState{0};
+    AnimationParameterId2D parameter{0};
+    float threshold{0.0f};
+    float minimumStateSeconds{0.0f};
+    AnimationCondition2D condition{AnimationCondition2D::Always};
+    bool expectedBool{true};
+};
+
 // Immutable, validated animation resource shared by any number of entities.
 class AnimationGraph2D {
 public:
@@ -83,15 +107,44 @@ public:
 
     [[nodiscard]] const AnimationState2D& state(std::size_t index) const;
     [[nodiscard]] std::optional<std::size_t> findState(std::string_view name) const;
+    [[nodiscard]] std::size_t stateCount() const noexcept { return m_states.size(); }
+    // Slot of a parameter some transition reads; nullopt when the graph never
+    // reads `name`.
+    [[nodiscard]] std::optional<AnimationParameterId2D> findParameter(std::string_view name) const;
+    [[nodiscard]] const std::string& parameterName(AnimationParameterId2D id) const;
+    [[nodiscard]] std::size_t parameterCount() const noexcept { return m_parameterNames.size(); }
+    [[nodiscard]] std::optional<AnimationEventId2D> findEvent(std::string_view name) const;
+    [[nodiscard]] const std::string& eventName(AnimationEventId2D id) const;
+    // Event of frame `frameIndex` of state `stateIndex`; both must be in range.
+    [[nodiscard]] AnimationEventId2D frameEvent(std::size_t stateIndex,
+                                                std::size_t frameIndex) const noexcept {
+        return m_frameEvents[m_frameOffsets[stateIndex] + frameIndex];
+    }
     [[nodiscard]] std::size_t initialStateIndex() const noexcept { return m_initialStateIndex; }
     [[nodiscard]] const std::vector<CompiledAnimationTransition2D>& transitions() const noexcept {
         return m_transitions;
     }
+    // Transitions that can leave `stateIndex`, in evaluation order: the
+    // state's own transitions, then "*" transitions that lead elsewhere, each
+    // group in declaration order. `stateIndex` must be below stateCount().
+    [[nodiscard]] std::span<const AnimationTransitionRule2D> transitionsFrom(
+        std::size_t stateIndex) const noexcept {
+        return {m_rules.data() + m_ruleOffsets[stateIndex],
+                m_rules.data() + m_ruleOffsets[stateIndex + 1]};
+    }
 
 private:
     std::vector<AnimationState2D> m_states;
     std::vector<CompiledAnimationTransition2D> m_transitions;
+    // Per-state rule ranges: state i owns [m_ruleOffsets[i], m_ruleOffsets[i + 1]).
+    std::vector<AnimationTransitionRule2D> m_rules;
+    std::vector<std::uint32_t> m_ruleOffsets;
     std::unordered_map<std::string, std::size_t> m_stateIndices;
+    std::vector<std::string> m_parameterNames;
+    std::vector<std::string> m_eventNames;
+    // Per-frame event ids, state by state from m_frameOffsets.
+    std::vector<AnimationEventId2D> m_frameEvents;
+    std::vector<std::uint32_t> m_frameOffsets;
     std::size_t m_initialStateIndex{0};
 };
 
@@ -1,15 +1,108 @@
 #include "ECS/Components/Animation2D.hpp"
 
+#include <algorithm>
+#include <stdexcept>
+
 namespace ECS {
 
+void Animator2D::requestState(std::string_view name) {
+    const auto found = graph ? graph->findState(name) : std::nullopt;
+    if (!found) {
+        throw std::invalid_argument(
+            "Animator2D requested unknown state: " + std::string{name});
+    }
+    requestedStateIndex = *found;
+}
+
+void AnimationParameters2D::bind(std::shared_ptr<const AnimationGraph2D> graph) {
+    if (graph == m_graph) {
+        return;
+    }
+    // Values the old graph read go back to the named store, then every named
+    // value the new graph reads takes its slot.
+    if (m_graph) {
+        for (std::size_t slot = 0; slot < m_flags.size(); ++slot) {
+            if (m_flags[slot] != 0) {
+                NamedValue& value = unbound(m_graph->parameterName(
+                    static_cast<AnimationParameterId2D>(slot)));
+                value.flags = m_flags[slot];
+                value.value = m_floats[slot];
+            }
+        }
+    }
+    const std::size_t count = graph ? graph->parameterCount() : 0;
+    m_flags.assign(count, 0);
+    m_floats.assign(count, 0.0f);
+    m_graph = std::move(graph);
+    std::erase_if(m_unbound, [this](const NamedValue& value) {
+        const AnimationParameterId2D id = find(value.name);
+        if (id == kNoAnimationParameter2D) {
+            return false;
+        }
+        m_flags[id] = value.flags;
+        m_floats[id] = value.value;
+        return true;
+    });
+}
+
+void AnimationParameters2D::setBool(std::string_view name, bool value) {
+    const AnimationParameterId2D id = find(name);
+    if (id != kNoAnimationParameter2D) {
+        setBool(id, value);
+        return;
+    }
+    NamedValue& named = unbound(name);
+    named.flags = static_cast<std::uint8_t>((named.flags & kFloatSet) | kBoolSet |
+                                            (value ? kBoolValue : 0));
+}
+
+void AnimationParameters2D::setFloat(std::string_view name, float value) {
+    const AnimationParameterId2D id = find(name);
+    if (id != kNoAnimationParameter2D) {
+        setFloat(id, value);
+        return;
+    }
+    NamedValue& named = unbound(name);
+    named.flags |= kFloatSet;
+    named.value = value;
+}
+
 bool AnimationParameters2D::getBool(std::string_view name, bool fallback) const {
-    const auto found = boolValues.find(std::string{name});
-    return found == boolValues.end() ? fallback : found->second;
+    const AnimationParameterId2D id = find(name);
+    if (id != kNoAnimationParameter2D) {
+        return getBool(id, fallback);
+    }
+    const NamedValue* named = findUnbound(name);
+    return named && (named->flags & kBoolSet) != 0 ? (named->flags & kBoolValue) != 0
+                                                   : fallback;
 }
 
 float AnimationParameters2D::getFloat(std::string_view name, float fallback) const {
-    const auto found = floatValues.find(std::string{name});
-    return found == floatValues.end() ? fallback : found->second;
+    const AnimationParameterId2D id = find(name);
+    if (id != kNoAnimationParameter2D) {
+        return getFloat(id, fallback);
+    }
+    const NamedValue* named = findUnbound(name);
+    return named && (named->flags & kFloatSet) != 0 ? named->value : fallback;
+}
+
+AnimationParameterId2D AnimationParameters2D::find(std::string_view name) const {
+    const auto id = m_graph ? m_graph->findParameter(name) : std::nullopt;
+    return id ? *id : kNoAnimationParameter2D;
+}
+
+const AnimationParameters2D::NamedValue* AnimationParameters2D::findUnbound(
+    std::string_view name) const noexcept {
+    const auto found = std::ranges::find(m_unbound, name, &NamedValue::name);
+    return found == m_unbound.end() ? nullptr : &*found;
+}
+
+AnimationParameters2D::NamedValue& AnimationParameters2D::unbound(std::string_view name) {
+    const auto found = std::ranges::find(m_unbound, name, &NamedValue::name);
+    if (found != m_unbound.end()) {
+        return *found;
+    }
+    return m_unbound.emplace_back(NamedValue{std::string{name}});
 }
 
 } // namespace ECS
@@ -2,19 +2,23 @@
 
 #include "ECS/Animation/AnimationGraph2D.hpp"
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <limits>
 #include <memory>
 #include <string>
 #include <string_view>
-#include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace ECS {
 
 struct Animator2D {
+    static constexpr std::size_t kNoState = std::numeric_limits<std::size_t>::max();
+
     std::shared_ptr<const AnimationGraph2D> graph;
-    std::size_t stateIndex{std::numeric_limits<std::size_t>::max()};
+    std::size_t stateIndex{kNoState};
     std::size_t frameIndex{0};
     float frameElapsedSeconds{0.0f};
     float stateElapsedSeconds{0.0f};
@@ -22,20 +26,86 @@ struct Animator2D {
     int frameDirection{1};
     bool playing{true};
     bool completed{false};
-    std::string requestedState;
+    // Entered on the next update, then reset to kNoState.
+    std::size_t requestedStateIndex{kNoState};
+
+    // Resolves `name` through the graph once; throws for an unknown state.
+    void requestState(std::string_view name);
 };
 
-struct AnimationParameters2D {
-    std::unordered_map<std::string, bool> boolValues;
-    std::unordered_map<std::string, float> floatValues;
+// Values the bound graph reads live in flat arrays sized to its parameters
+// and indexed by its AnimationParameterId2D slots. Values set by name before
+// a graph is bound, or for names the graph does not read, are kept by name
+// beside them and move into slots once a graph that reads them is bound, so
+// no write is lost. Gameplay code that sets parameters every step should
+// resolve slots once per graph (AnimationGraph2D::findParameter) and use the
+// id overloads, which ignore ids outside the bound graph; the name overloads
+// search the graph's parameter list on each call. AnimationSystem2D rebinds
+// the parameters to the animator's graph when the two differ, carrying
+// values over by name.
+class AnimationParameters2D {
+public:
+    AnimationParameters2D() = default;
+    explicit AnimationParameters2D(std::shared_ptr<const AnimationGraph2D> graph) {
+        bind(std::move(graph));
+    }
+
+    void bind(std::shared_ptr<const AnimationGraph2D> graph);
+    [[nodiscard]] const std::shared_ptr<const AnimationGraph2D>& graph() const noexcept {
+        return m_graph;
+    }
+
+    void setBool(AnimationParameterId2D id, bool value) noexcept {
+        if (id < m_flags.size()) {
+            m_flags[id] = static_cast<std::uint8_t>((m_flags[id] & kFloatSet) | kBoolSet |
+                                                    (value ? kBoolValue : 0));
+        }
+    }
+    void setFloat(AnimationParameterId2D id, float value) noexcept {
+        if (id < m_flags.size()) {
+            m_flags[id] |= kFloatSet;
+            m_floats[id] = value;
+        }
+    }
+    void setBool(std::string_view name, bool value);
+    void setFloat(std::string_view name, float value);
 
-    void setBool(std::string name, bool value) { boolValues[std::move(name)] = value; }
-    void setFloat(std::string name, float value) { floatValues[std::move(name)] = value; }
+    [[nodiscard]] bool hasBool(AnimationParameterId2D id) const noexcept {
+        return id < m_flags.size() && (m_flags[id] & kBoolSet) != 0;
+    }
+    [[nodiscard]] bool hasFloat(AnimationParameterId2D id) const noexcept {
+        return id < m_flags.size() && (m_flags[id] & kFloatSet) != 0;
+    }
+    [[nodiscard]] bool getBool(AnimationParameterId2D id, bool fallback = false) const noexcept {
+        return hasBool(id) ? (m_flags[id] & kBoolValue) != 0 : fallback;
+    }
+    [[nodiscard]] float getFloat(AnimationParameterId2D id, float fallback = 0.0f) const noexcept {
+        return hasFloat(id) ? m_floats[id] : fallback;
+    }
     [[nodiscard]] bool getBool(std::string_view name, bool fallback = false) const;
     [[nodiscard]] float getFloat(std::string_view name, float fallback = 0.0f) const;
+
+private:
+    enum Flag : std::uint8_t { kBoolSet = 1, kBoolValue = 2, kFloatSet = 4 };
+
+    // A value the bound graph has no slot for.
+    struct NamedValue {
+        std::string name;
+        std::uint8_t flags{0};
+        float value{0.0f};
+    };
+
+    [[nodiscard]] AnimationParameterId2D find(std::string_view name) const;
+    [[nodiscard]] const NamedValue* findUnbound(std::string_view name) const noexcept;
+    NamedValue& unbound(std::string_view name);
+
+    std::shared_ptr<const AnimationGraph2D> m_graph;
+    std::vector<std::uint8_t> m_flags;
+    std::vector<float> m_floats;
+    std::vector<NamedValue> m_unbound;
 };
 
-enum class AnimationEventKind2D {
+enum class AnimationEventKind2D : std::uint8_t {
     StateEntered,
     StateExited,
     Frame,
@@ -43,15 +113,67 @@ enum class AnimationEventKind2D {
     Completed
 };
 
+// Names resolve through the emitting animator's graph: `state` is a state
+// index, and Frame events carry the frame's graph event id (other kinds
+// carry kNoAnimationEvent2D).
 struct AnimationEvent2D {
     AnimationEventKind2D kind{AnimationEventKind2D::Frame};
-    std::string name;
-    std::string state;
-    std::size_t frameIndex{0};
+    AnimationEventId2D event{kNoAnimationEvent2D};
+    std::uint32_t state{0};
+    std::uint32_t frameIndex{0};
 };
 
-struct AnimationEventQueue2D {
-    std::vector<AnimationEvent2D> events;
+// Events raised since AnimationSystem2D::beginFrame, oldest first. Storage
+// for `capacity` events is reserved up front and kept across clear(), so
+// raising events allocates only when one render frame brings more events
+// than the queue has held before; it then grows rather than dropping any.
+// Give entities that can raise long bursts (many fixed steps per frame,
+// chains of transitions) a larger initial capacity.
+class AnimationEventQueue2D {
+public:
+    static constexpr std::size_t kDefaultCapacity = 16;
+
+    AnimationEventQueue2D() : AnimationEventQueue2D(kDefaultCapacity) {}
+    explicit AnimationEventQueue2D(std::size_t capacity) { m_events.reserve(capacity); }
+
+    void push(const AnimationEvent2D& event) { m_events.push_back(event); }
+    void clear() noexcept { m_events.clear(); }
+
+    [[nodiscard]] std::size_t size() const noexcept { return m_events.size(); }
+    [[nodiscard]] bool empty() const noexcept { return m_events.empty(); }
+    [[nodiscard]] std::size_t capacity() const noexcept { return m_events.capacity(); }
+    [[nodiscard]] const AnimationEvent2D& operator[](std::size_t index) const noexcept {
+        return m_events[index];
+    }
+
+    template<typename Function>
+    void forEach(Function&& function) const {
+        for (const AnimationEvent2D& event : m_events) {
+            function(event);
+        }
+    }
+    template<typename Function>
+    void forEach(AnimationEventKind2D kind, Function&& function) const {
+        for (const AnimationEvent2D& event : m_events) {
+            if (event.kind == kind) {
+                function(event);
+            }
+        }
+    }
+    [[nodiscard]] bool hasFrameEvent(AnimationEventId2D event) const noexcept {
+        return std::ranges::any_of(m_events, [event](const AnimationEvent2D& e) {
+            return e.kind == AnimationEventKind2D::Frame && e.event == event;
+        });
+    }
+    [[nodiscard]] bool hasStateEvent(AnimationEventKind2D kind,
+                                     std::size_t stateIndex) const noexcept {
+        return std::ranges::any_of(m_events, [kind, stateIndex](const AnimationEvent2D& e) {
+            return e.kind == kind && e.state == stateIndex;
+        });
+    }
+
+private:
+    std::vector<AnimationEvent2D> m_events;
 };
 
 } // namespace ECS
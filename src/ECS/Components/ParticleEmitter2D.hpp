@@ -17,6 +17,16 @@ struct ParticleEmitter2D {
     bool paused{false};
     bool targetFollowsTransform{true};
     bool autoDestroyWhenFinished{false};
+    // When ParticleSystem2D has a view, emitters whose simulation bounds miss
+    // it stop simulating and fast-forward on re-entering view.
+    bool cullWhenOffscreen{true};
+    // Skipped steps replayed per update once back in view. Each costs a
+    // normal step, and a backlog holds up to one lifetime of steps, so the
+    // limit bounds the catch-up spike; the emitter shows its past state
+    // until the backlog drains. Values below 2 are treated as 2.
+    std::size_t fastForwardStepsPerUpdate{8};
+    // Share of the ParticleBudget handed to ParticleSystem2D::update.
+    ParticlePriority priority{ParticlePriority::Normal};
 
     // Deferred until the fixed-step system has synchronized Transform2D.
     void requestBurst(unsigned int count) noexcept {
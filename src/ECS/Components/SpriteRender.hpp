@@ -39,4 +39,11 @@ struct SpriteRender {
     std::shared_ptr<GameObjects::Texture> normalTextureOverride;
 };
 
+// Marks a SpriteRender entity as level decoration baked into the renderer's
+// cached static batches instead of being extracted every frame. Systems that
+// move, hide, or re-skin a tagged entity set `dirty` so it is rebaked.
+struct StaticSprite2D {
+    bool dirty{true};
+};
+
 } // namespace ECS
@@ -73,6 +73,12 @@ public:
     }
 
     [[nodiscard]] std::size_t size() const noexcept { return m_aliveCount - m_pendingDestroy.size(); }
+    // Entities holding `Component`, including any pending destruction.
+    template<typename Component>
+    [[nodiscard]] std::size_t count() const noexcept {
+        const Storage<Component>* storage = findStorage<Component>();
+        return storage ? storage->size() : 0;
+    }
     [[nodiscard]] bool empty() const noexcept { return size() == 0; }
 
     void clear() {
@@ -8,37 +8,38 @@
 
 #include <algorithm>
 #include <cmath>
+#include <limits>
 #include <stdexcept>
+#include <string_view>
 
 namespace ECS {
 namespace {
-bool transitionPasses(const CompiledAnimationTransition2D& transition,
+bool transitionPasses(const AnimationTransitionRule2D& transition,
                       const AnimationParameters2D& parameters) {
     switch (transition.condition) {
         case AnimationCondition2D::Always:
             return true;
-        case AnimationCondition2D::BoolEquals: {
-            const auto found = parameters.boolValues.find(transition.parameter);
-            return found != parameters.boolValues.end() &&
-                   found->second == transition.expectedBool;
-        }
+        case AnimationCondition2D::BoolEquals:
+            return parameters.hasBool(transition.parameter) &&
+                   parameters.getBool(transition.parameter) == transition.expectedBool;
         case AnimationCondition2D::FloatGreater:
         case AnimationCondition2D::FloatLess:
         case AnimationCondition2D::FloatGreaterEqual:
         case AnimationCondition2D::FloatLessEqual: {
-            const auto found = parameters.floatValues.find(transition.parameter);
-            if (found == parameters.floatValues.end() || !std::isfinite(found->second)) {
+            const float value = parameters.getFloat(
+                transition.parameter, std::numeric_limits<float>::quiet_NaN());
+            if (!std::isfinite(value)) {
                 return false;
             }
             switch (transition.condition) {
                 case AnimationCondition2D::FloatGreater:
-                    return found->second > transition.threshold;
+                    return value > transition.threshold;
                 case AnimationCondition2D::FloatLess:
-                    return found->second < transition.threshold;
+                    return value < transition.threshold;
                 case AnimationCondition2D::FloatGreaterEqual:
-                    return found->second >= transition.threshold;
+                    return value >= transition.threshold;
                 case AnimationCondition2D::FloatLessEqual:
-                    return found->second <= transition.threshold;
+                    return value <= transition.threshold;
                 default:
                     return false;
             }
@@ -48,8 +49,10 @@ bool transitionPasses(const CompiledAnimationTransition2D& transition,
 }
 
 void pushEvent(AnimationEventQueue2D& queue, AnimationEventKind2D kind,
-               std::string name, const std::string& state, std::size_t frameIndex) {
-    queue.events.push_back({kind, std::move(name), state, frameIndex});
+               const Animator2D& animator,
+               AnimationEventId2D event = kNoAnimationEvent2D) {
+    queue.push({kind, event, static_cast<std::uint32_t>(animator.stateIndex),
+                static_cast<std::uint32_t>(animator.frameIndex)});
 }
 
 void applyFrame(const AnimationState2D& state, const Animator2D& animator,
@@ -62,12 +65,11 @@ void applyFrame(const AnimationState2D& state, const Animator2D& animator,
     renderable.normalTextureOverride = frame.normalTexture;
 }
 
-void emitFrameEvent(const AnimationState2D& state, const Animator2D& animator,
-                    AnimationEventQueue2D& events) {
-    const AnimationFrame2D& frame = state.clip.frames[animator.frameIndex];
-    if (!frame.event.empty()) {
-        pushEvent(events, AnimationEventKind2D::Frame, frame.event,
-                  state.name, animator.frameIndex);
+void emitFrameEvent(const Animator2D& animator, AnimationEventQueue2D& events) {
+    const AnimationEventId2D event =
+        animator.graph->frameEvent(animator.stateIndex, animator.frameIndex);
+    if (event != kNoAnimationEvent2D) {
+        pushEvent(events, AnimationEventKind2D::Frame, animator, event);
     }
 }
 
@@ -75,9 +77,7 @@ void enterState(Animator2D& animator, SpriteRender& renderable,
                 AnimationEventQueue2D& events, std::size_t targetIndex,
                 bool emitExit) {
     if (emitExit) {
-        const AnimationState2D& previous = animator.graph->state(animator.stateIndex);
-        pushEvent(events, AnimationEventKind2D::StateExited, previous.name,
-                  previous.name, animator.frameIndex);
+        pushEvent(events, AnimationEventKind2D::StateExited, animator);
     }
 
     animator.stateIndex = targetIndex;
@@ -90,10 +90,9 @@ void enterState(Animator2D& animator, SpriteRender& renderable,
     animator.frameDirection = reverse ? -1 : 1;
     animator.playing = true;
     animator.completed = false;
-    pushEvent(events, AnimationEventKind2D::StateEntered, current.name,
-              current.name, animator.frameIndex);
+    pushEvent(events, AnimationEventKind2D::StateEntered, animator);
     applyFrame(current, animator, renderable);
-    emitFrameEvent(current, animator, events);
+    emitFrameEvent(animator, events);
 }
 
 bool advanceFrame(Animator2D& animator, SpriteRender& renderable,
@@ -106,8 +105,7 @@ bool advanceFrame(Animator2D& animator, SpriteRender& renderable,
             ++animator.frameIndex;
             if (animator.frameIndex >= frameCount) {
                 animator.frameIndex = 0;
-                pushEvent(events, AnimationEventKind2D::ClipLooped, state.name,
-                          state.name, animator.frameIndex);
+                pushEvent(events, AnimationEventKind2D::ClipLooped, animator);
             }
             changed = true;
             break;
@@ -118,15 +116,13 @@ bool advanceFrame(Animator2D& animator, SpriteRender& renderable,
             } else {
                 animator.playing = false;
                 animator.completed = true;
-                pushEvent(events, AnimationEventKind2D::Completed, state.name,
-                          state.name, animator.frameIndex);
+                pushEvent(events, AnimationEventKind2D::Completed, animator);
             }
             break;
         case AnimationPlayback2D::LoopReverse:
             if (animator.frameIndex == 0) {
                 animator.frameIndex = frameCount - 1;
-                pushEvent(events, AnimationEventKind2D::ClipLooped, state.name,
-                          state.name, animator.frameIndex);
+                pushEvent(events, AnimationEventKind2D::ClipLooped, animator);
             } else {
                 --animator.frameIndex;
             }
@@ -139,14 +135,12 @@ bool advanceFrame(Animator2D& animator, SpriteRender& renderable,
             } else {
                 animator.playing = false;
                 animator.completed = true;
-                pushEvent(events, AnimationEventKind2D::Completed, state.name,
-                          state.name, animator.frameIndex);
+                pushEvent(events, AnimationEventKind2D::Completed, animator);
             }
             break;
         case AnimationPlayback2D::PingPong:
             if (frameCount == 1) {
-                pushEvent(events, AnimationEventKind2D::ClipLooped, state.name,
-                          state.name, 0);
+                pushEvent(events, AnimationEventKind2D::ClipLooped, animator);
                 break;
             }
             if (animator.frameDirection > 0) {
@@ -159,8 +153,7 @@ bool advanceFrame(Animator2D& animator, SpriteRender& renderable,
             } else if (animator.frameIndex == 0) {
                 animator.frameDirection = 1;
                 animator.frameIndex = 1;
-                pushEvent(events, AnimationEventKind2D::ClipLooped, state.name,
-                          state.name, animator.frameIndex);
+                pushEvent(events, AnimationEventKind2D::ClipLooped, animator);
             } else {
                 --animator.frameIndex;
             }
@@ -170,33 +163,61 @@ bool advanceFrame(Animator2D& animator, SpriteRender& renderable,
 
     if (changed) {
         applyFrame(state, animator, renderable);
-        emitFrameEvent(state, animator, events);
+        emitFrameEvent(animator, events);
     }
     return animator.playing;
 }
 }
 
 void CharacterAnimationParameterSystem2D::update(Registry& registry) {
+    // Slots are per graph; entities sharing a graph usually sit together, so
+    // they are resolved again only when the graph changes between entities.
+    struct Slots {
+        const AnimationGraph2D* graph{nullptr};
+        AnimationParameterId2D speed{kNoAnimationParameter2D};
+        AnimationParameterId2D verticalVelocity{kNoAnimationParameter2D};
+        AnimationParameterId2D moving{kNoAnimationParameter2D};
+        AnimationParameterId2D grounded{kNoAnimationParameter2D};
+        AnimationParameterId2D climbing{kNoAnimationParameter2D};
+        AnimationParameterId2D rising{kNoAnimationParameter2D};
+        AnimationParameterId2D falling{kNoAnimationParameter2D};
+    };
+    Slots ids;
+    const auto resolve = [&ids](const AnimationGraph2D* graph) {
+        const auto slot = [graph](std::string_view name) {
+            return graph ? graph->findParameter(name).value_or(kNoAnimationParameter2D)
+                         : kNoAnimationParameter2D;
+        };
+        ids = {graph, slot("speed"), slot("verticalVelocity"), slot("moving"),
+               slot("grounded"), slot("climbing"), slot("rising"), slot("falling")};
+    };
+
     registry.each<AnimationParameters2D, KinematicBody2D, GroundContact2D>(
-        [&registry](Entity entity, AnimationParameters2D& parameters,
+        [&registry, &ids, &resolve](Entity entity, AnimationParameters2D& parameters,
            const KinematicBody2D& body, const GroundContact2D& contact) {
+            if (const auto* animator = registry.tryGet<Animator2D>(entity)) {
+                parameters.bind(animator->graph);
+            }
+            if (parameters.graph().get() != ids.graph) {
+                resolve(parameters.graph().get());
+            }
             const auto* climbing = registry.tryGet<ClimbingState2D>(entity);
             const bool isClimbing = climbing && climbing->active;
-            parameters.setFloat("speed", std::abs(body.velocity.x));
-            parameters.setFloat("verticalVelocity", body.velocity.y);
-            parameters.setBool("moving", std::abs(body.velocity.x) > 1.0f);
-            parameters.setBool("grounded", contact.grounded);
-            parameters.setBool("climbing", isClimbing);
-            parameters.setBool("rising", !isClimbing && !contact.grounded &&
+            parameters.setFloat(ids.speed, std::abs(body.velocity.x));
+            parameters.setFloat(ids.verticalVelocity, body.velocity.y);
+            parameters.setBool(ids.moving, std::abs(body.velocity.x) > 1.0f);
+            parameters.setBool(ids.grounded, contact.grounded);
+            parameters.setBool(ids.climbing, isClimbing);
+            parameters.setBool(ids.rising, !isClimbing && !contact.grounded &&
                                                body.velocity.y > 0.0f);
-            parameters.setBool("falling", !isClimbing && !contact.grounded &&
+            parameters.setBool(ids.falling, !isClimbing && !contact.grounded &&
                                                 body.velocity.y <= 0.0f);
         });
 }
 
 void AnimationSystem2D::beginFrame(Registry& registry) {
     registry.each<AnimationEventQueue2D>(
-        [](Entity, AnimationEventQueue2D& events) { events.events.clear(); });
+        [](Entity, AnimationEventQueue2D& events) { events.clear(); });
 }
 
 void AnimationSystem2D::update(Registry& registry, float fixedDeltaTime,
@@ -211,38 +232,36 @@ void AnimationSystem2D::update(Registry& registry, float fixedDeltaTime,
     registry.each<Animator2D, AnimationParameters2D, SpriteRender,
                   AnimationEventQueue2D>(
         [fixedDeltaTime, feelingSpeedMultiplier](Entity, Animator2D& animator,
-                         const AnimationParameters2D& parameters,
+                         AnimationParameters2D& parameters,
                          SpriteRender& renderable, AnimationEventQueue2D& events) {
             if (!animator.graph) {
                 return;
             }
+            parameters.bind(animator.graph);
             if (!std::isfinite(animator.playbackSpeed) || animator.playbackSpeed < 0.0f) {
                 throw std::invalid_argument("Animator2D playback speed must be finite and non-negative");
             }
 
-            const bool initialized = animator.stateIndex !=
-                std::numeric_limits<std::size_t>::max();
+            const bool initialized = animator.stateIndex != Animator2D::kNoState;
             if (!initialized) {
                 enterState(animator, renderable, events,
                            animator.graph->initialStateIndex(), false);
             }
 
-            if (!animator.requestedState.empty()) {
-                const auto requested = animator.graph->findState(animator.requestedState);
-                if (!requested) {
-                    throw std::invalid_argument(
-                        "Animator2D requested unknown state: " + animator.requestedState);
+            if (animator.requestedStateIndex != Animator2D::kNoState) {
+                const std::size_t requested = animator.requestedStateIndex;
+                animator.requestedStateIndex = Animator2D::kNoState;
+                if (requested >= animator.graph->stateCount()) {
+                    throw std::invalid_argument("Animator2D requested state index is out of range");
                 }
-                if (*requested != animator.stateIndex) {
-                    enterState(animator, renderable, events, *requested, true);
+                if (requested != animator.stateIndex) {
+                    enterState(animator, renderable, events, requested, true);
                 }
-                animator.requestedState.clear();
             }
 
-            for (const CompiledAnimationTransition2D& transition : animator.graph->transitions()) {
-                if ((!transition.anySource &&
-                     transition.fromState != animator.stateIndex) ||
-                    animator.stateElapsedSeconds < transition.minimumStateSeconds ||
+            for (const AnimationTransitionRule2D& transition :
+                 animator.graph->transitionsFrom(animator.stateIndex)) {
+                if (animator.stateElapsedSeconds < transition.minimumStateSeconds ||
                     !transitionPasses(transition, parameters)) {
                     continue;
                 }
@@ -3,21 +3,37 @@
 #include "ECS/Components/ParticleEmitter2D.hpp"
 #include "ECS/Components/Transform2D.hpp"
 #include "ECS/Registry.hpp"
+#include "ParticleSystem/ParticleStepScheduler.hpp"
 
+#include <algorithm>
 #include <cmath>
 #include <stdexcept>
+#include <vector>
 
 namespace ECS {
+namespace {
+bool overlaps(const glm::vec4& a, const glm::vec4& b) {
+    return !(a.z < b.x || a.x > b.z || a.w < b.y || a.y > b.w);
+}
+} // namespace
 
-void ParticleSystem2D::update(Registry& registry, float fixedDeltaTime) {
+ParticleSystem2D::Stats ParticleSystem2D::update(Registry& registry, float fixedDeltaTime,
+                                                 Utils::WorkerPool* workers,
+                                                 std::optional<glm::vec4> viewBounds,
+                                                 const std::shared_ptr<ParticleBudget>& budget,
+                                                 const ParticleCollisionWorld* collisionWorld) {
     if (!std::isfinite(fixedDeltaTime) || fixedDeltaTime <= 0.0f) {
         throw std::invalid_argument(
             "ParticleSystem2D requires a positive finite fixed delta time");
     }
 
+    Stats stats{};
+    std::vector<Entity> entities;
+    std::vector<ParticleEmitter2D*> components;
+    std::vector<ParticleEmitter*> emitters;
+    std::vector<ParticleEmitter2D*> catchingUp;
     registry.each<Transform2D, ParticleEmitter2D>(
-        [&registry, fixedDeltaTime](Entity entity, const Transform2D& transform,
-                                    ParticleEmitter2D& particles) {
+        [&](Entity entity, const Transform2D& transform, ParticleEmitter2D& particles) {
             if (particles.paused) {
                 return;
             }
@@ -32,16 +48,68 @@ void ParticleSystem2D::update(Registry& registry, float fixedDeltaTime) {
                 particles.emitter.setTarget({target.x, target.y});
             }
             particles.emitter.setEmitting(particles.emitting);
-            particles.emitter.update(fixedDeltaTime);
-            // Burst after integration so deferred bursts spawn exactly at the
-            // synchronized transform; they take their first step next update.
-            particles.emitter.burst(particles.takePendingBurst());
-
-            if (particles.autoDestroyWhenFinished && !particles.emitting &&
-                particles.emitter.isFinished()) {
-                registry.destroy(entity);
+            if (budget) {
+                particles.emitter.setBudget(budget, particles.priority);
+            }
+            particles.emitter.setCollisionWorld(collisionWorld);
+            entities.push_back(entity);
+            components.push_back(&particles);
+            if (viewBounds && particles.cullWhenOffscreen &&
+                !overlaps(particles.emitter.simulationBounds(), *viewBounds)) {
+                particles.emitter.skip(fixedDeltaTime);
+                ++stats.culled;
+                return;
             }
+            if (particles.emitter.hasSkippedTime()) {
+                // This step joins the backlog so steps are replayed in order.
+                particles.emitter.defer(fixedDeltaTime);
+                catchingUp.push_back(&particles);
+                ++stats.fastForwarded;
+            } else {
+                particles.emitter.prepareStep(fixedDeltaTime);
+                emitters.push_back(&particles.emitter);
+            }
+            ++stats.simulated;
         });
+
+    // Emitters back in view replay a few skipped steps per update, one step
+    // of every such emitter per round, so a catch-up is spread over frames
+    // and workers instead of stalling the calling thread for a lifetime.
+    // At least two steps per update, so the backlog shrinks even though
+    // each update adds a step to it.
+    std::vector<ParticleEmitter*> replaying;
+    for (std::size_t round = 0;; ++round) {
+        replaying.clear();
+        for (ParticleEmitter2D* particles : catchingUp) {
+            if (round < std::max<std::size_t>(particles->fastForwardStepsPerUpdate, 2) &&
+                particles->emitter.prepareSkippedStep()) {
+                replaying.push_back(&particles->emitter);
+            }
+        }
+        if (replaying.empty()) {
+            break;
+        }
+        stepPreparedEmitters(replaying, workers);
+    }
+    stepPreparedEmitters(emitters, workers);
+
+    std::vector<Entity> finished;
+    for (std::size_t i = 0; i < components.size(); ++i) {
+        ParticleEmitter2D& particles = *components[i];
+        // Burst after integration so deferred bursts spawn exactly at the
+        // synchronized transform; they take their first step next update.
+        particles.emitter.burst(particles.takePendingBurst());
+
+        if (particles.autoDestroyWhenFinished && !particles.emitting &&
+            particles.emitter.isFinished()) {
+            finished.push_back(entities[i]);
+        }
+    }
+    // Destroyed only now: removal may move the components pointed to above.
+    for (const Entity entity : finished) {
+        registry.destroy(entity);
+    }
+    return stats;
 }
 
 } // namespace ECS
@@ -1,12 +1,43 @@
 #pragma once
 
+#include <glm/vec4.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+
+class ParticleBudget;
+class ParticleCollisionWorld;
+namespace Utils { class WorkerPool; }
+
 namespace ECS {
 
 class Registry;
 
 class ParticleSystem2D {
 public:
-    static void update(Registry& registry, float fixedDeltaTime);
+    struct Stats {
+        std::size_t simulated{0};
+        std::size_t culled{0};
+        // Emitters that replayed skipped time this update; included in
+        // `simulated`.
+        std::size_t fastForwarded{0};
+    };
+
+    // With `workers`, emitters (and ranges of large emitters) integrate in
+    // parallel after transforms are synced; results match the serial path.
+    // With `viewBounds` ({minX, minY, maxX, maxY}), emitters opted into
+    // culling whose simulation bounds miss the view only record elapsed time.
+    // Back in view, they replay that backlog at most
+    // ParticleEmitter2D::fastForwardStepsPerUpdate steps per update.
+    // With `budget`, every emitter spawns from it at its component priority.
+    // With `collisionWorld`, emitters whose config enables collision resolve
+    // against it; it must stay unchanged until the next update.
+    static Stats update(Registry& registry, float fixedDeltaTime,
+                        Utils::WorkerPool* workers = nullptr,
+                        std::optional<glm::vec4> viewBounds = std::nullopt,
+                        const std::shared_ptr<ParticleBudget>& budget = nullptr,
+                        const ParticleCollisionWorld* collisionWorld = nullptr);
 };
 
 } // namespace ECS
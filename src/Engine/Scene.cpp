@@ -3,16 +3,21 @@
 //
 
 #include "Scene.hpp"
+#include "ECS/Components/Collision2D.hpp"
+#include "ECS/Components/ParticleEmitter2D.hpp"
 #include "ECS/Components/SmoothedTransform2D.hpp"
 #include "ECS/Components/Transform2D.hpp"
 #include "GameObjects/Components/TransformComponent.hpp"
+#include "GameObjects/Components/ColliderComponent.hpp"
 #include "GameObjects/Components/RigidBodyComponent.hpp"
+#include "GameObjects/Components/SpriteComponent.hpp"
 #include "GameObjects/Components/HingeComponent.hpp"
 #include "Physics/RigidBody.hpp"
 #include "GameObjects/Components/TransformFollowerComponent.hpp"
 #include "GameObjects/Components/RopeSegmentComponent.hpp"
 #include "GameObjects/Components/AnimatorComponent.hpp"
 #include "GameObjects/Components/ControllerComponent.hpp"
+#include "GameObjects/Components/TilemapComponent.hpp"
 #include "RenderingSystem/RenderSystem.hpp"
 #include "ECS/Systems/CharacterMotorSystem.hpp"
 #include "ECS/Systems/ClimbingSystem2D.hpp"
@@ -20,10 +25,47 @@
 #include "ECS/Systems/AnimationSystem2D.hpp"
 #include "ECS/Systems/ParticleSystem2D.hpp"
 #include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <limits>
+#include <optional>
 #include <stdexcept>
 #include <utility>
 
+namespace {
+// Only entities that run per-step behaviour or simulate a body can move their
+// own transform. Colliders merely follow their transform, and static bodies
+// never move, so neither makes a sprite mobile.
+bool spriteMayMove(const Entity& entity) {
+    for (const auto& component : entity.components()) {
+        const IComponent* raw = component.get();
+        if (const auto* rigidBody = dynamic_cast<const RigidBodyComponent*>(raw)) {
+            if (rigidBody->body() &&
+                rigidBody->body()->getBodyType() != RigidBodyType::STATIC) {
+                return true;
+            }
+            continue;
+        }
+        if (dynamic_cast<const ColliderComponent*>(raw)) {
+            continue;
+        }
+        if (dynamic_cast<const IUpdatableComponent*>(raw)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Shared across scenes so a renderer cache can tell which scene (and which
+// generation of it) it was filled from.
+std::uint64_t nextSpriteIndexEpoch() {
+    static std::atomic<std::uint64_t> epoch{0};
+    return ++epoch;
+}
+}
+
+Scene::Scene() : m_spriteIndexEpoch(nextSpriteIndexEpoch()) {}
+
 void Scene::setAmbientLight(glm::vec3 color) {
     if (!std::isfinite(color.x) || !std::isfinite(color.y) ||
         !std::isfinite(color.z) || color.x < 0.0f || color.y < 0.0f ||
@@ -44,6 +86,20 @@ void Scene::setClearColor(const glm::vec4& color) {
     m_clearColor = color;
 }
 
+void Scene::setParticleWorkerThreads(std::size_t count) {
+    constexpr std::size_t maxWorkers = 64;
+    if (count > maxWorkers) {
+        throw std::invalid_argument("Scene supports at most 64 particle worker threads");
+    }
+    if (m_updating) {
+        throw std::logic_error("Particle worker threads cannot change during Scene::update");
+    }
+    if (count == particleWorkerThreads()) {
+        return;
+    }
+    m_particleWorkers = count > 0 ? std::make_unique<Utils::WorkerPool>(count) : nullptr;
+}
+
 void Scene::snapshotTransformsForInterpolation() {
     // Legacy entities: remember mobile transforms at the start of the step so
     // render extraction can interpolate between steps. Entities that cannot
@@ -96,6 +152,9 @@ Entity &Scene::addEntity(std::unique_ptr<Entity> entity) {
     }
 
     Entity& result = *entity;
+    m_spriteIndexProbes.push_back({&result, m_nextEntitySequence++,
+                                   std::numeric_limits<std::uint32_t>::max()});
+    m_particleTileProbes.push_back(&result);
     if (m_updating) {
         m_pendingAdditions.push_back(std::move(entity));
     } else {
@@ -110,6 +169,8 @@ void Scene::destroyEntity(Entity &entity) {
     });
     if (pendingIt != m_pendingAdditions.end()) {
         detachLegacyEntityReferences(&entity);
+        forgetSprite(entity);
+        forgetParticleTileSource(entity);
         m_pendingAdditions.erase(pendingIt);
         return;
     }
@@ -128,6 +189,8 @@ void Scene::destroyEntity(Entity &entity) {
         detachLegacyEntityReferences(&entity);
         m_triggerSystem.unregisterEntity(entity.getId());
         m_previousPositions.erase(entity.getId());
+        forgetSprite(entity);
+        forgetParticleTileSource(entity);
         m_entities.erase(it);
     }
 }
@@ -157,6 +220,12 @@ void Scene::detachLegacyEntityReferences(const Entity* target) {
 }
 
 void Scene::clear() {
+    // Every indexed entity is about to be destroyed; entities added later in
+    // the same update re-register through fresh probes.
+    resetSpriteIndex();
+    m_particleTileSources.clear();
+    m_particleTileProbes.clear();
+    m_particleCollisionDirty = true;
     if (m_updating) {
         m_clearPending = true;
         m_pendingAdditions.clear();
@@ -170,6 +239,147 @@ void Scene::clear() {
     m_fixedClock.reset();
 }
 
+void Scene::resetSpriteIndex() {
+    m_spriteIndexEpoch = nextSpriteIndexEpoch();
+    m_staticSpriteChanges.clear();
+    m_spriteIndex.clear();
+    m_spriteRecords.clear();
+    m_spriteHandles.clear();
+    m_spriteIndexProbes.clear();
+    m_mobileSprites.clear();
+    m_staleSprites.clear();
+}
+
+bool Scene::registerSprite(Entity& entity, std::uint64_t sequence) {
+    const auto* sprite = entity.getComponent<SpriteComponent>();
+    const auto* transform = entity.getComponent<TransformComponent>();
+    if (!sprite || !transform) {
+        return false;
+    }
+    SpriteIndexRecord record{&entity, sprite, transform, sequence,
+                             spriteMayMove(entity)};
+    record.batched = sprite->isStatic() && !record.mobile;
+    const auto handle = m_spriteIndex.insert(spriteIndexBounds(record));
+    if (handle >= m_spriteRecords.size()) {
+        m_spriteRecords.resize(static_cast<std::size_t>(handle) + 1);
+    }
+    m_spriteRecords[handle] = record;
+    m_spriteHandles.emplace(entity.getId(), handle);
+    if (record.mobile) {
+        m_mobileSprites.push_back(handle);
+    }
+    if (record.batched) {
+        m_staticSpriteChanges.insert(entity.getId());
+    }
+    return true;
+}
+
+void Scene::forgetSprite(const Entity& entity) {
+    std::erase_if(m_spriteIndexProbes, [&entity](const SpriteIndexProbe& probe) {
+        return probe.entity == &entity;
+    });
+    const auto it = m_spriteHandles.find(entity.getId());
+    if (it == m_spriteHandles.end()) {
+        return;
+    }
+    const auto handle = it->second;
+    if (m_spriteRecords[handle].batched) {
+        m_staticSpriteChanges.insert(entity.getId());
+    }
+    m_spriteHandles.erase(it);
+    m_spriteIndex.remove(handle);
+    m_spriteRecords[handle] = {};
+    std::erase(m_mobileSprites, handle);
+    std::erase(m_staleSprites, handle);
+}
+
+glm::vec4 Scene::spriteIndexBounds(const SpriteIndexRecord& record) const {
+    const glm::vec2 size = record.sprite->sprite()
+        ? record.sprite->sprite()->getSize() : glm::vec2(0.0f);
+    glm::vec4 bounds =
+        Rendering::spriteBounds(record.transform->modelMatrix(), size);
+    // Render interpolation only blends translation, so sweeping the bounds
+    // back to the step-start position covers every interpolated pose.
+    if (const glm::vec2* previous = previousPosition(record.entity->getId())) {
+        const glm::vec2 delta = *previous - record.transform->getTransform().Position;
+        bounds = {std::min(bounds.x, bounds.x + delta.x),
+                  std::min(bounds.y, bounds.y + delta.y),
+                  std::max(bounds.z, bounds.z + delta.x),
+                  std::max(bounds.w, bounds.w + delta.y)};
+    }
+    return bounds;
+}
+
+void Scene::refreshSpriteIndex() {
+    std::erase_if(m_spriteIndexProbes, [this](SpriteIndexProbe& probe) {
+        const std::uint32_t revision = probe.entity->componentRevision();
+        if (revision == probe.revision) {
+            return false;
+        }
+        probe.revision = revision;
+        return registerSprite(*probe.entity, probe.sequence);
+    });
+
+    for (const auto handle : m_staleSprites) {
+        SpriteIndexRecord& record = m_spriteRecords[handle];
+        const bool mobile = spriteMayMove(*record.entity);
+        if (mobile != record.mobile) {
+            record.mobile = mobile;
+            if (mobile) {
+                m_mobileSprites.push_back(handle);
+            } else {
+                std::erase(m_mobileSprites, handle);
+            }
+        }
+        if (!mobile) {
+            m_spriteIndex.update(handle, spriteIndexBounds(record));
+        }
+        const bool batched = record.sprite->isStatic() && !mobile;
+        if (batched || record.batched) {
+            m_staticSpriteChanges.insert(record.entity->getId());
+        }
+        record.batched = batched;
+    }
+    m_staleSprites.clear();
+
+    for (const auto handle : m_mobileSprites) {
+        m_spriteIndex.update(handle, spriteIndexBounds(m_spriteRecords[handle]));
+    }
+}
+
+const Scene::SpriteIndexRecord& Scene::spriteIndexRecord(
+    Rendering::SpriteSpatialIndex::Handle handle) const {
+    if (!m_spriteIndex.contains(handle)) {
+        throw std::out_of_range("Scene::spriteIndexRecord received a stale handle");
+    }
+    return m_spriteRecords[handle];
+}
+
+void Scene::invalidateSpriteBounds(const Entity& entity) {
+    const auto it = m_spriteHandles.find(entity.getId());
+    if (it != m_spriteHandles.end() &&
+        std::find(m_staleSprites.begin(), m_staleSprites.end(), it->second) ==
+            m_staleSprites.end()) {
+        m_staleSprites.push_back(it->second);
+    }
+}
+
+const Scene::SpriteIndexRecord* Scene::staticSpriteRecord(uint64_t entityId) const {
+    const auto it = m_spriteHandles.find(entityId);
+    if (it == m_spriteHandles.end() || !m_spriteRecords[it->second].batched) {
+        return nullptr;
+    }
+    return &m_spriteRecords[it->second];
+}
+
+void Scene::requeueStaticSprites() {
+    for (const auto& [entityId, handle] : m_spriteHandles) {
+        if (m_spriteRecords[handle].batched) {
+            m_staticSpriteChanges.insert(entityId);
+        }
+    }
+}
+
 Engine::FixedStepClock::Result Scene::advance(float frameDeltaTime) {
     ECS::AnimationSystem2D::beginFrame(m_ecsRegistry);
     if (!std::isfinite(frameDeltaTime) || frameDeltaTime < 0.0f) {
@@ -200,12 +410,21 @@ void Scene::flushPendingMutations() {
         m_ecsRegistry.clear();
         m_previousPositions.clear();
         m_pendingDestructions.clear();
+        m_particleTileSources.clear();
+        m_particleTileProbes.clear();
+        m_particleCollisionDirty = true;
         m_clearPending = false;
     } else if (!m_pendingDestructions.empty()) {
         for (const uint64_t id : m_pendingDestructions) {
             m_triggerSystem.unregisterEntity(id);
             m_previousPositions.erase(id);
         }
+        for (const auto& entity : m_entities) {
+            if (m_pendingDestructions.contains(entity->getId())) {
+                forgetSprite(*entity);
+                forgetParticleTileSource(*entity);
+            }
+        }
         std::erase_if(m_entities, [this](const auto& entity) {
             return m_pendingDestructions.contains(entity->getId());
         });
@@ -246,7 +465,10 @@ void Scene::update(float deltaTime) {
         ECS::CharacterAnimationParameterSystem2D::update(m_ecsRegistry);
         ECS::AnimationSystem2D::update(
             m_ecsRegistry, deltaTime, animationSpeed);
-        ECS::ParticleSystem2D::update(m_ecsRegistry, deltaTime);
+        refreshParticleCollision();
+        m_particleStats = ECS::ParticleSystem2D::update(
+            m_ecsRegistry, deltaTime, m_particleWorkers.get(), m_particleCullingView,
+            m_particleBudget, &m_particleCollision);
         for (auto& e : m_entities) {
             if (m_clearPending) {
                 break;
@@ -275,7 +497,122 @@ void Scene::update(float deltaTime) {
     flushPendingMutations();
 }
 
+void Scene::forgetParticleTileSource(const Entity& entity) {
+    std::erase(m_particleTileProbes, &entity);
+    if (std::erase_if(m_particleTileSources, [&entity](const ParticleTileSource& source) {
+            return source.entity == &entity;
+        }) != 0) {
+        m_particleCollisionDirty = true;
+    }
+}
+
+void Scene::refreshParticleCollision() {
+    // New entities are checked once, on their first step.
+    for (const Entity* entity : m_particleTileProbes) {
+        if (entity->getComponent<TilemapComponent>()) {
+            m_particleCollisionDirty = true;
+        }
+    }
+    m_particleTileProbes.clear();
+
+    bool needed = m_particleCollisionShared;
+    if (!needed) {
+        m_ecsRegistry.each<ECS::ParticleEmitter2D>(
+            [&needed](ECS::Entity, const ECS::ParticleEmitter2D& particles) {
+                needed = needed || particles.emitter.getConfig().collisionResponse !=
+                                       ParticleCollisionResponse::None;
+            });
+    }
+    if (!needed) {
+        // Changes noted meanwhile are applied once an emitter collides.
+        return;
+    }
+
+    bool dirty = m_particleCollisionDirty ||
+                 m_ecsRegistry.count<ECS::StaticCollider2D>() != m_particleStaticColliders;
+    m_ecsRegistry.each<ECS::StaticCollider2D, ECS::SurfaceVelocity2D>(
+        [&dirty](ECS::Entity, const ECS::StaticCollider2D&, const ECS::SurfaceVelocity2D& surface) {
+            dirty = dirty || surface.velocity != glm::vec2{0.0f};
+        });
+    const auto describe = [](const Entity& entity) -> std::optional<ParticleTileSource> {
+        const auto* tilemap = entity.getComponent<TilemapComponent>();
+        const auto* transform = entity.getComponent<TransformComponent>();
+        if (!tilemap || !transform) {
+            return std::nullopt;
+        }
+        const Transform& placement = transform->getTransform();
+        ParticleTileSource source{&entity, tilemap->data(), placement.Position, placement.Scale};
+        if (const auto& data = source.data) {
+            source.tiles = data->tiles.data();
+            source.tileCount = data->tiles.size();
+            source.width = data->width;
+            source.height = data->height;
+            source.tileSize = data->tileSize;
+        }
+        source.collision = tilemap->collisionEnabled();
+        return source;
+    };
+    for (std::size_t i = 0; !dirty && i < m_particleTileSources.size(); ++i) {
+        const ParticleTileSource& source = m_particleTileSources[i];
+        const auto current = describe(*source.entity);
+        dirty = !current || *current != source;
+    }
+    if (!dirty) {
+        return;
+    }
+
+    // Tilemaps with collision disabled are remembered too, so enabling it
+    // triggers a rebuild.
+    m_particleCollision.clearTileLayers();
+    m_particleTileSources.clear();
+    for (const auto& entity : m_entities) {
+        auto source = describe(*entity);
+        if (!source) {
+            continue;
+        }
+        if (source->collision) {
+            m_particleCollision.addTileLayer(source->data, source->position, source->scale);
+        }
+        m_particleTileSources.push_back(std::move(*source));
+    }
+
+    // The box grid is only rebuilt when the boxes differ.
+    m_particleCollisionBoxes.clear();
+    m_ecsRegistry.each<ECS::Transform2D, ECS::AabbCollider2D, ECS::StaticCollider2D>(
+        [&](ECS::Entity, const ECS::Transform2D& transform,
+            const ECS::AabbCollider2D& collider, const ECS::StaticCollider2D&) {
+            const glm::vec2 center = transform.position + collider.offset * transform.scale;
+            const glm::vec2 half = glm::abs(collider.halfExtents * transform.scale);
+            m_particleCollisionBoxes.emplace_back(center - half, center + half);
+        });
+    m_particleCollision.setBoxes(m_particleCollisionBoxes);
+    m_particleStaticColliders = m_ecsRegistry.count<ECS::StaticCollider2D>();
+    m_particleCollisionDirty = false;
+}
+
+void Scene::setParticleBudget(std::shared_ptr<ParticleBudget> budget) {
+    if (budget == m_particleBudget) {
+        return;
+    }
+    if (!budget) {
+        m_ecsRegistry.each<ECS::ParticleEmitter2D>(
+            [this](ECS::Entity, ECS::ParticleEmitter2D& particles) {
+                if (particles.emitter.budget() == m_particleBudget) {
+                    particles.emitter.setBudget(nullptr, particles.priority);
+                }
+            });
+    }
+    m_particleBudget = std::move(budget);
+}
+
 void Scene::updateWorld(float deltaTime, Camera &camera, Rendering::Renderer &renderer) {
+    // Last frame's view with a margin for camera motion during this frame.
+    m_particleCullingView = camera.getViewBounds(0.25f);
+    const glm::vec4 view = camera.getViewBounds();
+    if (m_particleBudget) {
+        m_particleBudget->setViewCenter(glm::vec2(view.x + view.z, view.y + view.w) * 0.5f);
+        m_particleBudget->resetCounters();
+    }
     advance(deltaTime);
     camera.applyFeeling(m_feelingsSystem.getSnapshot());
     camera.update(deltaTime);
@@ -13,18 +13,41 @@
 #include "Graphics/Camera/Camera.hpp"
 #include "RenderingSystem/Renderer.hpp"
 #include "RenderingSystem/PostProcessSettings.hpp"
+#include "RenderingSystem/SpriteSpatialIndex.hpp"
 #include "FeelingsSystem/FeelingsSystem.hpp"
 #include "ECS/Registry.hpp"
+#include "ECS/Systems/ParticleSystem2D.hpp"
 #include "Engine/FixedStepClock.hpp"
+#include "ParticleSystem/ParticleBudget.hpp"
+#include "ParticleSystem/ParticleCollisionWorld.hpp"
+#include "Utils/WorkerPool.hpp"
 
+#include <cstdint>
+#include <optional>
 #include <unordered_map>
 #include <unordered_set>
 #include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
 
+class SpriteComponent;
+class TransformComponent;
+
 class Scene {
 public:
-    Scene() = default;
+    // A legacy entity registered in the render-side sprite index.
+    struct SpriteIndexRecord {
+        Entity* entity{nullptr};
+        const SpriteComponent* sprite{nullptr};
+        const TransformComponent* transform{nullptr};
+        // Position of the entity in scene order; extraction sorts candidates
+        // by it so equal layer/z sprites keep their submission order.
+        std::uint64_t sequence{0};
+        bool mobile{false};
+        // Drawn from the renderer's static batches instead of the index.
+        bool batched{false};
+    };
+
+    Scene();
 
     virtual ~Scene() = default;
 
@@ -69,16 +92,99 @@ public:
     void configureFixedStep(Engine::FixedStepClock::Config config) { m_fixedClock.configure(config); }
     [[nodiscard]] double fixedStepSeconds() const noexcept { return m_fixedClock.stepSeconds(); }
     [[nodiscard]] double interpolationAlpha() const noexcept { return m_fixedClock.interpolationAlpha(); }
+    // Worker threads that integrate ECS particle emitters alongside the
+    // simulation thread; 0 (the default) keeps them serial. Results are
+    // identical either way.
+    void setParticleWorkerThreads(std::size_t count);
+    [[nodiscard]] std::size_t particleWorkerThreads() const noexcept {
+        return m_particleWorkers ? m_particleWorkers->workerCount() : 0;
+    }
+    // World bounds ECS particle emitters are culled against during fixed
+    // steps; updateWorld() keeps it on the camera view. nullopt disables
+    // culling.
+    void setParticleCullingView(std::optional<glm::vec4> viewBounds) {
+        m_particleCullingView = viewBounds;
+    }
+    // Emitter counts from the most recent fixed step.
+    [[nodiscard]] const ECS::ParticleSystem2D::Stats& particleStats() const noexcept {
+        return m_particleStats;
+    }
+    // Live-particle budget ECS emitters spawn from; none by default, so
+    // emitters are neither capped nor rate-scaled until a scene opts in.
+    // Share it with a ParticleEffectSystem or ParticleSystem to cap them
+    // together. updateWorld() centers its distance scaling on the camera and
+    // resets its per-frame counters. Passing nullptr detaches the emitters
+    // that drew from the previous budget.
+    void setParticleBudget(std::shared_ptr<ParticleBudget> budget);
+    [[nodiscard]] const std::shared_ptr<ParticleBudget>& particleBudget() const noexcept {
+        return m_particleBudget;
+    }
+    // Solid geometry collision-enabled ECS particle emitters resolve against,
+    // built from collision-enabled TilemapComponent layers and ECS static
+    // colliders. It is only maintained while some ECS emitter collides, or
+    // while shared: pass it to a ParticleEffectSystem or ParticleSystem after
+    // setParticleCollisionShared(true) to let their emitters collide too.
+    [[nodiscard]] const ParticleCollisionWorld& particleCollisionWorld() const noexcept {
+        return m_particleCollision;
+    }
+    void setParticleCollisionShared(bool shared) noexcept { m_particleCollisionShared = shared; }
+    // The fixed step rebuilds the world when legacy entities that had a
+    // tilemap on their first step are added or destroyed, a tilemap layer is
+    // moved, rescaled, given new data or has its dimensions, tile size or
+    // tile storage changed, the number of ECS static colliders changes, or a
+    // static collider has a surface velocity. Tile values edited in place are
+    // read directly. Call this after any other change: moving a static
+    // collider directly, or adding a tilemap to an existing entity.
+    void invalidateParticleCollision() noexcept { m_particleCollisionDirty = true; }
     // Position a legacy entity held at the start of the last simulation step,
     // for render interpolation. Returns nullptr for unknown entities.
     [[nodiscard]] const glm::vec2* previousPosition(uint64_t entityId) const {
         const auto it = m_previousPositions.find(entityId);
         return it != m_previousPositions.end() ? &it->second : nullptr;
     }
+    // Render-side spatial index over legacy sprite bounds. Registers sprites
+    // added since the last call and re-bounds mobile ones (covering both the
+    // previous and current pose so interpolated draws stay inside). Static
+    // sprites are bounded once. RenderSystem calls this before extraction.
+    void refreshSpriteIndex();
+    [[nodiscard]] const Rendering::SpriteSpatialIndex& spriteIndex() const noexcept { return m_spriteIndex; }
+    [[nodiscard]] const SpriteIndexRecord& spriteIndexRecord(
+        Rendering::SpriteSpatialIndex::Handle handle) const;
+    // Entities without per-step behaviour or a non-static body are treated as
+    // static decoration. Code that moves, rescales, or re-sprites one from the
+    // outside (or adds behaviour to it later) must call this so its bounds and
+    // mobility are recomputed on the next refresh.
+    void invalidateSpriteBounds(const Entity& entity);
+    // Entity ids whose static-batch membership or geometry changed since the
+    // last clearStaticSpriteChanges(). RenderSystem rebakes each from
+    // staticSpriteRecord(), which is null once the entity is no longer batched.
+    [[nodiscard]] const std::unordered_set<uint64_t>& staticSpriteChanges() const noexcept {
+        return m_staticSpriteChanges;
+    }
+    void clearStaticSpriteChanges() noexcept { m_staticSpriteChanges.clear(); }
+    [[nodiscard]] const SpriteIndexRecord* staticSpriteRecord(uint64_t entityId) const;
+    // Queues every batched sprite as changed, for a renderer cache that was
+    // last filled from another scene or an earlier epoch.
+    void requeueStaticSprites();
+    // Unique across scenes; changes whenever the sprite index is reset, so a
+    // cache tagged with an older value must be rebuilt.
+    [[nodiscard]] std::uint64_t spriteIndexEpoch() const noexcept { return m_spriteIndexEpoch; }
 private:
+    struct SpriteIndexProbe {
+        Entity* entity{nullptr};
+        std::uint64_t sequence{0};
+        std::uint32_t revision{0};
+    };
+
     void snapshotTransformsForInterpolation();
+    void refreshParticleCollision();
+    void forgetParticleTileSource(const Entity& entity);
     void detachLegacyEntityReferences(const Entity* target);
     void flushPendingMutations();
+    bool registerSprite(Entity& entity, std::uint64_t sequence);
+    void forgetSprite(const Entity& entity);
+    void resetSpriteIndex();
+    [[nodiscard]] glm::vec4 spriteIndexBounds(const SpriteIndexRecord& record) const;
 
     std::vector<std::unique_ptr<Entity>> m_entities;
     std::vector<std::unique_ptr<Entity>> m_pendingAdditions;
@@ -92,8 +198,48 @@ private:
     glm::vec3 m_ambientLight{0.16f, 0.16f, 0.18f};
     glm::vec4 m_clearColor{0.05f, 0.05f, 0.08f, 1.0f};
     Engine::FixedStepClock m_fixedClock{};
+    std::unique_ptr<Utils::WorkerPool> m_particleWorkers;
+    std::optional<glm::vec4> m_particleCullingView;
+    ECS::ParticleSystem2D::Stats m_particleStats{};
+    std::shared_ptr<ParticleBudget> m_particleBudget;
+    // Everything a collision tile layer captures when it is added, including
+    // the tile storage it points into, so in-place edits trigger a rebuild.
+    struct ParticleTileSource {
+        const Entity* entity{nullptr};
+        std::shared_ptr<const TilemapData> data;
+        glm::vec2 position{0.0f};
+        glm::vec2 scale{1.0f};
+        const int* tiles{nullptr};
+        std::size_t tileCount{0};
+        int width{0};
+        int height{0};
+        glm::vec2 tileSize{0.0f};
+        bool collision{false};
+
+        bool operator==(const ParticleTileSource&) const = default;
+    };
+    ParticleCollisionWorld m_particleCollision{};
+    std::vector<glm::vec4> m_particleCollisionBoxes;
+    // Tilemaps found by the last rebuild, and entities added since the last
+    // step, checked once for a tilemap.
+    std::vector<ParticleTileSource> m_particleTileSources;
+    std::vector<const Entity*> m_particleTileProbes;
+    std::size_t m_particleStaticColliders{0};
+    bool m_particleCollisionDirty{true};
+    bool m_particleCollisionShared{false};
     std::unordered_map<uint64_t, glm::vec2> m_previousPositions;
     std::vector<ECS::Entity> m_smoothedNeedingHistory;
+    Rendering::SpriteSpatialIndex m_spriteIndex{};
+    // Indexed by sprite index handle.
+    std::vector<SpriteIndexRecord> m_spriteRecords;
+    std::unordered_map<uint64_t, Rendering::SpriteSpatialIndex::Handle> m_spriteHandles;
+    // Entities not yet indexed; re-probed only when their components change.
+    std::vector<SpriteIndexProbe> m_spriteIndexProbes;
+    std::vector<Rendering::SpriteSpatialIndex::Handle> m_mobileSprites;
+    std::vector<Rendering::SpriteSpatialIndex::Handle> m_staleSprites;
+    std::unordered_set<uint64_t> m_staticSpriteChanges;
+    std::uint64_t m_spriteIndexEpoch{0};
+    std::uint64_t m_nextEntitySequence{0};
     bool m_paused{false};
     bool m_updating{false};
     bool m_clearPending{false};
@@ -29,12 +29,18 @@ public:
     void setZIndex(int z) { m_zIndex = z; }
     void setLayer(int layer) { m_layer = layer; }
     void setSprite(std::shared_ptr<GameObjects::Sprite> sprite);
+    // Opts the sprite into the renderer's cached static batches while its
+    // entity has no per-step behaviour. Baked sprites ignore later changes to
+    // the sprite or transform until Scene::invalidateSpriteBounds is called.
+    [[nodiscard]] bool isStatic() const { return m_static; }
+    void setStatic(bool isStatic) { m_static = isStatic; }
 
 private:
 
     std::shared_ptr<GameObjects::Sprite> m_sprite{nullptr};
     int m_zIndex{0};
     int m_layer{static_cast<int>(Rendering::RenderLayer::Gameplay)};
+    bool m_static{false};
 };
 
 #endif // GL2D_SPRITECOMPONENT_HPP
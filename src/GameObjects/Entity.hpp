@@ -43,6 +43,9 @@ public:
     virtual void update(double dt);
 
     uint64_t getId() const { return m_id; }
+    // Bumped whenever a component is added, so observers (e.g. the render
+    // sprite index) can notice structural changes without rescanning.
+    uint32_t componentRevision() const { return m_componentRevision; }
 
 private:
     template<typename T>
@@ -50,6 +53,7 @@ private:
 
     std::vector<std::unique_ptr<IComponent>> m_components{};
     uint64_t m_id{0};
+    uint32_t m_componentRevision{0};
     static std::atomic<uint64_t> s_nextId;
 };
 
@@ -59,6 +63,7 @@ T &Entity::addComponent(Args &&... args) {
     auto comp = std::make_unique<T>(std::forward<Args>(args)...);
     T &ref = *comp;
     m_components.push_back(std::move(comp));
+    ++m_componentRevision;
     return ref;
 }
 
@@ -98,6 +103,7 @@ inline void Entity::addComponent(std::unique_ptr<IComponent> component) {
         throw std::invalid_argument("Entity::addComponent requires a non-null component");
     }
     m_components.push_back(std::move(component));
+    ++m_componentRevision;
 }
 
 #endif // GL2D_ENTITY_HPP
@@ -1,6 +1,7 @@
 #include <algorithm>
 #include <memory>
 #include <utility>
+#include <vector>
 #include "Texture.hpp"
 #include "third_party/stb/stb_image.h"
 #include "Exceptions/TextureException.hpp"
@@ -104,8 +105,82 @@ namespace GameObjects {
         glActiveTexture(static_cast<GLenum>(previousActiveTexture));
     }
 
+    Texture::Texture(int width, int height, bool useSRGB,
+                     const unsigned char (&fill)[4])
+        : m_width(width), m_height(height), m_numChannels(4) {
+        if (width <= 0 || height <= 0) {
+            throw TextureException("Atlas page dimensions must be positive");
+        }
+        m_ownerContext = glfwGetCurrentContext();
+        if (!m_ownerContext) {
+            throw TextureException("Atlas page creation requires a current GLFW OpenGL context");
+        }
+        std::vector<unsigned char> texels(static_cast<std::size_t>(width) *
+                                          static_cast<std::size_t>(height) * 4U);
+        for (std::size_t i = 0; i < texels.size(); i += 4U) {
+            std::copy(std::begin(fill), std::end(fill), texels.begin() +
+                      static_cast<std::ptrdiff_t>(i));
+        }
+
+        GLint previousActiveTexture = 0;
+        glGetIntegerv(GL_ACTIVE_TEXTURE, &previousActiveTexture);
+        glActiveTexture(GL_TEXTURE0);
+        GLint previousTexture = 0;
+        glGetIntegerv(GL_TEXTURE_BINDING_2D, &previousTexture);
+
+        glGenTextures(1, &m_textureID);
+        if (!m_textureID) {
+            glActiveTexture(static_cast<GLenum>(previousActiveTexture));
+            throw TextureException("OpenGL failed to allocate atlas page storage");
+        }
+        glBindTexture(GL_TEXTURE_2D, m_textureID);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexImage2D(GL_TEXTURE_2D, 0, useSRGB ? GL_SRGB8_ALPHA8 : GL_RGBA8,
+                     width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, texels.data());
+        glBindTexture(GL_TEXTURE_2D, static_cast<GLuint>(previousTexture));
+        glActiveTexture(static_cast<GLenum>(previousActiveTexture));
+    }
+
+    Texture::Texture(std::shared_ptr<const Texture> page, const glm::vec4& uvRect,
+                     int width, int height)
+        : m_textureID(page ? page->m_textureID : 0), m_width(width),
+          m_height(height), m_numChannels(page ? page->m_numChannels : 0),
+          m_ownerContext(page ? page->m_ownerContext : nullptr),
+          m_uvRect(uvRect), m_page(std::move(page)) {
+        if (!m_page) {
+            throw TextureException("Atlas regions require a page texture");
+        }
+    }
+
+    void Texture::uploadRegion(int x, int y, int width, int height,
+                               const unsigned char* rgba) const {
+        if (x < 0 || y < 0 || width <= 0 || height <= 0 ||
+            width > m_width - x || height > m_height - y) {
+            throw TextureException("Atlas upload region lies outside the page");
+        }
+        GLint previousActiveTexture = 0;
+        glGetIntegerv(GL_ACTIVE_TEXTURE, &previousActiveTexture);
+        glActiveTexture(GL_TEXTURE0);
+        GLint previousTexture = 0;
+        GLint previousUnpackAlignment = 0;
+        glGetIntegerv(GL_TEXTURE_BINDING_2D, &previousTexture);
+        glGetIntegerv(GL_UNPACK_ALIGNMENT, &previousUnpackAlignment);
+
+        glBindTexture(GL_TEXTURE_2D, m_textureID);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, GL_RGBA,
+                        GL_UNSIGNED_BYTE, rgba);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, previousUnpackAlignment);
+        glBindTexture(GL_TEXTURE_2D, static_cast<GLuint>(previousTexture));
+        glActiveTexture(static_cast<GLenum>(previousActiveTexture));
+    }
+
     Texture::~Texture() {
-        if (m_textureID && glfwGetCurrentContext() == m_ownerContext) {
+        // Regions borrow their page's name; the page deletes it.
+        if (m_textureID && !m_page && glfwGetCurrentContext() == m_ownerContext) {
             glDeleteTextures(1, &m_textureID);
         }
     }
@@ -115,13 +190,15 @@ namespace GameObjects {
           m_width(std::exchange(other.m_width, 0)),
           m_height(std::exchange(other.m_height, 0)),
           m_numChannels(std::exchange(other.m_numChannels, 0)),
-          m_ownerContext(std::exchange(other.m_ownerContext, nullptr)) {}
+          m_ownerContext(std::exchange(other.m_ownerContext, nullptr)),
+          m_uvRect(std::exchange(other.m_uvRect, glm::vec4(0.0f, 0.0f, 1.0f, 1.0f))),
+          m_page(std::move(other.m_page)) {}
 
     Texture& Texture::operator=(Texture&& other) noexcept {
         if (this == &other) {
             return *this;
         }
-        if (m_textureID && glfwGetCurrentContext() == m_ownerContext) {
+        if (m_textureID && !m_page && glfwGetCurrentContext() == m_ownerContext) {
             glDeleteTextures(1, &m_textureID);
         }
         m_textureID = std::exchange(other.m_textureID, 0);
@@ -129,6 +206,8 @@ namespace GameObjects {
         m_height = std::exchange(other.m_height, 0);
         m_numChannels = std::exchange(other.m_numChannels, 0);
         m_ownerContext = std::exchange(other.m_ownerContext, nullptr);
+        m_uvRect = std::exchange(other.m_uvRect, glm::vec4(0.0f, 0.0f, 1.0f, 1.0f));
+        m_page = std::move(other.m_page);
         return *this;
     }
 
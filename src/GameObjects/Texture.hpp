@@ -1,8 +1,10 @@
 #ifndef GL2D_TEXTURE_HPP
 #define GL2D_TEXTURE_HPP
 
+#include <memory>
 #include <string>
 #include <GL/glew.h>
+#include <glm/vec4.hpp>
 
 namespace Managers { class TextureManager; }
 struct GLFWwindow;
@@ -29,13 +31,30 @@ namespace GameObjects {
         GLuint getID() const { return m_textureID; }
         int getWidth() const { return m_width; }
         int getHeight() const { return m_height; }
+        // Sub-rectangle of getID() this texture occupies, {u0, v0, u1, v1}.
+        // Atlas regions share their page's id; the sprite renderer maps sprite
+        // UVs into this rectangle so atlasing is transparent to sprite code.
+        const glm::vec4& uvRect() const { return m_uvRect; }
+        bool isAtlasRegion() const { return m_page != nullptr; }
 
     private:
         explicit Texture(const std::string& filepath, bool useSRGB);
+        // Blank RGBA8 atlas page filled with `fill`, sampled without mipmaps
+        // so neighbouring regions cannot bleed into each other.
+        Texture(int width, int height, bool useSRGB, const unsigned char (&fill)[4]);
+        // Region of `page` covering `uvRect`, `width` x `height` texels.
+        Texture(std::shared_ptr<const Texture> page, const glm::vec4& uvRect,
+                int width, int height);
+
+        // Uploads tightly packed RGBA8 texels into an atlas page.
+        void uploadRegion(int x, int y, int width, int height,
+                          const unsigned char* rgba) const;
 
         GLuint m_textureID{};
         int m_width{}, m_height{}, m_numChannels{};
         GLFWwindow* m_ownerContext{nullptr};
+        glm::vec4 m_uvRect{0.0f, 0.0f, 1.0f, 1.0f};
+        std::shared_ptr<const Texture> m_page;
     };
 
 } // namespace GameObjects
@@ -8,6 +8,11 @@
 #include <glm/vec2.hpp>
 #include <glm/vec4.hpp>
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+
 struct Vertex{
     glm::vec2 position{};
     glm::vec4 color{};
@@ -16,4 +21,28 @@ struct Vertex{
         return position == other.position && color == other.color && uv==other.uv;
     }
 };
+
+// 16-byte vertex for bandwidth-bound draws. Color is normalized RGBA8 and UVs
+// are 16-bit normalized, so both are clamped to [0, 1]; use Vertex for HDR
+// tints or repeating UVs.
+struct CompactVertex{
+    glm::vec2 position{};
+    std::array<std::uint8_t, 4> color{};
+    std::array<std::uint16_t, 2> uv{};
+    bool operator==(const CompactVertex& other) const = default;
+};
+static_assert(sizeof(CompactVertex) == 16, "CompactVertex must stay 16 bytes");
+
+inline CompactVertex compactVertex(const Vertex& vertex){
+    const auto unorm8 = [](float value) {
+        return static_cast<std::uint8_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 255.0f));
+    };
+    const auto unorm16 = [](float value) {
+        return static_cast<std::uint16_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 65535.0f));
+    };
+    return {vertex.position,
+            {unorm8(vertex.color.r), unorm8(vertex.color.g),
+             unorm8(vertex.color.b), unorm8(vertex.color.a)},
+            {unorm16(vertex.uv.x), unorm16(vertex.uv.y)}};
+}
 #endif //GL2D_VERTEX_HPP
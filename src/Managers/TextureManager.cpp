@@ -1,20 +1,89 @@
 #include "TextureManager.hpp"
 
+#include "Exceptions/TextureException.hpp"
+#include "third_party/stb/stb_image.h"
+
 #define GLFW_INCLUDE_NONE
 #include <GLFW/glfw3.h>
 
+#include <algorithm>
+#include <cstring>
 #include <stdexcept>
 
 namespace Managers {
+    namespace {
+        constexpr int kAtlasPageSize = 2048;
+        // Extruded border texels around every region; linear filtering never
+        // reaches a neighbour.
+        constexpr int kAtlasPadding = 2;
+        constexpr unsigned char kClearTexel[4] = {0, 0, 0, 0};
+        constexpr unsigned char kFlatNormalTexel[4] = {128, 128, 255, 255};
+
+        struct DecodedImage {
+            std::unique_ptr<unsigned char, decltype(&stbi_image_free)> texels{
+                nullptr, &stbi_image_free};
+            int width{0};
+            int height{0};
+        };
+
+        DecodedImage decodeRgba(const std::string& filepath) {
+            DecodedImage image;
+            int channels = 0;
+            // Matches Texture: rows bottom-up so v = 0 is the image bottom.
+            stbi_set_flip_vertically_on_load_thread(1);
+            unsigned char* decoded = stbi_load(filepath.c_str(), &image.width,
+                                               &image.height, &channels, 4);
+            const char* failureReason = decoded ? nullptr : stbi_failure_reason();
+            stbi_set_flip_vertically_on_load_thread(0);
+            image.texels.reset(decoded);
+            if (!image.texels || image.width <= 0 || image.height <= 0) {
+                throw GameObjects::TextureException(
+                    "Failed to decode '" + filepath + "': " +
+                    (failureReason ? failureReason : "invalid image dimensions"));
+            }
+            return image;
+        }
+
+        // Copies `source` into a buffer `padding` texels larger on each side,
+        // repeating the edge texels outward.
+        std::vector<unsigned char> extrude(const unsigned char* source, int width,
+                                           int height, int padding) {
+            const int paddedWidth = width + 2 * padding;
+            const int paddedHeight = height + 2 * padding;
+            std::vector<unsigned char> texels(static_cast<std::size_t>(paddedWidth) *
+                                              static_cast<std::size_t>(paddedHeight) * 4U);
+            for (int y = 0; y < paddedHeight; ++y) {
+                const int sourceY = std::clamp(y - padding, 0, height - 1);
+                for (int x = 0; x < paddedWidth; ++x) {
+                    const int sourceX = std::clamp(x - padding, 0, width - 1);
+                    std::memcpy(&texels[(static_cast<std::size_t>(y) * paddedWidth + x) * 4U],
+                                &source[(static_cast<std::size_t>(sourceY) * width + sourceX) * 4U],
+                                4U);
+                }
+            }
+            return texels;
+        }
+
+        GLFWwindow* requireContext(const char* caller) {
+            GLFWwindow* context = glfwGetCurrentContext();
+            if (!context) {
+                throw std::logic_error(std::string(caller) +
+                                       " requires a current GLFW OpenGL context");
+            }
+            return context;
+        }
+    } // namespace
+
     std::unordered_map<GLFWwindow*, TextureManager::ContextCache>
         TextureManager::m_textureCaches;
+    std::map<TextureManager::AtlasKey, TextureManager::AtlasState>
+        TextureManager::m_atlases;
+
+    TextureManager::AtlasState::AtlasState(int pageSize)
+        : packer(pageSize, pageSize, kAtlasPadding) {}
 
     std::shared_ptr<GameObjects::Texture> TextureManager::loadTexture(const std::string &filepath, bool useSRGB) {
-        GLFWwindow* context = glfwGetCurrentContext();
-        if (!context) {
-            throw std::logic_error(
-                "TextureManager::loadTexture requires a current GLFW OpenGL context");
-        }
+        GLFWwindow* context = requireContext("TextureManager::loadTexture");
         auto& cache = m_textureCaches[context];
         const std::size_t variant = useSRGB ? 1U : 0U;
         auto it = cache.find(filepath);
@@ -29,6 +98,117 @@ namespace Managers {
         return newTexture;
     }
 
+    TextureManager::AtlasTextures TextureManager::loadAtlasTextures(
+        const std::string& filepath, const std::string& normalPath, bool useSRGB) {
+        GLFWwindow* context = requireContext("TextureManager::loadAtlasTextures");
+        if (filepath.empty()) {
+            throw GameObjects::TextureException("Atlas texture path cannot be empty");
+        }
+        auto atlasIt = m_atlases.find({context, useSRGB});
+        if (atlasIt == m_atlases.end()) {
+            GLint maxTextureSize = kAtlasPageSize;
+            glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
+            atlasIt = m_atlases.try_emplace({context, useSRGB},
+                                            std::min(kAtlasPageSize, maxTextureSize)).first;
+        }
+        AtlasState& atlas = atlasIt->second;
+
+        const std::string regionKey = filepath + '\n' + normalPath;
+        if (const auto cached = atlas.regions.find(regionKey); cached != atlas.regions.end()) {
+            auto albedo = cached->second.albedo.lock();
+            auto normal = cached->second.normal.lock();
+            if (albedo && normal) {
+                return {std::move(albedo), std::move(normal)};
+            }
+        }
+
+        const DecodedImage image = decodeRgba(filepath);
+        DecodedImage normalImage;
+        if (!normalPath.empty()) {
+            normalImage = decodeRgba(normalPath);
+            if (normalImage.width != image.width || normalImage.height != image.height) {
+                throw GameObjects::TextureException(
+                    "Normal map '" + normalPath + "' does not match the size of '" +
+                    filepath + "'");
+            }
+        }
+
+        // Pages whose regions were all released are reused from scratch.
+        for (std::size_t page = 0; page < atlas.pages.size(); ++page) {
+            if (atlas.pages[page].albedo.expired() && atlas.pages[page].normal.expired() &&
+                atlas.packer.occupancy(page) > 0.0f) {
+                atlas.packer.resetPage(page);
+            }
+        }
+        const auto placement = atlas.packer.insert(image.width, image.height);
+        if (!placement) {
+            return {loadTexture(filepath, useSRGB),
+                    normalPath.empty() ? nullptr : loadTexture(normalPath, false)};
+        }
+        if (placement->page >= atlas.pages.size()) {
+            atlas.pages.resize(placement->page + 1);
+        }
+
+        AtlasPage& pageTextures = atlas.pages[placement->page];
+        const int pageSize = atlas.packer.pageWidth();
+        auto albedoPage = pageTextures.albedo.lock();
+        if (!albedoPage) {
+            albedoPage.reset(new GameObjects::Texture(pageSize, pageSize, useSRGB, kClearTexel));
+            pageTextures.albedo = albedoPage;
+        }
+        auto normalPage = pageTextures.normal.lock();
+        if (!normalPage) {
+            normalPage.reset(new GameObjects::Texture(pageSize, pageSize, false, kFlatNormalTexel));
+            pageTextures.normal = normalPage;
+        }
+
+        const int padding = atlas.packer.padding();
+        const int x = placement->x - padding;
+        const int y = placement->y - padding;
+        const int paddedWidth = image.width + 2 * padding;
+        const int paddedHeight = image.height + 2 * padding;
+        albedoPage->uploadRegion(x, y, paddedWidth, paddedHeight,
+                                 extrude(image.texels.get(), image.width,
+                                         image.height, padding).data());
+        if (normalImage.texels) {
+            normalPage->uploadRegion(x, y, paddedWidth, paddedHeight,
+                                     extrude(normalImage.texels.get(), image.width,
+                                             image.height, padding).data());
+        } else {
+            // The page may hold a released region's normals.
+            std::vector<unsigned char> flat(static_cast<std::size_t>(paddedWidth) *
+                                            static_cast<std::size_t>(paddedHeight) * 4U);
+            for (std::size_t i = 0; i < flat.size(); i += 4U) {
+                std::memcpy(&flat[i], kFlatNormalTexel, 4U);
+            }
+            normalPage->uploadRegion(x, y, paddedWidth, paddedHeight, flat.data());
+        }
+
+        const float scale = 1.0f / static_cast<float>(pageSize);
+        const glm::vec4 uvRect{static_cast<float>(placement->x) * scale,
+                               static_cast<float>(placement->y) * scale,
+                               static_cast<float>(placement->x + image.width) * scale,
+                               static_cast<float>(placement->y + image.height) * scale};
+        AtlasTextures textures{
+            std::shared_ptr<GameObjects::Texture>(new GameObjects::Texture(
+                albedoPage, uvRect, image.width, image.height)),
+            std::shared_ptr<GameObjects::Texture>(new GameObjects::Texture(
+                normalPage, uvRect, image.width, image.height))};
+        atlas.regions[regionKey] = {textures.albedo, textures.normal};
+        return textures;
+    }
+
+    std::vector<float> TextureManager::atlasOccupancy(bool useSRGB) {
+        GLFWwindow* context = requireContext("TextureManager::atlasOccupancy");
+        std::vector<float> occupancy;
+        if (const auto it = m_atlases.find({context, useSRGB}); it != m_atlases.end()) {
+            for (std::size_t page = 0; page < it->second.packer.pageCount(); ++page) {
+                occupancy.push_back(it->second.packer.occupancy(page));
+            }
+        }
+        return occupancy;
+    }
+
     void TextureManager::cleanUnusedTextures() {
         for (auto contextIt = m_textureCaches.begin();
              contextIt != m_textureCaches.end();) {
@@ -44,5 +224,16 @@ namespace Managers {
             contextIt = cache.empty() ? m_textureCaches.erase(contextIt)
                                       : std::next(contextIt);
         }
+        for (auto atlasIt = m_atlases.begin(); atlasIt != m_atlases.end();) {
+            auto& regions = atlasIt->second.regions;
+            std::erase_if(regions, [](const auto& entry) {
+                return entry.second.albedo.expired() && entry.second.normal.expired();
+            });
+            const bool pagesReleased = std::ranges::all_of(
+                atlasIt->second.pages, [](const AtlasPage& page) {
+                    return page.albedo.expired() && page.normal.expired();
+                });
+            atlasIt = pagesReleased ? m_atlases.erase(atlasIt) : std::next(atlasIt);
+        }
     }
 } // namespace Managers
@@ -5,22 +5,60 @@
 #ifndef GL2D_TEXTUREMANAGER_HPP
 #define GL2D_TEXTUREMANAGER_HPP
 #include "GameObjects/Texture.hpp"
+#include "RenderingSystem/AtlasPacker.hpp"
 #include <array>
+#include <map>
 #include <unordered_map>
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 struct GLFWwindow;
 namespace Managers {
 
     class TextureManager {
     public:
+        // An albedo region and the matching region of its normal-map page.
+        struct AtlasTextures {
+            std::shared_ptr<GameObjects::Texture> albedo;
+            // Flat normals when no normal map was given, so atlased sprites
+            // with and without normal maps still share a batch.
+            std::shared_ptr<GameObjects::Texture> normal;
+        };
+
         static std::shared_ptr<GameObjects::Texture> loadTexture(const std::string& filepath, bool useSRGB = false);
+        // Packs an image, and optionally a normal map of the same size, into
+        // shared atlas pages so sprites from different files batch together.
+        // The returned textures are regions whose UVs the sprite renderer
+        // remaps transparently. Images too large for a page fall back to
+        // standalone textures (with a null normal when none was given).
+        static AtlasTextures loadAtlasTextures(const std::string& filepath,
+                                               const std::string& normalPath = {},
+                                               bool useSRGB = false);
+        // Occupancy of each albedo atlas page of the current context.
+        static std::vector<float> atlasOccupancy(bool useSRGB = false);
         static void cleanUnusedTextures();
 
     private:
         using TextureVariants = std::array<std::weak_ptr<GameObjects::Texture>, 2>;
         using ContextCache = std::unordered_map<std::string, TextureVariants>;
+
+        struct AtlasPage {
+            std::weak_ptr<GameObjects::Texture> albedo;
+            std::weak_ptr<GameObjects::Texture> normal;
+        };
+        struct AtlasState {
+            explicit AtlasState(int pageSize);
+
+            Rendering::AtlasPacker packer;
+            // Parallel to the packer's pages.
+            std::vector<AtlasPage> pages;
+            std::unordered_map<std::string, AtlasPage> regions;
+        };
+        using AtlasKey = std::pair<GLFWwindow*, bool>;
+
         static std::unordered_map<GLFWwindow*, ContextCache> m_textureCaches;
+        static std::map<AtlasKey, AtlasState> m_atlases;
     };
 
 } // namespace Managers
@@ -0,0 +1,45 @@
+//
+// CounterRandom.hpp
+//
+
+#ifndef GL2D_COUNTERRANDOM_HPP
+#define GL2D_COUNTERRANDOM_HPP
+
+#include <cstdint>
+
+// Counter-based generator: value n of a stream is a pure hash of (seed, n)
+// using the SplitMix64 finalizer. The whole state is the seed and a
+// counter, any value can be computed out of order (so batches need no
+// serial dependency), and discard() jumps ahead in O(1).
+class CounterRandom {
+public:
+    explicit CounterRandom(std::uint64_t seed = 0) noexcept : m_seed(seed) {}
+
+    // Value `index` of the stream, independent of the counter.
+    [[nodiscard]] std::uint64_t at(std::uint64_t index) const noexcept {
+        std::uint64_t z = m_seed + (index + 1) * 0x9e3779b97f4a7c15ull;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+    // Uniform float in [0, 1) from the top 24 bits of at(index).
+    [[nodiscard]] float unitAt(std::uint64_t index) const noexcept {
+        return static_cast<float>(at(index) >> 40) * 0x1.0p-24f;
+    }
+
+    std::uint64_t next() noexcept { return at(m_counter++); }
+    float nextUnit() noexcept { return unitAt(m_counter++); }
+
+    void discard(std::uint64_t count) noexcept { m_counter += count; }
+    void seed(std::uint64_t seed) noexcept {
+        m_seed = seed;
+        m_counter = 0;
+    }
+    [[nodiscard]] std::uint64_t counter() const noexcept { return m_counter; }
+
+private:
+    std::uint64_t m_seed{0};
+    std::uint64_t m_counter{0};
+};
+
+#endif //GL2D_COUNTERRANDOM_HPP
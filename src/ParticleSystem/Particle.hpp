@@ -7,10 +7,11 @@
 
 #include <glm/glm.hpp>
 
+// One particle's state, used to spawn into and read back from a ParticlePool.
+// Particles are square, so size is a single edge length.
 struct Particle{
     glm::vec2 position{};
     glm::vec2 velocity{};
-    glm::vec2 acceleration{0.f,0.f};
 
     float rotation{0.0f};
     float angularVelocity{0.0f};
@@ -18,9 +19,8 @@ struct Particle{
     float lifeTime{1.0f};
     float age{0.0f};
 
-    glm::vec2 size{1.0f,1.0f};
-    glm::vec2 initialSize{1.0f,1.0f};
+    float size{1.0f};
+    float initialSize{1.0f};
     glm::vec4 color{1.0f};
-    bool alive{false};
 };
 #endif //GL2D_PARTICLE_HPP
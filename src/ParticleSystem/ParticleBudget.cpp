@@ -0,0 +1,165 @@
+//
+// ParticleBudget.cpp
+//
+
+#include "ParticleBudget.hpp"
+
+#include "Exceptions/SubsystemExceptions.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include <glm/geometric.hpp>
+
+namespace {
+bool unitInterval(float value) {
+    return std::isfinite(value) && value >= 0.0f && value <= 1.0f;
+}
+
+std::size_t index(ParticlePriority priority) noexcept {
+    return static_cast<std::size_t>(priority);
+}
+} // namespace
+
+ParticleBudget::ParticleBudget(const Settings& settings) {
+    setSettings(settings);
+}
+
+void ParticleBudget::setSettings(const Settings& settings) {
+    if (!unitInterval(settings.lowPriorityShare) ||
+        !unitInterval(settings.normalPriorityShare) ||
+        settings.lowPriorityShare > settings.normalPriorityShare) {
+        throw Engine::ParticleException(
+            "Particle budget priority shares must satisfy 0 <= low <= normal <= 1");
+    }
+    if (!std::isfinite(settings.fullRateDistance) || settings.fullRateDistance < 0.0f ||
+        !std::isfinite(settings.minRateDistance) ||
+        settings.minRateDistance < settings.fullRateDistance) {
+        throw Engine::ParticleException(
+            "Particle budget distances must be finite with 0 <= full rate <= min rate");
+    }
+    if (!unitInterval(settings.minRateScale)) {
+        throw Engine::ParticleException(
+            "Particle budget minimum rate scale must be within [0, 1]");
+    }
+    m_settings = settings;
+}
+
+float ParticleBudget::spawnRateScale(const glm::vec2& position) const noexcept {
+    if (!m_viewCenter) {
+        return 1.0f;
+    }
+    const float distance = glm::length(position - *m_viewCenter);
+    if (distance <= m_settings.fullRateDistance) {
+        return 1.0f;
+    }
+    if (distance >= m_settings.minRateDistance) {
+        return m_settings.minRateScale;
+    }
+    const float t = (distance - m_settings.fullRateDistance) /
+                    (m_settings.minRateDistance - m_settings.fullRateDistance);
+    return 1.0f + (m_settings.minRateScale - 1.0f) * t;
+}
+
+std::size_t ParticleBudget::limit(ParticlePriority priority) const noexcept {
+    const auto share = [this](float fraction) {
+        return static_cast<std::size_t>(
+            static_cast<double>(m_settings.maxLiveParticles) * fraction);
+    };
+    switch (priority) {
+        case ParticlePriority::Low:
+            return share(m_settings.lowPriorityShare);
+        case ParticlePriority::Normal:
+            return share(m_settings.normalPriorityShare);
+        case ParticlePriority::High:
+            break;
+    }
+    return m_settings.maxLiveParticles;
+}
+
+std::size_t ParticleBudget::acquire(std::size_t requested, ParticlePriority priority) noexcept {
+    const std::size_t cap = limit(priority);
+    const std::size_t available = m_live < cap ? cap - m_live : 0;
+    const std::size_t granted = std::min(requested, available);
+    m_granted += granted;
+    m_denied += requested - granted;
+    adopt(granted, priority);
+    return granted;
+}
+
+void ParticleBudget::adopt(std::size_t count, ParticlePriority priority) noexcept {
+    m_live += count;
+    m_liveByPriority[index(priority)] += count;
+    m_peak = std::max(m_peak, m_live);
+}
+
+void ParticleBudget::release(std::size_t count, ParticlePriority priority) noexcept {
+    std::size_t& bucket = m_liveByPriority[index(priority)];
+    count = std::min(count, bucket);
+    bucket -= count;
+    m_live -= count;
+}
+
+ParticleBudget::Usage ParticleBudget::usage() const noexcept {
+    return {m_live, m_settings.maxLiveParticles, m_peak, m_granted, m_denied,
+            m_liveByPriority};
+}
+
+void ParticleBudget::resetCounters() noexcept {
+    m_peak = m_live;
+    m_granted = 0;
+    m_denied = 0;
+}
+
+ParticleBudgetLease::ParticleBudgetLease(std::shared_ptr<ParticleBudget> budget,
+                                         ParticlePriority priority,
+                                         std::size_t held) noexcept
+    : m_budget(std::move(budget)), m_priority(priority) {
+    if (m_budget) {
+        m_budget->adopt(held, m_priority);
+        m_held = held;
+    }
+}
+
+ParticleBudgetLease::~ParticleBudgetLease() {
+    releaseAll();
+}
+
+ParticleBudgetLease::ParticleBudgetLease(ParticleBudgetLease&& other) noexcept
+    : m_budget(std::move(other.m_budget)),
+      m_priority(other.m_priority),
+      m_held(std::exchange(other.m_held, 0)) {}
+
+ParticleBudgetLease& ParticleBudgetLease::operator=(ParticleBudgetLease&& other) noexcept {
+    if (this != &other) {
+        releaseAll();
+        m_budget = std::move(other.m_budget);
+        m_priority = other.m_priority;
+        m_held = std::exchange(other.m_held, 0);
+    }
+    return *this;
+}
+
+std::size_t ParticleBudgetLease::acquire(std::size_t requested) noexcept {
+    if (!m_budget) {
+        return requested;
+    }
+    const std::size_t granted = m_budget->acquire(requested, m_priority);
+    m_held += granted;
+    return granted;
+}
+
+void ParticleBudgetLease::sync(std::size_t live) noexcept {
+    if (m_budget && m_held > live) {
+        m_budget->release(m_held - live, m_priority);
+        m_held = live;
+    }
+}
+
+void ParticleBudgetLease::releaseAll() noexcept {
+    if (m_budget) {
+        m_budget->release(m_held, m_priority);
+    }
+    m_held = 0;
+}
@@ -0,0 +1,119 @@
+//
+// ParticleBudget.hpp
+//
+
+#ifndef GL2D_PARTICLEBUDGET_HPP
+#define GL2D_PARTICLEBUDGET_HPP
+
+#include <glm/vec2.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+// Lower priorities stop spawning first as the shared budget fills, leaving
+// headroom for gameplay-critical effects.
+enum class ParticlePriority : std::uint8_t { Low, Normal, High };
+
+// Global cap on live particles shared by every emitter attached to it
+// (ParticleEffectSystem, ParticleSystem and ECS ParticleEmitter2D). Emitters
+// ask for particles before spawning and return them as they expire; a
+// request is trimmed to what the requester's priority may still use. Spawn
+// rates also fall off with distance from the view center. Not thread-safe:
+// emitters spawn and retire particles on the thread that updates them.
+class ParticleBudget {
+public:
+    struct Settings {
+        std::size_t maxLiveParticles{50'000};
+        // Fractions of maxLiveParticles Low and Normal emitters may fill;
+        // High may use the whole budget.
+        float lowPriorityShare{0.6f};
+        float normalPriorityShare{0.85f};
+        // Emitters within fullRateDistance of the view center spawn at full
+        // rate, falling linearly to minRateScale at minRateDistance.
+        float fullRateDistance{1'000.0f};
+        float minRateDistance{4'000.0f};
+        float minRateScale{0.1f};
+    };
+
+    struct Usage {
+        std::size_t live{0};
+        std::size_t limit{0};
+        // Highest live count since the last resetCounters().
+        std::size_t peak{0};
+        // Particles handed out and refused since the last resetCounters().
+        std::size_t granted{0};
+        std::size_t denied{0};
+        std::array<std::size_t, 3> liveByPriority{};
+    };
+
+    ParticleBudget() = default;
+    explicit ParticleBudget(const Settings& settings);
+
+    void setSettings(const Settings& settings);
+    [[nodiscard]] const Settings& settings() const noexcept { return m_settings; }
+
+    // nullopt disables distance scaling.
+    void setViewCenter(std::optional<glm::vec2> center) noexcept { m_viewCenter = center; }
+    [[nodiscard]] const std::optional<glm::vec2>& viewCenter() const noexcept { return m_viewCenter; }
+    [[nodiscard]] float spawnRateScale(const glm::vec2& position) const noexcept;
+
+    // Returns how many of `requested` particles `priority` may spawn now.
+    std::size_t acquire(std::size_t requested, ParticlePriority priority) noexcept;
+    // Counts particles that already exist, even past the cap.
+    void adopt(std::size_t count, ParticlePriority priority) noexcept;
+    void release(std::size_t count, ParticlePriority priority) noexcept;
+
+    [[nodiscard]] std::size_t live() const noexcept { return m_live; }
+    [[nodiscard]] std::size_t limit(ParticlePriority priority) const noexcept;
+    [[nodiscard]] Usage usage() const noexcept;
+    void resetCounters() noexcept;
+
+private:
+    Settings m_settings{};
+    std::optional<glm::vec2> m_viewCenter;
+    std::size_t m_live{0};
+    std::size_t m_peak{0};
+    std::size_t m_granted{0};
+    std::size_t m_denied{0};
+    std::array<std::size_t, 3> m_liveByPriority{};
+};
+
+// An emitter's share of a ParticleBudget: tracks how many particles it holds
+// and returns them when it is destroyed or reassigned. Without a budget
+// every request is granted.
+class ParticleBudgetLease {
+public:
+    ParticleBudgetLease() = default;
+    // Adopts `held` particles the emitter already owns.
+    ParticleBudgetLease(std::shared_ptr<ParticleBudget> budget,
+                        ParticlePriority priority, std::size_t held = 0) noexcept;
+    ~ParticleBudgetLease();
+
+    ParticleBudgetLease(const ParticleBudgetLease&) = delete;
+    ParticleBudgetLease& operator=(const ParticleBudgetLease&) = delete;
+    ParticleBudgetLease(ParticleBudgetLease&& other) noexcept;
+    ParticleBudgetLease& operator=(ParticleBudgetLease&& other) noexcept;
+
+    [[nodiscard]] std::size_t acquire(std::size_t requested) noexcept;
+    // Returns everything held beyond `live`.
+    void sync(std::size_t live) noexcept;
+    [[nodiscard]] float spawnRateScale(const glm::vec2& position) const noexcept {
+        return m_budget ? m_budget->spawnRateScale(position) : 1.0f;
+    }
+
+    [[nodiscard]] const std::shared_ptr<ParticleBudget>& budget() const noexcept { return m_budget; }
+    [[nodiscard]] ParticlePriority priority() const noexcept { return m_priority; }
+    [[nodiscard]] std::size_t held() const noexcept { return m_held; }
+
+private:
+    void releaseAll() noexcept;
+
+    std::shared_ptr<ParticleBudget> m_budget;
+    ParticlePriority m_priority{ParticlePriority::Normal};
+    std::size_t m_held{0};
+};
+
+#endif // GL2D_PARTICLEBUDGET_HPP
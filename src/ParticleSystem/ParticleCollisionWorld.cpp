@@ -0,0 +1,386 @@
+//
+// ParticleCollisionWorld.cpp
+//
+
+#include "ParticleCollisionWorld.hpp"
+
+#include "Exceptions/SubsystemExceptions.hpp"
+#include "GameObjects/Components/TilemapComponent.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define GL2D_PARTICLE_COLLISION_SSE2 1
+#endif
+
+namespace {
+bool finite(const glm::vec2& value) {
+    return std::isfinite(value.x) && std::isfinite(value.y);
+}
+
+std::size_t clampedCell(float coordinate, std::size_t cells) {
+    const float clamped = std::clamp(std::floor(coordinate), 0.0f,
+                                     static_cast<float>(cells - 1));
+    return static_cast<std::size_t>(clamped);
+}
+} // namespace
+
+ParticleCollisionWorld::ParticleCollisionWorld(float staticCellSize)
+    : m_staticCellSize(staticCellSize) {
+    if (!std::isfinite(staticCellSize) || staticCellSize <= 0.0f) {
+        throw Engine::ParticleException(
+            "Particle collision cell size must be finite and positive");
+    }
+}
+
+void ParticleCollisionWorld::clear() noexcept {
+    m_tileLayers.clear();
+    m_boxes.clear();
+    m_grid = CellGrid{};
+    m_cellStates.clear();
+    m_cellOffsets.clear();
+    m_cellBoxes.clear();
+}
+
+void ParticleCollisionWorld::addTileLayer(std::shared_ptr<const TilemapData> data,
+                                          const glm::vec2& origin,
+                                          const glm::vec2& scale) {
+    if (!data || data->width <= 0 || data->height <= 0) {
+        return;
+    }
+    const glm::vec2 tileSize = data->tileSize * scale;
+    if (!finite(origin) || !finite(tileSize) || tileSize.x <= 0.0f || tileSize.y <= 0.0f) {
+        throw Engine::ParticleException(
+            "Particle collision tile layers need a finite origin and positive tile size");
+    }
+    // Rows the tile vector does not fully cover are treated as empty.
+    const std::size_t stride = static_cast<std::size_t>(data->width);
+    const std::size_t rows = std::min(static_cast<std::size_t>(data->height),
+                                      data->tiles.size() / stride);
+    if (rows == 0) {
+        return;
+    }
+    if (stride * rows > static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max())) {
+        throw Engine::ParticleException("Particle collision tile layer is too large");
+    }
+    TileLayer layer{};
+    layer.tiles = data->tiles.data();
+    layer.grid.origin = origin;
+    layer.grid.inverseCellSize = 1.0f / tileSize;
+    layer.grid.columns = static_cast<float>(stride);
+    layer.grid.rows = static_cast<float>(rows);
+    layer.grid.stride = static_cast<std::uint32_t>(stride);
+    layer.data = std::move(data);
+    m_tileLayers.push_back(std::move(layer));
+}
+
+void ParticleCollisionWorld::setBoxes(std::span<const glm::vec4> boxes) {
+    if (std::ranges::equal(boxes, m_boxes)) {
+        return;
+    }
+    for (const glm::vec4& box : boxes) {
+        if (!finite({box.x, box.y}) || !finite({box.z, box.w}) ||
+            box.x > box.z || box.y > box.w) {
+            throw Engine::ParticleException(
+                "Particle collision boxes must be finite with min <= max");
+        }
+    }
+    if (boxes.size() > std::numeric_limits<std::uint32_t>::max()) {
+        throw Engine::ParticleException("Too many particle collision boxes");
+    }
+    m_boxes.assign(boxes.begin(), boxes.end());
+    buildGrid();
+}
+
+void ParticleCollisionWorld::buildGrid() {
+    m_grid = CellGrid{};
+    m_cellStates.clear();
+    m_cellOffsets.clear();
+    m_cellBoxes.clear();
+    if (m_boxes.empty()) {
+        return;
+    }
+
+    glm::vec2 minPoint{std::numeric_limits<float>::max()};
+    glm::vec2 maxPoint{std::numeric_limits<float>::lowest()};
+    double meanThickness = 0.0;
+    for (const glm::vec4& box : m_boxes) {
+        minPoint = glm::min(minPoint, glm::vec2(box.x, box.y));
+        maxPoint = glm::max(maxPoint, glm::vec2(box.z, box.w));
+        meanThickness += std::min(box.z - box.x, box.w - box.y);
+    }
+    meanThickness /= static_cast<double>(m_boxes.size());
+    // Cells about as thick as a typical box leave most of them fully
+    // inside or outside the boxes, so few lookups test boxes one by one.
+    const glm::dvec2 extent = glm::dvec2(maxPoint) - glm::dvec2(minPoint);
+    double cellSize = std::clamp(meanThickness, m_staticCellSize / 32.0,
+                                 static_cast<double>(m_staticCellSize));
+    const auto entriesFor = [&](double size, double& columns, double& rows) {
+        columns = std::floor(extent.x / size) + 1.0;
+        rows = std::floor(extent.y / size) + 1.0;
+        double entries = 0.0;
+        for (const glm::vec4& box : m_boxes) {
+            entries += (std::floor((box.z - box.x) / size) + 2.0) *
+                       (std::floor((box.w - box.y) / size) + 2.0);
+        }
+        return entries;
+    };
+    double columns = 0.0;
+    double rows = 0.0;
+    while (entriesFor(cellSize, columns, rows) > static_cast<double>(kMaxStaticCells) * 4.0 ||
+           columns * rows > static_cast<double>(kMaxStaticCells)) {
+        cellSize *= 2.0;
+    }
+    m_grid.origin = minPoint;
+    m_grid.inverseCellSize = glm::vec2(static_cast<float>(1.0 / cellSize));
+    m_grid.columns = static_cast<float>(columns);
+    m_grid.rows = static_cast<float>(rows);
+    m_grid.stride = static_cast<std::uint32_t>(columns);
+    const auto gridColumns = static_cast<std::size_t>(columns);
+    const auto gridRows = static_cast<std::size_t>(rows);
+
+    struct CellRange {
+        std::size_t minX, minY, maxX, maxY;
+    };
+    const auto cellsOf = [&](const glm::vec4& box) {
+        const glm::vec2 inverse = m_grid.inverseCellSize;
+        return CellRange{clampedCell((box.x - minPoint.x) * inverse.x, gridColumns),
+                         clampedCell((box.y - minPoint.y) * inverse.y, gridRows),
+                         clampedCell((box.z - minPoint.x) * inverse.x, gridColumns),
+                         clampedCell((box.w - minPoint.y) * inverse.y, gridRows)};
+    };
+
+    m_cellStates.assign(gridColumns * gridRows, kEmptyCell);
+    std::vector<std::uint64_t> counts(m_cellStates.size() + 1, 0);
+    for (const glm::vec4& box : m_boxes) {
+        const CellRange range = cellsOf(box);
+        for (std::size_t y = range.minY; y <= range.maxY; ++y) {
+            const double cellMinY = minPoint.y + static_cast<double>(y) * cellSize;
+            const bool coversY = box.y <= cellMinY && box.w >= cellMinY + cellSize;
+            for (std::size_t x = range.minX; x <= range.maxX; ++x) {
+                const std::size_t cell = y * gridColumns + x;
+                const double cellMinX = minPoint.x + static_cast<double>(x) * cellSize;
+                if (coversY && box.x <= cellMinX && box.z >= cellMinX + cellSize) {
+                    m_cellStates[cell] = kSolidCell;
+                } else if (m_cellStates[cell] != kSolidCell) {
+                    m_cellStates[cell] = kPartialCell;
+                }
+                ++counts[cell + 1];
+            }
+        }
+    }
+    for (std::size_t i = 1; i < counts.size(); ++i) {
+        counts[i] += counts[i - 1];
+    }
+    if (counts.back() > std::numeric_limits<std::uint32_t>::max()) {
+        throw Engine::ParticleException("Particle collision grid has too many entries");
+    }
+    m_cellOffsets.assign(counts.begin(), counts.end());
+    m_cellBoxes.resize(counts.back());
+    std::vector<std::uint32_t> cursor(m_cellOffsets.begin(), m_cellOffsets.end() - 1);
+    for (std::uint32_t index = 0; index < m_boxes.size(); ++index) {
+        const CellRange range = cellsOf(m_boxes[index]);
+        for (std::size_t y = range.minY; y <= range.maxY; ++y) {
+            for (std::size_t x = range.minX; x <= range.maxX; ++x) {
+                m_cellBoxes[cursor[y * gridColumns + x]++] = index;
+            }
+        }
+    }
+}
+
+bool ParticleCollisionWorld::locate(const CellGrid& grid, float x, float y,
+                                    std::uint32_t& cell) noexcept {
+    const float column = (x - grid.origin.x) * grid.inverseCellSize.x;
+    const float row = (y - grid.origin.y) * grid.inverseCellSize.y;
+    // Written so NaN positions fail the test.
+    if (!(column >= 0.0f && row >= 0.0f && column < grid.columns && row < grid.rows)) {
+        cell = 0;
+        return false;
+    }
+    cell = static_cast<std::uint32_t>(row) * grid.stride + static_cast<std::uint32_t>(column);
+    return true;
+}
+
+void ParticleCollisionWorld::locate(const CellGrid& grid, const float* xs, const float* ys,
+                                    std::size_t count, std::uint32_t* cells,
+                                    std::uint8_t* inside) noexcept {
+    std::size_t i = 0;
+#if defined(GL2D_PARTICLE_COLLISION_SSE2)
+    // Scattered particles make scalar range checks mispredict; clamping with
+    // min/max keeps this loop free of data-dependent branches. maxps returns
+    // its second operand for NaN, so NaN clamps to cell 0 and reads outside.
+    const __m128 originX = _mm_set1_ps(grid.origin.x);
+    const __m128 originY = _mm_set1_ps(grid.origin.y);
+    const __m128 inverseX = _mm_set1_ps(grid.inverseCellSize.x);
+    const __m128 inverseY = _mm_set1_ps(grid.inverseCellSize.y);
+    const __m128 columns = _mm_set1_ps(grid.columns);
+    const __m128 rows = _mm_set1_ps(grid.rows);
+    const __m128 lastColumn = _mm_set1_ps(grid.columns - 1.0f);
+    const __m128 lastRow = _mm_set1_ps(grid.rows - 1.0f);
+    const __m128 zero = _mm_setzero_ps();
+    alignas(16) std::int32_t column[4];
+    alignas(16) std::int32_t row[4];
+    for (; i + 4 <= count; i += 4) {
+        const __m128 x = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(xs + i), originX), inverseX);
+        const __m128 y = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(ys + i), originY), inverseY);
+        const __m128 onGrid = _mm_and_ps(
+            _mm_and_ps(_mm_cmpge_ps(x, zero), _mm_cmplt_ps(x, columns)),
+            _mm_and_ps(_mm_cmpge_ps(y, zero), _mm_cmplt_ps(y, rows)));
+        _mm_store_si128(reinterpret_cast<__m128i*>(column),
+                        _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(x, zero), lastColumn)));
+        _mm_store_si128(reinterpret_cast<__m128i*>(row),
+                        _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(y, zero), lastRow)));
+        const int mask = _mm_movemask_ps(onGrid);
+        for (int k = 0; k < 4; ++k) {
+            cells[i + k] = static_cast<std::uint32_t>(row[k]) * grid.stride +
+                           static_cast<std::uint32_t>(column[k]);
+            inside[i + k] = static_cast<std::uint8_t>((mask >> k) & 1);
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+        inside[i] = static_cast<std::uint8_t>(locate(grid, xs[i], ys[i], cells[i]));
+    }
+}
+
+bool ParticleCollisionWorld::boxesContain(std::uint32_t cell, float x, float y) const noexcept {
+    for (std::uint32_t k = m_cellOffsets[cell]; k < m_cellOffsets[cell + 1]; ++k) {
+        const glm::vec4& box = m_boxes[m_cellBoxes[k]];
+        if (x >= box.x && x <= box.z && y >= box.y && y <= box.w) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ParticleCollisionWorld::solidAt(float x, float y) const noexcept {
+    std::uint32_t cell = 0;
+    for (const TileLayer& layer : m_tileLayers) {
+        if (locate(layer.grid, x, y, cell) && layer.tiles[cell] >= 0) {
+            return true;
+        }
+    }
+    if (m_boxes.empty() || !locate(m_grid, x, y, cell)) {
+        return false;
+    }
+    const std::uint8_t state = m_cellStates[cell];
+    return state == kPartialCell ? boxesContain(cell, x, y) : state == kSolidCell;
+}
+
+void ParticleCollisionWorld::solidMask(const float* xs, const float* ys, std::size_t count,
+                                       std::uint8_t* solid) const noexcept {
+    std::array<std::uint32_t, kBatch> cells;
+    std::array<std::uint8_t, kBatch> inside;
+    for (std::size_t first = 0; first < count; first += kBatch) {
+        const std::size_t n = std::min(kBatch, count - first);
+        const float* x = xs + first;
+        const float* y = ys + first;
+        std::uint8_t* out = solid + first;
+        std::fill_n(out, n, std::uint8_t{0});
+        // Layer by layer so each pass is a straight run of gathers.
+        for (const TileLayer& layer : m_tileLayers) {
+            locate(layer.grid, x, y, n, cells.data(), inside.data());
+            for (std::size_t i = 0; i < n; ++i) {
+                out[i] |= static_cast<std::uint8_t>(inside[i] & (layer.tiles[cells[i]] >= 0));
+            }
+        }
+        if (m_boxes.empty()) {
+            continue;
+        }
+        locate(m_grid, x, y, n, cells.data(), inside.data());
+        for (std::size_t i = 0; i < n; ++i) {
+            const auto state = static_cast<std::uint8_t>(
+                m_cellStates[cells[i]] * inside[i] * (out[i] ^ 1));
+            // Only points in cells partly covered by boxes branch off.
+            out[i] |= state == kPartialCell
+                          ? static_cast<std::uint8_t>(boxesContain(cells[i], x[i], y[i]))
+                          : static_cast<std::uint8_t>(state == kSolidCell);
+        }
+    }
+}
+
+void ParticleCollisionWorld::resolve(const ParticleCollisionColumns& c,
+                                     const ParticleCollisionParams& params, float dt,
+                                     std::size_t begin, std::size_t end) const noexcept {
+    if (params.response == ParticleCollisionResponse::None || empty()) {
+        return;
+    }
+    // Each pass over a chunk is one batched lookup; only the particles that
+    // hit something are gathered for the response.
+    std::array<std::uint8_t, kBatch * 3> solid;
+    std::array<std::uint32_t, kBatch> hit;
+    std::array<float, kBatch * 3> probeX;
+    std::array<float, kBatch * 3> probeY;
+    const float keep = 1.0f - params.friction;
+    for (std::size_t chunk = begin; chunk < end; chunk += kBatch) {
+        const std::size_t count = std::min(kBatch, end - chunk);
+        solidMask(c.positionX + chunk, c.positionY + chunk, count, solid.data());
+        std::size_t hits = 0;
+        for (std::size_t j = 0; j < count; ++j) {
+            hit[hits] = static_cast<std::uint32_t>(j);
+            hits += solid[j];
+        }
+        if (hits == 0) {
+            continue;
+        }
+
+        if (params.response == ParticleCollisionResponse::Kill) {
+            for (std::size_t k = 0; k < hits; ++k) {
+                const std::size_t i = chunk + hit[k];
+                c.age[i] = c.lifeTime[i];
+            }
+            continue;
+        }
+        if (params.response == ParticleCollisionResponse::Stick) {
+            for (std::size_t k = 0; k < hits; ++k) {
+                const std::size_t i = chunk + hit[k];
+                c.positionX[i] -= c.velocityX[i] * dt;
+                c.positionY[i] -= c.velocityY[i] * dt;
+                c.velocityX[i] = 0.0f;
+                c.velocityY[i] = 0.0f;
+            }
+            continue;
+        }
+
+        // Bounce probes per hit: the previous position, then each
+        // single-axis move from it. Which move enters the solid tells the
+        // surface normal.
+        for (std::size_t k = 0; k < hits; ++k) {
+            const std::size_t i = chunk + hit[k];
+            const float previousX = c.positionX[i] - c.velocityX[i] * dt;
+            const float previousY = c.positionY[i] - c.velocityY[i] * dt;
+            probeX[k] = previousX;
+            probeY[k] = previousY;
+            probeX[hits + k] = c.positionX[i];
+            probeY[hits + k] = previousY;
+            probeX[2 * hits + k] = previousX;
+            probeY[2 * hits + k] = c.positionY[i];
+        }
+        solidMask(probeX.data(), probeY.data(), hits * 3, solid.data());
+        for (std::size_t k = 0; k < hits; ++k) {
+            if (solid[k] != 0) {
+                continue; // embedded already; reflecting would not free it
+            }
+            const std::size_t i = chunk + hit[k];
+            const bool blockedX = solid[hits + k] != 0;
+            const bool blockedY = solid[2 * hits + k] != 0;
+            if (blockedX || !blockedY) {
+                c.positionX[i] = probeX[k];
+                c.velocityX[i] = -c.velocityX[i] * params.restitution;
+            } else {
+                c.velocityX[i] *= keep;
+            }
+            if (blockedY || !blockedX) {
+                c.positionY[i] = probeY[k];
+                c.velocityY[i] = -c.velocityY[i] * params.restitution;
+            } else {
+                c.velocityY[i] *= keep;
+            }
+        }
+    }
+}
@@ -0,0 +1,126 @@
+//
+// ParticleCollisionWorld.hpp
+//
+
+#ifndef GL2D_PARTICLECOLLISIONWORLD_HPP
+#define GL2D_PARTICLECOLLISIONWORLD_HPP
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "ParticleEmitterConfig.hpp"
+
+struct TilemapData;
+
+struct ParticleCollisionParams {
+    ParticleCollisionResponse response{ParticleCollisionResponse::None};
+    float restitution{0.4f};
+    float friction{0.2f};
+};
+
+// Mutable views of the pool columns collision reads and writes.
+struct ParticleCollisionColumns {
+    float* positionX;
+    float* positionY;
+    float* velocityX;
+    float* velocityY;
+    float* age;
+    const float* lifeTime;
+};
+
+// Read-only snapshot of solid world geometry for particles: tilemap layers
+// looked up directly by cell, plus static boxes binned into one dense grid
+// whose cells record whether they are empty, fully solid, or need the boxes
+// binned there tested. Particles are points; a particle collides when its
+// position is inside solid geometry. Queries are safe from several threads
+// once built.
+class ParticleCollisionWorld {
+public:
+    static constexpr float kDefaultStaticCellSize = 128.0f;
+    // Static grid cells track the boxes' typical thickness, bounded by the
+    // constructor's staticCellSize; they grow rather than exceed this many
+    // cells (or four times as many box entries).
+    static constexpr std::size_t kMaxStaticCells = std::size_t{1} << 20;
+
+    explicit ParticleCollisionWorld(float staticCellSize = kDefaultStaticCellSize);
+
+    void clear() noexcept;
+    // Tile layers are cheap to re-add every step; boxes keep their grid.
+    void clearTileLayers() noexcept { m_tileLayers.clear(); }
+    // Tiles with a non-negative index are solid. `origin` is the world
+    // position of tile (0, 0)'s minimum corner; `scale` multiplies the tile
+    // size (rotation is not supported). The tiles are read in place, so
+    // re-add the layer after resizing its data.
+    void addTileLayer(std::shared_ptr<const TilemapData> data, const glm::vec2& origin,
+                      const glm::vec2& scale = glm::vec2(1.0f));
+    // Replaces the static boxes ({minX, minY, maxX, maxY}) and rebuilds the
+    // grid, unless they are unchanged.
+    void setBoxes(std::span<const glm::vec4> boxes);
+
+    [[nodiscard]] bool empty() const noexcept { return m_tileLayers.empty() && m_boxes.empty(); }
+    [[nodiscard]] std::size_t tileLayerCount() const noexcept { return m_tileLayers.size(); }
+    [[nodiscard]] std::size_t boxCount() const noexcept { return m_boxes.size(); }
+    [[nodiscard]] bool solidAt(const glm::vec2& point) const noexcept {
+        return solidAt(point.x, point.y);
+    }
+
+    // Batched response kernel over particles [begin, end) that were just
+    // integrated by `dt`. A particle found inside solid geometry is killed,
+    // stuck at its previous position, or bounced: the axis whose motion
+    // entered the solid is reflected (both at corners) and the other loses
+    // `friction` of its speed. Particles already embedded at their previous
+    // position do not bounce.
+    void resolve(const ParticleCollisionColumns& columns, const ParticleCollisionParams& params,
+                 float dt, std::size_t begin, std::size_t end) const noexcept;
+
+private:
+    // Placement of a uniform grid of cells: tile layers and the box grid.
+    struct CellGrid {
+        glm::vec2 origin{0.0f};
+        glm::vec2 inverseCellSize{1.0f};
+        float columns{0.0f};
+        float rows{0.0f};
+        std::uint32_t stride{0};
+    };
+
+    struct TileLayer {
+        std::shared_ptr<const TilemapData> data;
+        const int* tiles{nullptr};
+        CellGrid grid;
+    };
+
+    enum CellState : std::uint8_t { kEmptyCell, kSolidCell, kPartialCell };
+
+    // Points are located and tested in blocks of this many.
+    static constexpr std::size_t kBatch = 256;
+
+    // Returns whether (x, y) lies on the grid and, if so, its cell.
+    static bool locate(const CellGrid& grid, float x, float y, std::uint32_t& cell) noexcept;
+    // Batched locate(); off-grid points get inside[i] == 0 and a clamped cell.
+    static void locate(const CellGrid& grid, const float* xs, const float* ys,
+                       std::size_t count, std::uint32_t* cells, std::uint8_t* inside) noexcept;
+
+    [[nodiscard]] bool solidAt(float x, float y) const noexcept;
+    [[nodiscard]] bool boxesContain(std::uint32_t cell, float x, float y) const noexcept;
+    // solid[i] = solidAt(xs[i], ys[i]) for `count` points.
+    void solidMask(const float* xs, const float* ys, std::size_t count,
+                   std::uint8_t* solid) const noexcept;
+    void buildGrid();
+
+    float m_staticCellSize;
+    std::vector<TileLayer> m_tileLayers;
+    std::vector<glm::vec4> m_boxes;
+    // CSR grid over the union of the boxes; each cell also records whether
+    // it is empty, fully inside a box, or needs its boxes tested.
+    CellGrid m_grid;
+    std::vector<std::uint8_t> m_cellStates;
+    std::vector<std::uint32_t> m_cellOffsets;
+    std::vector<std::uint32_t> m_cellBoxes;
+};
+
+#endif // GL2D_PARTICLECOLLISIONWORLD_HPP
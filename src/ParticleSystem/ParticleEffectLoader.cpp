@@ -86,6 +86,39 @@ glm::vec4 vec4OrDefault(const Utils::JsonValue& obj, const std::string& key, con
     return result;
 }
 
+ParticlePriority priorityOrDefault(const Utils::JsonValue& obj, const std::string& key,
+                                   ParticlePriority fallback) {
+    if (!obj.hasKey(key)) {
+        return fallback;
+    }
+    const auto& value = obj.at(key);
+    if (value.isString()) {
+        const std::string& name = value.asString();
+        if (name == "low") return ParticlePriority::Low;
+        if (name == "normal") return ParticlePriority::Normal;
+        if (name == "high") return ParticlePriority::High;
+    }
+    throw Engine::ParticleException(
+        "Particle effect field '" + key + "' must be \"low\", \"normal\" or \"high\"");
+}
+
+ParticleCollisionResponse collisionOrDefault(const Utils::JsonValue& obj, const std::string& key,
+                                             ParticleCollisionResponse fallback) {
+    if (!obj.hasKey(key)) {
+        return fallback;
+    }
+    const auto& value = obj.at(key);
+    if (value.isString()) {
+        const std::string& name = value.asString();
+        if (name == "none") return ParticleCollisionResponse::None;
+        if (name == "bounce") return ParticleCollisionResponse::Bounce;
+        if (name == "stick") return ParticleCollisionResponse::Stick;
+        if (name == "kill") return ParticleCollisionResponse::Kill;
+    }
+    throw Engine::ParticleException("Particle effect field '" + key +
+                                    "' must be \"none\", \"bounce\", \"stick\" or \"kill\"");
+}
+
 ParticleEffectDefinition parseEffect(const Utils::JsonValue& node) {
     if (!node.isObject()) {
         throw Engine::ParticleException("Particle effect must be an object");
@@ -101,6 +134,7 @@ ParticleEffectDefinition parseEffect(const Utils::JsonValue& node) {
 
     def.maxParticles = integerOrDefault<std::size_t>(
         node, "maxParticles", 128, 1'000'000);
+    def.priority = priorityOrDefault(node, "priority", def.priority);
     def.config.spawnRate = numberOrDefault(node, "spawnRate", def.config.spawnRate);
     def.config.burstCount = integerOrDefault<unsigned int>(
         node, "burstCount", def.config.burstCount,
@@ -126,6 +160,11 @@ ParticleEffectDefinition parseEffect(const Utils::JsonValue& node) {
     def.config.homingStrength = numberOrDefault(node, "homingStrength", def.config.homingStrength);
     def.config.orbitStrength = numberOrDefault(node, "orbitStrength", def.config.orbitStrength);
     def.config.spiralStrength = numberOrDefault(node, "spiralStrength", def.config.spiralStrength);
+    def.config.collisionResponse = collisionOrDefault(
+        node, "collision", def.config.collisionResponse);
+    def.config.restitution = numberOrDefault(node, "restitution", def.config.restitution);
+    def.config.collisionFriction = numberOrDefault(
+        node, "collisionFriction", def.config.collisionFriction);
     def.config.randomSeed = integerOrDefault<std::uint32_t>(
         node, "randomSeed", def.config.randomSeed,
         std::numeric_limits<std::uint32_t>::max());
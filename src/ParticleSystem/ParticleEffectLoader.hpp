@@ -7,11 +7,14 @@
 
 #include <string>
 #include <vector>
+#include "ParticleBudget.hpp"
 #include "ParticleEmitterConfig.hpp"
 
 struct ParticleEffectDefinition {
     std::string name;
     std::size_t maxParticles{128};
+    // "priority": "low" | "normal" | "high"
+    ParticlePriority priority{ParticlePriority::Normal};
     ParticleEmitterConfig config{};
 };
 
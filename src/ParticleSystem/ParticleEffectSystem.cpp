@@ -3,17 +3,33 @@
 //
 
 #include "ParticleEffectSystem.hpp"
-#include <algorithm>
-#include "Particle.hpp"
+#include "ParticleStepScheduler.hpp"
 #include "RenderingSystem/ParticleRenderer.hpp"
 #include "Exceptions/SubsystemExceptions.hpp"
 
 #include <cmath>
 
+std::unique_ptr<ParticleEmitter>
+ParticleEffectSystem::takeEmitter(const ParticleEffectDefinition &def) {
+    for (std::size_t i = m_retired.size(); i-- > 0;) {
+        if (m_retired[i]->particles().capacity() != def.maxParticles) {
+            continue;
+        }
+        m_retired[i]->reset(def.config);
+        std::unique_ptr<ParticleEmitter> emitter = std::move(m_retired[i]);
+        m_retired[i] = std::move(m_retired.back());
+        m_retired.pop_back();
+        return emitter;
+    }
+    return std::make_unique<ParticleEmitter>(def.maxParticles, def.config);
+}
+
 ParticleEmitter* ParticleEffectSystem::spawnOneShot(const glm::vec2 &position,
                                                     const ParticleEffectDefinition &def,
                                                     unsigned int burstOverride) {
-    auto emitter = std::make_unique<ParticleEmitter>(def.maxParticles, def.config);
+    auto emitter = takeEmitter(def);
+    emitter->setBudget(m_budget, def.priority);
+    emitter->setCollisionWorld(m_collisionWorld);
     emitter->setPosition(position);
     emitter->setTarget(position);
     const unsigned int burstCount = burstOverride > 0 ? burstOverride : def.config.burstCount;
@@ -26,33 +42,44 @@ ParticleEmitter* ParticleEffectSystem::spawnOneShot(const glm::vec2 &position,
     return raw;
 }
 
-void ParticleEffectSystem::update(float dt) {
+void ParticleEffectSystem::setCollisionWorld(const ParticleCollisionWorld* world) noexcept {
+    m_collisionWorld = world;
+    for (auto& effect : m_active) {
+        effect.emitter->setCollisionWorld(world);
+    }
+}
+
+void ParticleEffectSystem::update(float dt, Utils::WorkerPool* workers) {
     if (!std::isfinite(dt) || dt < 0.0f) {
         throw Engine::ParticleException(
             "ParticleEffectSystem::update requires finite, non-negative delta time");
     }
-    auto it = m_active.begin();
-    while (it != m_active.end()) {
-        auto &em = it->emitter;
-        em->update(dt);
-        const auto &particles = em->getParticles();
-        const bool anyAlive = std::any_of(particles.begin(), particles.end(),
-                                          [](const Particle &p) { return p.alive; });
-        if (!anyAlive) {
-            it = m_active.erase(it);
-        } else {
-            ++it;
+    m_stepping.clear();
+    for (auto& effect : m_active) {
+        effect.emitter->prepareStep(dt);
+        m_stepping.push_back(effect.emitter.get());
+    }
+    stepPreparedEmitters(m_stepping, workers);
+
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < m_active.size(); ++i) {
+        std::unique_ptr<ParticleEmitter>& emitter = m_active[i].emitter;
+        if (!emitter->isFinished()) {
+            if (kept != i) {
+                m_active[kept].emitter = std::move(emitter);
+            }
+            ++kept;
+        } else if (m_retired.size() < kMaxRetiredEffects) {
+            m_retired.push_back(std::move(emitter));
         }
     }
+    m_active.resize(kept);
 }
 
 void ParticleEffectSystem::render(Rendering::ParticleRenderer &renderer) const {
     for (const auto& fx : m_active) {
-        for (const Particle& particle : fx.emitter->getParticles()) {
-            if (particle.alive) {
-                renderer.submit({particle.position, particle.size,
-                                 particle.rotation, particle.color});
-            }
+        if (renderer.inView(fx.emitter->simulationBounds())) {
+            renderer.submit(fx.emitter->particles());
         }
     }
 }
@@ -12,20 +12,23 @@
 #include "ParticleEffectLoader.hpp"
 
 namespace Rendering { class ParticleRenderer; }
+namespace Utils { class WorkerPool; }
 
 class ParticleEffectSystem {
 public:
     ParticleEffectSystem() = default;
 
-    // Spawns a one-shot effect: creates an emitter, bursts, and tracks it until all particles die.
+    // Spawns a one-shot effect: takes an emitter (recycled from a finished
+    // effect of the same capacity when possible), bursts, and tracks it until all particles die.
     // Returns a non-owning pointer for repositioning. It becomes invalid as soon
     // as the final particle expires and the effect is removed during update().
     ParticleEmitter* spawnOneShot(const glm::vec2& position,
                                   const ParticleEffectDefinition& def,
                                   unsigned int burstOverride = 0);
 
-    // Call once per frame to advance and cull finished one-shots.
-    void update(float dt);
+    // Call once per frame to advance and cull finished one-shots. With
+    // `workers`, effects integrate in parallel with identical results.
+    void update(float dt, Utils::WorkerPool* workers = nullptr);
 
     // Render all active effects.
     void render(Rendering::ParticleRenderer& renderer) const;
@@ -33,12 +36,36 @@ public:
     // For positioning moving effects (e.g., attach to a moving target).
     void setEffectPosition(ParticleEmitter* emitter, const glm::vec2& pos);
 
+    // Effects spawned from now on draw from `budget` at their definition's
+    // priority; live effects keep their current budget.
+    void setBudget(std::shared_ptr<ParticleBudget> budget) noexcept { m_budget = std::move(budget); }
+    [[nodiscard]] const std::shared_ptr<ParticleBudget>& budget() const noexcept { return m_budget; }
+
+    // Live and future effects collide with `world` (not owned) when their
+    // config enables collision; nullptr detaches.
+    void setCollisionWorld(const ParticleCollisionWorld* world) noexcept;
+    [[nodiscard]] const ParticleCollisionWorld* collisionWorld() const noexcept {
+        return m_collisionWorld;
+    }
+
+    [[nodiscard]] std::size_t activeEffectCount() const noexcept { return m_active.size(); }
+    [[nodiscard]] std::size_t retiredEffectCount() const noexcept { return m_retired.size(); }
+
+    // Finished emitters kept for reuse by later spawns.
+    static constexpr std::size_t kMaxRetiredEffects = 32;
+
 private:
     struct ActiveEffect {
         std::unique_ptr<ParticleEmitter> emitter;
     };
 
+    std::unique_ptr<ParticleEmitter> takeEmitter(const ParticleEffectDefinition& def);
+
     std::vector<ActiveEffect> m_active;
+    std::vector<std::unique_ptr<ParticleEmitter>> m_retired;
+    std::vector<ParticleEmitter*> m_stepping;
+    std::shared_ptr<ParticleBudget> m_budget;
+    const ParticleCollisionWorld* m_collisionWorld{nullptr};
 };
 
 #endif //GL2D_PARTICLEEFFECTSYSTEM_HPP
@@ -3,9 +3,11 @@
 //
 
 #include "ParticleEmitter.hpp"
+#include "ParticleCollisionWorld.hpp"
 #include "Exceptions/SubsystemExceptions.hpp"
 #include <algorithm>
 #include <cmath>
+#include <limits>
 #include <stdexcept>
 
 namespace {
@@ -14,12 +16,34 @@ std::size_t validatedCapacity(std::size_t capacity,
     validateParticleEmitterConfig(capacity, config);
     return capacity;
 }
+
+constexpr glm::vec4 kEmptyBounds{std::numeric_limits<float>::max(),
+                                 std::numeric_limits<float>::max(),
+                                 std::numeric_limits<float>::lowest(),
+                                 std::numeric_limits<float>::lowest()};
+
+// Furthest a particle's edge can get from its spawn point within
+// `lifeTime`: speed is bounded by the initial speed plus every acceleration
+// term (drag only slows particles down).
+float particleReach(const ParticleEmitterConfig& config, float lifeTime) {
+    const float acceleration = glm::length(config.gravity) + config.homingStrength +
+                               config.orbitStrength + std::abs(config.spiralStrength);
+    const float size = config.maxSize * std::max(1.0f, config.endSizeMultiplier);
+    return config.maxSpeed * lifeTime + 0.5f * acceleration * lifeTime * lifeTime + size;
+}
+
+// lifetime, direction, speed, size, angular velocity
+constexpr std::uint64_t kRandomsPerSpawn = 5;
+
+glm::vec4 unite(const glm::vec4& a, const glm::vec4& b) {
+    return {std::min(a.x, b.x), std::min(a.y, b.y), std::max(a.z, b.z), std::max(a.w, b.w)};
+}
 }
 
 ParticleEmitter::ParticleEmitter(std::size_t maxParticles, const ParticleEmitterConfig &config)
 : m_config(config), m_particles(validatedCapacity(maxParticles, config)),
-  m_rng(config.randomSeed),
-  m_unitDist(0.0f,1.0f)
+  m_spawnWindow(kEmptyBounds), m_previousSpawnWindow(kEmptyBounds),
+  m_rng(config.randomSeed)
 {
 }
 
@@ -42,7 +66,11 @@ void ParticleEmitter::setTarget(const glm::vec2 &target) {
 }
 
 void ParticleEmitter::setConfig(const ParticleEmitterConfig &cfg) {
-    validateParticleEmitterConfig(m_particles.size(), cfg);
+    validateParticleEmitterConfig(m_particles.capacity(), cfg);
+    if (!m_particles.empty()) {
+        m_heldLifeTime = std::max(m_heldLifeTime, m_config.maxLifeTime);
+        m_heldReach = std::max(m_heldReach, particleReach(m_config, m_heldLifeTime));
+    }
     m_config=cfg;
     m_rng.seed(cfg.randomSeed);
 }
@@ -51,110 +79,241 @@ const ParticleEmitterConfig &ParticleEmitter::getConfig() const {
     return m_config;
 }
 
+void ParticleEmitter::reset(const ParticleEmitterConfig &cfg) {
+    validateParticleEmitterConfig(m_particles.capacity(), cfg);
+    clearParticles();
+    m_config = cfg;
+    m_rng.seed(cfg.randomSeed);
+    m_position = glm::vec2(0.0f);
+    m_target = glm::vec2(0.0f);
+    m_spawnAccumulator = 0.0;
+    m_emitting = true;
+    m_stepDt = 0.0f;
+    m_skippedSeconds = 0.0;
+    m_skippedSteps = 0;
+    resetSpawnWindows();
+}
+
+void ParticleEmitter::setBudget(std::shared_ptr<ParticleBudget> budget,
+                                ParticlePriority priority) {
+    if (budget == m_budget.budget() && priority == m_budget.priority()) {
+        return;
+    }
+    // Released first so a priority change never counts the particles twice.
+    m_budget = ParticleBudgetLease();
+    m_budget = ParticleBudgetLease(std::move(budget), priority, m_particles.size());
+}
+
 void ParticleEmitter::update(float dt) {
+    prepareStep(dt);
+    stepRange(0, m_particles.size());
+    finishStep();
+}
+
+void ParticleEmitter::prepareStep(float dt) {
     if (!std::isfinite(dt) || dt < 0.0f) {
         throw Engine::ParticleException(
             "ParticleEmitter::update requires finite, non-negative delta time");
     }
+    m_stepDt = dt;
     if (dt == 0.0f) {
         return;
     }
+    advanceSpawnWindow(dt);
     if(m_emitting && m_config.spawnRate>0.0f){
-        const std::size_t available = m_particles.size() - m_liveParticleCount;
+        const std::size_t available = m_particles.capacity() - m_particles.size();
+        const double rate = static_cast<double>(m_config.spawnRate) *
+                            m_budget.spawnRateScale(m_position);
         const double produced = std::min(
-            m_spawnAccumulator + static_cast<double>(m_config.spawnRate) * dt,
+            m_spawnAccumulator + rate * dt,
             static_cast<double>(available) + 1.0);
         const double wholeParticles = std::floor(produced);
         m_spawnAccumulator = produced - wholeParticles;
         const std::size_t toSpawn = std::min(
             static_cast<std::size_t>(wholeParticles), available);
-        for(std::size_t i=0; i<toSpawn; ++i){
-            if (!spawnOne()) break;
-        }
+        spawn(toSpawn);
     }
-    for(auto& p: m_particles){
-        if(!p.alive) continue;
-        p.age+=dt;
-        if(p.age>=p.lifeTime){
-            p.alive= false;
-            --m_liveParticleCount;
-            continue;
-        }
-        p.velocity+=p.acceleration*dt;
-        if(m_config.drag>0.0f){
-            const float factor=std::exp(-m_config.drag*dt);
-            p.velocity*=factor;
-        }
-        // Steering behaviors
-        const glm::vec2 toTarget = m_target - p.position;
-        const float dist2 = glm::dot(toTarget, toTarget);
-        if(dist2 > 0.0001f){
-            const float invLen = 1.0f / std::sqrt(dist2);
-            const glm::vec2 dir = toTarget * invLen;
-            if(m_config.homingStrength>0.0f){
-                p.velocity += dir * (m_config.homingStrength * dt);
-            }
-            if(m_config.orbitStrength>0.0f){
-                const glm::vec2 tangential{-dir.y, dir.x};
-                p.velocity += tangential * (m_config.orbitStrength * dt);
-            }
-            if(m_config.spiralStrength!=0.0f){
-                p.velocity -= dir * (m_config.spiralStrength * dt);
-            }
+    m_step.gravity = m_config.gravity;
+    m_step.dragFactor = m_config.drag > 0.0f ? std::exp(-m_config.drag * dt) : 1.0f;
+    m_step.target = m_target;
+    m_step.homingStrength = m_config.homingStrength;
+    m_step.orbitStrength = m_config.orbitStrength;
+    m_step.spiralStrength = m_config.spiralStrength;
+    m_step.startColor = m_config.startColor;
+    m_step.endColor = m_config.endColor;
+    m_step.endSizeMultiplier = m_config.endSizeMultiplier;
+}
+
+void ParticleEmitter::stepRange(std::size_t begin, std::size_t end) noexcept {
+    if (m_stepDt > 0.0f) {
+        m_particles.step(m_step, m_stepDt, begin, end);
+        if (m_collisionWorld && m_config.collisionResponse != ParticleCollisionResponse::None) {
+            m_particles.collide(*m_collisionWorld,
+                                {m_config.collisionResponse, m_config.restitution,
+                                 m_config.collisionFriction},
+                                m_stepDt, begin, end);
         }
-        p.position+=p.velocity*dt;
-        p.rotation+=p.angularVelocity*dt;
-        float t= p.age/p.lifeTime;
-        p.color=glm::mix(m_config.startColor, m_config.endColor, t);
-        p.size = p.initialSize * glm::mix(1.0f, m_config.endSizeMultiplier, t);
     }
 }
 
-void ParticleEmitter::burst(unsigned int count) {
-    const std::size_t available = m_particles.size() - m_liveParticleCount;
-    const std::size_t toSpawn = std::min<std::size_t>(count, available);
-    for (std::size_t i = 0; i < toSpawn; ++i) {
-        if (!spawnOne()) break;
+void ParticleEmitter::finishStep() noexcept {
+    if (m_stepDt > 0.0f) {
+        m_particles.removeExpired();
+        m_budget.sync(m_particles.size());
+    }
+    m_stepDt = 0.0f;
+    if (m_particles.empty()) {
+        m_heldLifeTime = 0.0f;
+        m_heldReach = 0.0f;
+    }
+}
+
+float ParticleEmitter::boundsLifeTime() const noexcept {
+    return std::max(m_config.maxLifeTime, m_heldLifeTime);
+}
+
+void ParticleEmitter::advanceSpawnWindow(float dt) noexcept {
+    m_windowElapsed += dt;
+    if (m_windowElapsed >= boundsLifeTime()) {
+        m_previousSpawnWindow = m_spawnWindow;
+        m_spawnWindow = kEmptyBounds;
+        m_windowElapsed = 0.0;
     }
 }
 
-bool ParticleEmitter::spawnOne() {
-    if (m_liveParticleCount >= m_particles.size()) {
+void ParticleEmitter::resetSpawnWindows() noexcept {
+    m_spawnWindow = kEmptyBounds;
+    m_previousSpawnWindow = kEmptyBounds;
+    m_windowElapsed = 0.0;
+}
+
+void ParticleEmitter::clearParticles() noexcept {
+    m_particles.clear();
+    m_budget.sync(0);
+    m_heldLifeTime = 0.0f;
+    m_heldReach = 0.0f;
+}
+
+glm::vec4 ParticleEmitter::simulationBounds() const noexcept {
+    const glm::vec4 spawns = unite(unite(m_spawnWindow, m_previousSpawnWindow),
+                                   {m_position, m_position});
+    const float reach = std::max(particleReach(m_config, boundsLifeTime()), m_heldReach);
+    return spawns + glm::vec4(-reach, -reach, reach, reach);
+}
+
+void ParticleEmitter::skip(float dt) {
+    if (!std::isfinite(dt) || dt < 0.0f) {
+        throw Engine::ParticleException(
+            "ParticleEmitter::skip requires finite, non-negative delta time");
+    }
+    if (dt == 0.0f) {
+        return;
+    }
+    m_skippedSeconds += dt;
+    ++m_skippedSteps;
+    advanceSpawnWindow(dt);
+    if (!m_particles.empty() && m_skippedSeconds >= boundsLifeTime()) {
+        clearParticles();
+        resetSpawnWindows();
+    }
+    if (m_emitting && m_config.spawnRate > 0.0f) {
+        // Replayed spawns will come from here.
+        m_spawnWindow = unite(m_spawnWindow, {m_position, m_position});
+    }
+}
+
+void ParticleEmitter::defer(float dt) {
+    if (!std::isfinite(dt) || dt < 0.0f) {
+        throw Engine::ParticleException(
+            "ParticleEmitter::defer requires finite, non-negative delta time");
+    }
+    if (dt > 0.0f) {
+        m_skippedSeconds += dt;
+        ++m_skippedSteps;
+    }
+}
+
+void ParticleEmitter::trimSkippedTime() noexcept {
+    if (m_skippedSteps == 0) {
+        return;
+    }
+    const double dt = m_skippedSeconds / static_cast<double>(m_skippedSteps);
+    if (!m_emitting || m_config.spawnRate <= 0.0f) {
+        // Nothing new spawns, so only survivors need catching up.
+        if (m_particles.empty()) {
+            m_skippedSeconds = 0.0;
+            m_skippedSteps = 0;
+        }
+        return;
+    }
+    const double window = std::ceil(static_cast<double>(boundsLifeTime()) / dt);
+    if (static_cast<double>(m_skippedSteps) > window) {
+        // Everything alive now was spawned within the last lifetime.
+        m_particles.clear();
+        m_budget.sync(0);
+        m_skippedSteps = static_cast<std::size_t>(window);
+        m_skippedSeconds = dt * window;
+    }
+}
+
+bool ParticleEmitter::prepareSkippedStep() {
+    trimSkippedTime();
+    if (m_skippedSteps == 0) {
         return false;
     }
-    std::size_t index = m_nextFreeIndex;
-    while (m_particles[index].alive) {
-        index = (index + 1) % m_particles.size();
-    }
-    m_nextFreeIndex = (index + 1) % m_particles.size();
-    Particle& p=m_particles[index];
-    p.alive=true;
-    ++m_liveParticleCount;
-    p.age=0.0f;
-
-    float lifeRange=m_config.maxLifeTime-m_config.minLifeTime;
-    p.lifeTime=m_config.minLifeTime+m_unitDist(m_rng)*lifeRange;
-    float baseDir=m_config.direction;
-    float halfSpread=m_config.spread*0.5f;
-    float angle=baseDir+(m_unitDist(m_rng)* 2.0f-1.0f)*halfSpread;
-    float speedRange=m_config.maxSpeed-m_config.minSpeed;
-    float speed=m_config.minSpeed+m_unitDist(m_rng)*speedRange;
-
-    glm::vec2 dir=glm::normalize(glm::vec2(glm::cos(angle),glm::sin(angle)));
-    p.position=m_position;
-    p.velocity=dir*speed;
-    p.acceleration=m_config.gravity;
-
-    float sizeRange=m_config.maxSize-m_config.minSize;
-    float size=m_config.minSize+m_unitDist(m_rng)*sizeRange;
-    p.size=glm::vec2(size);
-    p.initialSize = p.size;
-
-    p.rotation=0.0f;
-    const float angularRange = m_config.maxAngularVelocity -
-                               m_config.minAngularVelocity;
-    p.angularVelocity = m_config.minAngularVelocity +
-                        m_unitDist(m_rng) * angularRange;
-    p.color=m_config.startColor;
+    const float dt = static_cast<float>(m_skippedSeconds / static_cast<double>(m_skippedSteps));
+    if (--m_skippedSteps == 0) {
+        m_skippedSeconds = 0.0;
+    } else {
+        m_skippedSeconds -= dt;
+    }
+    prepareStep(dt);
     return true;
 }
+
+void ParticleEmitter::fastForward() {
+    while (prepareSkippedStep()) {
+        stepRange(0, m_particles.size());
+        finishStep();
+    }
+}
+
+void ParticleEmitter::burst(unsigned int count) {
+    spawn(count);
+}
+
+std::size_t ParticleEmitter::spawn(std::size_t count) {
+    count = std::min(count, m_particles.capacity() - m_particles.size());
+    if (count > 0) {
+        count = m_budget.acquire(count);
+    }
+    if (count == 0) {
+        return 0;
+    }
+    m_spawnWindow = unite(m_spawnWindow, {m_position, m_position});
+    const float lifeRange = m_config.maxLifeTime - m_config.minLifeTime;
+    const float halfSpread = m_config.spread * 0.5f;
+    const float speedRange = m_config.maxSpeed - m_config.minSpeed;
+    const float sizeRange = m_config.maxSize - m_config.minSize;
+    const float angularRange = m_config.maxAngularVelocity - m_config.minAngularVelocity;
+
+    // Every spawn owns a fixed slice of the stream, so the batch has no
+    // serial dependency through the generator.
+    const std::uint64_t first = m_rng.counter();
+    for (std::size_t i = 0; i < count; ++i) {
+        const std::uint64_t base = first + i * kRandomsPerSpawn;
+        Particle p{};
+        p.lifeTime = m_config.minLifeTime + m_rng.unitAt(base) * lifeRange;
+        const float angle = m_config.direction + (m_rng.unitAt(base + 1) * 2.0f - 1.0f) * halfSpread;
+        const float speed = m_config.minSpeed + m_rng.unitAt(base + 2) * speedRange;
+        p.position = m_position;
+        p.velocity = glm::vec2(glm::cos(angle), glm::sin(angle)) * speed;
+        p.size = m_config.minSize + m_rng.unitAt(base + 3) * sizeRange;
+        p.initialSize = p.size;
+        p.angularVelocity = m_config.minAngularVelocity + m_rng.unitAt(base + 4) * angularRange;
+        p.color = m_config.startColor;
+        m_particles.push(p);
+    }
+    m_rng.discard(count * kRandomsPerSpawn);
+    return count;
+}
@@ -4,10 +4,13 @@
 
 #ifndef GL2D_PARTICLEEMITTER_HPP
 #define GL2D_PARTICLEEMITTER_HPP
+#include <memory>
 #include <vector>
-#include <random>
+#include "CounterRandom.hpp"
+#include "ParticleBudget.hpp"
 #include "ParticleEmitterConfig.hpp"
 #include "Particle.hpp"
+#include "ParticlePool.hpp"
 
 class ParticleEmitter {
 public:
@@ -28,27 +31,105 @@ public:
     void setTarget(const glm::vec2& target);
     void setConfig(const ParticleEmitterConfig& cfg);
     const ParticleEmitterConfig& getConfig() const;
-    const std::vector<Particle>& getParticles() const { return m_particles; }
-    [[nodiscard]] std::size_t liveParticleCount() const noexcept { return m_liveParticleCount; }
-    [[nodiscard]] bool isFinished() const noexcept { return m_liveParticleCount == 0; }
+    // Returns the emitter to its freshly constructed state under `cfg`,
+    // keeping its particle storage and budget for reuse.
+    void reset(const ParticleEmitterConfig& cfg);
+
+    // Spawns (bursts included) draw from `budget` at `priority` and spawn
+    // rates scale with distance from its view center. Live particles count
+    // against the new budget at once; nullptr detaches.
+    void setBudget(std::shared_ptr<ParticleBudget> budget,
+                   ParticlePriority priority = ParticlePriority::Normal);
+    [[nodiscard]] const std::shared_ptr<ParticleBudget>& budget() const noexcept {
+        return m_budget.budget();
+    }
+    [[nodiscard]] ParticlePriority priority() const noexcept { return m_budget.priority(); }
+    // Geometry particles collide with when the config's collisionResponse
+    // is not None. Not owned; it must outlive the emitter or be detached
+    // with nullptr, and must not change while a step is in flight.
+    void setCollisionWorld(const ParticleCollisionWorld* world) noexcept { m_collisionWorld = world; }
+    [[nodiscard]] const ParticleCollisionWorld* collisionWorld() const noexcept {
+        return m_collisionWorld;
+    }
+    // Live particles only, densely packed; order changes as particles expire.
+    const ParticlePool& particles() const noexcept { return m_particles; }
+    [[nodiscard]] std::size_t liveParticleCount() const noexcept { return m_particles.size(); }
+    [[nodiscard]] bool isFinished() const noexcept { return m_particles.empty(); }
     void setEmitting(bool emitting) noexcept { m_emitting = emitting; }
     [[nodiscard]] bool isEmitting() const noexcept { return m_emitting; }
     void update(float dt);
     void burst(unsigned  int count);
+
+    // Split form of update() for parallel schedulers. prepareStep() spawns
+    // (the emitter's only RNG use) and freezes the step parameters;
+    // stepRange() may then run concurrently on disjoint ranges of
+    // [0, liveParticleCount()); finishStep() removes expired particles.
+    // The result matches update() however the range is split.
+    void prepareStep(float dt);
+    void stepRange(std::size_t begin, std::size_t end) noexcept;
+    void finishStep() noexcept;
+
+    // Conservative world bounds {minX, minY, maxX, maxY} of every live
+    // particle and of anything spawned from the current position within one
+    // lifetime, derived from speed, acceleration and lifetime limits rather
+    // than particle positions.
+    [[nodiscard]] glm::vec4 simulationBounds() const noexcept;
+
+    // Offscreen level of detail. skip() records `dt` instead of simulating;
+    // particles expire wholesale once a full lifetime has been skipped.
+    // Catching up replays the skipped steps: spans no longer than one
+    // lifetime are replayed step by step (exact for an emitter that stayed
+    // put), longer ones replay only their final lifetime, which yields a
+    // statistically equivalent, deterministic state. A replayed step costs
+    // as much as a normal one, so catching up on a long span costs up to
+    // lifetime / dt steps.
+    void skip(float dt);
+    // Records `dt` to be replayed after the skipped steps, for an emitter
+    // that is still catching up and must not get ahead of its backlog.
+    void defer(float dt);
+    // Prepares the oldest skipped step like prepareStep(); returns false once
+    // nothing is left to replay. Finish it with stepRange()/finishStep() or
+    // stepPreparedEmitters(), which lets a caller spread a catch-up over
+    // several updates and across workers.
+    bool prepareSkippedStep();
+    // Replays every skipped step now, on the calling thread.
+    void fastForward();
+    [[nodiscard]] bool hasSkippedTime() const noexcept { return m_skippedSteps > 0; }
+    [[nodiscard]] std::size_t skippedSteps() const noexcept { return m_skippedSteps; }
 private:
     glm::vec2 m_position{0.0f,0.0f};
     ParticleEmitterConfig m_config;
-    std::vector<Particle> m_particles;
+    ParticlePool m_particles;
     double m_spawnAccumulator{0.0};
-    std::size_t m_nextFreeIndex{0};
-    std::size_t m_liveParticleCount{0};
     bool m_emitting{true};
     glm::vec2 m_target{0.0f,0.0f};
+    ParticleStepParams m_step{};
+    float m_stepDt{0.0f};
+
+    // Emitter positions that spawned particles during the current and the
+    // previous lifetime window; older spawns have expired.
+    glm::vec4 m_spawnWindow;
+    glm::vec4 m_previousSpawnWindow;
+    double m_windowElapsed{0.0};
+    // Lifetime and reach of particles spawned under an earlier config,
+    // held until the pool drains.
+    float m_heldLifeTime{0.0f};
+    float m_heldReach{0.0f};
+    double m_skippedSeconds{0.0};
+    std::size_t m_skippedSteps{0};
 
-    mutable std::mt19937 m_rng;
-    std::uniform_real_distribution<float> m_unitDist;
+    // Each spawn reads kRandomsPerSpawn consecutive values of this stream.
+    CounterRandom m_rng;
+    ParticleBudgetLease m_budget;
+    const ParticleCollisionWorld* m_collisionWorld{nullptr};
 
-    bool spawnOne();
+    // Spawns up to `count` particles; returns how many fit.
+    std::size_t spawn(std::size_t count);
+    [[nodiscard]] float boundsLifeTime() const noexcept;
+    void advanceSpawnWindow(float dt) noexcept;
+    void trimSkippedTime() noexcept;
+    void resetSpawnWindows() noexcept;
+    void clearParticles() noexcept;
 };
 
 
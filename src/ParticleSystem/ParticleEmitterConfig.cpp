@@ -28,7 +28,8 @@ void validateParticleEmitterConfig(std::size_t capacity,
         config.minSize, config.maxSize, config.endSizeMultiplier,
         config.minAngularVelocity, config.maxAngularVelocity,
         config.gravity.x, config.gravity.y, config.drag,
-        config.homingStrength, config.orbitStrength, config.spiralStrength
+        config.homingStrength, config.orbitStrength, config.spiralStrength,
+        config.restitution, config.collisionFriction
     };
     if (!std::ranges::all_of(values, [](float value) { return std::isfinite(value); })) {
         throw Engine::ParticleException(
@@ -62,6 +63,14 @@ void validateParticleEmitterConfig(std::size_t capacity,
         throw Engine::ParticleException(
             "Particle drag, homing, and orbit strengths cannot be negative");
     }
+    if (config.restitution < 0.0f || config.restitution > 1.0f ||
+        config.collisionFriction < 0.0f || config.collisionFriction > 1.0f) {
+        throw Engine::ParticleException(
+            "Particle restitution and collision friction must be within [0, 1]");
+    }
+    if (config.collisionResponse > ParticleCollisionResponse::Kill) {
+        throw Engine::ParticleException("Particle collision response is unknown");
+    }
     if (!finiteColor(config.startColor) || !finiteColor(config.endColor)) {
         throw Engine::ParticleException(
             "Particle colors require non-negative finite RGB and alpha in [0, 1]");
@@ -8,6 +8,14 @@
 #include <cstdint>
 #include <cstddef>
 
+// What a particle does on entering solid world geometry.
+enum class ParticleCollisionResponse : std::uint8_t {
+    None,    // collision disabled (default)
+    Bounce,  // reflect off the surface it crossed
+    Stick,   // stop at the surface for the rest of its life
+    Kill     // expire immediately
+};
+
 struct ParticleEmitterConfig{
     float spawnRate{50.0f};
     unsigned int burstCount{0};
@@ -39,6 +47,12 @@ struct ParticleEmitterConfig{
     float orbitStrength{0.0f};    // Tangential push around target point
     float spiralStrength{0.0f};   // Radial push (outward if positive) from target point
 
+    // Opt-in collision against the ParticleCollisionWorld the owning system
+    // provides (tilemaps and static colliders).
+    ParticleCollisionResponse collisionResponse{ParticleCollisionResponse::None};
+    float restitution{0.4f};          // Bounce: share of normal speed kept
+    float collisionFriction{0.2f};    // Bounce: share of tangential speed lost
+
     // Stable by default so fixed-step replays and tests reproduce exactly.
     std::uint32_t randomSeed{0x6d2b79f5u};
 };
@@ -0,0 +1,357 @@
+//
+// ParticlePool.cpp
+//
+
+#include "ParticlePool.hpp"
+#include "ParticleCollisionWorld.hpp"
+#include "ParticleStorageCache.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define GL2D_PARTICLE_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define GL2D_PARTICLE_SSE2 1
+#endif
+
+namespace {
+// Below this squared distance steering is skipped, as a direction toward the
+// target is meaningless.
+constexpr float kSteeringEpsilon = 0.0001f;
+
+struct Columns {
+    float* positionX;
+    float* positionY;
+    float* velocityX;
+    float* velocityY;
+    float* rotation;
+    float* angularVelocity;
+    float* age;
+    const float* lifeTime;
+    const float* initialSize;
+    float* size;
+    float* red;
+    float* green;
+    float* blue;
+    float* alpha;
+};
+
+// Per-step constants, pre-multiplied by dt once per update.
+struct StepConstants {
+    float dt;
+    float gravityX;
+    float gravityY;
+    float drag;
+    float targetX;
+    float targetY;
+    float radial;  // (homing - spiral) * dt along the direction to the target
+    float orbit;   // orbit * dt along the tangent
+    bool steering;
+    float startColor[4];
+    float colorDelta[4];
+    float sizeDelta;  // endSizeMultiplier - 1
+};
+
+// Reference kernel; also handles the tail the vector kernel leaves over. The
+// operation order matches the vector kernel so results do not depend on a
+// particle's position within a vector.
+void stepScalar(const Columns& c, const StepConstants& k, std::size_t begin,
+                std::size_t end) noexcept {
+    for (std::size_t i = begin; i < end; ++i) {
+        const float age = c.age[i] + k.dt;
+        c.age[i] = age;
+        float vx = (c.velocityX[i] + k.gravityX * k.dt) * k.drag;
+        float vy = (c.velocityY[i] + k.gravityY * k.dt) * k.drag;
+        if (k.steering) {
+            const float dx = k.targetX - c.positionX[i];
+            const float dy = k.targetY - c.positionY[i];
+            const float distance2 = dx * dx + dy * dy;
+            if (distance2 > kSteeringEpsilon) {
+                const float inverseLength = 1.0f / std::sqrt(distance2);
+                const float dirX = dx * inverseLength;
+                const float dirY = dy * inverseLength;
+                vx = vx + (dirX * k.radial - dirY * k.orbit);
+                vy = vy + (dirY * k.radial + dirX * k.orbit);
+            }
+        }
+        c.velocityX[i] = vx;
+        c.velocityY[i] = vy;
+        c.positionX[i] = c.positionX[i] + vx * k.dt;
+        c.positionY[i] = c.positionY[i] + vy * k.dt;
+        c.rotation[i] = c.rotation[i] + c.angularVelocity[i] * k.dt;
+        const float t = age / c.lifeTime[i];
+        c.red[i] = k.startColor[0] + k.colorDelta[0] * t;
+        c.green[i] = k.startColor[1] + k.colorDelta[1] * t;
+        c.blue[i] = k.startColor[2] + k.colorDelta[2] * t;
+        c.alpha[i] = k.startColor[3] + k.colorDelta[3] * t;
+        c.size[i] = c.initialSize[i] * (1.0f + k.sizeDelta * t);
+    }
+}
+
+#if defined(GL2D_PARTICLE_AVX2) || defined(GL2D_PARTICLE_SSE2)
+#if defined(GL2D_PARTICLE_AVX2)
+struct Lanes {
+    using V = __m256;
+    static constexpr std::size_t width = 8;
+    static V load(const float* p) noexcept { return _mm256_loadu_ps(p); }
+    static void store(float* p, V v) noexcept { _mm256_storeu_ps(p, v); }
+    static V set(float x) noexcept { return _mm256_set1_ps(x); }
+    static V add(V a, V b) noexcept { return _mm256_add_ps(a, b); }
+    static V sub(V a, V b) noexcept { return _mm256_sub_ps(a, b); }
+    static V mul(V a, V b) noexcept { return _mm256_mul_ps(a, b); }
+    static V div(V a, V b) noexcept { return _mm256_div_ps(a, b); }
+    static V sqrt(V a) noexcept { return _mm256_sqrt_ps(a); }
+    static V greater(V a, V b) noexcept { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+    static V select(V mask, V a, V b) noexcept { return _mm256_blendv_ps(b, a, mask); }
+};
+#else
+struct Lanes {
+    using V = __m128;
+    static constexpr std::size_t width = 4;
+    static V load(const float* p) noexcept { return _mm_loadu_ps(p); }
+    static void store(float* p, V v) noexcept { _mm_storeu_ps(p, v); }
+    static V set(float x) noexcept { return _mm_set1_ps(x); }
+    static V add(V a, V b) noexcept { return _mm_add_ps(a, b); }
+    static V sub(V a, V b) noexcept { return _mm_sub_ps(a, b); }
+    static V mul(V a, V b) noexcept { return _mm_mul_ps(a, b); }
+    static V div(V a, V b) noexcept { return _mm_div_ps(a, b); }
+    static V sqrt(V a) noexcept { return _mm_sqrt_ps(a); }
+    static V greater(V a, V b) noexcept { return _mm_cmpgt_ps(a, b); }
+    static V select(V mask, V a, V b) noexcept {
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    }
+};
+#endif
+
+// Processes whole vectors from the front of [begin, end) and returns the
+// index where the scalar tail starts.
+std::size_t stepVector(const Columns& c, const StepConstants& k,
+                       std::size_t begin, std::size_t end) noexcept {
+    using L = Lanes;
+    const L::V dt = L::set(k.dt);
+    const L::V gravityX = L::set(k.gravityX * k.dt);
+    const L::V gravityY = L::set(k.gravityY * k.dt);
+    const L::V drag = L::set(k.drag);
+    const L::V targetX = L::set(k.targetX);
+    const L::V targetY = L::set(k.targetY);
+    const L::V radial = L::set(k.radial);
+    const L::V orbit = L::set(k.orbit);
+    const L::V epsilon = L::set(kSteeringEpsilon);
+    const L::V one = L::set(1.0f);
+    const L::V sizeDelta = L::set(k.sizeDelta);
+    const L::V start[4] = {L::set(k.startColor[0]), L::set(k.startColor[1]),
+                           L::set(k.startColor[2]), L::set(k.startColor[3])};
+    const L::V delta[4] = {L::set(k.colorDelta[0]), L::set(k.colorDelta[1]),
+                           L::set(k.colorDelta[2]), L::set(k.colorDelta[3])};
+    float* const color[4] = {c.red, c.green, c.blue, c.alpha};
+
+    const std::size_t vectorEnd = end - (end - begin) % L::width;
+    for (std::size_t i = begin; i < vectorEnd; i += L::width) {
+        const L::V age = L::add(L::load(c.age + i), dt);
+        L::store(c.age + i, age);
+        L::V vx = L::mul(L::add(L::load(c.velocityX + i), gravityX), drag);
+        L::V vy = L::mul(L::add(L::load(c.velocityY + i), gravityY), drag);
+        L::V px = L::load(c.positionX + i);
+        L::V py = L::load(c.positionY + i);
+        if (k.steering) {
+            const L::V dx = L::sub(targetX, px);
+            const L::V dy = L::sub(targetY, py);
+            const L::V distance2 = L::add(L::mul(dx, dx), L::mul(dy, dy));
+            const L::V near = L::greater(distance2, epsilon);
+            // Lanes at the target divide by a safe length and are discarded.
+            const L::V inverseLength =
+                L::div(one, L::sqrt(L::select(near, distance2, one)));
+            const L::V dirX = L::mul(dx, inverseLength);
+            const L::V dirY = L::mul(dy, inverseLength);
+            const L::V steeredX =
+                L::add(vx, L::sub(L::mul(dirX, radial), L::mul(dirY, orbit)));
+            const L::V steeredY =
+                L::add(vy, L::add(L::mul(dirY, radial), L::mul(dirX, orbit)));
+            vx = L::select(near, steeredX, vx);
+            vy = L::select(near, steeredY, vy);
+        }
+        L::store(c.velocityX + i, vx);
+        L::store(c.velocityY + i, vy);
+        L::store(c.positionX + i, L::add(px, L::mul(vx, dt)));
+        L::store(c.positionY + i, L::add(py, L::mul(vy, dt)));
+        L::store(c.rotation + i, L::add(L::load(c.rotation + i),
+                                        L::mul(L::load(c.angularVelocity + i), dt)));
+        const L::V t = L::div(age, L::load(c.lifeTime + i));
+        for (int channel = 0; channel < 4; ++channel) {
+            L::store(color[channel] + i,
+                     L::add(start[channel], L::mul(delta[channel], t)));
+        }
+        L::store(c.size + i, L::mul(L::load(c.initialSize + i),
+                                    L::add(one, L::mul(sizeDelta, t))));
+    }
+    return vectorEnd;
+}
+#else
+std::size_t stepVector(const Columns&, const StepConstants&, std::size_t begin,
+                       std::size_t) noexcept {
+    return begin;
+}
+#endif
+} // namespace
+
+ParticlePool::ParticlePool(std::size_t capacity) : m_capacity(capacity) {
+    if (capacity > std::numeric_limits<std::size_t>::max() / sizeof(float) / kColumnCount) {
+        throw std::length_error("ParticlePool capacity is too large");
+    }
+    if (capacity > 0) {
+        m_storage = ParticleStorageCache::shared().acquire(capacity * kColumnCount);
+    }
+    bindColumns();
+}
+
+ParticlePool::~ParticlePool() {
+    releaseStorage();
+}
+
+ParticlePool::ParticlePool(ParticlePool&& other) noexcept
+    : m_capacity(std::exchange(other.m_capacity, 0)),
+      m_liveCount(std::exchange(other.m_liveCount, 0)),
+      m_storage(std::move(other.m_storage)) {
+    bindColumns();
+    other.bindColumns();
+}
+
+ParticlePool& ParticlePool::operator=(ParticlePool&& other) noexcept {
+    if (this != &other) {
+        releaseStorage();
+        m_capacity = std::exchange(other.m_capacity, 0);
+        m_liveCount = std::exchange(other.m_liveCount, 0);
+        m_storage = std::move(other.m_storage);
+        bindColumns();
+        other.bindColumns();
+    }
+    return *this;
+}
+
+void ParticlePool::bindColumns() noexcept {
+    float* column = m_storage.get();
+    for (float** binding :
+         {&m_positionX, &m_positionY, &m_velocityX, &m_velocityY, &m_rotation,
+          &m_angularVelocity, &m_age, &m_lifeTime, &m_initialSizes, &m_sizes,
+          &m_red, &m_green, &m_blue, &m_alpha}) {
+        *binding = column;
+        if (column != nullptr) {
+            column += m_capacity;
+        }
+    }
+}
+
+void ParticlePool::releaseStorage() noexcept {
+    if (m_storage) {
+        ParticleStorageCache::shared().release(std::move(m_storage),
+                                               m_capacity * kColumnCount);
+    }
+    m_capacity = 0;
+    m_liveCount = 0;
+    bindColumns();
+}
+
+bool ParticlePool::push(const Particle& particle) noexcept {
+    if (full()) {
+        return false;
+    }
+    const std::size_t i = m_liveCount++;
+    m_positionX[i] = particle.position.x;
+    m_positionY[i] = particle.position.y;
+    m_velocityX[i] = particle.velocity.x;
+    m_velocityY[i] = particle.velocity.y;
+    m_rotation[i] = particle.rotation;
+    m_angularVelocity[i] = particle.angularVelocity;
+    m_age[i] = particle.age;
+    m_lifeTime[i] = particle.lifeTime;
+    m_initialSizes[i] = particle.initialSize;
+    m_sizes[i] = particle.size;
+    m_red[i] = particle.color.r;
+    m_green[i] = particle.color.g;
+    m_blue[i] = particle.color.b;
+    m_alpha[i] = particle.color.a;
+    return true;
+}
+
+Particle ParticlePool::particle(std::size_t index) const noexcept {
+    Particle p{};
+    p.position = position(index);
+    p.velocity = {m_velocityX[index], m_velocityY[index]};
+    p.rotation = m_rotation[index];
+    p.angularVelocity = m_angularVelocity[index];
+    p.lifeTime = m_lifeTime[index];
+    p.age = m_age[index];
+    p.size = m_sizes[index];
+    p.initialSize = m_initialSizes[index];
+    p.color = color(index);
+    return p;
+}
+
+std::size_t ParticlePool::update(const ParticleStepParams& params, float dt) noexcept {
+    step(params, dt, 0, m_liveCount);
+    return removeExpired();
+}
+
+void ParticlePool::step(const ParticleStepParams& params, float dt,
+                        std::size_t begin, std::size_t end) noexcept {
+    end = std::min(end, m_liveCount);
+    if (begin >= end) {
+        return;
+    }
+    const Columns columns{m_positionX, m_positionY, m_velocityX, m_velocityY,
+                          m_rotation, m_angularVelocity, m_age, m_lifeTime,
+                          m_initialSizes, m_sizes, m_red, m_green, m_blue, m_alpha};
+    const glm::vec4 colorDelta = params.endColor - params.startColor;
+    const StepConstants constants{
+        dt, params.gravity.x, params.gravity.y, params.dragFactor,
+        params.target.x, params.target.y,
+        (params.homingStrength - params.spiralStrength) * dt,
+        params.orbitStrength * dt,
+        params.homingStrength != 0.0f || params.orbitStrength != 0.0f ||
+            params.spiralStrength != 0.0f,
+        {params.startColor.r, params.startColor.g, params.startColor.b, params.startColor.a},
+        {colorDelta.r, colorDelta.g, colorDelta.b, colorDelta.a},
+        params.endSizeMultiplier - 1.0f};
+
+    const std::size_t tail = stepVector(columns, constants, begin, end);
+    stepScalar(columns, constants, tail, end);
+}
+
+void ParticlePool::collide(const ParticleCollisionWorld& world,
+                           const ParticleCollisionParams& params, float dt,
+                           std::size_t begin, std::size_t end) noexcept {
+    end = std::min(end, m_liveCount);
+    if (begin >= end) {
+        return;
+    }
+    world.resolve({m_positionX, m_positionY, m_velocityX, m_velocityY, m_age, m_lifeTime},
+                  params, dt, begin, end);
+}
+
+std::size_t ParticlePool::removeExpired() noexcept {
+    const std::size_t before = m_liveCount;
+    std::size_t i = 0;
+    while (i < m_liveCount) {
+        if (m_age[i] >= m_lifeTime[i]) {
+            moveParticle(--m_liveCount, i);
+        } else {
+            ++i;
+        }
+    }
+    return before - m_liveCount;
+}
+
+void ParticlePool::moveParticle(std::size_t from, std::size_t to) noexcept {
+    for (float* column :
+         {m_positionX, m_positionY, m_velocityX, m_velocityY, m_rotation,
+          m_angularVelocity, m_age, m_lifeTime, m_initialSizes, m_sizes,
+          m_red, m_green, m_blue, m_alpha}) {
+        column[to] = column[from];
+    }
+}
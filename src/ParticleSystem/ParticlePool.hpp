@@ -0,0 +1,129 @@
+//
+// ParticlePool.hpp
+//
+
+#ifndef GL2D_PARTICLEPOOL_HPP
+#define GL2D_PARTICLEPOOL_HPP
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <memory>
+
+#include "Particle.hpp"
+
+class ParticleCollisionWorld;
+struct ParticleCollisionParams;
+
+// Emitter-wide inputs to one ParticlePool::update step.
+struct ParticleStepParams {
+    glm::vec2 gravity{0.0f};
+    // Velocity scale applied this step, i.e. exp(-drag * dt).
+    float dragFactor{1.0f};
+    glm::vec2 target{0.0f};
+    float homingStrength{0.0f};
+    float orbitStrength{0.0f};
+    float spiralStrength{0.0f};
+    glm::vec4 startColor{1.0f};
+    glm::vec4 endColor{1.0f};
+    float endSizeMultiplier{1.0f};
+};
+
+// Read-only views of the columns a renderer needs, each `count` floats long.
+struct ParticleRenderColumns {
+    const float* positionX{nullptr};
+    const float* positionY{nullptr};
+    const float* size{nullptr};
+    const float* rotation{nullptr};
+    const float* red{nullptr};
+    const float* green{nullptr};
+    const float* blue{nullptr};
+    const float* alpha{nullptr};
+    std::size_t count{0};
+};
+
+// Structure-of-arrays particle storage. Live particles occupy [0, size())
+// with no holes: expired particles are swap-removed, so iteration never
+// branches on liveness and the update kernel streams each column with SIMD
+// (SSE2 on x86-64, AVX2 when the engine is built with it). All columns live
+// in one block drawn from ParticleStorageCache::shared() and returned to it
+// on destruction.
+class ParticlePool {
+public:
+    explicit ParticlePool(std::size_t capacity);
+    ~ParticlePool();
+
+    ParticlePool(const ParticlePool&) = delete;
+    ParticlePool& operator=(const ParticlePool&) = delete;
+    // The moved-from pool is left empty with zero capacity.
+    ParticlePool(ParticlePool&& other) noexcept;
+    ParticlePool& operator=(ParticlePool&& other) noexcept;
+
+    [[nodiscard]] std::size_t capacity() const noexcept { return m_capacity; }
+    [[nodiscard]] std::size_t size() const noexcept { return m_liveCount; }
+    [[nodiscard]] bool empty() const noexcept { return m_liveCount == 0; }
+    [[nodiscard]] bool full() const noexcept { return m_liveCount == m_capacity; }
+
+    // Appends a live particle; returns false when the pool is full.
+    bool push(const Particle& particle) noexcept;
+    void clear() noexcept { m_liveCount = 0; }
+
+    // Ages and integrates every live particle by `dt`, then swap-removes the
+    // ones that expired. Returns the number removed.
+    std::size_t update(const ParticleStepParams& params, float dt) noexcept;
+
+    // Split form of update() for callers that integrate disjoint ranges of
+    // one pool on several threads: step() each range, then removeExpired()
+    // once. Results do not depend on how the live range is split.
+    void step(const ParticleStepParams& params, float dt, std::size_t begin,
+              std::size_t end) noexcept;
+    std::size_t removeExpired() noexcept;
+    // Resolves particles in [begin, end) that step() moved into solid
+    // geometry; killed particles are removed by the next removeExpired().
+    void collide(const ParticleCollisionWorld& world, const ParticleCollisionParams& params,
+                 float dt, std::size_t begin, std::size_t end) noexcept;
+
+    // Snapshot of the live particle at `index` (< size()).
+    [[nodiscard]] Particle particle(std::size_t index) const noexcept;
+    [[nodiscard]] glm::vec2 position(std::size_t index) const noexcept {
+        return {m_positionX[index], m_positionY[index]};
+    }
+    [[nodiscard]] float particleSize(std::size_t index) const noexcept { return m_sizes[index]; }
+    [[nodiscard]] float rotation(std::size_t index) const noexcept { return m_rotation[index]; }
+    [[nodiscard]] glm::vec4 color(std::size_t index) const noexcept {
+        return {m_red[index], m_green[index], m_blue[index], m_alpha[index]};
+    }
+    // Valid until the pool is next modified.
+    [[nodiscard]] ParticleRenderColumns renderColumns() const noexcept {
+        return {m_positionX, m_positionY, m_sizes, m_rotation,
+                m_red, m_green, m_blue, m_alpha, m_liveCount};
+    }
+
+private:
+    static constexpr std::size_t kColumnCount = 14;
+
+    void moveParticle(std::size_t from, std::size_t to) noexcept;
+    void bindColumns() noexcept;
+    void releaseStorage() noexcept;
+
+    std::size_t m_capacity{0};
+    std::size_t m_liveCount{0};
+    std::unique_ptr<float[]> m_storage;
+    // Column views into m_storage, each m_capacity floats long.
+    float* m_positionX{nullptr};
+    float* m_positionY{nullptr};
+    float* m_velocityX{nullptr};
+    float* m_velocityY{nullptr};
+    float* m_rotation{nullptr};
+    float* m_angularVelocity{nullptr};
+    float* m_age{nullptr};
+    float* m_lifeTime{nullptr};
+    float* m_initialSizes{nullptr};
+    float* m_sizes{nullptr};
+    float* m_red{nullptr};
+    float* m_green{nullptr};
+    float* m_blue{nullptr};
+    float* m_alpha{nullptr};
+};
+
+#endif // GL2D_PARTICLEPOOL_HPP
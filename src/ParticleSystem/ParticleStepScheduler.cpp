@@ -0,0 +1,47 @@
+//
+// ParticleStepScheduler.cpp
+//
+
+#include "ParticleStepScheduler.hpp"
+
+#include "ParticleEmitter.hpp"
+#include "Utils/WorkerPool.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace {
+struct StepRange {
+    ParticleEmitter* emitter;
+    std::size_t begin;
+    std::size_t end;
+};
+}
+
+void stepPreparedEmitters(std::span<ParticleEmitter* const> emitters,
+                          Utils::WorkerPool* workers) {
+    if (workers == nullptr || workers->workerCount() == 0) {
+        for (ParticleEmitter* emitter : emitters) {
+            emitter->stepRange(0, emitter->liveParticleCount());
+            emitter->finishStep();
+        }
+        return;
+    }
+
+    std::vector<StepRange> ranges;
+    ranges.reserve(emitters.size());
+    for (ParticleEmitter* emitter : emitters) {
+        const std::size_t count = emitter->liveParticleCount();
+        for (std::size_t begin = 0; begin < count; begin += kParticleStepRangeSize) {
+            ranges.push_back({emitter, begin,
+                              std::min(count, begin + kParticleStepRangeSize)});
+        }
+    }
+    workers->parallelFor(ranges.size(), [&ranges](std::size_t index) {
+        const StepRange& range = ranges[index];
+        range.emitter->stepRange(range.begin, range.end);
+    });
+    for (ParticleEmitter* emitter : emitters) {
+        emitter->finishStep();
+    }
+}
@@ -0,0 +1,27 @@
+//
+// ParticleStepScheduler.hpp
+//
+
+#ifndef GL2D_PARTICLESTEPSCHEDULER_HPP
+#define GL2D_PARTICLESTEPSCHEDULER_HPP
+
+#include <cstddef>
+#include <span>
+
+class ParticleEmitter;
+namespace Utils { class WorkerPool; }
+
+// Emitters larger than this are integrated as several independent ranges.
+// A multiple of every SIMD width, so splitting never changes which kernel
+// path a particle takes.
+inline constexpr std::size_t kParticleStepRangeSize = 16384;
+
+// Integrates emitters whose prepareStep() has run, spreading emitters and
+// ranges of large emitters across `workers` (inline when null), then calls
+// finishStep() on each emitter in order. Each emitter's spawning and RNG
+// stay in prepareStep(), so the outcome is identical to calling update() on
+// every emitter serially.
+void stepPreparedEmitters(std::span<ParticleEmitter* const> emitters,
+                          Utils::WorkerPool* workers);
+
+#endif //GL2D_PARTICLESTEPSCHEDULER_HPP
@@ -0,0 +1,76 @@
+//
+// ParticleStorageCache.cpp
+//
+
+#include "ParticleStorageCache.hpp"
+
+#include <utility>
+
+ParticleStorageCache::ParticleStorageCache(std::size_t maxCachedBytes)
+    : m_maxCachedBytes(maxCachedBytes) {}
+
+ParticleStorageCache& ParticleStorageCache::shared() {
+    static ParticleStorageCache cache;
+    return cache;
+}
+
+std::unique_ptr<float[]> ParticleStorageCache::acquire(std::size_t floats) {
+    {
+        const std::lock_guard lock(m_mutex);
+        // Newest first: the most recently released block is the likeliest
+        // to still be in cache.
+        for (std::size_t i = m_blocks.size(); i-- > 0;) {
+            if (m_blocks[i].floats == floats) {
+                std::unique_ptr<float[]> data = std::move(m_blocks[i].data);
+                m_blocks.erase(m_blocks.begin() + static_cast<std::ptrdiff_t>(i));
+                m_cachedBytes -= floats * sizeof(float);
+                ++m_hits;
+                return data;
+            }
+        }
+        ++m_misses;
+    }
+    return std::make_unique_for_overwrite<float[]>(floats);
+}
+
+void ParticleStorageCache::release(std::unique_ptr<float[]> block,
+                                   std::size_t floats) noexcept {
+    const std::size_t bytes = floats * sizeof(float);
+    if (!block || bytes == 0 || bytes > m_maxCachedBytes) {
+        return;
+    }
+    const std::lock_guard lock(m_mutex);
+    evictTo(m_maxCachedBytes - bytes);
+    try {
+        m_blocks.push_back({std::move(block), floats});
+        m_cachedBytes += bytes;
+    } catch (...) {
+        // Out of memory for bookkeeping: the block is simply freed.
+    }
+}
+
+void ParticleStorageCache::setMaxCachedBytes(std::size_t bytes) {
+    const std::lock_guard lock(m_mutex);
+    m_maxCachedBytes = bytes;
+    evictTo(bytes);
+}
+
+void ParticleStorageCache::trim() noexcept {
+    const std::lock_guard lock(m_mutex);
+    evictTo(0);
+}
+
+ParticleStorageCache::Stats ParticleStorageCache::stats() const {
+    const std::lock_guard lock(m_mutex);
+    return {m_cachedBytes, m_blocks.size(), m_hits, m_misses};
+}
+
+void ParticleStorageCache::evictTo(std::size_t bytes) noexcept {
+    std::size_t evicted = 0;
+    while (evicted < m_blocks.size() && m_cachedBytes > bytes) {
+        m_cachedBytes -= m_blocks[evicted].floats * sizeof(float);
+        ++evicted;
+    }
+    m_blocks.erase(m_blocks.begin(),
+                   m_blocks.begin() + static_cast<std::ptrdiff_t>(evicted));
+}
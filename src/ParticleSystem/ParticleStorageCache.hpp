@@ -0,0 +1,63 @@
+//
+// ParticleStorageCache.hpp
+//
+
+#ifndef GL2D_PARTICLESTORAGECACHE_HPP
+#define GL2D_PARTICLESTORAGECACHE_HPP
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Recycles ParticlePool column storage. Pools return their block when they
+// are destroyed and the next pool of the same capacity reuses it, so effects
+// that spawn and expire every few frames stop hitting the heap. Blocks are
+// matched by exact size (emitters of one effect share a capacity); the oldest
+// blocks are freed once the cache would exceed its byte limit. Thread-safe.
+class ParticleStorageCache {
+public:
+    static constexpr std::size_t kDefaultMaxCachedBytes = std::size_t{16} << 20;
+
+    struct Stats {
+        std::size_t cachedBytes{0};
+        std::size_t cachedBlocks{0};
+        // Acquisitions served from the cache and from the heap.
+        std::size_t hits{0};
+        std::size_t misses{0};
+    };
+
+    explicit ParticleStorageCache(std::size_t maxCachedBytes = kDefaultMaxCachedBytes);
+
+    ParticleStorageCache(const ParticleStorageCache&) = delete;
+    ParticleStorageCache& operator=(const ParticleStorageCache&) = delete;
+
+    // The cache every ParticlePool draws from.
+    static ParticleStorageCache& shared();
+
+    // Uninitialized storage for `floats` values.
+    [[nodiscard]] std::unique_ptr<float[]> acquire(std::size_t floats);
+    void release(std::unique_ptr<float[]> block, std::size_t floats) noexcept;
+
+    void setMaxCachedBytes(std::size_t bytes);
+    void trim() noexcept;
+    [[nodiscard]] Stats stats() const;
+
+private:
+    struct Block {
+        std::unique_ptr<float[]> data;
+        std::size_t floats{0};
+    };
+
+    void evictTo(std::size_t bytes) noexcept;
+
+    mutable std::mutex m_mutex;
+    // Oldest first.
+    std::vector<Block> m_blocks;
+    std::size_t m_maxCachedBytes;
+    std::size_t m_cachedBytes{0};
+    std::size_t m_hits{0};
+    std::size_t m_misses{0};
+};
+
+#endif // GL2D_PARTICLESTORAGECACHE_HPP
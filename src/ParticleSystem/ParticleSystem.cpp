@@ -3,33 +3,55 @@
 //
 
 #include "ParticleSystem.hpp"
+#include "ParticleStepScheduler.hpp"
 #include "RenderingSystem/ParticleRenderer.hpp"
 #include "Exceptions/SubsystemExceptions.hpp"
 
 #include <cmath>
 
-ParticleEmitter *ParticleSystem::createEmitter(std::size_t maxParticles, const ParticleEmitterConfig &cfg) {
-    m_emitters.push_back(std::make_unique<ParticleEmitter>(maxParticles, cfg));
+ParticleEmitter *ParticleSystem::createEmitter(std::size_t maxParticles, const ParticleEmitterConfig &cfg,
+                                              ParticlePriority priority) {
+    auto emitter = std::make_unique<ParticleEmitter>(maxParticles, cfg);
+    emitter->setBudget(m_budget, priority);
+    emitter->setCollisionWorld(m_collisionWorld);
+    m_emitters.push_back(std::move(emitter));
     return m_emitters.back().get();
 }
 
-void ParticleSystem::update(float dt) {
+void ParticleSystem::setBudget(std::shared_ptr<ParticleBudget> budget) {
+    m_budget = std::move(budget);
+    for (auto &e: m_emitters) {
+        e->setBudget(m_budget, e->priority());
+    }
+}
+
+void ParticleSystem::setCollisionWorld(const ParticleCollisionWorld* world) noexcept {
+    m_collisionWorld = world;
+    for (auto &e: m_emitters) {
+        e->setCollisionWorld(world);
+    }
+}
+
+void ParticleSystem::update(float dt, Utils::WorkerPool* workers) {
     if (!std::isfinite(dt) || dt < 0.0f) {
         throw Engine::ParticleException(
             "ParticleSystem::update requires finite, non-negative delta time");
     }
+    std::vector<ParticleEmitter*> emitters;
+    emitters.reserve(m_emitters.size());
     for (auto &e: m_emitters) {
-        e->update(dt);
+        e->prepareStep(dt);
+        emitters.push_back(e.get());
     }
+    stepPreparedEmitters(emitters, workers);
 }
 
 void ParticleSystem::render(Rendering::ParticleRenderer &renderer) const {
     for(const auto& e: m_emitters){
-        for (const Particle& particle : e->getParticles()) {
-            if (particle.alive) {
-                renderer.submit({particle.position, particle.size,
-                                 particle.rotation, particle.color});
-            }
+        // Direct submission does not cull per particle, so whole emitters
+        // outside the renderer's view are skipped here.
+        if (renderer.inView(e->simulationBounds())) {
+            renderer.submit(e->particles());
         }
     }
 }
@@ -13,6 +13,7 @@
 namespace Rendering{
     class ParticleRenderer;
 }
+namespace Utils { class WorkerPool; }
 class ParticleSystem {
 public:
     ParticleSystem() = default;
@@ -27,11 +28,24 @@ public:
 
     ParticleSystem &operator=(ParticleSystem &&other) = delete;
 
-    ParticleEmitter* createEmitter(std::size_t maxParticles, const ParticleEmitterConfig& cfg);
-    void update(float dt);
+    ParticleEmitter* createEmitter(std::size_t maxParticles, const ParticleEmitterConfig& cfg,
+                                   ParticlePriority priority = ParticlePriority::Normal);
+    // Attaches every emitter, existing and future, to `budget`.
+    void setBudget(std::shared_ptr<ParticleBudget> budget);
+    [[nodiscard]] const std::shared_ptr<ParticleBudget>& budget() const noexcept { return m_budget; }
+    // Every emitter, existing and future, collides with `world` (not owned)
+    // when its config enables collision; nullptr detaches.
+    void setCollisionWorld(const ParticleCollisionWorld* world) noexcept;
+    [[nodiscard]] const ParticleCollisionWorld* collisionWorld() const noexcept {
+        return m_collisionWorld;
+    }
+    // With `workers`, emitters integrate in parallel with identical results.
+    void update(float dt, Utils::WorkerPool* workers = nullptr);
     void render(Rendering::ParticleRenderer& renderer) const;
 private:
     std::vector<std::unique_ptr<ParticleEmitter>> m_emitters;
+    std::shared_ptr<ParticleBudget> m_budget;
+    const ParticleCollisionWorld* m_collisionWorld{nullptr};
 };
 
 
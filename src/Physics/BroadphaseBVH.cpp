@@ -14,6 +14,30 @@ constexpr std::uint32_t kLeafCapacity = 4;
 float area(const AABB& bounds) {
     return bounds.width() * bounds.height();
 }
+
+// Slab test of the segment origin + t * delta, t in [0, 1], against bounds
+// grown by a small margin so ray casts grazing an edge are still reported.
+bool segmentTouches(const AABB& bounds, const glm::vec2& origin, const glm::vec2& delta) {
+    constexpr float margin = 1e-4f;
+    float tMin = 0.0f;
+    float tMax = 1.0f;
+    for (int axis = 0; axis < 2; ++axis) {
+        const float low = bounds.getMin()[axis] - margin;
+        const float high = bounds.getMax()[axis] + margin;
+        if (delta[axis] == 0.0f) {
+            if (origin[axis] < low || origin[axis] > high) return false;
+            continue;
+        }
+        const float inverse = 1.0f / delta[axis];
+        float t1 = (low - origin[axis]) * inverse;
+        float t2 = (high - origin[axis]) * inverse;
+        if (t1 > t2) std::swap(t1, t2);
+        tMin = std::max(tMin, t1);
+        tMax = std::min(tMax, t2);
+        if (tMin > tMax) return false;
+    }
+    return true;
+}
 }
 
 void BroadphaseBVH::build(const std::vector<Entry>& entries) {
@@ -113,6 +137,34 @@ void BroadphaseBVH::queryNode(std::uint32_t nodeIndex, const AABB& bounds,
     queryNode(node.right, bounds, output);
 }
 
+void BroadphaseBVH::querySegment(const glm::vec2& from, const glm::vec2& to,
+                                 std::vector<void*>& output) const {
+    if (m_nodes.empty()) {
+        return;
+    }
+    const glm::vec2 delta = to - from;
+    // Explicit stack; the tree is median-split, so its depth is logarithmic.
+    std::uint32_t stack[64];
+    std::size_t size = 0;
+    stack[size++] = 0;
+    while (size > 0) {
+        const Node& node = m_nodes[stack[--size]];
+        if (!segmentTouches(node.bounds, from, delta)) {
+            continue;
+        }
+        if (node.leaf()) {
+            for (std::uint32_t i = node.begin; i < node.end; ++i) {
+                if (segmentTouches(m_entries[i].value.bounds, from, delta)) {
+                    output.push_back(m_entries[i].value.user);
+                }
+            }
+            continue;
+        }
+        stack[size++] = node.right;
+        stack[size++] = node.left;
+    }
+}
+
 std::vector<BroadphaseBVH::Pair> BroadphaseBVH::overlappingPairs() const {
     std::vector<Pair> result;
     overlappingPairs(result);
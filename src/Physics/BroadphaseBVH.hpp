@@ -32,6 +32,10 @@ public:
     [[nodiscard]] bool empty() const noexcept { return m_entries.empty(); }
 
     void query(const AABB& bounds, std::vector<void*>& output) const;
+    // Appends entries whose bounds the segment from `from` to `to` touches;
+    // suited to line-of-sight and ray queries, whose bounding boxes are poor.
+    void querySegment(const glm::vec2& from, const glm::vec2& to,
+                      std::vector<void*>& output) const;
     [[nodiscard]] std::vector<Pair> overlappingPairs() const;
     // Appends into a caller-owned buffer so per-frame callers can reuse it.
     void overlappingPairs(std::vector<Pair>& output) const;
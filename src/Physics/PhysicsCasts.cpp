@@ -48,12 +48,7 @@ struct RayHitData {
 };
 
 bool shouldSkip(const ColliderEntry& entry, const PhysicsCasts::CastFilter& filter) {
-    if (!entry.collider) return true;
-    if (filter.ignore && entry.entity == filter.ignore) return true;
-    if (!filter.includeTriggers && entry.collider->isTrigger()) return true;
-    const uint32_t bit = 1u << entry.collider->getLayer();
-    if ((filter.layerMask & bit) == 0u) return true;
-    return false;
+    return !entry.collider || !PhysicsCasts::accepts(filter, entry.entity, *entry.collider);
 }
 
 std::vector<ColliderEntry> gatherColliders(const std::vector<std::unique_ptr<Entity>>& entities) {
@@ -269,6 +264,119 @@ glm::vec2 closestPointOnSegment(const glm::vec2& a, const glm::vec2& b, const gl
 
 namespace PhysicsCasts {
 
+bool accepts(const CastFilter& filter, const Entity* entity, const ACollider& collider) {
+    if (filter.ignore && entity == filter.ignore) return false;
+    if (!filter.includeTriggers && collider.isTrigger()) return false;
+    const uint32_t bit = 1u << collider.getLayer();
+    return (filter.layerMask & bit) != 0u;
+}
+
+bool rayCastCollider(const glm::vec2& origin,
+                     const glm::vec2& direction,
+                     float maxDistance,
+                     Entity* entity,
+                     ACollider& collider,
+                     CastHit& out) {
+    RayHitData data{};
+    bool found = false;
+    switch (collider.getType()) {
+        case ColliderType::AABB: {
+            auto* box = dynamic_cast<AABBCollider*>(&collider);
+            found = box && rayVsAabb(origin, direction, box->getAABB(), maxDistance, data);
+            break;
+        }
+        case ColliderType::CIRCLE: {
+            auto* circle = dynamic_cast<CircleCollider*>(&collider);
+            found = circle && rayVsCircle(origin, direction, circle->getAABB().center(),
+                                          circle->getWorldRadius(), maxDistance, data);
+            break;
+        }
+        case ColliderType::CAPSULE: {
+            auto* cap = dynamic_cast<CapsuleCollider*>(&collider);
+            found = cap && rayVsCapsule(origin, direction, maxDistance, cap->getWorldA(),
+                                        cap->getWorldB(), cap->getWorldRadius(), data);
+            break;
+        }
+        default:
+            break;
+    }
+    if (found) {
+        out = CastHit{true, data.point, data.normal, data.t, entity, &collider};
+    }
+    return found;
+}
+
+bool overlapCircleCollider(const glm::vec2& center,
+                           float radius,
+                           Entity* entity,
+                           ACollider& collider,
+                           CastHit& out) {
+    switch (collider.getType()) {
+        case ColliderType::AABB: {
+            const AABB box = collider.getAABB();
+            const glm::vec2 closest = glm::clamp(center, box.getMin(), box.getMax());
+            const glm::vec2 diff = center - closest;
+            const float dist2 = glm::dot(diff, diff);
+            if (dist2 > radius * radius) return false;
+            const float dist = std::sqrt(std::max(dist2, 0.0f));
+            glm::vec2 normal = safeNormal(diff, glm::vec2{1.0f, 0.0f});
+            glm::vec2 contact = closest;
+            float penetration = radius - dist;
+            if (dist <= kEpsilon) {
+                const float left = center.x - box.getMin().x;
+                const float right = box.getMax().x - center.x;
+                const float down = center.y - box.getMin().y;
+                const float up = box.getMax().y - center.y;
+                const float nearest = std::min({left, right, down, up});
+                penetration = radius + nearest;
+                if (nearest == left) {
+                    normal = {-1.0f, 0.0f};
+                    contact = {box.getMin().x, center.y};
+                } else if (nearest == right) {
+                    normal = {1.0f, 0.0f};
+                    contact = {box.getMax().x, center.y};
+                } else if (nearest == down) {
+                    normal = {0.0f, -1.0f};
+                    contact = {center.x, box.getMin().y};
+                } else {
+                    normal = {0.0f, 1.0f};
+                    contact = {center.x, box.getMax().y};
+                }
+            }
+            out = CastHit{true, contact, normal, penetration, entity, &collider};
+            return true;
+        }
+        case ColliderType::CIRCLE: {
+            const auto* circle = dynamic_cast<CircleCollider*>(&collider);
+            if (!circle) return false;
+            const glm::vec2 otherCenter = circle->getAABB().center();
+            const float otherRadius = circle->getWorldRadius();
+            const glm::vec2 diff = center - otherCenter;
+            const float dist = glm::length(diff);
+            const float sumR = radius + otherRadius;
+            if (dist > sumR) return false;
+            const glm::vec2 n = safeNormal(diff, glm::vec2{1.0f, 0.0f});
+            out = CastHit{true, otherCenter + n * otherRadius, n, sumR - dist, entity, &collider};
+            return true;
+        }
+        case ColliderType::CAPSULE: {
+            const auto* cap = dynamic_cast<CapsuleCollider*>(&collider);
+            if (!cap) return false;
+            const float capRadius = cap->getWorldRadius();
+            const glm::vec2 closest = closestPointOnSegment(cap->getWorldA(), cap->getWorldB(), center);
+            const glm::vec2 diff = center - closest;
+            const float dist = glm::length(diff);
+            const float sumR = radius + capRadius;
+            if (dist > sumR) return false;
+            const glm::vec2 n = safeNormal(diff, glm::vec2{1.0f, 0.0f});
+            out = CastHit{true, closest + n * capRadius, n, sumR - dist, entity, &collider};
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
 CastHit rayCast(const glm::vec2& origin,
                 const glm::vec2& direction,
                 float maxDistance,
@@ -288,43 +396,8 @@ CastHit rayCast(const glm::vec2& origin,
     const auto colliders = gatherColliders(entities);
     for (const auto& entry : colliders) {
         if (shouldSkip(entry, filter)) continue;
-
-        RayHitData data{};
-        switch (entry.collider->getType()) {
-            case ColliderType::AABB: {
-                auto* box = dynamic_cast<AABBCollider*>(entry.collider);
-                if (box && rayVsAabb(origin, dir, box->getAABB(), closest, data)) {
-                    closest = data.t;
-                    best = CastHit{true, data.point, data.normal, data.t, entry.entity, entry.collider};
-                }
-                break;
-            }
-            case ColliderType::CIRCLE: {
-                auto* circle = dynamic_cast<CircleCollider*>(entry.collider);
-                if (circle) {
-                    const AABB bounds = circle->getAABB();
-                    const glm::vec2 center = bounds.center();
-                    const float radius = circle->getWorldRadius();
-                    if (rayVsCircle(origin, dir, center, radius, closest, data)) {
-                        closest = data.t;
-                        best = CastHit{true, data.point, data.normal, data.t, entry.entity, entry.collider};
-                    }
-                }
-                break;
-            }
-            case ColliderType::CAPSULE: {
-                auto* cap = dynamic_cast<CapsuleCollider*>(entry.collider);
-                if (cap) {
-                    const float radius = cap->getWorldRadius();
-                    if (rayVsCapsule(origin, dir, closest, cap->getWorldA(), cap->getWorldB(), radius, data)) {
-                        closest = data.t;
-                        best = CastHit{true, data.point, data.normal, data.t, entry.entity, entry.collider};
-                    }
-                }
-                break;
-            }
-            default:
-                break;
+        if (rayCastCollider(origin, dir, closest, entry.entity, *entry.collider, best)) {
+            closest = best.distance;
         }
     }
 
@@ -485,79 +558,9 @@ std::vector<CastHit> overlapCircle(const glm::vec2& center,
     const auto colliders = gatherColliders(entities);
     for (const auto& entry : colliders) {
         if (shouldSkip(entry, filter)) continue;
-
-        switch (entry.collider->getType()) {
-            case ColliderType::AABB: {
-                const AABB box = entry.collider->getAABB();
-                const glm::vec2 closest = glm::clamp(center, box.getMin(), box.getMax());
-                const glm::vec2 diff = center - closest;
-                const float dist2 = glm::dot(diff, diff);
-                if (dist2 <= radius * radius) {
-                    const float dist = std::sqrt(std::max(dist2, 0.0f));
-                    glm::vec2 normal = safeNormal(diff, glm::vec2{1.0f, 0.0f});
-                    glm::vec2 contact = closest;
-                    float penetration = radius - dist;
-                    if (dist <= kEpsilon) {
-                        const float left = center.x - box.getMin().x;
-                        const float right = box.getMax().x - center.x;
-                        const float down = center.y - box.getMin().y;
-                        const float up = box.getMax().y - center.y;
-                        const float nearest = std::min({left, right, down, up});
-                        penetration = radius + nearest;
-                        if (nearest == left) {
-                            normal = {-1.0f, 0.0f};
-                            contact = {box.getMin().x, center.y};
-                        } else if (nearest == right) {
-                            normal = {1.0f, 0.0f};
-                            contact = {box.getMax().x, center.y};
-                        } else if (nearest == down) {
-                            normal = {0.0f, -1.0f};
-                            contact = {center.x, box.getMin().y};
-                        } else {
-                            normal = {0.0f, 1.0f};
-                            contact = {center.x, box.getMax().y};
-                        }
-                    }
-                    hits.push_back(CastHit{true, contact, normal, penetration,
-                                           entry.entity, entry.collider});
-                }
-                break;
-            }
-            case ColliderType::CIRCLE: {
-                const auto* circle = dynamic_cast<CircleCollider*>(entry.collider);
-                if (!circle) break;
-                const AABB bounds = circle->getAABB();
-                const glm::vec2 otherCenter = bounds.center();
-                const float otherRadius = circle->getWorldRadius();
-                const glm::vec2 diff = center - otherCenter;
-                const float dist = glm::length(diff);
-                const float sumR = radius + otherRadius;
-                if (dist <= sumR) {
-                    const glm::vec2 n = safeNormal(diff, glm::vec2{1.0f, 0.0f});
-                    const glm::vec2 contact = otherCenter + n * otherRadius;
-                    hits.push_back(CastHit{true, contact, n, sumR - dist, entry.entity, entry.collider});
-                }
-                break;
-            }
-            case ColliderType::CAPSULE: {
-                const auto* cap = dynamic_cast<CapsuleCollider*>(entry.collider);
-                if (!cap) break;
-                const glm::vec2 a = cap->getWorldA();
-                const glm::vec2 bPt = cap->getWorldB();
-                const float capRadius = cap->getWorldRadius();
-                const glm::vec2 closest = closestPointOnSegment(a, bPt, center);
-                const glm::vec2 diff = center - closest;
-                const float dist = glm::length(diff);
-                const float sumR = radius + capRadius;
-                if (dist <= sumR) {
-                    const glm::vec2 n = safeNormal(diff, glm::vec2{1.0f, 0.0f});
-                    const glm::vec2 contact = closest + n * capRadius;
-                    hits.push_back(CastHit{true, contact, n, sumR - dist, entry.entity, entry.collider});
-                }
-                break;
-            }
-            default:
-                break;
+        CastHit hit{};
+        if (overlapCircleCollider(center, radius, entry.entity, *entry.collider, hit)) {
+            hits.push_back(hit);
         }
     }
     return hits;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <glm/vec2.hpp>
 #include <memory>
 #include <vector>
@@ -56,4 +57,21 @@ std::vector<CastHit> overlapCircle(const glm::vec2& center,
                                    const std::vector<std::unique_ptr<Entity>>& entities,
                                    CastFilter filter = {});
 
+// Per-collider building blocks of the queries above, for callers that find
+// candidate colliders themselves (through a BroadphaseBVH, say). `direction`
+// must be unit length; a ray only hits within maxDistance. On a hit `out` is
+// filled in, naming `entity`, and true is returned.
+bool accepts(const CastFilter& filter, const Entity* entity, const ACollider& collider);
+bool rayCastCollider(const glm::vec2& origin,
+                     const glm::vec2& direction,
+                     float maxDistance,
+                     Entity* entity,
+                     ACollider& collider,
+                     CastHit& out);
+bool overlapCircleCollider(const glm::vec2& center,
+                           float radius,
+                           Entity* entity,
+                           ACollider& collider,
+                           CastHit& out);
+
 } // namespace PhysicsCasts
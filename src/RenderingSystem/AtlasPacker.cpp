@@ -0,0 +1,156 @@
+//
+// AtlasPacker.cpp
+//
+
+#include "AtlasPacker.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace Rendering {
+
+SkylinePacker::SkylinePacker(int width, int height)
+    : m_width(width), m_height(height) {
+    if (width <= 0 || height <= 0) {
+        throw std::invalid_argument("SkylinePacker page dimensions must be positive");
+    }
+    reset();
+}
+
+void SkylinePacker::reset() {
+    m_skyline.assign(1, Segment{0, 0, m_width});
+    m_usedArea = 0;
+}
+
+float SkylinePacker::occupancy() const noexcept {
+    return static_cast<float>(
+        static_cast<double>(m_usedArea) /
+        (static_cast<double>(m_width) * static_cast<double>(m_height)));
+}
+
+std::optional<int> SkylinePacker::fit(std::size_t segment, int width,
+                                      int height) const {
+    const int x = m_skyline[segment].x;
+    if (width > m_width - x) {
+        return std::nullopt;
+    }
+    int remaining = width;
+    int y = m_skyline[segment].y;
+    for (std::size_t i = segment; remaining > 0; ++i) {
+        y = std::max(y, m_skyline[i].y);
+        if (height > m_height - y) {
+            return std::nullopt;
+        }
+        remaining -= m_skyline[i].width;
+    }
+    return y;
+}
+
+std::optional<SkylinePacker::Position> SkylinePacker::insert(int width, int height) {
+    if (width <= 0 || height <= 0) {
+        throw std::invalid_argument("SkylinePacker rectangles must have positive size");
+    }
+    std::size_t best = m_skyline.size();
+    int bestTop = m_height + 1;
+    int bestSegmentWidth = m_width + 1;
+    int bestY = 0;
+    for (std::size_t i = 0; i < m_skyline.size(); ++i) {
+        const auto y = fit(i, width, height);
+        if (!y) continue;
+        const int top = *y + height;
+        if (top < bestTop ||
+            (top == bestTop && m_skyline[i].width < bestSegmentWidth)) {
+            best = i;
+            bestTop = top;
+            bestSegmentWidth = m_skyline[i].width;
+            bestY = *y;
+        }
+    }
+    if (best == m_skyline.size()) {
+        return std::nullopt;
+    }
+
+    const Position position{m_skyline[best].x, bestY};
+    m_skyline.insert(m_skyline.begin() + static_cast<std::ptrdiff_t>(best),
+                     Segment{position.x, bestY + height, width});
+    // Trim the segments now covered by the new one.
+    for (std::size_t i = best + 1; i < m_skyline.size();) {
+        const Segment& previous = m_skyline[i - 1];
+        Segment& current = m_skyline[i];
+        const int overlap = previous.x + previous.width - current.x;
+        if (overlap <= 0) break;
+        current.x += overlap;
+        current.width -= overlap;
+        if (current.width > 0) break;
+        m_skyline.erase(m_skyline.begin() + static_cast<std::ptrdiff_t>(i));
+    }
+    // Merge neighbours at the same height.
+    for (std::size_t i = 0; i + 1 < m_skyline.size();) {
+        if (m_skyline[i].y == m_skyline[i + 1].y) {
+            m_skyline[i].width += m_skyline[i + 1].width;
+            m_skyline.erase(m_skyline.begin() + static_cast<std::ptrdiff_t>(i + 1));
+        } else {
+            ++i;
+        }
+    }
+    m_usedArea += static_cast<std::uint64_t>(width) * static_cast<std::uint64_t>(height);
+    return position;
+}
+
+AtlasPacker::AtlasPacker(int pageWidth, int pageHeight, int padding,
+                         std::size_t maxPages)
+    : m_pageWidth(pageWidth), m_pageHeight(pageHeight), m_padding(padding),
+      m_maxPages(maxPages) {
+    if (pageWidth <= 0 || pageHeight <= 0) {
+        throw std::invalid_argument("AtlasPacker page dimensions must be positive");
+    }
+    if (padding < 0 || padding > std::min(pageWidth, pageHeight) / 2) {
+        throw std::invalid_argument("AtlasPacker padding must fit inside a page");
+    }
+    if (maxPages == 0) {
+        throw std::invalid_argument("AtlasPacker requires at least one page");
+    }
+}
+
+std::optional<AtlasPacker::Placement> AtlasPacker::insert(int width, int height) {
+    if (width <= 0 || height <= 0) {
+        throw std::invalid_argument("AtlasPacker rectangles must have positive size");
+    }
+    if (width > m_pageWidth - 2 * m_padding || height > m_pageHeight - 2 * m_padding) {
+        return std::nullopt;
+    }
+    const int paddedWidth = width + 2 * m_padding;
+    const int paddedHeight = height + 2 * m_padding;
+    const auto place = [&](std::size_t page) -> std::optional<Placement> {
+        const auto position = m_pages[page].insert(paddedWidth, paddedHeight);
+        if (!position) return std::nullopt;
+        return Placement{page, position->x + m_padding, position->y + m_padding,
+                         width, height};
+    };
+    for (std::size_t page = 0; page < m_pages.size(); ++page) {
+        if (auto placement = place(page)) {
+            return placement;
+        }
+    }
+    if (m_pages.size() >= m_maxPages) {
+        return std::nullopt;
+    }
+    m_pages.emplace_back(m_pageWidth, m_pageHeight);
+    return place(m_pages.size() - 1);
+}
+
+void AtlasPacker::resetPage(std::size_t page) {
+    if (page >= m_pages.size()) {
+        throw std::out_of_range("AtlasPacker::resetPage received an unknown page");
+    }
+    m_pages[page].reset();
+}
+
+float AtlasPacker::occupancy(std::size_t page) const {
+    if (page >= m_pages.size()) {
+        throw std::out_of_range("AtlasPacker::occupancy received an unknown page");
+    }
+    return m_pages[page].occupancy();
+}
+
+} // namespace Rendering
@@ -0,0 +1,99 @@
+//
+// AtlasPacker.hpp
+//
+
+#ifndef GL2D_ATLASPACKER_HPP
+#define GL2D_ATLASPACKER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+namespace Rendering {
+
+// Skyline bottom-left rectangle packer for one atlas page. Rectangles are
+// placed on the lowest fitting segment of the skyline; space below an
+// overhang is not reclaimed, which keeps inserts O(segments) and is a good
+// fit for sprite-sized rectangles arriving in load order.
+class SkylinePacker {
+public:
+    struct Position {
+        int x{0};
+        int y{0};
+    };
+
+    SkylinePacker(int width, int height);
+
+    // Returns the bottom-left corner of the placed rectangle, or nullopt if it
+    // does not fit anywhere on the page.
+    std::optional<Position> insert(int width, int height);
+    void reset();
+
+    [[nodiscard]] int width() const noexcept { return m_width; }
+    [[nodiscard]] int height() const noexcept { return m_height; }
+    [[nodiscard]] std::uint64_t usedArea() const noexcept { return m_usedArea; }
+    // Fraction of the page covered by placed rectangles, in [0, 1].
+    [[nodiscard]] float occupancy() const noexcept;
+
+private:
+    struct Segment {
+        int x{0};
+        int y{0};
+        int width{0};
+    };
+
+    [[nodiscard]] std::optional<int> fit(std::size_t segment, int width,
+                                         int height) const;
+
+    int m_width{0};
+    int m_height{0};
+    std::uint64_t m_usedArea{0};
+    std::vector<Segment> m_skyline;
+};
+
+// Multi-page atlas allocator. Every rectangle is surrounded by `padding`
+// texels on each side so callers can extrude edges against filtering bleed;
+// reported placements are the unpadded interior. Pages are tried first-fit
+// and a new page opens when none has room.
+class AtlasPacker {
+public:
+    static constexpr std::size_t unlimitedPages = std::numeric_limits<std::size_t>::max();
+
+    struct Placement {
+        std::size_t page{0};
+        int x{0};
+        int y{0};
+        int width{0};
+        int height{0};
+    };
+
+    AtlasPacker(int pageWidth, int pageHeight, int padding = 1,
+                std::size_t maxPages = unlimitedPages);
+
+    // Returns nullopt when the padded rectangle exceeds a page or every page
+    // (up to maxPages) is full.
+    std::optional<Placement> insert(int width, int height);
+    // Forgets every rectangle on `page`, e.g. once its texture was released.
+    void resetPage(std::size_t page);
+    void clear() noexcept { m_pages.clear(); }
+
+    [[nodiscard]] std::size_t pageCount() const noexcept { return m_pages.size(); }
+    // Fraction of `page` covered by padded rectangles.
+    [[nodiscard]] float occupancy(std::size_t page) const;
+    [[nodiscard]] int pageWidth() const noexcept { return m_pageWidth; }
+    [[nodiscard]] int pageHeight() const noexcept { return m_pageHeight; }
+    [[nodiscard]] int padding() const noexcept { return m_padding; }
+
+private:
+    int m_pageWidth{0};
+    int m_pageHeight{0};
+    int m_padding{0};
+    std::size_t m_maxPages{unlimitedPages};
+    std::vector<SkylinePacker> m_pages;
+};
+
+} // namespace Rendering
+
+#endif // GL2D_ATLASPACKER_HPP
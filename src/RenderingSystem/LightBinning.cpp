@@ -0,0 +1,107 @@
+//
+// LightBinning.cpp
+//
+
+#include "LightBinning.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace Rendering {
+
+glm::vec4 lightScreenBounds(const Light& light, const glm::mat4& viewProjection,
+                            int width, int height) {
+    const glm::vec4 fullScreen{0.0f, 0.0f, static_cast<float>(width),
+                               static_cast<float>(height)};
+    if (light.type == LightType::DIRECTIONAL) {
+        return fullScreen;
+    }
+    const float radius = light.radius;
+    const glm::vec2 corners[] = {{light.pos.x - radius, light.pos.y - radius},
+                                 {light.pos.x + radius, light.pos.y - radius},
+                                 {light.pos.x + radius, light.pos.y + radius},
+                                 {light.pos.x - radius, light.pos.y + radius}};
+    glm::vec2 minPoint{std::numeric_limits<float>::max()};
+    glm::vec2 maxPoint{std::numeric_limits<float>::lowest()};
+    for (const glm::vec2& corner : corners) {
+        const glm::vec4 clip = viewProjection * glm::vec4(corner, 0.0f, 1.0f);
+        const glm::vec2 pixel{(clip.x / clip.w * 0.5f + 0.5f) * static_cast<float>(width),
+                              (clip.y / clip.w * 0.5f + 0.5f) * static_cast<float>(height)};
+        minPoint = glm::min(minPoint, pixel);
+        maxPoint = glm::max(maxPoint, pixel);
+    }
+    return {minPoint.x, minPoint.y, maxPoint.x, maxPoint.y};
+}
+
+void binLights(std::span<const Light> lights, const glm::mat4& viewProjection,
+               int width, int height, int tileSize, LightTileGrid& grid) {
+    if (width <= 0 || height <= 0 || tileSize <= 0) {
+        throw std::invalid_argument(
+            "Light binning requires a positive framebuffer and tile size");
+    }
+    if (lights.size() > std::numeric_limits<std::uint32_t>::max()) {
+        throw std::length_error("Light binning supports at most 2^32 - 1 lights");
+    }
+    grid.tileSize = tileSize;
+    grid.tilesX = (width + tileSize - 1) / tileSize;
+    grid.tilesY = (height + tileSize - 1) / tileSize;
+    const std::size_t tileCount = grid.tileCount();
+
+    // Tile rectangle covered by each light, or an empty one when it misses.
+    struct TileRange {
+        int minX{0};
+        int minY{0};
+        int maxX{-1};
+        int maxY{-1};
+    };
+    std::vector<TileRange> ranges(lights.size());
+    grid.offsets.assign(tileCount + 1, 0u);
+    for (std::size_t i = 0; i < lights.size(); ++i) {
+        const Light& light = lights[i];
+        if (light.type != LightType::DIRECTIONAL &&
+            (!(light.radius > 0.0f) || !std::isfinite(light.radius))) {
+            continue;
+        }
+        const glm::vec4 bounds = lightScreenBounds(light, viewProjection, width, height);
+        if (!std::isfinite(bounds.x) || !std::isfinite(bounds.y) ||
+            !std::isfinite(bounds.z) || !std::isfinite(bounds.w) ||
+            bounds.z < 0.0f || bounds.w < 0.0f ||
+            bounds.x >= static_cast<float>(width) ||
+            bounds.y >= static_cast<float>(height)) {
+            continue;
+        }
+        const auto tile = [tileSize](float pixel, int tiles) {
+            const float cell = std::floor(pixel / static_cast<float>(tileSize));
+            return static_cast<int>(std::clamp(cell, 0.0f, static_cast<float>(tiles - 1)));
+        };
+        TileRange& range = ranges[i];
+        range = {tile(bounds.x, grid.tilesX), tile(bounds.y, grid.tilesY),
+                 tile(bounds.z, grid.tilesX), tile(bounds.w, grid.tilesY)};
+        for (int y = range.minY; y <= range.maxY; ++y) {
+            for (int x = range.minX; x <= range.maxX; ++x) {
+                ++grid.offsets[static_cast<std::size_t>(y) * grid.tilesX + x + 1];
+            }
+        }
+    }
+
+    for (std::size_t t = 0; t < tileCount; ++t) {
+        grid.offsets[t + 1] += grid.offsets[t];
+    }
+    grid.indices.resize(grid.offsets[tileCount]);
+    // Fill cursors start at each tile's offset; walking lights in order keeps
+    // every tile list sorted.
+    std::vector<std::uint32_t> cursor(grid.offsets.begin(), grid.offsets.end() - 1);
+    for (std::size_t i = 0; i < lights.size(); ++i) {
+        const TileRange& range = ranges[i];
+        for (int y = range.minY; y <= range.maxY; ++y) {
+            for (int x = range.minX; x <= range.maxX; ++x) {
+                grid.indices[cursor[static_cast<std::size_t>(y) * grid.tilesX + x]++] =
+                    static_cast<std::uint32_t>(i);
+            }
+        }
+    }
+}
+
+} // namespace Rendering
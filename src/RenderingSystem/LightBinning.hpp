@@ -0,0 +1,50 @@
+//
+// LightBinning.hpp
+//
+
+#ifndef GL2D_LIGHTBINNING_HPP
+#define GL2D_LIGHTBINNING_HPP
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec4.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "Graphics/LightingSystem/Light.hpp"
+
+namespace Rendering {
+
+// Per-tile light lists in compressed-row form: the lights touching tile t are
+// indices[offsets[t] .. offsets[t + 1]), in ascending light order. Tiles are
+// numbered row-major from the bottom-left pixel, matching gl_FragCoord.
+struct LightTileGrid {
+    int tileSize{32};
+    int tilesX{0};
+    int tilesY{0};
+    std::vector<std::uint32_t> offsets;
+    std::vector<std::uint32_t> indices;
+
+    [[nodiscard]] std::size_t tileCount() const noexcept {
+        return static_cast<std::size_t>(tilesX) * static_cast<std::size_t>(tilesY);
+    }
+};
+
+// Pixel-space bounds {minX, minY, maxX, maxY} of a light's area of effect on
+// a `width` x `height` framebuffer, conservative under camera rotation.
+// Directional lights cover the whole framebuffer.
+[[nodiscard]] glm::vec4 lightScreenBounds(const Light& light,
+                                          const glm::mat4& viewProjection,
+                                          int width, int height);
+
+// Bins `lights` into `tileSize`-pixel screen tiles. Lights without area
+// (non-directional with radius <= 0) or entirely off screen land in no tile.
+// `grid` is reused across frames to avoid reallocation.
+void binLights(std::span<const Light> lights, const glm::mat4& viewProjection,
+               int width, int height, int tileSize, LightTileGrid& grid);
+
+} // namespace Rendering
+
+#endif // GL2D_LIGHTBINNING_HPP
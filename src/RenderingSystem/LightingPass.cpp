@@ -8,15 +8,41 @@
 #include <glm/ext/matrix_clip_space.hpp>
 #include <glm/gtc/matrix_inverse.hpp>
 #include <glm/vec2.hpp>
+#include <algorithm>
 #include <array>
 #include <stdexcept>
 
 namespace Rendering {
+namespace {
+// Texture units past the scene, normal and cookie samplers.
+constexpr int kLightDataUnit = 2 + LightingPass::kMaxCookies;
+constexpr int kTileOffsetsUnit = kLightDataUnit + 1;
+constexpr int kTileIndicesUnit = kLightDataUnit + 2;
+
+// Four RGBA32F texels per light; the layout is mirrored in lighting.frag.
+void packLight(const Light& light, std::vector<glm::vec4>& output) {
+    output.emplace_back(light.pos, light.dir);
+    output.emplace_back(light.color, light.intensity);
+    output.emplace_back(light.radius, light.falloff, light.innerCutoff,
+                        light.outerCutoff);
+    output.emplace_back(static_cast<float>(light.type), light.emissiveBoost,
+                        static_cast<float>(light.cookieSlot), light.cookieStrength);
+}
+} // namespace
 
 LightingPass::~LightingPass() {
+    destroy(m_lightData);
+    destroy(m_tileOffsets);
+    destroy(m_tileIndices);
     if (m_vertexArray) glDeleteVertexArrays(1, &m_vertexArray);
 }
 
+void LightingPass::destroy(TextureBuffer& target) noexcept {
+    if (target.texture) glDeleteTextures(1, &target.texture);
+    if (target.buffer) glDeleteBuffers(1, &target.buffer);
+    target = {};
+}
+
 void LightingPass::ensureResources() {
     if (!m_shader) {
         m_shader = std::make_shared<Graphics::Shader>(
@@ -29,6 +55,33 @@ void LightingPass::ensureResources() {
                 "OpenGL failed to allocate the lighting pass vertex array");
         }
     }
+    for (TextureBuffer* target : {&m_lightData, &m_tileOffsets, &m_tileIndices}) {
+        if (target->texture) continue;
+        glGenBuffers(1, &target->buffer);
+        glGenTextures(1, &target->texture);
+        if (!target->buffer || !target->texture) {
+            destroy(*target);
+            throw std::runtime_error(
+                "OpenGL failed to allocate the lighting pass light buffers");
+        }
+    }
+}
+
+void LightingPass::upload(TextureBuffer& target, GLenum format, const void* data,
+                          std::size_t bytes) {
+    // Texture buffers cannot be empty; a single zero texel stands in.
+    static constexpr std::array<float, 4> kEmpty{};
+    if (bytes == 0) {
+        data = kEmpty.data();
+        bytes = sizeof(kEmpty);
+    }
+    GLint previousBuffer = 0;
+    glGetIntegerv(GL_TEXTURE_BUFFER_BINDING, &previousBuffer);
+    glBindBuffer(GL_TEXTURE_BUFFER, target.buffer);
+    glBufferData(GL_TEXTURE_BUFFER, static_cast<GLsizeiptr>(bytes), data, GL_STREAM_DRAW);
+    glBindBuffer(GL_TEXTURE_BUFFER, static_cast<GLuint>(previousBuffer));
+    glBindTexture(GL_TEXTURE_BUFFER, target.texture);
+    glTexBuffer(GL_TEXTURE_BUFFER, format, target.buffer);
 }
 
 void LightingPass::draw(const RenderTarget &target, const std::vector<Light> &lights,
@@ -56,32 +109,43 @@ void LightingPass::draw(const RenderTarget &target, const std::vector<Light> &li
     m_shader->setUniformFloat3("uAmbient", ambientColor);
     m_shader->setUniformMat4("uInverseViewProjection", inverseViewProjection);
 
-    const int count = static_cast<int>(std::min<size_t>(lights.size(), kMaxLights));
-    m_shader->setUniformInt1("uLightCount", count);
-
-    for (int i = 0; i < count; ++i) {
-        const auto &l = lights[static_cast<size_t>(i)];
-        const std::string base = "uLights[" + std::to_string(i) + "].";
-        m_shader->setUniformInt1(base + "type", static_cast<int>(l.type));
-        m_shader->setUniformFloat2(base + "pos", l.pos);
-        m_shader->setUniformFloat2(base + "dir", l.dir);
-        m_shader->setUniformFloat1(base + "radius", l.radius);
-        m_shader->setUniformFloat3(base + "color", l.color);
-        m_shader->setUniformFloat1(base + "intensity", l.intensity);
-        m_shader->setUniformFloat1(base + "falloff", l.falloff);
-        m_shader->setUniformFloat1(base + "innerCutoff", l.innerCutoff);
-        m_shader->setUniformFloat1(base + "outerCutoff", l.outerCutoff);
-        m_shader->setUniformFloat1(base + "emissiveBoost", l.emissiveBoost);
-        m_shader->setUniformInt1(base + "cookieSlot", l.cookieSlot);
-        m_shader->setUniformFloat1(base + "cookieStrength", l.cookieStrength);
+    // Lights past kMaxLights are dropped, as the uniform array used to.
+    const std::span<const Light> binned(
+        lights.data(), std::min<std::size_t>(lights.size(), kMaxLights));
+    binLights(binned, glm::inverse(inverseViewProjection), target.width(),
+              target.height(), kTileSize, m_grid);
+    GLint maxTexels = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &maxTexels);
+    if (m_grid.indices.size() > static_cast<std::size_t>(maxTexels)) {
+        throw std::length_error("LightingPass tile lists exceed GL_MAX_TEXTURE_BUFFER_SIZE");
     }
+    m_packedLights.clear();
+    for (const Light& light : binned) {
+        packLight(light, m_packedLights);
+    }
+
+    glActiveTexture(GL_TEXTURE0 + kLightDataUnit);
+    upload(m_lightData, GL_RGBA32F, m_packedLights.data(),
+           m_packedLights.size() * sizeof(glm::vec4));
+    glActiveTexture(GL_TEXTURE0 + kTileOffsetsUnit);
+    upload(m_tileOffsets, GL_R32UI, m_grid.offsets.data(),
+           m_grid.offsets.size() * sizeof(std::uint32_t));
+    glActiveTexture(GL_TEXTURE0 + kTileIndicesUnit);
+    upload(m_tileIndices, GL_R32UI, m_grid.indices.data(),
+           m_grid.indices.size() * sizeof(std::uint32_t));
+    m_shader->setUniformInt1("uLightData", kLightDataUnit);
+    m_shader->setUniformInt1("uTileOffsets", kTileOffsetsUnit);
+    m_shader->setUniformInt1("uTileIndices", kTileIndicesUnit);
+    m_shader->setUniformInt1("uTileSize", m_grid.tileSize);
+    m_shader->setUniformInt1("uTilesX", m_grid.tilesX);
+    m_shader->setUniformInt1("uTilesY", m_grid.tilesY);
 
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, target.colorTexture());
     glActiveTexture(GL_TEXTURE1);
     glBindTexture(GL_TEXTURE_2D, target.normalTexture());
     if (!cookieTextures.empty()) {
-        const int count = static_cast<int>(std::min(cookieTextures.size(), static_cast<size_t>(kMaxLights)));
+        const int count = static_cast<int>(std::min(cookieTextures.size(), static_cast<size_t>(kMaxCookies)));
         for (int i = 0; i < count; ++i) {
             m_shader->setUniformInt1("uCookieTex[" + std::to_string(i) + "]", 2 + i);
             glActiveTexture(GL_TEXTURE2 + static_cast<GLenum>(i));
@@ -98,10 +162,14 @@ void LightingPass::draw(const RenderTarget &target, const std::vector<Light> &li
     glDrawArrays(GL_TRIANGLES, 0, 3);
     glBindVertexArray(0);
     for (int i = 0; i < static_cast<int>(std::min(
-             cookieTextures.size(), static_cast<std::size_t>(kMaxLights))); ++i) {
+             cookieTextures.size(), static_cast<std::size_t>(kMaxCookies))); ++i) {
         glActiveTexture(GL_TEXTURE2 + static_cast<GLenum>(i));
         glBindTexture(GL_TEXTURE_2D, 0);
     }
+    for (const int unit : {kLightDataUnit, kTileOffsetsUnit, kTileIndicesUnit}) {
+        glActiveTexture(GL_TEXTURE0 + static_cast<GLenum>(unit));
+        glBindTexture(GL_TEXTURE_BUFFER, 0);
+    }
     glActiveTexture(GL_TEXTURE1);
     glBindTexture(GL_TEXTURE_2D, 0);
     glActiveTexture(GL_TEXTURE0);
@@ -15,12 +15,21 @@
 
 #include "Graphics/Shader.hpp"
 #include "Graphics/LightingSystem/Light.hpp"
+#include "RenderingSystem/LightBinning.hpp"
 #include "RenderTarget.hpp"
 
 namespace Rendering {
 
+// Resolves scene lighting in one fullscreen pass. Lights are binned into
+// screen tiles on the CPU and uploaded as texture buffers, so each fragment
+// only evaluates the lights overlapping its tile.
 class LightingPass {
 public:
+    // Lights beyond kMaxLights are ignored; cookie samplers stay fixed-size.
+    static constexpr int kMaxLights = 4096;
+    static constexpr int kMaxCookies = 8;
+    static constexpr int kTileSize = 32;
+
     LightingPass() = default;
     ~LightingPass();
 
@@ -42,11 +51,27 @@ public:
               const std::vector<GLuint>& cookieTextures,
               const glm::vec3& ambientColor = glm::vec3(0.05f));
 
+    // Light count and tile lists of the last draw, for debugging and stats.
+    [[nodiscard]] const LightTileGrid& tileGrid() const noexcept { return m_grid; }
+
 private:
+    struct TextureBuffer {
+        GLuint buffer{0};
+        GLuint texture{0};
+    };
+
     void ensureResources();
-    static constexpr int kMaxLights = 8;
+    void upload(TextureBuffer& target, GLenum format, const void* data,
+                std::size_t bytes);
+    static void destroy(TextureBuffer& target) noexcept;
+
     GLuint m_vertexArray{0};
     std::shared_ptr<Graphics::Shader> m_shader;
+    TextureBuffer m_lightData;
+    TextureBuffer m_tileOffsets;
+    TextureBuffer m_tileIndices;
+    LightTileGrid m_grid;
+    std::vector<glm::vec4> m_packedLights;
 };
 
 } // namespace Rendering
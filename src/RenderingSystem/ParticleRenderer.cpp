@@ -4,23 +4,21 @@
 
 #include "ParticleRenderer.hpp"
 #include <GL/glew.h>
-#include <array>
 #include <cmath>
 #include <cstddef>
-#include <cstdint>
 #include <limits>
 #include <vector>
 #include <algorithm>
 #include <stdexcept>
 #include "Graphics/Shader.hpp"
 #include "GameObjects/Texture.hpp"
+#include "ParticleSystem/ParticlePool.hpp"
 
 namespace {
-struct ParticleVertex {
-    glm::vec2 position;
-    glm::vec4 color;
-    glm::vec2 uv;
-};
+// Instances per draw are capped by GLsizei; the instance buffer also has to
+// stay addressable through GLsizeiptr offsets.
+constexpr std::size_t kMaxInstances = static_cast<std::size_t>(
+    std::numeric_limits<GLsizei>::max() / 16);
 
 GLuint createDefaultTexture() {
     // Build a soft radial falloff texture procedurally to give particles a high-res glow.
@@ -87,31 +85,22 @@ Rendering::ParticleRenderer::ParticleRenderer()
     try {
         glGenVertexArrays(1, &m_vao);
         glGenBuffers(1, &m_vbo);
-        glGenBuffers(1, &m_ebo);
-        if (!m_vao || !m_vbo || !m_ebo) {
+        if (!m_vao || !m_vbo) {
             throw std::runtime_error(
                 "OpenGL failed to allocate particle renderer buffers");
         }
 
+        // Every attribute is per instance; the quad corners come from
+        // gl_VertexID. Column offsets depend on the batch size and are set
+        // at flush time.
         GLint previousVertexArray = 0;
-        GLint previousArrayBuffer = 0;
         glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &previousVertexArray);
-        glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &previousArrayBuffer);
         glBindVertexArray(m_vao);
-        glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
-
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(ParticleVertex),
-                              reinterpret_cast<void*>(offsetof(ParticleVertex, position)));
-        glEnableVertexAttribArray(1);
-        glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(ParticleVertex),
-                              reinterpret_cast<void*>(offsetof(ParticleVertex, color)));
-        glEnableVertexAttribArray(2);
-        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(ParticleVertex),
-                              reinterpret_cast<void*>(offsetof(ParticleVertex, uv)));
+        for (GLuint column = 0; column < InstanceColumnCount; ++column) {
+            glEnableVertexAttribArray(column);
+            glVertexAttribDivisor(column, 1);
+        }
         glBindVertexArray(static_cast<GLuint>(previousVertexArray));
-        glBindBuffer(GL_ARRAY_BUFFER, static_cast<GLuint>(previousArrayBuffer));
 
         m_defaultTexture = createDefaultTexture();
     } catch (...) {
@@ -130,11 +119,9 @@ Rendering::ParticleRenderer::~ParticleRenderer() {
 void Rendering::ParticleRenderer::destroyResources() noexcept {
     if (m_defaultTexture) glDeleteTextures(1, &m_defaultTexture);
     if (m_vbo) glDeleteBuffers(1, &m_vbo);
-    if (m_ebo) glDeleteBuffers(1, &m_ebo);
     if (m_vao) glDeleteVertexArrays(1, &m_vao);
     m_defaultTexture = 0;
     m_vbo = 0;
-    m_ebo = 0;
     m_vao = 0;
 }
 
@@ -150,7 +137,11 @@ void Rendering::ParticleRenderer::begin(
     }
     m_viewProj = viewProjection;
     m_viewBounds = viewBounds;
-    m_batch.clear();
+    for (auto& column : m_instances) {
+        column.clear();
+    }
+    m_instanceCount = 0;
+    m_batchTint = glm::vec4(1.0f);
     m_blendMode = ParticleBlendMode::Alpha;
     m_currentTexture = m_defaultTexture;
     m_useRadialMask = true;
@@ -165,6 +156,12 @@ void Rendering::ParticleRenderer::begin(
     m_frameActive = true;
 }
 
+bool Rendering::ParticleRenderer::inView(const glm::vec4 &bounds) const noexcept {
+    return !m_viewBounds ||
+           !(bounds.z < m_viewBounds->x || bounds.x > m_viewBounds->z ||
+             bounds.w < m_viewBounds->y || bounds.y > m_viewBounds->w);
+}
+
 void Rendering::ParticleRenderer::submit(const Rendering::ParticleRenderData &p) {
     if (!m_frameActive) {
         throw std::logic_error("ParticleRenderer::submit requires an active frame");
@@ -188,19 +185,66 @@ void Rendering::ParticleRenderer::submit(const Rendering::ParticleRenderData &p)
             return;
         }
     }
-    Rendering::ParticleRenderData tinted = p;
-    tinted.color *= m_globalTint;
-    if (!std::isfinite(tinted.color.x) || !std::isfinite(tinted.color.y) ||
-        !std::isfinite(tinted.color.z) || !std::isfinite(tinted.color.w)) {
-        throw std::overflow_error("Particle tint multiplication overflowed");
+    setBatchTint(glm::vec4(1.0f));
+    reserveInstances(1);
+    m_instances[PositionX].push_back(p.position.x);
+    m_instances[PositionY].push_back(p.position.y);
+    m_instances[SizeX].push_back(p.size.x);
+    m_instances[SizeY].push_back(p.size.y);
+    m_instances[Rotation].push_back(p.rotation);
+    m_instances[Red].push_back(p.color.r);
+    m_instances[Green].push_back(p.color.g);
+    m_instances[Blue].push_back(p.color.b);
+    m_instances[Alpha].push_back(p.color.a);
+    ++m_instanceCount;
+}
+
+void Rendering::ParticleRenderer::submit(const ParticlePool &particles, const glm::vec4 &tint) {
+    submit(particles.renderColumns(), tint);
+}
+
+void Rendering::ParticleRenderer::submit(const ParticleRenderColumns &columns,
+                                         const glm::vec4 &tint) {
+    if (!m_frameActive) {
+        throw std::logic_error("ParticleRenderer::submit requires an active frame");
     }
-    constexpr std::size_t maxParticles = std::min(
-        static_cast<std::size_t>(std::numeric_limits<std::uint32_t>::max() / 8U),
-        static_cast<std::size_t>(std::numeric_limits<GLsizei>::max() / 12));
-    if (m_batch.size() >= maxParticles) {
-        throw std::length_error("Particle batch exceeds OpenGL index limits");
+    if (!std::isfinite(tint.x) || !std::isfinite(tint.y) ||
+        !std::isfinite(tint.z) || !std::isfinite(tint.w) ||
+        tint.x < 0.0f || tint.y < 0.0f || tint.z < 0.0f || tint.w < 0.0f) {
+        throw std::invalid_argument("Particle tint must be finite and non-negative");
+    }
+    if (columns.count == 0) {
+        return;
+    }
+    setBatchTint(tint);
+    reserveInstances(columns.count);
+    const auto append = [&columns](std::vector<float>& column, const float* source) {
+        column.insert(column.end(), source, source + columns.count);
+    };
+    append(m_instances[PositionX], columns.positionX);
+    append(m_instances[PositionY], columns.positionY);
+    append(m_instances[SizeX], columns.size);
+    append(m_instances[SizeY], columns.size);
+    append(m_instances[Rotation], columns.rotation);
+    append(m_instances[Red], columns.red);
+    append(m_instances[Green], columns.green);
+    append(m_instances[Blue], columns.blue);
+    append(m_instances[Alpha], columns.alpha);
+    m_instanceCount += columns.count;
+}
+
+void Rendering::ParticleRenderer::setBatchTint(const glm::vec4 &tint) {
+    if (tint == m_batchTint) {
+        return;
+    }
+    flush();
+    m_batchTint = tint;
+}
+
+void Rendering::ParticleRenderer::reserveInstances(std::size_t count) {
+    if (count > kMaxInstances - m_instanceCount) {
+        throw std::length_error("Particle batch exceeds OpenGL instance limits");
     }
-    m_batch.push_back(tinted);
 }
 
 void Rendering::ParticleRenderer::end() {
@@ -282,66 +326,31 @@ void Rendering::ParticleRenderer::applyFeeling(const FeelingsSystem::FeelingSnap
         throw std::invalid_argument(
             "Particle feeling tint requires non-negative finite RGB and alpha in [0, 1]");
     }
+    if (m_frameActive && tint != m_globalTint) {
+        // Particles already queued keep the tint they were submitted under.
+        flush();
+    }
     m_globalTint = tint;
 }
 
 void Rendering::ParticleRenderer::flush() {
-    if (m_batch.empty()) return;
+    if (m_instanceCount == 0) return;
 
     const bool useBorder = m_borderThickness > 0.0f && (m_borderColor.a > 0.0f);
-
-    std::vector<ParticleVertex> vertices;
-    std::vector<uint32_t> indices;
-    const size_t quadCount = m_batch.size() * (useBorder ? 2 : 1);
-    vertices.reserve(quadCount * 4);
-    indices.reserve(quadCount * 6);
-
-    const std::array<glm::vec2, 4> baseUV{
-            glm::vec2(0.0f, 1.0f),
-            glm::vec2(1.0f, 1.0f),
-            glm::vec2(1.0f, 0.0f),
-            glm::vec2(0.0f, 0.0f)
-    };
-
-    auto emitQuad = [&](const Rendering::ParticleRenderData& p, const glm::vec2& size, const glm::vec4& color) {
-        const glm::vec2 halfSize = size * 0.5f;
-        const float c = std::cos(p.rotation);
-        const float s = std::sin(p.rotation);
-
-        const std::array<glm::vec2, 4> corners{
-                glm::vec2(-halfSize.x, -halfSize.y),
-                glm::vec2(halfSize.x, -halfSize.y),
-                glm::vec2(halfSize.x, halfSize.y),
-                glm::vec2(-halfSize.x, halfSize.y)
-        };
-
-        const uint32_t baseIndex = static_cast<uint32_t>(vertices.size());
-        for (size_t i = 0; i < corners.size(); ++i) {
-            const glm::vec2 rotated{
-                    corners[i].x * c - corners[i].y * s,
-                    corners[i].x * s + corners[i].y * c
-            };
-            vertices.push_back(
-                    ParticleVertex{p.position + rotated, color, baseUV[i]}
-            );
-        }
-        indices.insert(indices.end(),
-                       {baseIndex, baseIndex + 1, baseIndex + 2, baseIndex + 2, baseIndex + 3, baseIndex});
-    };
-
-    for (const auto &p: m_batch) {
-        if (useBorder) {
-            const glm::vec2 borderSize = p.size * (1.0f + m_borderThickness * 2.0f);
-            emitQuad(p, borderSize, m_borderColor);
-        }
-        emitQuad(p, p.size, p.color);
+    const glm::vec4 tint = m_batchTint * m_globalTint;
+    if (!std::isfinite(tint.x) || !std::isfinite(tint.y) ||
+        !std::isfinite(tint.z) || !std::isfinite(tint.w)) {
+        throw std::overflow_error("Particle tint multiplication overflowed");
     }
 
     m_shader->enable();
     m_shader->setUniformMat4("projection", m_viewProj);
-    m_shader->setUniformMat4("transform", glm::mat4(1.0f));
     m_shader->setUniformInt1("spriteTexture", 0);
     m_shader->setUniformInt1("uUseRadialMask", m_useRadialMask ? 1 : 0);
+    m_shader->setUniformFloat4("uTint", tint);
+    m_shader->setUniformInt1("uUseBorder", useBorder ? 1 : 0);
+    m_shader->setUniformFloat4("uBorderColor", m_borderColor);
+    m_shader->setUniformFloat1("uBorderScale", 1.0f + m_borderThickness * 2.0f);
 
     glBlendEquation(GL_FUNC_ADD);
     if (m_blendMode == ParticleBlendMode::Additive) {
@@ -351,23 +360,27 @@ void Rendering::ParticleRenderer::flush() {
     }
 
     glBindVertexArray(m_vao);
-
     glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
-    glBufferData(GL_ARRAY_BUFFER,
-                 static_cast<GLsizeiptr>(vertices.size() * sizeof(ParticleVertex)),
-                 vertices.data(), GL_DYNAMIC_DRAW);
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER,
-                 static_cast<GLsizeiptr>(indices.size() * sizeof(uint32_t)),
-                 indices.data(), GL_DYNAMIC_DRAW);
+    const auto columnBytes = static_cast<GLsizeiptr>(m_instanceCount * sizeof(float));
+    // Orphaned every flush so the upload never waits on the previous draw.
+    glBufferData(GL_ARRAY_BUFFER, columnBytes * InstanceColumnCount, nullptr, GL_STREAM_DRAW);
+    for (GLuint column = 0; column < InstanceColumnCount; ++column) {
+        const GLintptr offset = columnBytes * column;
+        glBufferSubData(GL_ARRAY_BUFFER, offset, columnBytes, m_instances[column].data());
+        glVertexAttribPointer(column, 1, GL_FLOAT, GL_FALSE, 0,
+                              reinterpret_cast<void*>(offset));
+    }
 
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, m_currentTexture);
 
-    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(indices.size()), GL_UNSIGNED_INT, nullptr);
+    glDrawArraysInstanced(GL_TRIANGLES, 0, useBorder ? 12 : 6,
+                          static_cast<GLsizei>(m_instanceCount));
 
     glBindVertexArray(0);
     glBindTexture(GL_TEXTURE_2D, 0);
-    m_batch.clear();
+    for (auto& column : m_instances) {
+        column.clear();
+    }
+    m_instanceCount = 0;
 }
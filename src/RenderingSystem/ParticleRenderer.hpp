@@ -6,6 +6,8 @@
 #define GL2D_PARTICLERENDERER_HPP
 #include <glm/glm.hpp>
 #include <glm/mat4x4.hpp>
+#include <array>
+#include <cstddef>
 #include <memory>
 #include <optional>
 #include <vector>
@@ -14,6 +16,8 @@
 
 namespace Graphics { class Shader; }
 namespace GameObjects { class Texture; }
+class ParticlePool;
+struct ParticleRenderColumns;
 
 namespace Rendering{
     struct ParticleRenderData {
@@ -39,7 +43,18 @@ namespace Rendering{
         void begin(const glm::mat4& viewProjection = glm::mat4(1.0f),
                    std::optional<glm::vec4> viewBounds = std::nullopt);
         void submit(const ParticleRenderData& p);
+        // Direct submission: appends every live particle by copying the
+        // pool's columns, with no per-particle work on the CPU. The data is
+        // trusted as produced by the simulation (no validation or view
+        // culling; cull whole emitters with inView() first). `tint` multiplies particle
+        // colors; a tint change starts a new draw.
+        void submit(const ParticlePool& particles, const glm::vec4& tint = glm::vec4(1.0f));
+        void submit(const ParticleRenderColumns& columns, const glm::vec4& tint = glm::vec4(1.0f));
         void end();
+        // Whether world bounds {minX, minY, maxX, maxY}, such as an emitter's
+        // simulationBounds(), touch the view passed to begin(); always true
+        // without one.
+        [[nodiscard]] bool inView(const glm::vec4& bounds) const noexcept;
         // Changing mode flushes the current batch so submission order is kept.
         void setBlendMode(ParticleBlendMode mode);
         // A null texture selects the built-in soft radial particle.
@@ -48,14 +63,23 @@ namespace Rendering{
         void applyFeeling(const FeelingsSystem::FeelingSnapshot& snapshot);
 
     private:
+        // Per-instance attributes, uploaded as one tightly packed column each.
+        enum InstanceColumn : std::size_t {
+            PositionX, PositionY, SizeX, SizeY, Rotation, Red, Green, Blue, Alpha,
+            InstanceColumnCount
+        };
+
         void flush();
+        void setBatchTint(const glm::vec4& tint);
+        void reserveInstances(std::size_t count);
         void restoreBlendState() noexcept;
         void destroyResources() noexcept;
 
-        std::vector<ParticleRenderData> m_batch{};
+        std::array<std::vector<float>, InstanceColumnCount> m_instances{};
+        std::size_t m_instanceCount{0};
+        glm::vec4 m_batchTint{1.0f};
         unsigned int m_vao=0;
         unsigned int m_vbo=0;
-        unsigned int m_ebo=0;
 
         unsigned int m_defaultTexture=0;
         std::shared_ptr<Graphics::Shader> m_shader;
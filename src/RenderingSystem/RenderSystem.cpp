@@ -31,34 +31,22 @@
 #include "ECS/Components/ParticleEmitter2D.hpp"
 #include "ECS/Components/ParticleRender2D.hpp"
 #include "RenderingSystem/ParticleRenderer.hpp"
+#include "RenderingSystem/SpriteSpatialIndex.hpp"
+#include "RenderingSystem/StaticSpriteBatch.hpp"
 #include <algorithm>
+#include <cstdint>
 #include <GL/glew.h>
 #include <vector>
 #include <glm/geometric.hpp>
 #include <glm/gtc/matrix_inverse.hpp>
 #include <chrono>
 #include <cmath>
-#include <limits>
 namespace {
 inline bool overlaps(const glm::vec4 &aabb, const glm::vec4 &view) {
     return !(aabb.z < view.x || aabb.x > view.z || aabb.w < view.y ||
              aabb.y > view.w);
 }
 
-glm::vec4 transformedBounds(const glm::mat4& model, const glm::vec2& size) {
-    const glm::vec2 corners[] = {{0.0f, 0.0f}, {size.x, 0.0f},
-                                 {size.x, size.y}, {0.0f, size.y}};
-    glm::vec2 minPoint{std::numeric_limits<float>::max()};
-    glm::vec2 maxPoint{std::numeric_limits<float>::lowest()};
-    for (const glm::vec2& corner : corners) {
-        const glm::vec4 world = model * glm::vec4(corner, 0.0f, 1.0f);
-        const glm::vec2 point{world.x, world.y};
-        minPoint = glm::min(minPoint, point);
-        maxPoint = glm::max(maxPoint, point);
-    }
-    return {minPoint.x, minPoint.y, maxPoint.x, maxPoint.y};
-}
-
 struct LightingFeeling {
     float intensityMul{1.0f};
     float radiusMul{1.0f};
@@ -98,6 +86,24 @@ double nowSeconds() {
     return std::chrono::duration<double>(t).count();
 }
 
+Rendering::SpriteDrawData spriteRenderDrawData(const ECS::SpriteRender& renderable) {
+    Rendering::SpriteDrawData drawData{};
+    drawData.color = renderable.sprite->getColor() * renderable.tint *
+                     renderable.animationTint;
+    drawData.uvRect = renderable.useCustomUV
+        ? renderable.uvRect : renderable.sprite->getUVCoords();
+    drawData.flipX = renderable.flipX;
+    drawData.textureOverride = renderable.textureOverride.get();
+    drawData.normalTextureOverride = renderable.normalTextureOverride.get();
+    return drawData;
+}
+
+std::uint64_t staticSpriteKey(ECS::Entity entity) {
+    return Rendering::StaticSpriteBatch::kTaggedKeyBit |
+           (static_cast<std::uint64_t>(entity.generation() & 0x7fffffffu) << 32) |
+           entity.index();
+}
+
 bool lightOverlapsView(const Light& light, const glm::vec4& viewBounds) {
     if (light.type == LightType::DIRECTIONAL) {
         return true;
@@ -108,6 +114,70 @@ bool lightOverlapsView(const Light& light, const glm::vec4& viewBounds) {
 }
 }
 
+// Rebakes the static batch members that changed since the last frame. Legacy
+// sprites report changes through the scene; ECS decoration through the dirty
+// flag on its StaticSprite2D tag.
+void RenderSystem::updateStaticSprites(Scene& scene,
+                                       Rendering::Renderer& renderer) {
+    auto& staticSprites = renderer.staticSprites();
+    const bool rebuild = staticSprites.sourceEpoch() != scene.spriteIndexEpoch();
+    if (rebuild) {
+        staticSprites.clear();
+        staticSprites.setSourceEpoch(scene.spriteIndexEpoch());
+        scene.requeueStaticSprites();
+    }
+
+    for (const uint64_t entityId : scene.staticSpriteChanges()) {
+        const Scene::SpriteIndexRecord* record = scene.staticSpriteRecord(entityId);
+        const GameObjects::Sprite* sprite = record ? record->sprite->sprite() : nullptr;
+        if (!sprite) {
+            staticSprites.remove(entityId);
+            continue;
+        }
+        staticSprites.set(entityId, renderer.buildQuad(
+            *sprite, record->transform->modelMatrix(), record->sprite->layer(),
+            record->sprite->zIndex()));
+    }
+    scene.clearStaticSpriteChanges();
+
+    auto& registry = scene.registry();
+    std::size_t drawableTagged = 0;
+    registry.each<ECS::Transform2D, ECS::SpriteRender, ECS::StaticSprite2D>(
+        [&](ECS::Entity entity, const ECS::Transform2D& transform,
+            const ECS::SpriteRender& renderable, ECS::StaticSprite2D& tag) {
+            const bool drawable = renderable.visible && renderable.sprite;
+            drawableTagged += drawable ? 1 : 0;
+            if (!tag.dirty && !rebuild) {
+                return;
+            }
+            tag.dirty = false;
+            if (!drawable) {
+                staticSprites.remove(staticSpriteKey(entity));
+                return;
+            }
+            staticSprites.set(staticSpriteKey(entity), renderer.buildQuad(
+                *renderable.sprite, ECS::toMatrix(transform), renderable.layer,
+                renderable.zIndex, spriteRenderDrawData(renderable)));
+        });
+    // Destroyed or untagged entities leave members behind; a count mismatch is
+    // the only time the members are scanned.
+    if (staticSprites.taggedMemberCount() != drawableTagged) {
+        staticSprites.removeIf([&registry](std::uint64_t key) {
+            if (!(key & Rendering::StaticSpriteBatch::kTaggedKeyBit)) {
+                return false;
+            }
+            const ECS::Entity entity{
+                static_cast<ECS::Entity::Index>(key & 0xffffffffu),
+                static_cast<ECS::Entity::Generation>((key >> 32) & 0x7fffffffu)};
+            const auto* renderable = registry.alive(entity)
+                ? registry.tryGet<ECS::SpriteRender>(entity) : nullptr;
+            return !renderable || !renderable->visible || !renderable->sprite ||
+                   !registry.has<ECS::Transform2D>(entity) ||
+                   !registry.has<ECS::StaticSprite2D>(entity);
+        });
+    }
+}
+
 void RenderSystem::renderScene(Scene &scene, Camera &camera,
                                Rendering::Renderer &renderer) {
     const glm::mat4 &viewProj = camera.getViewProjection();
@@ -138,45 +208,59 @@ void RenderSystem::renderScene(Scene &scene, Camera &camera,
 
     renderer.tilemapRenderer().render(scene, viewProj);
 
+    // Static decoration is drawn from cached chunks merged into the sprite
+    // queue by layer/z; only members that changed are rebuilt.
+    scene.refreshSpriteIndex();
+    updateStaticSprites(scene, renderer);
+    renderer.drawStaticSprites(viewBounds);
+
     // Render interpolation: draw poses blended between the last two fixed
     // steps so movement is smooth at any display rate.
     const float interpolationAlpha =
         static_cast<float>(scene.interpolationAlpha());
 
-    for (auto &entityPtr : scene.getEntities()) {
-        if (!entityPtr) continue;
-        auto *spriteComp = entityPtr->getComponent<SpriteComponent>();
-        auto *transformComp = entityPtr->getComponent<TransformComponent>();
-        if (!spriteComp || !transformComp) continue;
+    // Legacy sprites come from the scene's spatial index, so extraction cost
+    // follows what is near the view rather than the level size. Candidates are
+    // restored to scene order to keep equal layer/z submission deterministic.
+    std::vector<Rendering::SpriteSpatialIndex::Handle> spriteCandidates;
+    scene.spriteIndex().query(viewBounds, spriteCandidates);
+    std::erase_if(spriteCandidates,
+        [&scene](Rendering::SpriteSpatialIndex::Handle handle) {
+            return scene.spriteIndexRecord(handle).batched;
+        });
+    std::sort(spriteCandidates.begin(), spriteCandidates.end(),
+        [&scene](Rendering::SpriteSpatialIndex::Handle left,
+                 Rendering::SpriteSpatialIndex::Handle right) {
+            return scene.spriteIndexRecord(left).sequence <
+                   scene.spriteIndexRecord(right).sequence;
+        });
+    for (const auto handle : spriteCandidates) {
+        const Scene::SpriteIndexRecord& record = scene.spriteIndexRecord(handle);
+        auto *sprite = record.sprite->sprite();
+        if (!sprite) continue;
 
-        const auto baseSize = spriteComp->sprite() ? spriteComp->sprite()->getSize() : glm::vec2(0.0f);
-        glm::mat4 model = transformComp->modelMatrix();
+        glm::mat4 model = record.transform->modelMatrix();
         if (const glm::vec2* previous =
-                scene.previousPosition(entityPtr->getId())) {
+                scene.previousPosition(record.entity->getId())) {
             const glm::vec2 interpolated = glm::mix(
-                *previous, transformComp->getTransform().Position,
+                *previous, record.transform->getTransform().Position,
                 interpolationAlpha);
             model[3].x = interpolated.x;
             model[3].y = interpolated.y;
         }
-        const glm::vec4 spriteAabb = transformedBounds(model, baseSize);
-
-        if (!overlaps(spriteAabb, viewBounds)) {
+        if (!overlaps(Rendering::spriteBounds(model, sprite->getSize()), viewBounds)) {
             continue;
         }
-
-        if (auto *sprite = spriteComp->sprite()) {
-            renderer.submitSprite(*sprite, model,
-                                  spriteComp->layer(),
-                                  spriteComp->zIndex());
-        }
+        renderer.submitSprite(*sprite, model, record.sprite->layer(),
+                              record.sprite->zIndex());
     }
 
     // ECS-native render extraction. It intentionally shares the same renderer
     // queue as legacy entities so sorting remains deterministic during migration.
     scene.registry().each<ECS::Transform2D, ECS::SpriteRender>(
         [&](ECS::Entity entity, const ECS::Transform2D& transform, const ECS::SpriteRender& renderable) {
-            if (!renderable.visible || !renderable.sprite) {
+            if (!renderable.visible || !renderable.sprite ||
+                scene.registry().has<ECS::StaticSprite2D>(entity)) {
                 return;
             }
             const auto* previous =
@@ -185,19 +269,11 @@ void RenderSystem::renderScene(Scene &scene, Camera &camera,
                 ? ECS::toMatrix(ECS::interpolatedTransform2D(
                       previous->value, transform, interpolationAlpha))
                 : ECS::toMatrix(transform);
-            if (!overlaps(transformedBounds(model, renderable.sprite->getSize()), viewBounds)) {
+            if (!overlaps(Rendering::spriteBounds(model, renderable.sprite->getSize()), viewBounds)) {
                 return;
             }
-            Rendering::SpriteDrawData drawData{};
-            drawData.color = renderable.sprite->getColor() * renderable.tint *
-                             renderable.animationTint;
-            drawData.uvRect = renderable.useCustomUV
-                ? renderable.uvRect : renderable.sprite->getUVCoords();
-            drawData.flipX = renderable.flipX;
-            drawData.textureOverride = renderable.textureOverride.get();
-            drawData.normalTextureOverride = renderable.normalTextureOverride.get();
             renderer.submitSprite(*renderable.sprite, model, renderable.layer,
-                                  renderable.zIndex, drawData);
+                                  renderable.zIndex, spriteRenderDrawData(renderable));
         });
 
     renderer.endFrame();
@@ -315,19 +391,18 @@ void RenderSystem::renderScene(Scene &scene, Camera &camera,
             });
         auto& particleRenderer = renderer.particleRenderer();
         particleRenderer.applyFeeling(scene.feelings().getSnapshot());
-        particleRenderer.begin(camera.getViewProjection(),
-                               camera.getViewBounds(0.1f));
+        const glm::vec4 particleView = camera.getViewBounds(0.1f);
+        particleRenderer.begin(camera.getViewProjection(), particleView);
         for (const ParticleDrawSource& source : particleSources) {
+                // Direct submission skips per-particle culling, so whole
+                // emitters are culled by their simulation bounds instead.
+                if (!particleRenderer.inView(source.emitter->emitter.simulationBounds())) {
+                    continue;
+                }
                 particleRenderer.setBlendMode(source.presentation->blendMode);
                 particleRenderer.setTexture(source.presentation->texture.get());
-                for (const Particle& particle : source.emitter->emitter.getParticles()) {
-                    if (particle.alive) {
-                        particleRenderer.submit({
-                            particle.position, particle.size,
-                            particle.rotation,
-                            particle.color * source.presentation->tint});
-                    }
-                }
+                particleRenderer.submit(source.emitter->emitter.particles(),
+                                        source.presentation->tint);
         }
         particleRenderer.end();
     }
@@ -17,6 +17,10 @@ public:
 
     // Renders all sprites within the camera view, with padding of half the view size.
     static void renderScene(Scene& scene, Camera& camera, Rendering::Renderer& renderer);
+
+private:
+    // Rebakes the static batch members that changed since the last frame.
+    static void updateStaticSprites(Scene& scene, Rendering::Renderer& renderer);
 };
 
 #endif //GL2D_RENDERSYSTEM_HPP
@@ -20,6 +20,7 @@
 #include <cstddef>
 #include <limits>
 #include <stdexcept>
+#include <utility>
 
 namespace Rendering {
 namespace {
@@ -76,8 +77,10 @@ bool finite(const glm::mat4& value) {
 }
 } // namespace
 
-Renderer::Renderer(const std::string &vsPath, const std::string &fsPath)
-    : m_shader(std::make_shared<Graphics::Shader>(vsPath, fsPath)) {
+Renderer::Renderer(const std::string &vsPath, const std::string &fsPath,
+                   VertexFormat vertexFormat)
+    : m_shader(std::make_shared<Graphics::Shader>(vsPath, fsPath)),
+      m_vertexFormat(vertexFormat) {
   try {
     createBuffers();
     createDefaultTexture();
@@ -107,15 +110,7 @@ void Renderer::createBuffers() {
   glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
   glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ibo);
 
-  glEnableVertexAttribArray(0);
-  glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-                        (void *)offsetof(Vertex, position));
-  glEnableVertexAttribArray(1);
-  glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-                        (void *)offsetof(Vertex, color));
-  glEnableVertexAttribArray(2);
-  glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-                        (void *)offsetof(Vertex, uv));
+  configureVertexAttributes(m_vertexFormat);
 
   glBindVertexArray(static_cast<GLuint>(previousVertexArray));
   glBindBuffer(GL_ARRAY_BUFFER, static_cast<GLuint>(previousArrayBuffer));
@@ -155,6 +150,7 @@ void Renderer::beginFrame(const glm::mat4 &viewProj,
   }
   m_viewProj = viewProj;
   m_quads.clear();
+  m_drawStaticThisFrame = false;
   m_frameActive = true;
   if (clearBuffer) {
       glClearColor(clearColor.r, clearColor.g, clearColor.b, clearColor.a);
@@ -166,11 +162,10 @@ void Renderer::submitSprite(const GameObjects::Sprite &sprite,
                             const glm::mat4 &model,
                             int layer,
                             int zOrder) {
-  SpriteDrawData drawData{};
-  drawData.color = sprite.getColor();
-  drawData.uvRect = sprite.getUVCoords();
-  drawData.flipX = sprite.isFlipX();
-  submitSprite(sprite, model, layer, zOrder, drawData);
+  if (!m_frameActive) {
+    throw std::logic_error("Renderer::submitSprite requires an active frame");
+  }
+  m_quads.push_back(buildQuad(sprite, model, layer, zOrder));
 }
 
 void Renderer::submitSprite(const GameObjects::Sprite &sprite,
@@ -181,18 +176,35 @@ void Renderer::submitSprite(const GameObjects::Sprite &sprite,
   if (!m_frameActive) {
     throw std::logic_error("Renderer::submitSprite requires an active frame");
   }
+  m_quads.push_back(buildQuad(sprite, model, layer, zOrder, drawData));
+}
+
+Renderer::Quad Renderer::buildQuad(const GameObjects::Sprite &sprite,
+                                   const glm::mat4 &model, int layer,
+                                   int zOrder) const {
+  SpriteDrawData drawData{};
+  drawData.color = sprite.getColor();
+  drawData.uvRect = sprite.getUVCoords();
+  drawData.flipX = sprite.isFlipX();
+  return buildQuad(sprite, model, layer, zOrder, drawData);
+}
+
+Renderer::Quad Renderer::buildQuad(const GameObjects::Sprite &sprite,
+                                   const glm::mat4 &model, int layer,
+                                   int zOrder,
+                                   const SpriteDrawData &drawData) const {
   const glm::vec2 size = sprite.getSize();
   if (!finite(model) || !finite(drawData.color) || !finite(drawData.uvRect) ||
       !finite(size) || size.x < 0.0f || size.y < 0.0f) {
     throw std::invalid_argument(
         "Renderer sprite transform, size, color, and UVs must be finite; size cannot be negative");
   }
+  const GameObjects::Texture *albedo =
+      drawData.textureOverride ? drawData.textureOverride
+      : sprite.hasTexture()    ? sprite.getTexture().get()
+                               : nullptr;
   Quad quad{};
-  quad.textureId = drawData.textureOverride
-                       ? drawData.textureOverride->getID()
-                       : sprite.hasTexture() && sprite.getTexture()
-                       ? sprite.getTexture()->getID()
-                       : m_defaultTexture;
+  quad.textureId = albedo ? albedo->getID() : m_defaultTexture;
   quad.normalTextureId = drawData.normalTextureOverride
                          ? drawData.normalTextureOverride->getID()
                          : sprite.hasNormalTexture() && sprite.getNormalTexture()
@@ -202,7 +214,14 @@ void Renderer::submitSprite(const GameObjects::Sprite &sprite,
   quad.zIndex = zOrder;
 
   const auto &color = drawData.color;
-  const auto &uv = drawData.uvRect;
+  glm::vec4 uv = drawData.uvRect;
+  if (albedo && albedo->isAtlasRegion()) {
+    // Sprite UVs address the region; remap them onto its atlas page.
+    const glm::vec4 &region = albedo->uvRect();
+    const glm::vec2 extent{region.z - region.x, region.w - region.y};
+    uv = {region.x + uv.x * extent.x, region.y + uv.y * extent.y,
+          region.x + uv.z * extent.x, region.y + uv.w * extent.y};
+  }
   const std::array<glm::vec2, 4> localPositions = {
       glm::vec2(0.0f, size.y), glm::vec2(size.x, size.y),
       glm::vec2(size.x, 0.0f), glm::vec2(0.0f, 0.0f)};
@@ -219,12 +238,42 @@ void Renderer::submitSprite(const GameObjects::Sprite &sprite,
     quad.verts[i] = makeVertex(glm::vec2(world.x, world.y), tintedColor,
                                uvCoords[i]);
   }
+  return quad;
+}
+
+void Renderer::drawStaticSprites(const glm::vec4 &viewBounds) {
+  if (!m_frameActive) {
+    throw std::logic_error("Renderer::drawStaticSprites requires an active frame");
+  }
+  if (!finite(viewBounds)) {
+    throw std::invalid_argument("Renderer static sprite view bounds must be finite");
+  }
+  m_drawStaticThisFrame = true;
+  m_staticViewBounds = viewBounds;
+}
 
-  m_quads.push_back(quad);
+void Renderer::drawStaticChunk(StaticSpriteBatch::Chunk &chunk,
+                               GLuint textureId, GLuint normalTextureId) {
+  m_staticSprites->upload(chunk);
+  if (chunk.indexCount == 0) {
+    return;
+  }
+  glBindVertexArray(chunk.vao);
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_2D, textureId);
+  glActiveTexture(GL_TEXTURE1);
+  glBindTexture(GL_TEXTURE_2D, normalTextureId);
+  glDrawElements(GL_TRIANGLES, chunk.indexCount, GL_UNSIGNED_INT, nullptr);
+  glBindVertexArray(m_vao);
 }
 
 void Renderer::flush() {
-  if (m_quads.empty()) {
+  std::vector<std::pair<const StaticSpriteBatch::ChunkKey *,
+                        StaticSpriteBatch::Chunk *>> staticChunks;
+  if (m_drawStaticThisFrame && m_staticSprites) {
+    m_staticSprites->collectVisible(m_staticViewBounds, staticChunks);
+  }
+  if (m_quads.empty() && staticChunks.empty()) {
     return;
   }
 
@@ -245,13 +294,33 @@ void Renderer::flush() {
   glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
   glBindVertexArray(m_vao);
 
-  std::vector<Vertex> vertices;
+  std::vector<std::byte> vertices;
   std::vector<uint32_t> indices;
+  const std::size_t stride = vertexStride(m_vertexFormat);
   constexpr std::size_t maxQuadsPerBatch = std::min(
       static_cast<std::size_t>(std::numeric_limits<std::uint32_t>::max() / 4U),
       static_cast<std::size_t>(std::numeric_limits<GLsizei>::max() / 6));
+  // Static chunks arrive in (layer, zIndex) order and are drawn ahead of
+  // queued sprites with the same layer/z, so decoration stays behind
+  // dynamic sprites sharing its slot.
+  size_t staticIndex = 0;
+  const auto staticPrecedes = [&](const Quad &quad) {
+    if (staticIndex >= staticChunks.size()) return false;
+    const auto &key = *staticChunks[staticIndex].first;
+    return key.layer != quad.layer ? key.layer < quad.layer
+                                   : key.zIndex <= quad.zIndex;
+  };
+  const auto drawNextStaticChunk = [&]() {
+    const auto &[key, chunk] = staticChunks[staticIndex++];
+    drawStaticChunk(*chunk, key->textureId, key->normalTextureId);
+  };
+
   size_t quadIndex = 0;
   while (quadIndex < m_quads.size()) {
+    while (staticPrecedes(m_quads[quadIndex])) {
+      drawNextStaticChunk();
+    }
+    const size_t batchStart = quadIndex;
     const GLuint currentTexture = m_quads[quadIndex].textureId;
     const GLuint currentNormal = m_quads[quadIndex].normalTextureId;
     vertices.clear();
@@ -260,12 +329,12 @@ void Renderer::flush() {
     for (; quadIndex < m_quads.size() &&
            m_quads[quadIndex].textureId == currentTexture &&
            m_quads[quadIndex].normalTextureId == currentNormal &&
-           vertices.size() / 4U < maxQuadsPerBatch;
+           vertices.size() / (4U * stride) < maxQuadsPerBatch &&
+           (quadIndex == batchStart || !staticPrecedes(m_quads[quadIndex]));
          ++quadIndex) {
       const auto &quad = m_quads[quadIndex];
-      const auto base = static_cast<uint32_t>(vertices.size());
-      vertices.insert(vertices.end(), std::begin(quad.verts),
-                      std::end(quad.verts));
+      const auto base = static_cast<uint32_t>(vertices.size() / stride);
+      appendVertices(m_vertexFormat, quad.verts, 4U, vertices);
       indices.insert(indices.end(),
                      {base, static_cast<uint32_t>(base + 1),
                       static_cast<uint32_t>(base + 2),
@@ -274,8 +343,7 @@ void Renderer::flush() {
     }
 
     glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
-    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(vertices.size() *
-                                                          sizeof(Vertex)),
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(vertices.size()),
                  vertices.data(), GL_DYNAMIC_DRAW);
 
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ibo);
@@ -291,6 +359,9 @@ void Renderer::flush() {
     glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(indices.size()),
                    GL_UNSIGNED_INT, nullptr);
   }
+  while (staticIndex < staticChunks.size()) {
+    drawNextStaticChunk();
+  }
 
   glBindVertexArray(0);
   glActiveTexture(GL_TEXTURE1);
@@ -367,4 +438,12 @@ LightingPass& Renderer::lightingPass() {
   if (!m_lightingPass) m_lightingPass = std::make_unique<LightingPass>();
   return *m_lightingPass;
 }
+
+StaticSpriteBatch& Renderer::staticSprites() {
+  if (!m_staticSprites) {
+    m_staticSprites = std::make_unique<StaticSpriteBatch>(
+        StaticSpriteBatch::defaultChunkSize, m_vertexFormat);
+  }
+  return *m_staticSprites;
+}
 } // namespace Rendering
@@ -16,6 +16,8 @@
 #include "GameObjects/Sprite.hpp"
 #include "FeelingsSystem/FeelingSnapshot.hpp"
 #include "RenderingSystem/RenderLayers.hpp"
+#include "RenderingSystem/StaticSpriteBatch.hpp"
+#include "RenderingSystem/VertexLayout.hpp"
 
 class RenderSystem;
 
@@ -38,8 +40,11 @@ struct SpriteDrawData {
 
 class Renderer {
 public:
+  // VertexFormat::Compact halves sprite vertex bandwidth but clamps colors
+  // and UVs to [0, 1].
   explicit Renderer(const std::string &vsPath = "Shaders/vertex.vert",
-           const std::string &fsPath = "Shaders/fragment.frag");
+           const std::string &fsPath = "Shaders/fragment.frag",
+           VertexFormat vertexFormat = VertexFormat::Standard);
   ~Renderer();
 
   Renderer(const Renderer &other) = delete;
@@ -61,13 +66,20 @@ public:
 private:
   friend class ::RenderSystem;
 
-  struct Quad {
-    GLuint textureId{0};
-    GLuint normalTextureId{0};
-    int layer{static_cast<int>(RenderLayer::Gameplay)};
-    int zIndex{0};
-    Vertex verts[4];
-  };
+  using Quad = SpriteQuad;
+  // Validates and transforms a sprite into a world-space quad, as submitted.
+  [[nodiscard]] Quad buildQuad(const GameObjects::Sprite &sprite,
+                               const glm::mat4 &model, int layer, int zOrder,
+                               const SpriteDrawData &drawData) const;
+  [[nodiscard]] Quad buildQuad(const GameObjects::Sprite &sprite,
+                               const glm::mat4 &model, int layer,
+                               int zOrder) const;
+  // Draws the static batch chunks overlapping `viewBounds` in this frame,
+  // merged with the queued sprites by layer/z. Reset by beginFrame so overlay
+  // frames do not repeat the level.
+  void drawStaticSprites(const glm::vec4 &viewBounds);
+  void drawStaticChunk(StaticSpriteBatch::Chunk &chunk, GLuint textureId,
+                       GLuint normalTextureId);
   void createDefaultTexture();
   void createDefaultNormalTexture();
 
@@ -81,8 +93,10 @@ private:
   ParticleRenderer& particleRenderer();
   TilemapRenderer& tilemapRenderer();
   LightingPass& lightingPass();
+  StaticSpriteBatch& staticSprites();
 
   std::shared_ptr<Graphics::Shader> m_shader;
+  VertexFormat m_vertexFormat{VertexFormat::Standard};
   GLuint m_vao{}, m_vbo{}, m_ibo{};
   GLuint m_defaultTexture{0};
   GLuint m_defaultNormal{0};
@@ -90,12 +104,15 @@ private:
   std::vector<Quad> m_quads;
   glm::vec4 m_globalTint{1.0f, 1.0f, 1.0f, 1.0f};
   bool m_frameActive{false};
+  bool m_drawStaticThisFrame{false};
+  glm::vec4 m_staticViewBounds{0.0f};
   std::unique_ptr<RenderTarget> m_sceneTarget;
   std::unique_ptr<ColorRenderTarget> m_lightingTarget;
   std::unique_ptr<PostProcessPipeline> m_postProcessor;
   std::unique_ptr<ParticleRenderer> m_particleRenderer;
   std::unique_ptr<TilemapRenderer> m_tilemapRenderer;
   std::unique_ptr<LightingPass> m_lightingPass;
+  std::unique_ptr<StaticSpriteBatch> m_staticSprites;
 };
 
 } // namespace Rendering
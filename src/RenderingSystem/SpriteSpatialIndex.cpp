@@ -0,0 +1,246 @@
+//
+// SpriteSpatialIndex.cpp
+//
+
+#include "SpriteSpatialIndex.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include <glm/common.hpp>
+
+namespace Rendering {
+namespace {
+// Keeps cell coordinates of far-away (but finite) bounds inside int range.
+constexpr float kCellCoordinateLimit = static_cast<float>(1 << 29);
+
+bool finite(const glm::vec4& value) {
+    return std::isfinite(value.x) && std::isfinite(value.y) &&
+           std::isfinite(value.z) && std::isfinite(value.w);
+}
+
+void validateBounds(const glm::vec4& bounds) {
+    if (!finite(bounds) || bounds.x > bounds.z || bounds.y > bounds.w) {
+        throw std::invalid_argument(
+            "SpriteSpatialIndex bounds must be finite with min <= max");
+    }
+}
+
+bool overlaps(const glm::vec4& a, const glm::vec4& b) {
+    return !(a.z < b.x || a.x > b.z || a.w < b.y || a.y > b.w);
+}
+} // namespace
+
+glm::vec4 spriteBounds(const glm::mat4& model, const glm::vec2& size) {
+    const glm::vec2 corners[] = {{0.0f, 0.0f}, {size.x, 0.0f},
+                                 {size.x, size.y}, {0.0f, size.y}};
+    glm::vec2 minPoint{std::numeric_limits<float>::max()};
+    glm::vec2 maxPoint{std::numeric_limits<float>::lowest()};
+    for (const glm::vec2& corner : corners) {
+        const glm::vec4 world = model * glm::vec4(corner, 0.0f, 1.0f);
+        const glm::vec2 point{world.x, world.y};
+        minPoint = glm::min(minPoint, point);
+        maxPoint = glm::max(maxPoint, point);
+    }
+    return {minPoint.x, minPoint.y, maxPoint.x, maxPoint.y};
+}
+
+SpriteSpatialIndex::SpriteSpatialIndex(float cellSize, int maxCellsPerEntry)
+    : m_cellSize(cellSize),
+      m_inverseCellSize(1.0f / cellSize),
+      m_maxCellsPerEntry(maxCellsPerEntry) {
+    if (!std::isfinite(cellSize) || cellSize <= 0.0f) {
+        throw std::invalid_argument(
+            "SpriteSpatialIndex cell size must be finite and positive");
+    }
+    if (maxCellsPerEntry <= 0) {
+        throw std::invalid_argument(
+            "SpriteSpatialIndex requires at least one cell per entry");
+    }
+}
+
+std::uint64_t SpriteSpatialIndex::cellKey(int x, int y) noexcept {
+    return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(x)) << 32) |
+           static_cast<std::uint32_t>(y);
+}
+
+SpriteSpatialIndex::CellRange
+SpriteSpatialIndex::cellRange(const glm::vec4& bounds) const {
+    const auto cell = [this](float coordinate) {
+        return static_cast<int>(std::clamp(std::floor(coordinate * m_inverseCellSize),
+                                           -kCellCoordinateLimit,
+                                           kCellCoordinateLimit));
+    };
+    CellRange range{cell(bounds.x), cell(bounds.y), cell(bounds.z),
+                    cell(bounds.w), false};
+    const std::int64_t cellCount =
+        (static_cast<std::int64_t>(range.maxX) - range.minX + 1) *
+        (static_cast<std::int64_t>(range.maxY) - range.minY + 1);
+    range.oversized = cellCount > m_maxCellsPerEntry;
+    return range;
+}
+
+void SpriteSpatialIndex::link(Handle handle, const CellRange& cells) {
+    if (cells.oversized) {
+        m_oversized.push_back(handle);
+        return;
+    }
+    for (int y = cells.minY; y <= cells.maxY; ++y) {
+        for (int x = cells.minX; x <= cells.maxX; ++x) {
+            m_cells[cellKey(x, y)].push_back(handle);
+        }
+    }
+}
+
+void SpriteSpatialIndex::unlink(Handle handle, const CellRange& cells) {
+    const auto eraseFrom = [handle](std::vector<Handle>& handles) {
+        const auto it = std::find(handles.begin(), handles.end(), handle);
+        if (it != handles.end()) {
+            *it = handles.back();
+            handles.pop_back();
+        }
+    };
+    if (cells.oversized) {
+        eraseFrom(m_oversized);
+        return;
+    }
+    for (int y = cells.minY; y <= cells.maxY; ++y) {
+        for (int x = cells.minX; x <= cells.maxX; ++x) {
+            const auto it = m_cells.find(cellKey(x, y));
+            if (it == m_cells.end()) continue;
+            eraseFrom(it->second);
+            if (it->second.empty()) {
+                m_cells.erase(it);
+            }
+        }
+    }
+}
+
+SpriteSpatialIndex::Handle SpriteSpatialIndex::insert(const glm::vec4& bounds) {
+    validateBounds(bounds);
+    Handle handle = invalidHandle;
+    if (!m_freeHandles.empty()) {
+        handle = m_freeHandles.back();
+        m_freeHandles.pop_back();
+    } else {
+        if (m_entries.size() >= invalidHandle) {
+            throw std::length_error("SpriteSpatialIndex handle space exhausted");
+        }
+        handle = static_cast<Handle>(m_entries.size());
+        m_entries.emplace_back();
+        m_visitStamps.push_back(0);
+    }
+    Entry& entry = m_entries[handle];
+    entry.bounds = bounds;
+    entry.cells = cellRange(bounds);
+    entry.live = true;
+    link(handle, entry.cells);
+    ++m_liveCount;
+    return handle;
+}
+
+void SpriteSpatialIndex::update(Handle handle, const glm::vec4& bounds) {
+    if (!contains(handle)) {
+        throw std::out_of_range("SpriteSpatialIndex::update received a stale handle");
+    }
+    validateBounds(bounds);
+    Entry& entry = m_entries[handle];
+    entry.bounds = bounds;
+    const CellRange cells = cellRange(bounds);
+    if (cells == entry.cells) {
+        return;
+    }
+    unlink(handle, entry.cells);
+    entry.cells = cells;
+    link(handle, entry.cells);
+}
+
+void SpriteSpatialIndex::remove(Handle handle) {
+    if (!contains(handle)) {
+        return;
+    }
+    Entry& entry = m_entries[handle];
+    unlink(handle, entry.cells);
+    entry.live = false;
+    m_freeHandles.push_back(handle);
+    --m_liveCount;
+}
+
+void SpriteSpatialIndex::clear() noexcept {
+    m_entries.clear();
+    m_freeHandles.clear();
+    m_cells.clear();
+    m_oversized.clear();
+    m_visitStamps.clear();
+    m_liveCount = 0;
+    m_queryStamp = 0;
+}
+
+bool SpriteSpatialIndex::contains(Handle handle) const noexcept {
+    return handle < m_entries.size() && m_entries[handle].live;
+}
+
+const glm::vec4& SpriteSpatialIndex::bounds(Handle handle) const {
+    if (!contains(handle)) {
+        throw std::out_of_range("SpriteSpatialIndex::bounds received a stale handle");
+    }
+    return m_entries[handle].bounds;
+}
+
+bool SpriteSpatialIndex::visit(Handle handle) const {
+    if (m_visitStamps[handle] == m_queryStamp) {
+        return false;
+    }
+    m_visitStamps[handle] = m_queryStamp;
+    return true;
+}
+
+void SpriteSpatialIndex::query(const glm::vec4& bounds,
+                               std::vector<Handle>& output) const {
+    validateBounds(bounds);
+    if (m_liveCount == 0) {
+        return;
+    }
+    if (++m_queryStamp == 0) {
+        std::fill(m_visitStamps.begin(), m_visitStamps.end(), 0u);
+        m_queryStamp = 1;
+    }
+
+    const auto collect = [&](const std::vector<Handle>& handles) {
+        for (const Handle handle : handles) {
+            if (visit(handle) && overlaps(m_entries[handle].bounds, bounds)) {
+                output.push_back(handle);
+            }
+        }
+    };
+
+    collect(m_oversized);
+    const CellRange range = cellRange(bounds);
+    const std::int64_t rangeCells =
+        (static_cast<std::int64_t>(range.maxX) - range.minX + 1) *
+        (static_cast<std::int64_t>(range.maxY) - range.minY + 1);
+    if (rangeCells > static_cast<std::int64_t>(m_cells.size())) {
+        // Zoomed far out: walking the occupied cells is cheaper than probing
+        // every empty cell under the query.
+        for (const auto& [key, handles] : m_cells) {
+            const int x = static_cast<int>(static_cast<std::uint32_t>(key >> 32));
+            const int y = static_cast<int>(static_cast<std::uint32_t>(key));
+            if (x >= range.minX && x <= range.maxX && y >= range.minY &&
+                y <= range.maxY) {
+                collect(handles);
+            }
+        }
+        return;
+    }
+    for (int y = range.minY; y <= range.maxY; ++y) {
+        for (int x = range.minX; x <= range.maxX; ++x) {
+            const auto it = m_cells.find(cellKey(x, y));
+            if (it != m_cells.end()) {
+                collect(it->second);
+            }
+        }
+    }
+}
+
+} // namespace Rendering
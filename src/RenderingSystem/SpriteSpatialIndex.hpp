@@ -0,0 +1,96 @@
+//
+// SpriteSpatialIndex.hpp
+//
+
+#ifndef GL2D_SPRITESPATIALINDEX_HPP
+#define GL2D_SPRITESPATIALINDEX_HPP
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+namespace Rendering {
+
+// World-space bounds of a sprite quad of `size` placed by `model`, packed as
+// {minX, minY, maxX, maxY} to match Camera::getViewBounds.
+glm::vec4 spriteBounds(const glm::mat4& model, const glm::vec2& size);
+
+// Render-side uniform grid over sprite bounds, maintained incrementally.
+// Entries are binned into every cell they overlap, so a moving sprite only
+// re-bins when its covered cell range changes. Entries spanning more than
+// `maxCellsPerEntry` cells (backdrops, skies) live in a small list that every
+// query tests instead of being smeared across the grid. Queries visit only
+// the cells under the requested bounds and report each entry once.
+class SpriteSpatialIndex final {
+public:
+    using Handle = std::uint32_t;
+    static constexpr Handle invalidHandle = std::numeric_limits<Handle>::max();
+
+    explicit SpriteSpatialIndex(float cellSize = 512.0f,
+                                int maxCellsPerEntry = 64);
+
+    // Handles are dense and recycled after remove(), so callers may use them
+    // to index parallel per-entry arrays.
+    Handle insert(const glm::vec4& bounds);
+    void update(Handle handle, const glm::vec4& bounds);
+    void remove(Handle handle);
+    void clear() noexcept;
+
+    // Appends every live handle whose bounds overlap `bounds`, each once, in
+    // no particular order.
+    void query(const glm::vec4& bounds, std::vector<Handle>& output) const;
+
+    [[nodiscard]] bool contains(Handle handle) const noexcept;
+    [[nodiscard]] const glm::vec4& bounds(Handle handle) const;
+    [[nodiscard]] std::size_t size() const noexcept { return m_liveCount; }
+    [[nodiscard]] bool empty() const noexcept { return m_liveCount == 0; }
+    [[nodiscard]] std::size_t occupiedCells() const noexcept { return m_cells.size(); }
+    [[nodiscard]] std::size_t oversizedCount() const noexcept { return m_oversized.size(); }
+    [[nodiscard]] float cellSize() const noexcept { return m_cellSize; }
+
+private:
+    struct CellRange {
+        int minX{0};
+        int minY{0};
+        int maxX{-1};
+        int maxY{-1};
+        bool oversized{false};
+
+        bool operator==(const CellRange&) const = default;
+    };
+
+    struct Entry {
+        glm::vec4 bounds{0.0f};
+        CellRange cells{};
+        bool live{false};
+    };
+
+    [[nodiscard]] CellRange cellRange(const glm::vec4& bounds) const;
+    void link(Handle handle, const CellRange& cells);
+    void unlink(Handle handle, const CellRange& cells);
+    [[nodiscard]] bool visit(Handle handle) const;
+    static std::uint64_t cellKey(int x, int y) noexcept;
+
+    float m_cellSize{512.0f};
+    float m_inverseCellSize{1.0f / 512.0f};
+    int m_maxCellsPerEntry{64};
+    std::vector<Entry> m_entries;
+    std::vector<Handle> m_freeHandles;
+    std::unordered_map<std::uint64_t, std::vector<Handle>> m_cells;
+    std::vector<Handle> m_oversized;
+    std::size_t m_liveCount{0};
+    // Per-entry stamps deduplicate entries reached through several cells
+    // without a per-query set.
+    mutable std::vector<std::uint32_t> m_visitStamps;
+    mutable std::uint32_t m_queryStamp{0};
+};
+
+} // namespace Rendering
+
+#endif // GL2D_SPRITESPATIALINDEX_HPP
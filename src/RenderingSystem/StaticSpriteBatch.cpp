@@ -0,0 +1,236 @@
+//
+// StaticSpriteBatch.cpp
+//
+
+#include "StaticSpriteBatch.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace Rendering {
+namespace {
+// Keeps cell coordinates of far-away (but finite) quads inside int range.
+constexpr float kCellCoordinateLimit = static_cast<float>(1 << 29);
+
+glm::vec4 quadBounds(const SpriteQuad& quad) {
+    glm::vec4 bounds{std::numeric_limits<float>::max(),
+                     std::numeric_limits<float>::max(),
+                     std::numeric_limits<float>::lowest(),
+                     std::numeric_limits<float>::lowest()};
+    for (const Vertex& vertex : quad.verts) {
+        bounds.x = std::min(bounds.x, vertex.position.x);
+        bounds.y = std::min(bounds.y, vertex.position.y);
+        bounds.z = std::max(bounds.z, vertex.position.x);
+        bounds.w = std::max(bounds.w, vertex.position.y);
+    }
+    return bounds;
+}
+
+glm::vec4 merged(const glm::vec4& a, const glm::vec4& b) {
+    return {std::min(a.x, b.x), std::min(a.y, b.y),
+            std::max(a.z, b.z), std::max(a.w, b.w)};
+}
+
+bool overlaps(const glm::vec4& a, const glm::vec4& b) {
+    return !(a.z < b.x || a.x > b.z || a.w < b.y || a.y > b.w);
+}
+} // namespace
+
+StaticSpriteBatch::StaticSpriteBatch(float chunkSize, VertexFormat format)
+    : m_chunkSize(chunkSize), m_format(format) {
+    if (!std::isfinite(chunkSize) || chunkSize <= 0.0f) {
+        throw std::invalid_argument(
+            "StaticSpriteBatch chunk size must be finite and positive");
+    }
+}
+
+StaticSpriteBatch::~StaticSpriteBatch() { clear(); }
+
+void StaticSpriteBatch::destroyBuffers(Chunk& chunk) noexcept {
+    if (chunk.vbo) glDeleteBuffers(1, &chunk.vbo);
+    if (chunk.ibo) glDeleteBuffers(1, &chunk.ibo);
+    if (chunk.vao) glDeleteVertexArrays(1, &chunk.vao);
+    chunk.vbo = 0;
+    chunk.ibo = 0;
+    chunk.vao = 0;
+    chunk.indexCount = 0;
+}
+
+StaticSpriteBatch::ChunkKey
+StaticSpriteBatch::chunkKeyFor(const SpriteQuad& quad,
+                               const glm::vec4& bounds) const {
+    // Members are binned by their centre, so a chunk's bounds may overhang its
+    // cell by at most half of its largest member.
+    const auto cell = [this](float coordinate) {
+        return static_cast<int>(std::clamp(std::floor(coordinate / m_chunkSize),
+                                           -kCellCoordinateLimit,
+                                           kCellCoordinateLimit));
+    };
+    return {quad.layer, quad.zIndex, quad.textureId, quad.normalTextureId,
+            cell((bounds.x + bounds.z) * 0.5f), cell((bounds.y + bounds.w) * 0.5f)};
+}
+
+void StaticSpriteBatch::set(std::uint64_t key, const SpriteQuad& quad) {
+    const glm::vec4 bounds = quadBounds(quad);
+    if (!std::isfinite(bounds.x) || !std::isfinite(bounds.y) ||
+        !std::isfinite(bounds.z) || !std::isfinite(bounds.w)) {
+        throw std::invalid_argument("StaticSpriteBatch quads must be finite");
+    }
+    const ChunkKey chunkKey = chunkKeyFor(quad, bounds);
+
+    auto existing = m_members.find(key);
+    if (existing != m_members.end()) {
+        if (existing->second.chunk == chunkKey) {
+            existing->second.quad = quad;
+            existing->second.bounds = bounds;
+            Chunk& chunk = m_chunks.at(chunkKey);
+            chunk.dirty = true;
+            chunk.bounds = merged(chunk.bounds, bounds);
+            return;
+        }
+        detach(key, existing->second);
+        m_members.erase(existing);
+        if (key & kTaggedKeyBit) {
+            --m_taggedMembers;
+        }
+        existing = m_members.end();
+    }
+
+    if (existing == m_members.end() && (key & kTaggedKeyBit)) {
+        ++m_taggedMembers;
+    }
+    m_members.emplace(key, Member{quad, bounds, chunkKey});
+    auto [it, inserted] = m_chunks.try_emplace(chunkKey);
+    Chunk& chunk = it->second;
+    chunk.bounds = inserted ? bounds : merged(chunk.bounds, bounds);
+    chunk.members.push_back(key);
+    chunk.dirty = true;
+}
+
+void StaticSpriteBatch::detach(std::uint64_t key, const Member& member) {
+    const auto chunkIt = m_chunks.find(member.chunk);
+    if (chunkIt == m_chunks.end()) {
+        return;
+    }
+    Chunk& chunk = chunkIt->second;
+    std::erase(chunk.members, key);
+    if (chunk.members.empty()) {
+        destroyBuffers(chunk);
+        m_chunks.erase(chunkIt);
+        return;
+    }
+    chunk.bounds = m_members.at(chunk.members.front()).bounds;
+    for (const std::uint64_t remaining : chunk.members) {
+        chunk.bounds = merged(chunk.bounds, m_members.at(remaining).bounds);
+    }
+    chunk.dirty = true;
+}
+
+bool StaticSpriteBatch::remove(std::uint64_t key) {
+    const auto it = m_members.find(key);
+    if (it == m_members.end()) {
+        return false;
+    }
+    detach(key, it->second);
+    m_members.erase(it);
+    if (key & kTaggedKeyBit) {
+        --m_taggedMembers;
+    }
+    return true;
+}
+
+void StaticSpriteBatch::clear() noexcept {
+    for (auto& [key, chunk] : m_chunks) {
+        (void)key;
+        destroyBuffers(chunk);
+    }
+    m_chunks.clear();
+    m_members.clear();
+    m_taggedMembers = 0;
+}
+
+bool StaticSpriteBatch::contains(std::uint64_t key) const noexcept {
+    return m_members.contains(key);
+}
+
+std::size_t StaticSpriteBatch::dirtyChunkCount() const noexcept {
+    return static_cast<std::size_t>(std::count_if(
+        m_chunks.begin(), m_chunks.end(),
+        [](const auto& entry) { return entry.second.dirty; }));
+}
+
+void StaticSpriteBatch::collectVisible(
+    const glm::vec4& viewBounds,
+    std::vector<std::pair<const ChunkKey*, Chunk*>>& output) {
+    for (auto& [key, chunk] : m_chunks) {
+        if (overlaps(chunk.bounds, viewBounds)) {
+            output.emplace_back(&key, &chunk);
+        }
+    }
+}
+
+void StaticSpriteBatch::buildGeometry(const Chunk& chunk,
+                                      std::vector<Vertex>& vertices,
+                                      std::vector<std::uint32_t>& indices) const {
+    vertices.clear();
+    indices.clear();
+    vertices.reserve(chunk.members.size() * 4U);
+    indices.reserve(chunk.members.size() * 6U);
+    for (const std::uint64_t key : chunk.members) {
+        const SpriteQuad& quad = m_members.at(key).quad;
+        const auto base = static_cast<std::uint32_t>(vertices.size());
+        vertices.insert(vertices.end(), std::begin(quad.verts), std::end(quad.verts));
+        indices.insert(indices.end(),
+                       {base, base + 1U, base + 2U, base + 2U, base + 3U, base});
+    }
+}
+
+void StaticSpriteBatch::upload(Chunk& chunk) {
+    if (!chunk.dirty && chunk.vao) {
+        return;
+    }
+    if (chunk.members.size() >
+        static_cast<std::size_t>(std::numeric_limits<GLsizei>::max()) / 6U) {
+        throw std::length_error("StaticSpriteBatch chunk exceeds OpenGL index limits");
+    }
+    std::vector<Vertex> vertices;
+    std::vector<std::uint32_t> indices;
+    buildGeometry(chunk, vertices, indices);
+
+    GLint previousVertexArray = 0;
+    GLint previousArrayBuffer = 0;
+    glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &previousVertexArray);
+    glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &previousArrayBuffer);
+    if (!chunk.vao) {
+        glGenVertexArrays(1, &chunk.vao);
+        glGenBuffers(1, &chunk.vbo);
+        glGenBuffers(1, &chunk.ibo);
+        if (!chunk.vao || !chunk.vbo || !chunk.ibo) {
+            destroyBuffers(chunk);
+            throw std::runtime_error("OpenGL failed to allocate static sprite buffers");
+        }
+        glBindVertexArray(chunk.vao);
+        glBindBuffer(GL_ARRAY_BUFFER, chunk.vbo);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, chunk.ibo);
+        configureVertexAttributes(m_format);
+    } else {
+        glBindVertexArray(chunk.vao);
+        glBindBuffer(GL_ARRAY_BUFFER, chunk.vbo);
+    }
+    std::vector<std::byte> encoded;
+    appendVertices(m_format, vertices.data(), vertices.size(), encoded);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(encoded.size()),
+                 encoded.data(), GL_STATIC_DRAW);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER,
+                 static_cast<GLsizeiptr>(indices.size() * sizeof(std::uint32_t)),
+                 indices.data(), GL_STATIC_DRAW);
+    glBindVertexArray(static_cast<GLuint>(previousVertexArray));
+    glBindBuffer(GL_ARRAY_BUFFER, static_cast<GLuint>(previousArrayBuffer));
+
+    chunk.indexCount = static_cast<GLsizei>(indices.size());
+    chunk.dirty = false;
+}
+
+} // namespace Rendering
@@ -0,0 +1,140 @@
+//
+// StaticSpriteBatch.hpp
+//
+
+#ifndef GL2D_STATICSPRITEBATCH_HPP
+#define GL2D_STATICSPRITEBATCH_HPP
+
+#include <GL/glew.h>
+#include <glm/vec4.hpp>
+
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "GameObjects/Vertex.hpp"
+#include "RenderingSystem/RenderLayers.hpp"
+#include "RenderingSystem/VertexLayout.hpp"
+
+namespace Rendering {
+
+// A transformed, tinted sprite quad ready for batching.
+struct SpriteQuad {
+    GLuint textureId{0};
+    GLuint normalTextureId{0};
+    int layer{static_cast<int>(RenderLayer::Gameplay)};
+    int zIndex{0};
+    Vertex verts[4];
+};
+
+// Cache of sprites that do not move. Members are baked once into vertex
+// buffers grouped by layer, z-index, texture pair and a world-space chunk, so
+// a frame only culls whole chunks and re-uploads the chunks whose members
+// changed. Chunks iterate in (layer, zIndex) order for merging with the
+// dynamic queue; within one layer/z slot static sprites are grouped by
+// texture, so overlapping static decoration should use distinct z-indices.
+class StaticSpriteBatch {
+public:
+    // Keys with this bit set form a second key space (RenderSystem uses it for
+    // ECS entities); taggedMemberCount() lets a caller notice vanished members
+    // without scanning.
+    static constexpr std::uint64_t kTaggedKeyBit = std::uint64_t{1} << 63;
+
+    struct ChunkKey {
+        int layer{0};
+        int zIndex{0};
+        GLuint textureId{0};
+        GLuint normalTextureId{0};
+        int cellX{0};
+        int cellY{0};
+
+        auto operator<=>(const ChunkKey&) const = default;
+    };
+
+    struct Chunk {
+        std::vector<std::uint64_t> members;
+        glm::vec4 bounds{0.0f};
+        GLuint vao{0};
+        GLuint vbo{0};
+        GLuint ibo{0};
+        GLsizei indexCount{0};
+        // Set when membership changed since the last upload.
+        bool dirty{true};
+    };
+
+    static constexpr float defaultChunkSize = 1024.0f;
+
+    // `format` selects the encoding uploaded to the chunk buffers.
+    explicit StaticSpriteBatch(float chunkSize = defaultChunkSize,
+                               VertexFormat format = VertexFormat::Standard);
+    ~StaticSpriteBatch();
+
+    StaticSpriteBatch(const StaticSpriteBatch&) = delete;
+    StaticSpriteBatch& operator=(const StaticSpriteBatch&) = delete;
+    StaticSpriteBatch(StaticSpriteBatch&&) = delete;
+    StaticSpriteBatch& operator=(StaticSpriteBatch&&) = delete;
+
+    // Adds or replaces the member with `key`, dirtying only the chunks it
+    // leaves and joins.
+    void set(std::uint64_t key, const SpriteQuad& quad);
+    bool remove(std::uint64_t key);
+    void clear() noexcept;
+    [[nodiscard]] bool contains(std::uint64_t key) const noexcept;
+
+    // Appends the chunks overlapping `viewBounds` ({minX, minY, maxX, maxY})
+    // in draw order.
+    void collectVisible(const glm::vec4& viewBounds,
+                        std::vector<std::pair<const ChunkKey*, Chunk*>>& output);
+    // Rebuilds and uploads a dirty chunk's buffers. Requires a GL context.
+    void upload(Chunk& chunk);
+    // Builds the chunk's vertex/index data in member order.
+    void buildGeometry(const Chunk& chunk, std::vector<Vertex>& vertices,
+                       std::vector<std::uint32_t>& indices) const;
+
+    [[nodiscard]] std::size_t memberCount() const noexcept { return m_members.size(); }
+    [[nodiscard]] std::size_t taggedMemberCount() const noexcept { return m_taggedMembers; }
+    [[nodiscard]] std::size_t chunkCount() const noexcept { return m_chunks.size(); }
+    [[nodiscard]] std::size_t dirtyChunkCount() const noexcept;
+
+    // Identifies the scene state the members were baked from; RenderSystem
+    // rebakes everything when a different scene (or a cleared one) renders.
+    [[nodiscard]] std::uint64_t sourceEpoch() const noexcept { return m_sourceEpoch; }
+    void setSourceEpoch(std::uint64_t epoch) noexcept { m_sourceEpoch = epoch; }
+
+    template<typename Predicate>
+    std::size_t removeIf(Predicate&& predicate) {
+        std::vector<std::uint64_t> doomed;
+        for (const auto& [key, member] : m_members) {
+            if (predicate(key)) doomed.push_back(key);
+        }
+        for (const std::uint64_t key : doomed) remove(key);
+        return doomed.size();
+    }
+
+private:
+    struct Member {
+        SpriteQuad quad{};
+        glm::vec4 bounds{0.0f};
+        ChunkKey chunk{};
+    };
+
+    [[nodiscard]] ChunkKey chunkKeyFor(const SpriteQuad& quad,
+                                       const glm::vec4& bounds) const;
+    void detach(std::uint64_t key, const Member& member);
+    static void destroyBuffers(Chunk& chunk) noexcept;
+
+    float m_chunkSize{defaultChunkSize};
+    VertexFormat m_format{VertexFormat::Standard};
+    std::unordered_map<std::uint64_t, Member> m_members;
+    std::map<ChunkKey, Chunk> m_chunks;
+    std::size_t m_taggedMembers{0};
+    std::uint64_t m_sourceEpoch{0};
+};
+
+} // namespace Rendering
+
+#endif // GL2D_STATICSPRITEBATCH_HPP
@@ -19,6 +19,7 @@
 #include "Graphics/Shader.hpp"
 #include "LevelBuildingSystem/Tileset.hpp"
 #include "Managers/TilesetManager.hpp"
+#include "RenderingSystem/VertexLayout.hpp"
 
 namespace Rendering {
 
@@ -69,15 +70,7 @@ struct TilemapRenderer::Impl {
         glBindVertexArray(cache.vao);
         glBindBuffer(GL_ARRAY_BUFFER, cache.vbo);
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, cache.ibo);
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-                              reinterpret_cast<void*>(offsetof(Vertex, position)));
-        glEnableVertexAttribArray(1);
-        glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-                              reinterpret_cast<void*>(offsetof(Vertex, color)));
-        glEnableVertexAttribArray(2);
-        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-                              reinterpret_cast<void*>(offsetof(Vertex, uv)));
+        configureVertexAttributes(VertexFormat::Compact);
         glBindVertexArray(static_cast<GLuint>(previousVertexArray));
         glBindBuffer(GL_ARRAY_BUFFER, static_cast<GLuint>(previousArrayBuffer));
     }
@@ -106,7 +99,9 @@ struct TilemapRenderer::Impl {
             throw std::length_error("Tilemap mesh exceeds OpenGL index limits");
         }
 
-        std::vector<Vertex> vertices;
+        // Tiles are always untinted with UVs inside the tileset, so the
+        // compact encoding is lossless here and halves the chunk size.
+        std::vector<CompactVertex> vertices;
         std::vector<std::uint32_t> indices;
         vertices.reserve(cellCount * 4U);
         indices.reserve(cellCount * 6U);
@@ -128,13 +123,14 @@ struct TilemapRenderer::Impl {
                     static_cast<float>(y) * data->tileSize.y};
                 const std::uint32_t first = static_cast<std::uint32_t>(vertices.size());
                 const glm::vec4 white{1.0f};
-                vertices.push_back({{base.x, base.y + data->tileSize.y}, white,
-                                    {uv.x, uv.w}});
-                vertices.push_back({{base.x + data->tileSize.x,
-                                     base.y + data->tileSize.y}, white, {uv.z, uv.w}});
-                vertices.push_back({{base.x + data->tileSize.x, base.y}, white,
-                                    {uv.z, uv.y}});
-                vertices.push_back({base, white, {uv.x, uv.y}});
+                vertices.push_back(compactVertex({{base.x, base.y + data->tileSize.y},
+                                                  white, {uv.x, uv.w}}));
+                vertices.push_back(compactVertex({{base.x + data->tileSize.x,
+                                                   base.y + data->tileSize.y},
+                                                  white, {uv.z, uv.w}}));
+                vertices.push_back(compactVertex({{base.x + data->tileSize.x, base.y},
+                                                  white, {uv.z, uv.y}}));
+                vertices.push_back(compactVertex({base, white, {uv.x, uv.y}}));
                 indices.insert(indices.end(),
                     {first, first + 1U, first + 2U,
                      first + 2U, first + 3U, first});
@@ -149,7 +145,7 @@ struct TilemapRenderer::Impl {
         glBindVertexArray(cache.vao);
         glBindBuffer(GL_ARRAY_BUFFER, cache.vbo);
         glBufferData(GL_ARRAY_BUFFER,
-                     static_cast<GLsizeiptr>(vertices.size() * sizeof(Vertex)),
+                     static_cast<GLsizeiptr>(vertices.size() * sizeof(CompactVertex)),
                      vertices.data(), GL_STATIC_DRAW);
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, cache.ibo);
         glBufferData(GL_ELEMENT_ARRAY_BUFFER,
@@ -0,0 +1,54 @@
+//
+// VertexLayout.cpp
+//
+
+#include "VertexLayout.hpp"
+
+#include <GL/glew.h>
+
+#include <cstring>
+
+namespace Rendering {
+
+std::size_t vertexStride(VertexFormat format) noexcept {
+    return format == VertexFormat::Compact ? sizeof(CompactVertex) : sizeof(Vertex);
+}
+
+void configureVertexAttributes(VertexFormat format) {
+    glEnableVertexAttribArray(0);
+    glEnableVertexAttribArray(1);
+    glEnableVertexAttribArray(2);
+    if (format == VertexFormat::Compact) {
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(CompactVertex),
+                              reinterpret_cast<void*>(offsetof(CompactVertex, position)));
+        glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(CompactVertex),
+                              reinterpret_cast<void*>(offsetof(CompactVertex, color)));
+        glVertexAttribPointer(2, 2, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(CompactVertex),
+                              reinterpret_cast<void*>(offsetof(CompactVertex, uv)));
+        return;
+    }
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex),
+                          reinterpret_cast<void*>(offsetof(Vertex, position)));
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex),
+                          reinterpret_cast<void*>(offsetof(Vertex, color)));
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex),
+                          reinterpret_cast<void*>(offsetof(Vertex, uv)));
+}
+
+void appendVertices(VertexFormat format, const Vertex* vertices, std::size_t count,
+                    std::vector<std::byte>& output) {
+    const std::size_t offset = output.size();
+    output.resize(offset + count * vertexStride(format));
+    std::byte* destination = output.data() + offset;
+    if (format == VertexFormat::Standard) {
+        std::memcpy(destination, vertices, count * sizeof(Vertex));
+        return;
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+        const CompactVertex compact = compactVertex(vertices[i]);
+        std::memcpy(destination + i * sizeof(CompactVertex), &compact,
+                    sizeof(CompactVertex));
+    }
+}
+
+} // namespace Rendering
@@ -0,0 +1,31 @@
+//
+// VertexLayout.hpp
+//
+
+#ifndef GL2D_VERTEXLAYOUT_HPP
+#define GL2D_VERTEXLAYOUT_HPP
+
+#include <cstddef>
+#include <vector>
+
+#include "GameObjects/Vertex.hpp"
+
+namespace Rendering {
+
+// Vertex encodings accepted by the sprite shaders. Both feed attributes 0-2
+// (position, color, uv), so switching only changes bandwidth.
+enum class VertexFormat {
+    Standard, // Vertex, 32 bytes
+    Compact   // CompactVertex, 16 bytes
+};
+
+[[nodiscard]] std::size_t vertexStride(VertexFormat format) noexcept;
+// Describes attributes 0-2 for the bound vertex array and array buffer.
+void configureVertexAttributes(VertexFormat format);
+// Appends `vertices` to `output` encoded as `format`.
+void appendVertices(VertexFormat format, const Vertex* vertices, std::size_t count,
+                    std::vector<std::byte>& output);
+
+} // namespace Rendering
+
+#endif // GL2D_VERTEXLAYOUT_HPP
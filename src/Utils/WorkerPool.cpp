@@ -0,0 +1,105 @@
+#include "WorkerPool.hpp"
+
+namespace Utils {
+
+    WorkerPool::WorkerPool(std::size_t workerCount) {
+        m_workers.reserve(workerCount);
+        try {
+            for (std::size_t i = 0; i < workerCount; ++i) {
+                m_workers.emplace_back([this] { workerLoop(); });
+            }
+        } catch (...) {
+            {
+                std::lock_guard lock(m_mutex);
+                m_stopping = true;
+            }
+            m_wake.notify_all();
+            for (std::thread &worker: m_workers) worker.join();
+            throw;
+        }
+    }
+
+    WorkerPool::~WorkerPool() {
+        {
+            std::lock_guard lock(m_mutex);
+            m_stopping = true;
+        }
+        m_wake.notify_all();
+        for (std::thread &worker: m_workers) {
+            worker.join();
+        }
+    }
+
+    void WorkerPool::parallelFor(std::size_t count, const std::function<void(std::size_t)> &task) {
+        if (count == 0) {
+            return;
+        }
+        if (m_workers.empty() || count == 1) {
+            for (std::size_t i = 0; i < count; ++i) task(i);
+            return;
+        }
+        {
+            std::lock_guard lock(m_mutex);
+            m_task = &task;
+            m_count = count;
+            m_next = 0;
+            m_busy = 1;
+            m_error = nullptr;
+            ++m_generation;
+        }
+        m_wake.notify_all();
+        runTasks();
+
+        std::unique_lock lock(m_mutex);
+        --m_busy;
+        m_done.wait(lock, [this] { return m_busy == 0; });
+        m_task = nullptr;
+        if (m_error) {
+            std::rethrow_exception(std::exchange(m_error, nullptr));
+        }
+    }
+
+    void WorkerPool::workerLoop() {
+        std::uint64_t seen = 0;
+        std::unique_lock lock(m_mutex);
+        while (true) {
+            m_wake.wait(lock, [&] { return m_stopping || m_generation != seen; });
+            if (m_stopping) {
+                return;
+            }
+            seen = m_generation;
+            if (m_task == nullptr || m_next >= m_count) {
+                continue;
+            }
+            ++m_busy;
+            lock.unlock();
+            runTasks();
+            lock.lock();
+            if (--m_busy == 0) {
+                m_done.notify_one();
+            }
+        }
+    }
+
+    void WorkerPool::runTasks() {
+        while (true) {
+            std::size_t index;
+            {
+                std::lock_guard lock(m_mutex);
+                if (m_next >= m_count) {
+                    return;
+                }
+                index = m_next++;
+            }
+            try {
+                (*m_task)(index);
+            } catch (...) {
+                std::lock_guard lock(m_mutex);
+                if (!m_error) m_error = std::current_exception();
+                // Skip the remaining indices; the loop has already failed.
+                m_next = m_count;
+            }
+        }
+    }
+
+}
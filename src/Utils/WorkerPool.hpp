@@ -0,0 +1,55 @@
+#ifndef GL2D_WORKERPOOL_HPP
+#define GL2D_WORKERPOOL_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace Utils {
+
+    // Fixed set of worker threads for fork-join loops. parallelFor blocks the
+    // caller, which also takes indices, until every index has run; the first
+    // exception thrown by a task is rethrown on the caller. One parallelFor
+    // runs at a time; calls from inside a task are not supported.
+    class WorkerPool {
+    public:
+        // `workerCount` threads in addition to the calling thread; 0 runs every
+        // loop inline.
+        explicit WorkerPool(std::size_t workerCount);
+        ~WorkerPool();
+
+        WorkerPool(const WorkerPool &) = delete;
+        WorkerPool &operator=(const WorkerPool &) = delete;
+        WorkerPool(WorkerPool &&) = delete;
+        WorkerPool &operator=(WorkerPool &&) = delete;
+
+        void parallelFor(std::size_t count, const std::function<void(std::size_t)> &task);
+
+        [[nodiscard]] std::size_t workerCount() const noexcept { return m_workers.size(); }
+
+    private:
+        void workerLoop();
+        void runTasks();
+
+        std::vector<std::thread> m_workers;
+        std::mutex m_mutex;
+        std::condition_variable m_wake;
+        std::condition_variable m_done;
+        const std::function<void(std::size_t)> *m_task{nullptr};
+        std::size_t m_count{0};
+        std::size_t m_next{0};
+        std::size_t m_busy{0};
+        std::uint64_t m_generation{0};
+        std::exception_ptr m_error;
+        bool m_stopping{false};
+    };
+
+}
+
+#endif //GL2D_WORKERPOOL_HPP
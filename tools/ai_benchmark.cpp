@@ -0,0 +1,362 @@
+// Headless AI benchmark. Perception: a level of static wall boxes, a player
+// and a crowd of agents that each check line of sight to the player and
+// listen around themselves every tick. Times the immediate hasLineOfSight
+// and canHear calls against one PerceptionService batch per tick, with and
+// without a baked occlusion grid, and checks that all three agree. Behaviour
+// trees: ticks a guard tree for a large crowd (10k by default), once as one
+// BehaviourTree per agent and once as a CompiledBehaviourTree over all
+// agents, and checks that both agree. Update scheduling: runs the same crowd,
+// scattered around the player with an AICombatBrain each, every tick and
+// through an UpdateScheduler, and reports per-bucket counts and time. No GL
+// context required.
+
+#include "AISystem/AICombatBrain.hpp"
+#include "AISystem/BehaviourTree.hpp"
+#include "AISystem/CompiledBehaviourTree.hpp"
+#include "AISystem/Perception.hpp"
+#include "AISystem/PerceptionService.hpp"
+#include "AISystem/UpdateScheduler.hpp"
+#include "GameObjects/Components/ColliderComponent.hpp"
+#include "GameObjects/Components/TransformComponent.hpp"
+#include "GameObjects/Entity.hpp"
+#include "Physics/Collision/AABBCollider.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+namespace {
+using AI::NodeStatus;
+
+constexpr std::uint32_t kWallLayer = 1;
+constexpr std::uint32_t kActorLayer = 2;
+
+std::uint32_t nextRandom(std::uint32_t& state) {
+    state = state * 1664525u + 1013904223u;
+    return state >> 8u;
+}
+
+float randomRange(std::uint32_t& state, float min, float max) {
+    return min + (max - min) * static_cast<float>(nextRandom(state) & 0xFFFFu) / 65535.0f;
+}
+
+Entity& addBox(std::vector<std::unique_ptr<Entity>>& entities, const glm::vec2& position,
+               const glm::vec2& halfSize, std::uint32_t layer) {
+    auto entity = std::make_unique<Entity>();
+    entity->addComponent<TransformComponent>().setPosition(position);
+    auto& collider = entity->addComponent<ColliderComponent>(
+        std::make_unique<AABBCollider>(-halfSize, halfSize));
+    collider.setLayer(layer);
+    collider.ensureCollider(*entity);
+    entities.push_back(std::move(entity));
+    return *entities.back();
+}
+
+glm::vec2 positionOf(const Entity& entity) {
+    return entity.getComponent<TransformComponent>()->getTransform().Position;
+}
+
+struct Frame {
+    double ms{0.0};
+    std::size_t visible{0};
+    std::size_t heard{0};
+};
+
+struct Guard {
+    float distance{0.0f};
+    float health{1.0f};
+    int ammo{0};
+    int patrolStep{0};
+    int attacks{0};
+
+    friend bool operator==(const Guard&, const Guard&) = default;
+};
+
+AI::BehaviourTree<Guard> makeGuardTree() {
+    using Tree = AI::BehaviourTree<Guard>;
+    auto flee = Tree::makeSequence();
+    flee->addChild(Tree::makeCondition([](Guard* g) { return g->health < 0.25f; }));
+    flee->addChild(Tree::makeAction([](Guard* g) {
+        g->distance += 1.0f;
+        g->health += 0.01f;
+        return NodeStatus::Running;
+    }));
+
+    auto attack = Tree::makeSequence();
+    attack->addChild(Tree::makeCondition([](Guard* g) { return g->distance < 8.0f; }));
+    attack->addChild(Tree::makeInverter(Tree::makeCondition([](Guard* g) { return g->ammo == 0; })));
+    attack->addChild(Tree::makeCooldown(Tree::makeAction([](Guard* g) {
+        --g->ammo;
+        ++g->attacks;
+        g->health -= 0.05f;
+        return NodeStatus::Success;
+    }), 0.5f));
+
+    auto reload = Tree::makeSequence();
+    reload->addChild(Tree::makeCondition([](Guard* g) { return g->ammo == 0; }));
+    reload->addChild(Tree::makeRepeater(Tree::makeAction([](Guard* g) {
+        ++g->ammo;
+        return NodeStatus::Success;
+    }), 3));
+
+    auto chase = Tree::makeSequence();
+    chase->addChild(Tree::makeCondition([](Guard* g) { return g->distance < 40.0f; }));
+    chase->addChild(Tree::makeSucceeder(Tree::makeAction([](Guard* g) {
+        g->distance -= 0.75f;
+        return g->distance < 8.0f ? NodeStatus::Success : NodeStatus::Running;
+    })));
+
+    auto patrol = Tree::makeAction([](Guard* g) {
+        g->patrolStep = (g->patrolStep + 1) % 16;
+        g->distance += g->patrolStep < 8 ? -1.5f : 1.0f;
+        return NodeStatus::Success;
+    });
+
+    auto root = Tree::makeSelector();
+    root->addChild(std::move(flee));
+    root->addChild(std::move(attack));
+    root->addChild(std::move(reload));
+    root->addChild(std::move(chase));
+    root->addChild(std::move(patrol));
+    Tree tree;
+    tree.setRoot(std::move(root));
+    return tree;
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    const int agentCount = argc > 1 ? std::atoi(argv[1]) : 200;
+    const int ticks = argc > 2 ? std::atoi(argv[2]) : 60;
+    const int wallCount = argc > 3 ? std::atoi(argv[3]) : 400;
+    const int treeAgents = argc > 4 ? std::atoi(argv[4]) : 10000;
+    if (agentCount <= 0 || ticks <= 0 || wallCount < 0 || treeAgents <= 0) {
+        std::cerr << "Usage: GL2D_AI_BENCHMARK [agents] [ticks] [walls] [tree agents]\n";
+        return 2;
+    }
+
+    constexpr float worldSize = 400.0f;
+    constexpr float hearingRadius = 12.0f;
+    std::uint32_t random = 7u;
+    std::vector<std::unique_ptr<Entity>> entities;
+    for (int i = 0; i < wallCount; ++i) {
+        const bool horizontal = (i & 1) == 0;
+        const float length = randomRange(random, 4.0f, 24.0f);
+        const glm::vec2 halfSize = horizontal ? glm::vec2{length, 1.0f} : glm::vec2{1.0f, length};
+        addBox(entities, {randomRange(random, 0.0f, worldSize), randomRange(random, 0.0f, worldSize)},
+               halfSize, kWallLayer);
+    }
+    Entity& player = addBox(entities, {worldSize * 0.5f, worldSize * 0.5f}, glm::vec2{0.5f}, kActorLayer);
+    std::vector<Entity*> agents;
+    for (int i = 0; i < agentCount; ++i) {
+        agents.push_back(&addBox(entities,
+                                 {randomRange(random, 0.0f, worldSize), randomRange(random, 0.0f, worldSize)},
+                                 glm::vec2{0.5f}, kActorLayer));
+    }
+    const std::uint32_t sightMask = (1u << kWallLayer) | (1u << kActorLayer);
+    const std::uint32_t hearingMask = 1u << kActorLayer;
+
+    const auto immediate = [&] {
+        Frame frame;
+        std::vector<Entity*> heard;
+        const auto start = std::chrono::steady_clock::now();
+        for (Entity* agent : agents) {
+            const glm::vec2 eye = positionOf(*agent);
+            frame.visible += AI::hasLineOfSight(eye, positionOf(player), entities, sightMask,
+                                                agent, &player) ? 1u : 0u;
+            AI::canHear(eye, hearingRadius, entities, hearingMask, agent, &heard);
+            frame.heard += heard.size();
+        }
+        frame.ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+        return frame;
+    };
+
+    const auto batched = [&](AI::PerceptionService& perception) {
+        Frame frame;
+        std::vector<AI::PerceptionTicket> sight;
+        std::vector<AI::PerceptionTicket> hearing;
+        const auto start = std::chrono::steady_clock::now();
+        for (Entity* agent : agents) {
+            const glm::vec2 eye = positionOf(*agent);
+            sight.push_back(perception.requestLineOfSight(eye, positionOf(player), sightMask,
+                                                          agent, &player));
+            hearing.push_back(perception.requestHearing(eye, hearingRadius, hearingMask, agent));
+        }
+        perception.update(entities);
+        // Read back as the agents would on the next tick.
+        for (std::size_t i = 0; i < agents.size(); ++i) {
+            frame.visible += perception.lineOfSight(sight[i]).value_or(false) ? 1u : 0u;
+            frame.heard += perception.heardEntities(hearing[i]).size();
+        }
+        frame.ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+        return frame;
+    };
+
+    AI::PerceptionService plain;
+    AI::PerceptionService occluded;
+    const auto bakeStart = std::chrono::steady_clock::now();
+    occluded.bakeOcclusion(entities, 1u << kWallLayer, 1.0f);
+    const double bakeMs = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - bakeStart).count();
+
+    double immediateMs = 0.0;
+    double batchedMs = 0.0;
+    double occludedMs = 0.0;
+    std::size_t visible = 0;
+    std::size_t heard = 0;
+    for (int tick = 0; tick < ticks; ++tick) {
+        // Agents shuffle a little every tick.
+        for (Entity* agent : agents) {
+            auto* transform = agent->getComponent<TransformComponent>();
+            transform->setPosition(transform->getTransform().Position +
+                                   glm::vec2{randomRange(random, -0.5f, 0.5f),
+                                             randomRange(random, -0.5f, 0.5f)});
+        }
+        const Frame a = immediate();
+        const Frame b = batched(plain);
+        const Frame c = batched(occluded);
+        if (a.visible != b.visible || a.visible != c.visible || a.heard != b.heard ||
+            a.heard != c.heard) {
+            std::cerr << "perception results differ at tick " << tick << '\n';
+            return 1;
+        }
+        immediateMs += a.ms;
+        batchedMs += b.ms;
+        occludedMs += c.ms;
+        visible += a.visible;
+        heard += a.heard;
+    }
+
+    const auto& stats = occluded.stats();
+    std::cout << "agents=" << agentCount << " walls=" << wallCount
+              << " colliders=" << entities.size() << " ticks=" << ticks << '\n'
+              << "visible_avg=" << static_cast<double>(visible) / ticks
+              << " heard_avg=" << static_cast<double>(heard) / ticks << '\n'
+              << "immediate_ms_per_tick=" << immediateMs / ticks
+              << " batched_ms_per_tick=" << batchedMs / ticks
+              << " occlusion_ms_per_tick=" << occludedMs / ticks << '\n'
+              << "occlusion_bake_ms=" << bakeMs << " occluded_cells=" << occluded.occludedCells()
+              << " occlusion_rejects=" << stats.occlusionRejects
+              << " collider_tests_per_tick=" << static_cast<double>(stats.colliderTests) / ticks
+              << " plain_collider_tests_per_tick="
+              << static_cast<double>(plain.stats().colliderTests) / ticks << '\n';
+
+    std::vector<Guard> guards;
+    for (int i = 0; i < treeAgents; ++i) {
+        guards.push_back(Guard{randomRange(random, 0.0f, 60.0f), randomRange(random, 0.2f, 1.0f),
+                               static_cast<int>(nextRandom(random) % 4u), i % 16, 0});
+    }
+    std::vector<Guard> compiledGuards = guards;
+    std::vector<Guard> lodGuards = guards;
+    std::vector<Guard> everyTickGuards = guards;
+
+    const auto treeBuildStart = std::chrono::steady_clock::now();
+    std::vector<AI::BehaviourTree<Guard>> trees;
+    trees.reserve(guards.size());
+    for (int i = 0; i < treeAgents; ++i) {
+        trees.push_back(makeGuardTree());
+    }
+    const double treeBuildMs = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - treeBuildStart).count();
+    const auto compileStart = std::chrono::steady_clock::now();
+    const AI::CompiledBehaviourTree<Guard> compiled(makeGuardTree());
+    AI::BTAgentStates states = compiled.makeStates(guards.size());
+    const double compileMs = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - compileStart).count();
+
+    std::vector<NodeStatus> statuses(guards.size());
+    double treeMs = 0.0;
+    double compiledMs = 0.0;
+    std::size_t running = 0;
+    constexpr float dt = 1.0f / 30.0f;
+    for (int tick = 0; tick < ticks; ++tick) {
+        std::size_t treeRunning = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < guards.size(); ++i) {
+            treeRunning += trees[i].tick(&guards[i], dt) == NodeStatus::Running ? 1u : 0u;
+        }
+        treeMs += std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+
+        start = std::chrono::steady_clock::now();
+        compiled.tickAll(states, compiledGuards, dt, statuses);
+        compiledMs += std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+
+        const std::size_t compiledRunning = static_cast<std::size_t>(
+            std::count(statuses.begin(), statuses.end(), NodeStatus::Running));
+        if (treeRunning != compiledRunning || guards != compiledGuards) {
+            std::cerr << "behaviour tree results differ at tick " << tick << '\n';
+            return 1;
+        }
+        running += treeRunning;
+    }
+
+    std::cout << "tree_agents=" << treeAgents << " tree_nodes=" << compiled.nodeCount()
+              << " state_slots_per_agent=" << states.slotsPerAgent()
+              << " running_avg=" << static_cast<double>(running) / ticks << '\n'
+              << "tree_build_ms=" << treeBuildMs << " compile_ms=" << compileMs << '\n'
+              << "tree_ms_per_tick=" << treeMs / ticks
+              << " compiled_ms_per_tick=" << compiledMs / ticks << '\n';
+
+    // Level of detail: the same guards spread over the level, each with a
+    // combat brain, thinking every tick or at the rate their distance allows.
+    const glm::vec2 playerPosition = positionOf(player);
+    std::vector<glm::vec2> guardPositions;
+    std::vector<AICombatBrain> brains(guards.size());
+    AI::UpdateScheduler scheduler;
+    for (std::size_t i = 0; i < guards.size(); ++i) {
+        guardPositions.push_back({randomRange(random, 0.0f, worldSize), randomRange(random, 0.0f, worldSize)});
+        brains[i].setCooldown(0.5f);
+        static_cast<void>(scheduler.add(i, guardPositions[i]));
+    }
+    std::vector<AICombatBrain> everyTickBrains = brains;
+    AI::BTAgentStates lodStates = compiled.makeStates(guards.size());
+    AI::BTAgentStates everyTickStates = compiled.makeStates(guards.size());
+    const auto think = [&](std::vector<Guard>& crowd, std::vector<AICombatBrain>& crowdBrains,
+                           AI::BTAgentStates& crowdStates, std::size_t i, float elapsed) {
+        compiled.tick(crowdStates, i, &crowd[i], elapsed);
+        crowdBrains[i].update(elapsed);
+        const glm::vec2 target = guardPositions[i] + glm::vec2{crowd[i].distance, 0.0f};
+        return crowdBrains[i].tryAttack(guardPositions[i], target) ? 1u : 0u;
+    };
+    const std::vector<glm::vec2> focus{playerPosition};
+    double everyTickMs = 0.0;
+    double scheduledMs = 0.0;
+    std::size_t everyTickAttacks = 0;
+    std::size_t scheduledAttacks = 0;
+    for (int tick = 0; tick < ticks; ++tick) {
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < everyTickGuards.size(); ++i) {
+            everyTickAttacks += think(everyTickGuards, everyTickBrains, everyTickStates, i, dt);
+        }
+        everyTickMs += std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+
+        start = std::chrono::steady_clock::now();
+        scheduler.tick(dt, focus, [&](const AI::UpdateScheduler::Update& update) {
+            scheduledAttacks += think(lodGuards, brains, lodStates, update.user, update.dt);
+        });
+        scheduledMs += std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+    }
+
+    const auto& lod = scheduler.stats();
+    std::cout << "lod_every_tick_ms_per_tick=" << everyTickMs / ticks
+              << " lod_scheduled_ms_per_tick=" << scheduledMs / ticks
+              << " every_tick_attacks=" << everyTickAttacks
+              << " scheduled_attacks=" << scheduledAttacks << '\n';
+    constexpr const char* bucketNames[AI::kUpdateRateCount]{"every_tick", "every_4th", "every_16th"};
+    for (std::size_t bucket = 0; bucket < AI::kUpdateRateCount; ++bucket) {
+        const auto& stats = lod.buckets[bucket];
+        std::cout << "bucket=" << bucketNames[bucket] << " agents=" << stats.agents
+                  << " updates_per_tick=" << static_cast<double>(stats.updates) / ticks
+                  << " ms_per_tick=" << stats.totalMs / ticks << '\n';
+    }
+    return 0;
+}
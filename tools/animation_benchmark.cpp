@@ -0,0 +1,138 @@
+// Headless ECS animation benchmark: entities sharing one platformer-style
+// graph (idle, run, rise, fall, land, hurt with an any-source transition),
+// their parameters driven by a cheap deterministic pattern so a share of
+// them change state every step. Reports AnimationSystem2D::update cost per
+// 60 Hz step. No GL context required.
+
+#include "ECS/Animation/AnimationGraph2D.hpp"
+#include "ECS/Components/Animation2D.hpp"
+#include "ECS/Components/SpriteRender.hpp"
+#include "ECS/Registry.hpp"
+#include "ECS/Systems/AnimationSystem2D.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+std::shared_ptr<const ECS::AnimationGraph2D> makeGraph() {
+    const auto clip = [](int frames, ECS::AnimationPlayback2D playback) {
+        ECS::AnimationClip2D result{};
+        result.playback = playback;
+        for (int i = 0; i < frames; ++i) {
+            ECS::AnimationFrame2D frame{};
+            frame.durationSeconds = 0.08f;
+            frame.uvRect = {static_cast<float>(i) * 0.125f, 0.0f,
+                            static_cast<float>(i + 1) * 0.125f, 1.0f};
+            result.frames.push_back(frame);
+        }
+        return result;
+    };
+    using Condition = ECS::AnimationCondition2D;
+    std::vector<ECS::AnimationState2D> states{
+        {"Idle", clip(4, ECS::AnimationPlayback2D::Loop)},
+        {"Run", clip(8, ECS::AnimationPlayback2D::Loop)},
+        {"Rise", clip(2, ECS::AnimationPlayback2D::Once)},
+        {"Fall", clip(2, ECS::AnimationPlayback2D::Loop)},
+        {"Land", clip(3, ECS::AnimationPlayback2D::Once)},
+        {"Hurt", clip(3, ECS::AnimationPlayback2D::Once)}
+    };
+    std::vector<ECS::AnimationTransition2D> transitions{
+        {"*", "Hurt", Condition::BoolEquals, "hurt", 0.0f, true},
+        {"Idle", "Run", Condition::FloatGreater, "speed", 10.0f},
+        {"Idle", "Rise", Condition::BoolEquals, "rising", 0.0f, true},
+        {"Idle", "Fall", Condition::BoolEquals, "falling", 0.0f, true},
+        {"Run", "Idle", Condition::FloatLessEqual, "speed", 10.0f},
+        {"Run", "Rise", Condition::BoolEquals, "rising", 0.0f, true},
+        {"Run", "Fall", Condition::BoolEquals, "falling", 0.0f, true},
+        {"Rise", "Fall", Condition::BoolEquals, "falling", 0.0f, true},
+        {"Fall", "Land", Condition::BoolEquals, "grounded", 0.0f, true},
+        {"Land", "Run", Condition::FloatGreater, "speed", 10.0f, true, 0.1f},
+        {"Land", "Idle", Condition::Always, {}, 0.0f, true, 0.2f},
+        {"Hurt", "Idle", Condition::BoolEquals, "hurt", 0.0f, false, 0.3f}
+    };
+    return std::make_shared<const ECS::AnimationGraph2D>(
+        std::move(states), std::move(transitions), "Idle");
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t entityCount = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 50'000;
+    const int frames = argc > 2 ? std::atoi(argv[2]) : 300;
+    if (entityCount == 0 || frames <= 0) {
+        std::cerr << "Usage: GL2D_ANIMATION_BENCHMARK [positive entity count] [positive frame count]\n";
+        return 2;
+    }
+
+    const auto graph = makeGraph();
+    const ECS::AnimationParameterId2D speed = *graph->findParameter("speed");
+    const ECS::AnimationParameterId2D rising = *graph->findParameter("rising");
+    const ECS::AnimationParameterId2D falling = *graph->findParameter("falling");
+    const ECS::AnimationParameterId2D grounded = *graph->findParameter("grounded");
+    const ECS::AnimationParameterId2D hurt = *graph->findParameter("hurt");
+
+    ECS::Registry registry;
+    for (std::size_t i = 0; i < entityCount; ++i) {
+        const ECS::Entity entity = registry.create();
+        registry.emplace<ECS::SpriteRender>(entity);
+        registry.emplace<ECS::AnimationParameters2D>(entity, graph);
+        registry.emplace<ECS::Animator2D>(entity).graph = graph;
+        registry.emplace<ECS::AnimationEventQueue2D>(entity);
+    }
+
+    // Each entity follows a 4 s run/jump/land cycle offset by its index, so
+    // transitions are spread evenly over the steps.
+    std::size_t step = 0;
+    const auto drive = [&] {
+        std::size_t index = 0;
+        registry.each<ECS::AnimationParameters2D>(
+            [&](ECS::Entity, ECS::AnimationParameters2D& parameters) {
+                const std::size_t phase = (step + index * 7) % 240;
+                parameters.setFloat(speed, phase < 120 ? 200.0f : 0.0f);
+                parameters.setBool(rising, phase >= 60 && phase < 80);
+                parameters.setBool(falling, phase >= 80 && phase < 100);
+                parameters.setBool(grounded, phase < 60 || phase >= 100);
+                parameters.setBool(hurt, phase >= 200 && phase < 210 && index % 8 == 0);
+                ++index;
+            });
+        ++step;
+    };
+
+    for (int i = 0; i < 30; ++i) {
+        drive();
+        ECS::AnimationSystem2D::beginFrame(registry);
+        ECS::AnimationSystem2D::update(registry, 1.0f / 60.0f);
+    }
+
+    std::vector<double> frameMs;
+    frameMs.reserve(static_cast<std::size_t>(frames));
+    std::size_t events = 0;
+    for (int i = 0; i < frames; ++i) {
+        drive();
+        ECS::AnimationSystem2D::beginFrame(registry);
+        const auto start = std::chrono::steady_clock::now();
+        ECS::AnimationSystem2D::update(registry, 1.0f / 60.0f);
+        frameMs.push_back(std::chrono::duration<double, std::milli>(
+                              std::chrono::steady_clock::now() - start)
+                              .count());
+        registry.each<ECS::AnimationEventQueue2D>(
+            [&events](ECS::Entity, const ECS::AnimationEventQueue2D& queue) {
+                events += queue.size();
+            });
+    }
+    double total = 0.0;
+    for (const double ms : frameMs) total += ms;
+    std::sort(frameMs.begin(), frameMs.end());
+    const double average = total / static_cast<double>(frameMs.size());
+    std::cout << "entities=" << entityCount << " frames=" << frames
+              << " avg_ms=" << average
+              << " p99_ms="
+              << frameMs[static_cast<std::size_t>(static_cast<double>(frameMs.size() - 1) * 0.99)]
+              << " events_per_step=" << static_cast<double>(events) / frames
+              << " entities_per_ms=" << static_cast<double>(entityCount) / average << "\n";
+    return 0;
+}
@@ -0,0 +1,98 @@
+// Headless CPU light binning benchmark: bins a scene of point and spot
+// lights plus one directional light into 32-pixel tiles of a 1080p
+// framebuffer, as LightingPass does every frame. No GL context required.
+
+#include "Graphics/LightingSystem/Light.hpp"
+#include "RenderingSystem/LightBinning.hpp"
+
+#include <glm/ext/matrix_clip_space.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+std::vector<Light> buildLights(std::size_t count, float worldWidth, float worldHeight) {
+    std::mt19937 rng(1234u);
+    std::uniform_real_distribution<float> x(-200.0f, worldWidth + 200.0f);
+    std::uniform_real_distribution<float> y(-200.0f, worldHeight + 200.0f);
+    std::uniform_real_distribution<float> radius(24.0f, 160.0f);
+
+    std::vector<Light> lights;
+    lights.reserve(count + 1);
+    Light sun{};
+    sun.type = LightType::DIRECTIONAL;
+    sun.intensity = 0.3f;
+    lights.push_back(sun);
+    for (std::size_t i = 0; i < count; ++i) {
+        Light light{};
+        light.type = i % 4 == 0 ? LightType::SPOT : LightType::POINT;
+        light.pos = {x(rng), y(rng)};
+        light.radius = radius(rng);
+        light.intensity = 1.0f;
+        lights.push_back(light);
+    }
+    return lights;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int frames = argc > 1 ? std::atoi(argv[1]) : 600;
+    const int lightCount = argc > 2 ? std::atoi(argv[2]) : 1000;
+    if (frames <= 0 || lightCount < 0) {
+        std::cerr << "Usage: GL2D_LIGHT_BINNING_BENCHMARK [positive frame count] [light count]\n";
+        return 2;
+    }
+
+    constexpr int width = 1920;
+    constexpr int height = 1080;
+    constexpr int tileSize = 32;
+    const std::vector<Light> lights =
+        buildLights(static_cast<std::size_t>(lightCount), width, height);
+    const glm::mat4 viewProjection = glm::ortho(0.0f, static_cast<float>(width), 0.0f,
+                                                static_cast<float>(height), -1.0f, 1.0f);
+
+    Rendering::LightTileGrid grid;
+    for (int i = 0; i < 30; ++i) {
+        Rendering::binLights(lights, viewProjection, width, height, tileSize, grid);
+    }
+
+    std::vector<double> frameMs;
+    frameMs.reserve(static_cast<std::size_t>(frames));
+    for (int i = 0; i < frames; ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        Rendering::binLights(lights, viewProjection, width, height, tileSize, grid);
+        frameMs.push_back(std::chrono::duration<double, std::milli>(
+                              std::chrono::steady_clock::now() - start)
+                              .count());
+    }
+
+    double total = 0.0;
+    for (const double ms : frameMs) total += ms;
+    std::vector<double> sorted = frameMs;
+    std::sort(sorted.begin(), sorted.end());
+    const double average = total / static_cast<double>(frameMs.size());
+    const double p99 = sorted[static_cast<std::size_t>(
+        static_cast<double>(sorted.size() - 1) * 0.99)];
+
+    std::size_t maxPerTile = 0;
+    for (std::size_t t = 0; t < grid.tileCount(); ++t) {
+        maxPerTile = std::max<std::size_t>(maxPerTile, grid.offsets[t + 1] - grid.offsets[t]);
+    }
+
+    std::cout << "lights=" << lights.size()
+              << " tiles=" << grid.tileCount()
+              << " avg_lights_per_tile="
+              << static_cast<double>(grid.indices.size()) /
+                     static_cast<double>(grid.tileCount())
+              << " max_lights_per_tile=" << maxPerTile
+              << " avg_ms=" << average
+              << " p99_ms=" << p99
+              << " max_ms=" << sorted.back() << "\n";
+    return 0;
+}
@@ -0,0 +1,311 @@
+// Headless navmesh benchmark: stamps a large raster with a deterministic
+// scatter of blocked rooms and pillars (and compares its size and build time
+// with a per-cell predicate), builds a PolyNavMesh from it, whole and tiled, and
+// times toggling small obstacles on the tiled one. Then it times path
+// queries between random walkable points through one reused NavQuery, and
+// the same requests through a PathRequestQueue, on the calling thread and on
+// a WorkerPool. Then compares node expansions of flat A* with a
+// HierarchicalNavGraph search, refined fully or only its first segment, and
+// times a FlowField toward one goal: full builds, incremental updates as the
+// goal walks from cell to cell, and sampling it for every query point. No GL
+// context required.
+
+#include "AISystem/NavMesh/FlowField.hpp"
+#include "AISystem/NavMesh/HierarchicalNavGraph.hpp"
+#include "AISystem/NavMesh/NavQuery.hpp"
+#include "AISystem/NavMesh/NavRaster.hpp"
+#include "AISystem/NavMesh/PathRequestQueue.hpp"
+#include "AISystem/NavMesh/PolyNavMesh.hpp"
+#include "Utils/WorkerPool.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace {
+std::uint32_t nextRandom(std::uint32_t& state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+// Blocked rooms, plus `pillarsPerMille` single blocked cells per thousand,
+// which fragment the polygon mesh.
+NavRaster makeRaster(int width, int height, int pillarsPerMille) {
+    NavRaster raster(width, height, 1.0f, glm::vec2{0.0f});
+    std::uint32_t seed = 0x9E3779B9u;
+    const int obstacles = width * height / 200;
+    for (int i = 0; i < obstacles; ++i) {
+        const int x = static_cast<int>(nextRandom(seed) % static_cast<std::uint32_t>(width));
+        const int y = static_cast<int>(nextRandom(seed) % static_cast<std::uint32_t>(height));
+        const int w = 1 + static_cast<int>(nextRandom(seed) % 8u);
+        const int h = 1 + static_cast<int>(nextRandom(seed) % 8u);
+        raster.fillCells(x, y, x + w - 1, y + h - 1, false);
+    }
+    const long long pillars = static_cast<long long>(width) * height * pillarsPerMille / 1000;
+    for (long long i = 0; i < pillars; ++i) {
+        const int x = static_cast<int>(nextRandom(seed) % static_cast<std::uint32_t>(width));
+        const int y = static_cast<int>(nextRandom(seed) % static_cast<std::uint32_t>(height));
+        raster.setWalkable(x, y, false);
+    }
+    raster.clearDirtyTiles();
+    return raster;
+}
+
+struct QueueRun {
+    double totalMs{0.0};
+    std::uint64_t updates{0};
+    PathRequestQueue::Stats stats;
+};
+
+QueueRun runQueue(const PolyNavMesh& mesh, const std::vector<glm::vec2>& walkable, int queries,
+                  Utils::WorkerPool* workers) {
+    PathRequestQueue queue(mesh);
+    std::vector<PathHandle> handles;
+    handles.reserve(static_cast<std::size_t>(queries));
+    QueueRun run;
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < queries; ++i) {
+        handles.push_back(queue.request(walkable[static_cast<std::size_t>(i) * 2],
+                                        walkable[static_cast<std::size_t>(i) * 2 + 1]));
+    }
+    NavPath path;
+    while (queue.stats().pending > 0) {
+        queue.update(workers);
+        ++run.updates;
+    }
+    for (const PathHandle handle : handles) {
+        queue.poll(handle, path);
+    }
+    run.totalMs = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+    run.stats = queue.stats();
+    return run;
+}
+
+template<typename Function>
+double measureMilliseconds(Function&& function) {
+    const auto start = std::chrono::steady_clock::now();
+    function();
+    return std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    const int width = argc > 1 ? std::atoi(argv[1]) : 2000;
+    const int height = argc > 2 ? std::atoi(argv[2]) : 500;
+    const int queries = argc > 3 ? std::atoi(argv[3]) : 200;
+    const int clusterSize =
+        argc > 4 ? std::atoi(argv[4]) : HierarchicalNavGraph::kDefaultClusterSize;
+    const int pillarsPerMille = argc > 5 ? std::atoi(argv[5]) : 0;
+    if (width <= 0 || height <= 0 || queries <= 0 || clusterSize <= 0 || pillarsPerMille < 0) {
+        std::cerr << "Usage: GL2D_NAVMESH_BENCHMARK [width] [height] [path queries] "
+                     "[cluster size] [pillars per thousand cells]\n";
+        return 2;
+    }
+
+    NavRaster raster;
+    const double rasterMs =
+        measureMilliseconds([&] { raster = makeRaster(width, height, pillarsPerMille); });
+    // The same walkability through a per-cell predicate, for comparison.
+    const double predicateMs = measureMilliseconds([&] {
+        const NavRaster copy = NavRaster::buildFromPredicate(
+            width, height, raster.cellSize(), raster.origin(), [&raster](const NavAABB& cell) {
+                int x = 0;
+                int y = 0;
+                return raster.worldToCell((cell.min + cell.max) * 0.5f, x, y) &&
+                       raster.isWalkable(x, y);
+            });
+        if (copy.walkableCount() != raster.walkableCount()) std::abort();
+    });
+    PolyNavMesh mesh;
+    const double buildMs = measureMilliseconds([&] { mesh.buildFromRaster(raster); });
+
+    // Doors and crates: toggle 3x3 blocks and rebuild only their tiles.
+    NavRaster editable = raster;
+    PolyNavMesh tiledMesh;
+    const double tiledBuildMs = measureMilliseconds([&] { tiledMesh.buildTiled(editable); });
+    const std::size_t tiledPolygons = tiledMesh.polyCount();
+    constexpr int kObstacleUpdates = 200;
+    std::vector<double> updateMs;
+    std::size_t removedPolys = 0;
+    std::uint32_t obstacleSeed = 777u;
+    for (int i = 0; i < kObstacleUpdates; ++i) {
+        const int x = static_cast<int>(nextRandom(obstacleSeed) % static_cast<std::uint32_t>(width));
+        const int y = static_cast<int>(nextRandom(obstacleSeed) % static_cast<std::uint32_t>(height));
+        updateMs.push_back(measureMilliseconds([&] {
+            for (int dy = 0; dy < 3 && y + dy < height; ++dy) {
+                for (int dx = 0; dx < 3 && x + dx < width; ++dx) {
+                    editable.setWalkable(x + dx, y + dy, !editable.isWalkable(x + dx, y + dy));
+                }
+            }
+            tiledMesh.updateTiles(editable);
+            editable.clearDirtyTiles();
+        }));
+        removedPolys += tiledMesh.lastRemovedPolys().size();
+    }
+    double updateTotal = 0.0;
+    for (const double ms : updateMs) updateTotal += ms;
+    std::sort(updateMs.begin(), updateMs.end());
+
+    std::vector<glm::vec2> walkable;
+    std::uint32_t seed = 12345u;
+    while (walkable.size() < static_cast<std::size_t>(queries) * 2) {
+        const int x = static_cast<int>(nextRandom(seed) % static_cast<std::uint32_t>(width));
+        const int y = static_cast<int>(nextRandom(seed) % static_cast<std::uint32_t>(height));
+        if (raster.isWalkable(x, y)) {
+            walkable.push_back(raster.cellCenter(x, y));
+        }
+    }
+
+    NavQuery query;
+    NavPath path;
+    std::vector<double> queryMs;
+    queryMs.reserve(static_cast<std::size_t>(queries));
+    std::size_t found = 0;
+    std::size_t flatExpansions = 0;
+    for (int i = 0; i < queries; ++i) {
+        const glm::vec2 start = walkable[static_cast<std::size_t>(i) * 2];
+        const glm::vec2 end = walkable[static_cast<std::size_t>(i) * 2 + 1];
+        queryMs.push_back(measureMilliseconds([&] {
+            found += query.findPath(mesh, start, end, path) ? 1 : 0;
+        }));
+        flatExpansions += query.expansions();
+    }
+    double total = 0.0;
+    for (const double ms : queryMs) total += ms;
+    std::sort(queryMs.begin(), queryMs.end());
+
+    std::cout << "raster_bytes=" << raster.memoryBytes()
+              << " walkable_cells=" << raster.walkableCount()
+              << " raster_stamp_ms=" << rasterMs << " raster_predicate_ms=" << predicateMs << '\n'
+              << "cells=" << width << "x" << height
+              << " polygons=" << mesh.polygons().size()
+              << " build_ms=" << buildMs << '\n'
+              << "tiled_polygons=" << tiledPolygons << " tiled_build_ms=" << tiledBuildMs
+              << " obstacle_updates=" << kObstacleUpdates
+              << " obstacle_update_avg_ms=" << updateTotal / kObstacleUpdates
+              << " obstacle_update_max_ms=" << updateMs.back()
+              << " obstacle_removed_polys_avg="
+              << static_cast<double>(removedPolys) / kObstacleUpdates << '\n'
+              << "queries=" << queries << " found=" << found
+              << " path_avg_ms=" << total / queries
+              << " path_p99_ms="
+              << queryMs[static_cast<std::size_t>(static_cast<double>(queryMs.size() - 1) * 0.99)]
+              << '\n';
+
+    const unsigned hardwareThreads = std::thread::hardware_concurrency();
+    HierarchicalNavGraph graph(clusterSize);
+    const double hierarchyBuildMs = measureMilliseconds([&] { graph.buildFromRaster(raster); });
+    HierarchicalPath route;
+    std::size_t hierarchyFound = 0;
+    std::size_t abstractExpansions = 0;
+    std::size_t firstSegmentExpansions = 0;
+    std::size_t fullRefineExpansions = 0;
+    double firstSegmentMs = 0.0;
+    double fullRefineMs = 0.0;
+    for (int i = 0; i < queries; ++i) {
+        const glm::vec2 start = walkable[static_cast<std::size_t>(i) * 2];
+        const glm::vec2 end = walkable[static_cast<std::size_t>(i) * 2 + 1];
+        firstSegmentMs += measureMilliseconds([&] {
+            path.points.clear();
+            if (graph.findAbstractPath(start, end, route)) {
+                graph.refine(route, 1, path);
+            }
+        });
+        hierarchyFound += route.valid() ? 1 : 0;
+        abstractExpansions += route.abstractExpansions;
+        firstSegmentExpansions += route.refineExpansions;
+        fullRefineMs += measureMilliseconds([&] { graph.refine(route, route.segmentCount(), path); });
+        fullRefineExpansions += route.refineExpansions;
+    }
+    const double clusterRebuildMs = measureMilliseconds([&] {
+        graph.rebuildCluster(raster, graph.clusterColumns() / 2, graph.clusterRows() / 2);
+    });
+    std::cout << "flat_expansions_avg=" << static_cast<double>(flatExpansions) / queries << '\n'
+              << "hpa_cluster=" << graph.clusterSize() << " hpa_nodes=" << graph.nodeCount()
+              << " hpa_edges=" << graph.edgeCount() << " hpa_build_ms=" << hierarchyBuildMs
+              << " hpa_cluster_rebuild_ms=" << clusterRebuildMs << '\n'
+              << "hpa_found=" << hierarchyFound
+              << " hpa_abstract_expansions_avg=" << static_cast<double>(abstractExpansions) / queries
+              << " hpa_first_segment_expansions_avg="
+              << static_cast<double>(firstSegmentExpansions) / queries
+              << " hpa_full_refine_expansions_avg="
+              << static_cast<double>(fullRefineExpansions) / queries << '\n'
+              << "hpa_first_segment_avg_ms=" << firstSegmentMs / queries
+              << " hpa_full_path_avg_ms=" << (firstSegmentMs + fullRefineMs) / queries << '\n';
+
+    Utils::WorkerPool workers(hardwareThreads > 1 ? hardwareThreads - 1 : 1);
+    const QueueRun serial = runQueue(mesh, walkable, queries, nullptr);
+    const QueueRun parallel = runQueue(mesh, walkable, queries, &workers);
+    std::cout << "queue_budget=" << PathRequestQueue::Settings{}.expansionBudget
+              << " queue_updates=" << serial.updates
+              << " queue_ms=" << serial.totalMs
+              << " queue_latency_avg_updates=" << serial.stats.averageLatencyUpdates
+              << " queue_latency_max_updates=" << serial.stats.maxLatencyUpdates << '\n'
+              << "workers=" << workers.workerCount()
+              << " queue_parallel_ms=" << parallel.totalMs
+              << " queue_parallel_updates=" << parallel.updates << '\n';
+
+    FlowField field;
+    const glm::vec2 goal = walkable.front();
+    const double fieldBuildMs = measureMilliseconds([&] { field.build(raster, goal); });
+    const std::size_t fieldBuildTiles = field.lastTilesIntegrated();
+    const double fieldParallelMs = measureMilliseconds([&] { field.build(raster, goal, &workers); });
+    // Walk the goal one cell at a time, as a chased agent would.
+    int moves = 0;
+    int rebuilds = 0;
+    int pendingMoves = 0;
+    std::size_t moveTiles = 0;
+    double moveMs = 0.0;
+    double rebuildMs = 0.0;
+    glm::vec2 moved = goal;
+    for (int step = 0; step < 64; ++step) {
+        const glm::vec2 next = moved + glm::vec2{raster.cellSize(), 0.0f};
+        int x = 0;
+        int y = 0;
+        if (!raster.worldToCell(next, x, y) || !raster.isWalkable(x, y)) break;
+        moved = next;
+        const double ms = measureMilliseconds([&] { field.moveGoal(raster, moved, &workers); });
+        // Drift rebuilds are full builds; the budget only bounds updates.
+        if (field.lastRebuilt()) {
+            rebuildMs += ms;
+            ++rebuilds;
+            continue;
+        }
+        moveMs += ms;
+        moveTiles += field.lastTilesIntegrated();
+        pendingMoves += field.pending() ? 1 : 0;
+        ++moves;
+    }
+    // Then let the last move finish, as a goal that stops would.
+    int settleCalls = 0;
+    double settleMs = 0.0;
+    while (field.pending()) {
+        settleMs += measureMilliseconds([&] { field.moveGoal(raster, moved, &workers); });
+        ++settleCalls;
+    }
+    glm::vec2 steering{0.0f};
+    const double sampleMs = measureMilliseconds([&] {
+        for (const glm::vec2& point : walkable) steering += field.direction(point);
+    });
+    std::cout << "flow_tile=" << field.settings().tileSize << " flow_build_ms=" << fieldBuildMs
+              << " flow_build_tiles=" << fieldBuildTiles
+              << " flow_parallel_build_ms=" << fieldParallelMs << '\n'
+              << "flow_tile_budget=" << field.settings().tileBudget
+              << " flow_moves=" << moves << " flow_moves_left_pending=" << pendingMoves
+              << " flow_move_avg_ms=" << (moves > 0 ? moveMs / moves : 0.0)
+              << " flow_move_avg_tiles="
+              << (moves > 0 ? static_cast<double>(moveTiles) / moves : 0.0)
+              << " flow_settle_calls=" << settleCalls << " flow_settle_ms=" << settleMs << '\n'
+              << "flow_move_rebuilds=" << rebuilds << " flow_move_rebuild_ms=" << rebuildMs << '\n'
+              << "flow_samples=" << walkable.size() << " flow_sample_ms=" << sampleMs
+              << " flow_steering_checksum=" << steering.x + steering.y << '\n';
+    return 0;
+}
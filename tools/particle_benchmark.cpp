@@ -0,0 +1,138 @@
+// Headless particle simulation benchmark: one emitter holding 1M live
+// particles with gravity, drag and homing enabled, stepped at 60 Hz. Reports
+// the time to burst the pool full and update throughput in particles per
+// millisecond, then steps 100k bouncing particles against a tile floor and a
+// field of static boxes. No GL context required.
+
+#include "GameObjects/Components/TilemapComponent.hpp"
+#include "ParticleSystem/ParticleCollisionWorld.hpp"
+#include "ParticleSystem/ParticleEmitter.hpp"
+#include "ParticleSystem/ParticleEmitterConfig.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+namespace {
+struct Timing {
+    double average;
+    double p99;
+};
+
+template<typename Step>
+Timing measure(int frames, Step&& step) {
+    std::vector<double> frameMs;
+    frameMs.reserve(static_cast<std::size_t>(frames));
+    for (int i = 0; i < frames; ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        step();
+        frameMs.push_back(std::chrono::duration<double, std::milli>(
+                              std::chrono::steady_clock::now() - start)
+                              .count());
+    }
+    double total = 0.0;
+    for (const double ms : frameMs) total += ms;
+    std::sort(frameMs.begin(), frameMs.end());
+    return {total / static_cast<double>(frameMs.size()),
+            frameMs[static_cast<std::size_t>(static_cast<double>(frameMs.size() - 1) * 0.99)]};
+}
+
+// 100k particles raining onto a 512x8 tile floor of 16 px tiles with 2000
+// static boxes scattered above it; once settled nearly all of them touch
+// something every step.
+Timing measureCollision(int frames, ParticleCollisionResponse response, std::size_t& live) {
+    auto floor = std::make_shared<TilemapData>();
+    floor->width = 512;
+    floor->height = 8;
+    floor->tileSize = {16.0f, 16.0f};
+    floor->tiles.assign(static_cast<std::size_t>(floor->width * floor->height), -1);
+    std::fill_n(floor->tiles.begin(), floor->width * 2, 0);
+    ParticleCollisionWorld world;
+    world.addTileLayer(floor, {-4096.0f, 0.0f});
+    std::vector<glm::vec4> boxes;
+    for (int i = 0; i < 2000; ++i) {
+        const float x = -4000.0f + static_cast<float>(i % 200) * 40.0f;
+        const float y = 60.0f + static_cast<float>(i / 200) * 24.0f;
+        boxes.emplace_back(x, y, x + 12.0f, y + 6.0f);
+    }
+    world.setBoxes(boxes);
+
+    ParticleEmitterConfig config{};
+    config.spawnRate = 0.0f;
+    config.minLifeTime = 1.0e6f;
+    config.maxLifeTime = 2.0e6f;
+    config.minSpeed = 50.0f;
+    config.maxSpeed = 400.0f;
+    config.spread = 6.2831853f;
+    config.gravity = {0.0f, -900.0f};
+    config.collisionResponse = response;
+    config.restitution = 0.6f;
+    config.collisionFriction = 0.1f;
+
+    constexpr std::size_t kColliding = 100'000;
+    ParticleEmitter emitter{kColliding, config};
+    emitter.setCollisionWorld(&world);
+    for (int row = 0; row < 100; ++row) {
+        emitter.setPosition({-4000.0f + static_cast<float>(row) * 80.0f, 200.0f});
+        emitter.burst(static_cast<unsigned int>(kColliding / 100));
+    }
+    // Let the rain reach the floor first.
+    for (int i = 0; i < 60; ++i) {
+        emitter.update(1.0f / 60.0f);
+    }
+    const Timing timing = measure(frames, [&] { emitter.update(1.0f / 60.0f); });
+    live = emitter.liveParticleCount();
+    return timing;
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    const int frames = argc > 1 ? std::atoi(argv[1]) : 300;
+    const int particleCount = argc > 2 ? std::atoi(argv[2]) : 1'000'000;
+    if (frames <= 0 || particleCount <= 0) {
+        std::cerr << "Usage: GL2D_PARTICLE_BENCHMARK [positive frame count] [particle count]\n";
+        return 2;
+    }
+
+    ParticleEmitterConfig config{};
+    config.spawnRate = 0.0f;
+    // Outlive the run so the live count stays constant.
+    config.minLifeTime = 1.0e6f;
+    config.maxLifeTime = 2.0e6f;
+    config.drag = 0.5f;
+    config.homingStrength = 20.0f;
+    config.endColor = {1.0f, 0.2f, 0.0f, 0.0f};
+    config.endSizeMultiplier = 0.25f;
+
+    ParticleEmitter emitter{static_cast<std::size_t>(particleCount), config};
+    emitter.setTarget({100.0f, 50.0f});
+    const auto burstStart = std::chrono::steady_clock::now();
+    emitter.burst(static_cast<unsigned int>(particleCount));
+    const double burstMs = std::chrono::duration<double, std::milli>(
+                               std::chrono::steady_clock::now() - burstStart)
+                               .count();
+
+    for (int i = 0; i < 10; ++i) {
+        emitter.update(1.0f / 60.0f);
+    }
+
+    const Timing timing = measure(frames, [&] { emitter.update(1.0f / 60.0f); });
+    std::cout << "particles=" << emitter.liveParticleCount()
+              << " burst_ms=" << burstMs
+              << " avg_ms=" << timing.average
+              << " p99_ms=" << timing.p99
+              << " particles_per_ms="
+              << static_cast<double>(emitter.liveParticleCount()) / timing.average << "\n";
+
+    std::size_t colliding = 0;
+    const Timing unresolved = measureCollision(frames, ParticleCollisionResponse::None, colliding);
+    const Timing collision = measureCollision(frames, ParticleCollisionResponse::Bounce, colliding);
+    std::cout << "colliding_particles=" << colliding
+              << " collision_avg_ms=" << collision.average
+              << " collision_p99_ms=" << collision.p99
+              << " collision_off_avg_ms=" << unresolved.average << "\n";
+    return 0;
+}